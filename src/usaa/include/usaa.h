@@ -4,7 +4,18 @@
 #ifndef BE_USAA_H_
 #define BE_USAA_H_
 
-#include "export.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#include "usaa_export.h"
+
+/** Error codes.
+ */
+#define USAA_EOK        0
+#define USAA_EFAILD     -1
+#define USAA_EMEMORY    -2 /* Cannot allocate or reallocate a block of memory. */
+#define USAA_EIO        -3 /* Cannot open, map or read a file. */
+#define USAA_EFORMAT    -4 /* The input is not laid out as Unity writes it. */
 
 /** USAA Classes Ordered by ID Number.
  */
@@ -244,4 +255,630 @@
 #define MSAA_LIGHTMAP_PARAMETERS                1113
 #define MSAA_LIGHTMAP_SNAPSHOT                  1120
 
+/** Class flags.
+ */
+#define USAA_CLASS_COMPONENT    0x01 /* Attached to a GameObject. */
+#define USAA_CLASS_ASSET        0x02 /* A named object stored as or in an asset. */
+#define USAA_CLASS_MANAGER      0x04 /* Project or scene settings. */
+#define USAA_CLASS_EDITOR       0x08 /* Only exists in the editor, never in builds. */
+#define USAA_CLASS_ABSTRACT     0x10 /* Only a base of other classes. */
+
+/** What is known of a class id.
+ */
+typedef struct {
+    const char *name;
+    int parent;             /* The base class id, 0 for Object. */
+    unsigned flags;
+    unsigned short enter;   /* The pre-order number of the class in the hierarchy. */
+    unsigned short leave;   /* One past the numbers of its derived classes. */
+} usaa_class_t;
+
+/** Look a class id up in constant time.
+ *  Returns NULL for unknown ids.
+ */
+USAA_DECL const usaa_class_t *usaa_class_get(int class_id);
+
+/** The Unity name of a class, or NULL for unknown ids.
+ */
+USAA_DECL const char *usaa_class_name(int class_id);
+
+/** The USAA_CLASS_* flags of a class, 0 for unknown ids.
+ */
+USAA_DECL unsigned usaa_class_flags(int class_id);
+
+/** Check if a class is or derives from a base class, in constant time.
+ */
+USAA_DECL int usaa_class_is_a(int class_id, int base_id);
+
+/** Find a class id by its Unity name, 0 if there is none.
+ */
+USAA_DECL int usaa_class_find(const char *name, size_t length);
+
+/** A read-only view of a whole file, mapped when possible.
+ */
+typedef struct {
+    const char *data;
+    size_t size;
+    void *handle;
+} usaa_map_t;
+
+/** Map a file for reading.
+ *  Returns USAA_EOK, or USAA_EIO if the file cannot be opened or mapped.
+ */
+USAA_DECL int usaa_map_open(usaa_map_t *map, const char *path);
+
+/** Unmap a file.
+ */
+USAA_DECL void usaa_map_close(usaa_map_t *map);
+
+/** A Unity object, one YAML document introduced by `--- !u!<class> &<fileID>`.
+ *  The offsets are in bytes from the start of the scanned text.
+ */
+typedef struct {
+    int class_id;
+    int stripped;           /* The header ends with `stripped`, the object lives in a prefab. */
+    int64_t file_id;
+    size_t offset;          /* The first byte of the `---` line. */
+    size_t body;            /* The first byte after the header line. */
+    size_t length;          /* The bytes up to the next header or the end of the text. */
+} usaa_object_t;
+
+/** The objects of a file, in the order of the text.
+ */
+typedef struct {
+    usaa_object_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_objects_t;
+
+/** Append the objects of a Unity YAML text to a list, initially zeroed.
+ *  Only the document headers are read, the bodies are skipped with memchr().
+ *  Lines that look like headers but do not parse are left in the body of
+ *  the previous object.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_objects_scan(usaa_objects_t *objects, const char *data, size_t size);
+
+/** Free a list of objects.
+ */
+USAA_DECL void usaa_objects_destroy(usaa_objects_t *objects);
+
+/** A Unity GUID, the 32 hex digits of the text read as two numbers.
+ */
+typedef struct {
+    uint64_t high;
+    uint64_t low;
+} usaa_guid_t;
+
+/** Parse the 32 hex digits of a GUID.
+ *  Returns USAA_EOK, or USAA_EFORMAT if the text is not a GUID.
+ */
+USAA_DECL int usaa_guid_parse(usaa_guid_t *guid, const char *text, size_t length);
+
+/** Write the 32 hex digits of a GUID and a NUL.
+ */
+USAA_DECL void usaa_guid_format(const usaa_guid_t *guid, char *text);
+
+/** Check if two GUIDs are equal.
+ */
+#define USAA_GUID_EQUAL(a, b) ((a)->high == (b)->high && (a)->low == (b)->low)
+
+/** A reference to an object, `{fileID: <id>, guid: <guid>, type: <type>}`,
+ *  or `{fileID: <id>}` for the objects of the same file.
+ */
+typedef struct {
+    int64_t file_id;
+    usaa_guid_t guid;       /* Zero for the objects of the same file. */
+    int type;               /* 2 for assets, 3 for their objects, 0 if not given. */
+    int external;           /* The reference has a GUID. */
+} usaa_reference_t;
+
+/** Find the next reference in a text, leaving `pointer` after it.
+ *  Returns 1 if one is found, 0 at the end of the text.
+ */
+USAA_DECL int usaa_reference_next(const char **pointer, const char *end, usaa_reference_t *reference);
+
+/** No node of a hierarchy.
+ */
+#define USAA_HIERARCHY_NONE UINT32_MAX
+
+/** A Transform or RectTransform placed in the hierarchy of a file.
+ */
+typedef struct {
+    int64_t file_id;
+    int64_t game_object;    /* The fileID of the GameObject, 0 if not given. */
+    size_t object;          /* The index of the Transform in the objects of the file. */
+    uint32_t parent;        /* USAA_HIERARCHY_NONE for the roots. */
+    uint32_t first_child;
+    uint32_t next_sibling;  /* The children in the order of `m_Children`. */
+    uint32_t depth;         /* 0 for the roots. */
+} usaa_hierarchy_node_t;
+
+/** The GameObject hierarchy of a scene or prefab, one node per Transform.
+ *  The roots are chained by `next_sibling` from `first_root` in the order of
+ *  the text.
+ */
+typedef struct {
+    usaa_hierarchy_node_t *nodes;
+    size_t count;
+    uint32_t first_root;
+
+    uint32_t *table;        /* Open addressing by the fileIDs of the Transforms and GameObjects, node + 1. */
+    size_t mask;
+} usaa_hierarchy_t;
+
+/** Build the hierarchy of the Transforms of a text from their `m_Children`,
+ *  and from `m_Father` for the ones no parent lists, like the children
+ *  added under the stripped Transform of a prefab instance. A link that
+ *  would close a cycle is dropped.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_hierarchy_build(usaa_hierarchy_t *hierarchy, const char *text, const usaa_objects_t *objects);
+
+/** Free a hierarchy.
+ */
+USAA_DECL void usaa_hierarchy_destroy(usaa_hierarchy_t *hierarchy);
+
+/** The node of a Transform, or of the Transform of a GameObject, by fileID,
+ *  USAA_HIERARCHY_NONE if there is none.
+ */
+USAA_DECL uint32_t usaa_hierarchy_find(const usaa_hierarchy_t *hierarchy, int64_t file_id);
+
+/** An asset of a project, known by its .meta file.
+ */
+typedef struct {
+    usaa_guid_t guid;
+    const char *path;       /* The asset path from the project root, '/' separated, without ".meta". */
+    int importer;           /* The class id of the importer, 0 if unknown. */
+    int folder;             /* The asset is a folder. */
+} usaa_asset_t;
+
+/** Blocks of strings freed together.
+ */
+typedef struct usaa_arena_s usaa_arena_t;
+
+/** The assets of a Unity project, indexed by GUID.
+ */
+typedef struct {
+    char *root;
+    usaa_asset_t *assets;   /* Sorted by path. */
+    size_t count;
+    size_t duplicates;      /* The .meta files whose GUID was already taken, left out. */
+
+    uint32_t *table;        /* Open addressing by GUID, asset index + 1, 0 when free. */
+    size_t mask;
+
+    usaa_arena_t *strings;
+} usaa_project_t;
+
+/** Index the .meta files found under the Assets and Packages folders of a
+ *  project, walking the directories on `threads` threads, all processors if
+ *  not positive.
+ *  Returns USAA_EOK, USAA_EIO if there is no Assets folder, or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_project_open(usaa_project_t *project, const char *root, int threads);
+
+/** Find an asset by its path from the project root, NULL if there is none.
+ */
+USAA_DECL const usaa_asset_t *usaa_project_find_path(const usaa_project_t *project,
+        const char *path, size_t length);
+
+/** Free a project index.
+ */
+USAA_DECL void usaa_project_destroy(usaa_project_t *project);
+
+/** Find an asset by GUID, NULL if the project does not have it.
+ */
+USAA_DECL const usaa_asset_t *usaa_project_find(const usaa_project_t *project, const usaa_guid_t *guid);
+
+/** A file of a project holding Unity objects as YAML.
+ */
+typedef struct {
+    const usaa_asset_t *asset;
+    uint64_t size;
+    uint64_t mtime;         /* The time of the last change, in nanoseconds. */
+    size_t objects;         /* The objects found, 0 until the file is scanned. */
+    int error;              /* USAA_EIO, USAA_EFORMAT for binary files, or what the visit returned. */
+    int skip;               /* Set before usaa_scan_run() to leave the file alone. */
+} usaa_scan_file_t;
+
+/** Look at a scanned file, on the thread that scanned it.
+ *  `worker` is below the threads of the scan, the text is only mapped during the call.
+ *  Returns USAA_EOK, or an error kept as the error of the file.
+ */
+typedef int (*usaa_scan_visit_t)(void *data, int worker, const usaa_scan_file_t *file,
+        const char *text, const usaa_objects_t *objects);
+
+/** The scan of the YAML files of a project.
+ */
+typedef struct {
+    const usaa_project_t *project;
+    int threads;
+
+    usaa_scan_file_t *files;    /* The largest first. */
+    size_t count;
+
+    uint64_t bytes;             /* The totals of the files scanned without error. */
+    uint64_t objects;
+    size_t failed;
+    size_t skipped;
+} usaa_scan_t;
+
+/** Pick the files of a project to scan, scenes, prefabs and other YAML assets,
+ *  and order them by size, getting the sizes on `threads` threads, all
+ *  processors if not positive.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_scan_init(usaa_scan_t *scan, const usaa_project_t *project, int threads);
+
+/** Map and scan the files not skipped, calling `visit` if not NULL for each of them.
+ *  Every thread starts on large files of its own and steals small ones from
+ *  the others when it runs out, and writes to the files it took and to totals
+ *  of its own, added up at the end.
+ *  Returns USAA_EOK or USAA_EMEMORY, the files keep their own errors.
+ */
+USAA_DECL int usaa_scan_run(usaa_scan_t *scan, usaa_scan_visit_t visit, void *data);
+
+/** Free a scan.
+ */
+USAA_DECL void usaa_scan_destroy(usaa_scan_t *scan);
+
+/** The version of the index file layout, changed whenever it changes.
+ */
+#define USAA_INDEX_VERSION  1
+
+/** A file of an index, its records are ranges of the index arrays.
+ *  All records are laid out the same way on disk and in memory.
+ */
+typedef struct {
+    uint64_t mtime;
+    uint64_t size;
+    uint64_t hash;              /* Of the content. */
+    usaa_guid_t guid;
+    uint32_t path;              /* The offset of the path in the strings, NUL terminated. */
+    uint32_t path_length;
+    uint32_t objects;
+    uint32_t object_count;
+    uint32_t references;
+    uint32_t reference_count;
+    int32_t error;              /* The error of the scan, USAA_EFORMAT for binary files. */
+    uint32_t reserved;
+} usaa_index_file_t;
+
+typedef struct {
+    int32_t class_id;
+    int32_t stripped;
+    int64_t file_id;
+    uint64_t offset;
+    uint64_t body;
+    uint64_t length;
+} usaa_index_object_t;
+
+typedef struct {
+    uint32_t object;            /* The object holding it, from the first of its file. */
+    int32_t type;
+    int64_t file_id;
+    usaa_guid_t guid;
+    uint32_t external;
+    uint32_t reserved;
+} usaa_index_reference_t;
+
+/** What scans found, kept between runs in a file mapped as it is.
+ */
+typedef struct {
+    const usaa_index_file_t *files;     /* Sorted by path. */
+    size_t count;
+    const usaa_index_object_t *objects;
+    size_t object_count;
+    const usaa_index_reference_t *references;
+    size_t reference_count;
+    const char *strings;
+    size_t strings_size;
+
+    size_t reused;              /* The files of the last update taken from the previous index. */
+    size_t parsed;              /* The files of the last update scanned again. */
+    int changed;                /* The last update changed the index, it needs saving. */
+
+    usaa_map_t map;             /* The file, if the index was loaded. */
+    void *memory;               /* The block, if the index was updated. */
+    size_t size;
+} usaa_index_t;
+
+/** Map an index file.
+ *  Returns USAA_EOK, USAA_EIO if the file cannot be mapped, or USAA_EFORMAT if
+ *  it is not an index of this version and byte order. The index is then
+ *  empty and can still be updated.
+ */
+USAA_DECL int usaa_index_load(usaa_index_t *index, const char *path);
+
+/** Bring an index up to date with the files of a scan.
+ *  Files with the mtime and size of the index are skipped. The others are
+ *  scanned, and kept from the index if the hash of their content did not
+ *  change, or have their objects and references extracted again.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_index_update(usaa_index_t *index, usaa_scan_t *scan);
+
+/** Build a new index from a previous one and the files of a scan, like
+ *  usaa_index_update() but leaving the previous index as it is for the
+ *  threads still reading it.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_index_rebuild(usaa_index_t *index, const usaa_index_t *previous, usaa_scan_t *scan);
+
+/** Write an index to a file, replacing it at once.
+ *  Returns USAA_EOK or USAA_EIO.
+ */
+USAA_DECL int usaa_index_save(const usaa_index_t *index, const char *path);
+
+/** Free an index.
+ */
+USAA_DECL void usaa_index_destroy(usaa_index_t *index);
+
+/** Find a file of an index by path, NULL if there is none.
+ */
+USAA_DECL const usaa_index_file_t *usaa_index_find(const usaa_index_t *index, const char *path, size_t length);
+
+/** The directions of the edges of a dependency graph.
+ */
+#define USAA_GRAPH_FORWARD  0 /* From an asset to the assets it references. */
+#define USAA_GRAPH_REVERSE  1 /* From an asset to the assets referencing it. */
+
+/** No node.
+ */
+#define USAA_GRAPH_NONE     UINT32_MAX
+
+/** Edges stored as compressed sparse rows: the targets of node `n` are
+ *  `targets[offsets[n]]` up to `targets[offsets[n + 1]]`, sorted.
+ */
+typedef struct {
+    uint32_t *offsets;
+    uint32_t *targets;
+} usaa_edges_t;
+
+/** The references between the assets of a project.
+ *  The first nodes are the assets of the project in the same order, the
+ *  others the GUIDs referenced but not in the project, built-in resources
+ *  or missing assets.
+ */
+typedef struct {
+    const usaa_project_t *project;
+
+    usaa_guid_t *guids;     /* The GUIDs of the nodes. */
+    size_t count;
+    size_t edges;
+    usaa_edges_t direction[2];
+
+    uint32_t *table;        /* Open addressing by GUID for the nodes out of the project, node + 1. */
+    size_t mask;
+} usaa_graph_t;
+
+/** The targets of a node in a direction, and their number.
+ */
+#define USAA_GRAPH_TARGETS(graph, dir, node) \
+    ((graph)->direction[dir].targets + (graph)->direction[dir].offsets[node])
+#define USAA_GRAPH_DEGREE(graph, dir, node) \
+    ((graph)->direction[dir].offsets[(node) + 1] - (graph)->direction[dir].offsets[node])
+
+/** Run a scan and build the graph of the references with a GUID between
+ *  its files, all the objects of an asset making one node.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_graph_build(usaa_graph_t *graph, usaa_scan_t *scan);
+
+/** Build the graph of the references kept in an index, without scanning.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_graph_build_index(usaa_graph_t *graph, const usaa_project_t *project,
+        const usaa_index_t *index);
+
+/** Free a graph.
+ */
+USAA_DECL void usaa_graph_destroy(usaa_graph_t *graph);
+
+/** The node of a GUID, USAA_GRAPH_NONE if it is not referenced nor in the project.
+ */
+USAA_DECL uint32_t usaa_graph_find(const usaa_graph_t *graph, const usaa_guid_t *guid);
+
+/** Find the nodes reached from some roots in a direction, the roots included,
+ *  in breadth-first order. The nodes are allocated with malloc().
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_graph_closure(const usaa_graph_t *graph, const uint32_t *roots, size_t count,
+        int dir, uint32_t **nodes, size_t *reached);
+
+/** Mark the nodes reached from some roots in a direction, the roots
+ *  included, in a bitmap of (count + 63) / 64 words set to zero, bit
+ *  `n & 63` of word `n >> 6` for node `n`. Each level of the search is
+ *  shared among `threads` threads, all processors if not positive.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_graph_reach(const usaa_graph_t *graph, const uint32_t *roots, size_t count,
+        int dir, int threads, uint64_t *reached);
+
+/** Check if a node reaches another one forward, searching from both ends.
+ *  Returns 1 if it does, 0 if it does not, or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_graph_reaches(const usaa_graph_t *graph, uint32_t from, uint32_t to);
+
+/** An asset no build includes.
+ */
+typedef struct {
+    const usaa_asset_t *asset;
+    uint64_t size;
+} usaa_unused_asset_t;
+
+/** The assets no build root reaches.
+ */
+typedef struct {
+    usaa_unused_asset_t *assets;    /* The largest first. */
+    size_t count;
+    uint64_t bytes;
+
+    size_t scenes;          /* The roots by kind. */
+    size_t resources;
+    size_t bundles;
+    size_t reached;         /* The assets reached from the roots. */
+} usaa_unused_t;
+
+/** Find the assets under Assets/ that the builds leave out.
+ *  The roots are the scenes enabled in ProjectSettings/EditorBuildSettings.asset,
+ *  the assets in Resources folders and the ones with an AssetBundle, theirs or
+ *  that of a folder above them. The assets of Editor folders, scripts and
+ *  plugins are built their own way and never reported.
+ *  Runs on `threads` threads, all processors if not positive.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_unused_find(usaa_unused_t *unused, const usaa_graph_t *graph, int threads);
+
+/** Free the unused assets.
+ */
+USAA_DECL void usaa_unused_destroy(usaa_unused_t *unused);
+
+/** A property a prefab instance overrides, `propertyPath` set to `value`
+ *  or to `objectReference`. The texts are as written in the YAML, quotes
+ *  included, and live as long as the file they come from.
+ */
+typedef struct {
+    usaa_reference_t target;    /* The object of the source prefab. */
+    const char *property_path;
+    size_t property_length;
+    const char *value;
+    size_t value_length;
+    usaa_reference_t object_reference;
+} usaa_modification_t;
+
+/** An object of a file once its prefab instances are expanded.
+ */
+typedef struct {
+    int class_id;
+    int64_t file_id;            /* The XOR of the instance and source fileIDs for the objects of instances. */
+    int64_t instance;           /* The fileID of the PrefabInstance it comes from, 0 for the objects of the file. */
+    const char *text;           /* The document of the object, in the file or in its source prefab. */
+    size_t length;
+    size_t modifications;       /* The first override of the object, the innermost prefab first. */
+    size_t modification_count;
+} usaa_resolved_object_t;
+
+/** The objects of a scene or prefab with those of its prefab instances,
+ *  nested ones included, in place of their stripped placeholders.
+ */
+typedef struct {
+    usaa_resolved_object_t *objects;
+    size_t count;
+    usaa_modification_t *modifications;
+    size_t modification_count;
+
+    size_t instances;           /* The prefab instances, nested ones included. */
+    size_t missing;             /* The instances whose source prefab cannot be read. */
+
+    uint32_t *table;            /* Open addressing by fileID, object + 1. */
+    size_t mask;
+} usaa_resolved_t;
+
+/** The resolved prefabs of a project by GUID, each read and resolved once
+ *  and shared by all threads.
+ */
+typedef struct usaa_prefab_cache_s usaa_prefab_cache_t;
+
+/** Create an empty prefab cache for a project, which must outlive it.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_prefab_cache_create(usaa_prefab_cache_t **cache, const usaa_project_t *project);
+
+/** Free a prefab cache and the prefabs it resolved.
+ */
+USAA_DECL void usaa_prefab_cache_destroy(usaa_prefab_cache_t *cache);
+
+/** Get the resolved objects of a prefab, resolving it on first use.
+ *  A thread asking for a prefab another thread is resolving waits for it.
+ *  Returns USAA_EOK, USAA_EIO if the prefab is not in the project or cannot
+ *  be read, USAA_EFORMAT if it nests itself, or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_prefab_cache_get(usaa_prefab_cache_t *cache, const usaa_guid_t *guid,
+        const usaa_resolved_t **resolved);
+
+/** Resolve the objects of a scanned text. Each PrefabInstance brings in the
+ *  resolved objects of its `m_SourcePrefab` from the cache, less its
+ *  `m_RemovedComponents` and `m_RemovedGameObjects`, with its
+ *  `m_Modifications` after those of the source. Instances written before
+ *  Unity 2018.3 keep full copies of their objects in the text and bring in
+ *  nothing. Instances whose source cannot be resolved are counted as missing.
+ *  Returns USAA_EOK or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_resolve(usaa_resolved_t *resolved, usaa_prefab_cache_t *cache, const char *text,
+        const usaa_objects_t *objects);
+
+/** Free resolved objects.
+ */
+USAA_DECL void usaa_resolved_destroy(usaa_resolved_t *resolved);
+
+/** Find a resolved object by fileID, NULL if there is none.
+ */
+USAA_DECL const usaa_resolved_object_t *usaa_resolved_find(const usaa_resolved_t *resolved, int64_t file_id);
+
+/** The last override of a property of a resolved object, the one that
+ *  wins, or NULL if the text of the object holds its value.
+ */
+USAA_DECL const usaa_modification_t *usaa_resolved_override(const usaa_resolved_t *resolved,
+        const usaa_resolved_object_t *object, const char *property_path, size_t length);
+
+#if defined(__linux__)
+
+/** What is known of a project at one time, read while the watch moves on.
+ */
+typedef struct {
+    usaa_project_t project;
+    usaa_index_t index;
+    usaa_graph_t graph;
+    uint64_t generation;    /* One more at each refresh. */
+} usaa_snapshot_t;
+
+/** A project kept up to date with inotify.
+ */
+typedef struct usaa_watch_s usaa_watch_t;
+
+/** Index a project and start watching its Assets and Packages trees.
+ *  The index file, if not NULL, is loaded to start with and saved on close.
+ *  The refreshes scan on `threads` threads, all processors if not positive,
+ *  once no change came for `debounce` milliseconds.
+ *  Returns USAA_EOK, USAA_EIO, USAA_EFAILD if inotify is not available, or USAA_EMEMORY.
+ */
+USAA_DECL int usaa_watch_open(usaa_watch_t **watch, const char *root, const char *index_path,
+        int threads, int debounce);
+
+/** Hear of a refresh that failed, on the thread of usaa_watch_run().
+ *  The snapshot before it is kept, and the next refresh walks the whole project.
+ */
+typedef void (*usaa_watch_report_t)(void *data, int error);
+
+/** Wait for changes and refresh the snapshot until usaa_watch_stop() is called.
+ *  Only the directories that changed are listed again. A refresh that fails
+ *  is passed to `report`, if not NULL, when it fails.
+ *  Returns USAA_EOK, or USAA_EFAILD if waiting for the changes failed.
+ */
+USAA_DECL int usaa_watch_run(usaa_watch_t *watch, usaa_watch_report_t report, void *data);
+
+/** Make usaa_watch_run() return, from any thread or a signal handler.
+ */
+USAA_DECL void usaa_watch_stop(usaa_watch_t *watch);
+
+/** Take the current snapshot, it stays valid until it is released with the
+ *  ticket. Never blocks, refreshes wait for the readers of the snapshots
+ *  they replace.
+ */
+USAA_DECL const usaa_snapshot_t *usaa_watch_acquire(usaa_watch_t *watch, int *ticket);
+
+/** Release a snapshot taken with usaa_watch_acquire().
+ */
+USAA_DECL void usaa_watch_release(usaa_watch_t *watch, int ticket);
+
+/** Stop watching, save the index if a refresh changed it since it was
+ *  loaded or saved, and free everything.
+ *  No snapshot may be held anymore.
+ */
+USAA_DECL void usaa_watch_close(usaa_watch_t *watch);
+
+#endif /* __linux__ */
+
 #endif /* !BE_USAA_H_ */
@@ -0,0 +1,82 @@
+/* The class table: the constant enter and leave numbers agree with the
+ * bases for every pair of classes.
+ */
+
+#include "usaa_test.h"
+
+/* The derivation as the bases tell it, walking up to Object.
+ */
+static int usaa_test_derives_(int class_id, int base_id)
+{
+    while (class_id) {
+        if (class_id == base_id)
+            return 1;
+        class_id = usaa_class_get(class_id)->parent;
+    }
+    return 0;
+}
+
+static void usaa_test_is_a_all_(void)
+{
+    int class_id;
+    int base_id;
+    int classes = 0;
+
+    for (class_id = 1; class_id <= MSAA_LIGHTMAP_SNAPSHOT; class_id++) {
+        const usaa_class_t *info = usaa_class_get(class_id);
+
+        if (!info)
+            continue;
+        classes++;
+        USAA_TEST_CHECK(info->enter < info->leave);
+        USAA_TEST_CHECK(!info->parent || usaa_class_get(info->parent));
+
+        for (base_id = 1; base_id <= MSAA_LIGHTMAP_SNAPSHOT; base_id++) {
+            if (!usaa_class_get(base_id))
+                continue;
+            if (usaa_class_is_a(class_id, base_id) != usaa_test_derives_(class_id, base_id)) {
+                fprintf(stderr, "%s is_a %s disagrees with the bases\n",
+                    info->name, usaa_class_name(base_id));
+                USAA_TEST_CHECK(0);
+            }
+        }
+    }
+    USAA_TEST_CHECK(classes > 200);
+}
+
+static void usaa_test_is_a_(void)
+{
+    USAA_TEST_CHECK(usaa_class_is_a(USAA_MESH_RENDERER, USAA_MESH_RENDERER));
+    USAA_TEST_CHECK(usaa_class_is_a(USAA_MESH_RENDERER, USAA_RENDERER));
+    USAA_TEST_CHECK(usaa_class_is_a(USAA_MESH_RENDERER, USAA_COMPONENT));
+    USAA_TEST_CHECK(usaa_class_is_a(USAA_MESH_RENDERER, USAA_EDITOR_EXTENSION));
+    USAA_TEST_CHECK(!usaa_class_is_a(USAA_RENDERER, USAA_MESH_RENDERER));
+    USAA_TEST_CHECK(!usaa_class_is_a(USAA_TRANSFORM, USAA_RENDERER));
+    USAA_TEST_CHECK(usaa_class_is_a(USAA_CUBEMAP, USAA_TEXTURE));
+    USAA_TEST_CHECK(!usaa_class_is_a(USAA_CUBEMAP, USAA_COMPONENT));
+    USAA_TEST_CHECK(usaa_class_is_a(MSAA_PVR_IMPORTER, MSAA_ASSET_IMPORTER));
+
+    /* Unknown ids derive from nothing, and nothing derives from them. */
+    USAA_TEST_CHECK(!usaa_class_is_a(0, USAA_COMPONENT));
+    USAA_TEST_CHECK(!usaa_class_is_a(USAA_TRANSFORM, 0));
+    USAA_TEST_CHECK(!usaa_class_is_a(500, USAA_COMPONENT));
+    USAA_TEST_CHECK(!usaa_class_is_a(USAA_TRANSFORM, MSAA_LIGHTMAP_SNAPSHOT + 1));
+}
+
+static void usaa_test_lookup_(void)
+{
+    USAA_TEST_CHECK(!strcmp(usaa_class_name(USAA_TRANSFORM), "Transform"));
+    USAA_TEST_CHECK(usaa_class_find("Transform", 9) == USAA_TRANSFORM);
+    USAA_TEST_CHECK(usaa_class_find("Transforms", 10) == 0);
+    USAA_TEST_CHECK(usaa_class_find("PVRImporter", 11) == MSAA_PVR_IMPORTER);
+    USAA_TEST_CHECK(usaa_class_flags(USAA_RENDERER) == (USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT));
+    USAA_TEST_CHECK(usaa_class_get(MSAA_PREFAB - 1) == NULL);
+}
+
+int main(void)
+{
+    usaa_test_is_a_all_();
+    usaa_test_is_a_();
+    usaa_test_lookup_();
+    return USAA_TEST_RESULT();
+}
@@ -0,0 +1,72 @@
+/* The hierarchy of tests/fixtures/Assets/Hierarchy.unity: children in the
+ * order of `m_Children`, the ones only `m_Father` knows after them, and a
+ * cycle broken.
+ */
+
+#include "usaa_test.h"
+
+int main(int argc, char *argv[])
+{
+    char path[4096];
+    usaa_objects_t objects = { NULL, 0, 0 };
+    usaa_hierarchy_t hierarchy;
+    usaa_map_t map;
+    uint32_t root, first, second, third, a, b;
+
+    USAA_TEST_REQUIRE(argc == 2);
+    snprintf(path, sizeof(path), "%s/Assets/Hierarchy.unity", argv[1]);
+    USAA_TEST_REQUIRE(!usaa_map_open(&map, path));
+    USAA_TEST_REQUIRE(!usaa_objects_scan(&objects, map.data, map.size));
+    USAA_TEST_REQUIRE(!usaa_hierarchy_build(&hierarchy, map.data, &objects));
+
+    /* A RectTransform is a Transform too. */
+    USAA_TEST_CHECK(hierarchy.count == 6);
+
+    /* The GameObject finds its Transform. */
+    root = usaa_hierarchy_find(&hierarchy, 101);
+    USAA_TEST_REQUIRE(root != USAA_HIERARCHY_NONE);
+    USAA_TEST_CHECK(usaa_hierarchy_find(&hierarchy, 100) == root);
+    USAA_TEST_CHECK(usaa_hierarchy_find(&hierarchy, 0) == USAA_HIERARCHY_NONE);
+    USAA_TEST_CHECK(hierarchy.first_root == root);
+
+    /* 301 and 201 as `m_Children` lists them, not as the text has them,
+     * then 401 that only names its father. */
+    first = hierarchy.nodes[root].first_child;
+    USAA_TEST_REQUIRE(first != USAA_HIERARCHY_NONE);
+    second = hierarchy.nodes[first].next_sibling;
+    USAA_TEST_REQUIRE(second != USAA_HIERARCHY_NONE);
+    third = hierarchy.nodes[second].next_sibling;
+    USAA_TEST_REQUIRE(third != USAA_HIERARCHY_NONE);
+    USAA_TEST_CHECK(hierarchy.nodes[first].file_id == 301);
+    USAA_TEST_CHECK(hierarchy.nodes[second].file_id == 201);
+    USAA_TEST_CHECK(hierarchy.nodes[third].file_id == 401);
+    USAA_TEST_CHECK(hierarchy.nodes[third].next_sibling == USAA_HIERARCHY_NONE);
+    USAA_TEST_CHECK(hierarchy.nodes[first].parent == root && hierarchy.nodes[first].depth == 1);
+    USAA_TEST_CHECK(hierarchy.nodes[third].parent == root && hierarchy.nodes[third].depth == 1);
+
+    /* 501 and 601 list each other: one link is dropped, the other one of
+     * them is a root with the first as its only child. */
+    a = usaa_hierarchy_find(&hierarchy, 501);
+    b = usaa_hierarchy_find(&hierarchy, 601);
+    USAA_TEST_REQUIRE(a != USAA_HIERARCHY_NONE && b != USAA_HIERARCHY_NONE);
+    if (hierarchy.nodes[a].parent == USAA_HIERARCHY_NONE) {
+        uint32_t swap = a;
+
+        a = b;
+        b = swap;
+    }
+    USAA_TEST_CHECK(hierarchy.nodes[b].parent == USAA_HIERARCHY_NONE);
+    USAA_TEST_CHECK(hierarchy.nodes[a].parent == b);
+    USAA_TEST_CHECK(hierarchy.nodes[b].first_child == a);
+    USAA_TEST_CHECK(hierarchy.nodes[a].first_child == USAA_HIERARCHY_NONE);
+    USAA_TEST_CHECK(hierarchy.nodes[a].depth == 1);
+
+    /* The roots in the order of the text. */
+    USAA_TEST_CHECK(hierarchy.nodes[root].next_sibling == b);
+    USAA_TEST_CHECK(hierarchy.nodes[b].next_sibling == USAA_HIERARCHY_NONE);
+
+    usaa_hierarchy_destroy(&hierarchy);
+    usaa_objects_destroy(&objects);
+    usaa_map_close(&map);
+    return USAA_TEST_RESULT();
+}
@@ -0,0 +1,119 @@
+/* An index of tests/fixtures saved, loaded back the same, and rescanned
+ * warm without opening a file.
+ */
+
+#include "usaa_test.h"
+
+/* Check two indexes hold the same records.
+ */
+static void usaa_test_same_(const usaa_index_t *a, const usaa_index_t *b)
+{
+    size_t i;
+
+    USAA_TEST_REQUIRE(a->count == b->count);
+    USAA_TEST_CHECK(a->object_count == b->object_count);
+    USAA_TEST_CHECK(a->reference_count == b->reference_count);
+    for (i = 0; i < a->count; i++) {
+        const usaa_index_file_t *x = a->files + i;
+        const usaa_index_file_t *y = b->files + i;
+
+        USAA_TEST_CHECK(!strcmp(a->strings + x->path, b->strings + y->path));
+        USAA_TEST_CHECK(x->mtime == y->mtime && x->size == y->size && x->hash == y->hash);
+        USAA_TEST_CHECK(USAA_GUID_EQUAL(&x->guid, &y->guid));
+        USAA_TEST_CHECK(x->object_count == y->object_count && x->reference_count == y->reference_count);
+        USAA_TEST_CHECK(x->error == y->error);
+    }
+    if (a->object_count == b->object_count)
+        USAA_TEST_CHECK(!memcmp(a->objects, b->objects, a->object_count * sizeof(usaa_index_object_t)));
+    if (a->reference_count == b->reference_count)
+        USAA_TEST_CHECK(!memcmp(a->references, b->references, a->reference_count * sizeof(usaa_index_reference_t)));
+}
+
+/* Copy an index file with another version in its header, which follows the
+ * 8 octets of the magic.
+ */
+static void usaa_test_copy_version_(const char *from, const char *to, uint32_t version)
+{
+    char buffer[65536];
+    size_t size;
+    FILE *file;
+
+    file = fopen(from, "rb");
+    USAA_TEST_REQUIRE(file);
+    size = fread(buffer, 1, sizeof(buffer), file);
+    fclose(file);
+    USAA_TEST_REQUIRE(size > 12 && size < sizeof(buffer));
+
+    memcpy(buffer + 8, &version, sizeof(version));
+    file = fopen(to, "wb");
+    USAA_TEST_REQUIRE(file);
+    USAA_TEST_REQUIRE(fwrite(buffer, 1, size, file) == size);
+    fclose(file);
+}
+
+int main(int argc, char *argv[])
+{
+    char copy[4096];
+    char path[4096];
+    const usaa_index_file_t *file;
+    usaa_project_t project;
+    usaa_index_t fresh;
+    usaa_index_t loaded;
+    usaa_index_t rebuilt;
+    usaa_scan_t scan;
+
+    USAA_TEST_REQUIRE(argc == 3);
+    snprintf(path, sizeof(path), "%s/usaa_index_test.idx", argv[2]);
+    USAA_TEST_REQUIRE(!usaa_project_open(&project, argv[1], 2));
+    USAA_TEST_REQUIRE(!usaa_scan_init(&scan, &project, 2));
+
+    /* A cold scan parses every file, all the fixtures are YAML assets. */
+    memset(&fresh, 0, sizeof(usaa_index_t));
+    USAA_TEST_REQUIRE(!usaa_index_update(&fresh, &scan));
+    USAA_TEST_CHECK(fresh.count == project.count);
+    USAA_TEST_CHECK(fresh.parsed == project.count && fresh.reused == 0 && fresh.changed);
+    file = usaa_index_find(&fresh, "Assets/Inner.prefab", 19);
+    USAA_TEST_REQUIRE(file);
+    USAA_TEST_CHECK(file->object_count == 4 && !file->error);
+    USAA_TEST_CHECK(file->objects + 1 < fresh.object_count
+        && fresh.objects[file->objects + 1].file_id == INT64_C(-8679921383154817045));
+    USAA_TEST_CHECK(!usaa_index_find(&fresh, "Assets/Inner", 12));
+
+    /* What is saved loads back the same. */
+    USAA_TEST_REQUIRE(!usaa_index_save(&fresh, path));
+    USAA_TEST_REQUIRE(!usaa_index_load(&loaded, path));
+    usaa_test_same_(&fresh, &loaded);
+
+    /* A warm rescan takes every file from the index and leaves it as it is. */
+    USAA_TEST_REQUIRE(!usaa_index_update(&loaded, &scan));
+    USAA_TEST_CHECK(loaded.reused == project.count && loaded.parsed == 0 && !loaded.changed);
+    usaa_test_same_(&fresh, &loaded);
+
+    /* So does a rebuild next to it. */
+    USAA_TEST_REQUIRE(!usaa_index_rebuild(&rebuilt, &loaded, &scan));
+    USAA_TEST_CHECK(rebuilt.reused == project.count && rebuilt.parsed == 0);
+    usaa_test_same_(&fresh, &rebuilt);
+
+    /* The same index under another version is refused, under its own it loads. */
+    snprintf(copy, sizeof(copy), "%s/usaa_index_test_version.idx", argv[2]);
+    usaa_index_destroy(&loaded);
+    usaa_test_copy_version_(path, copy, USAA_INDEX_VERSION + 1);
+    USAA_TEST_CHECK(usaa_index_load(&loaded, copy) == USAA_EFORMAT);
+    USAA_TEST_CHECK(loaded.count == 0);
+    usaa_test_copy_version_(path, copy, USAA_INDEX_VERSION);
+    USAA_TEST_CHECK(!usaa_index_load(&loaded, copy));
+    usaa_test_same_(&fresh, &loaded);
+    usaa_index_destroy(&loaded);
+
+    /* So is a file that is no index at all. */
+    snprintf(path, sizeof(path), "%s/Assets/Inner.prefab", argv[1]);
+    USAA_TEST_CHECK(usaa_index_load(&loaded, path) == USAA_EFORMAT);
+    USAA_TEST_CHECK(loaded.count == 0);
+
+    usaa_index_destroy(&rebuilt);
+    usaa_index_destroy(&loaded);
+    usaa_index_destroy(&fresh);
+    usaa_scan_destroy(&scan);
+    usaa_project_destroy(&project);
+    return USAA_TEST_RESULT();
+}
@@ -0,0 +1,114 @@
+/* The prefabs of tests/fixtures: Outer instances Inner with overrides and a
+ * removed component, Self instances itself, Holder instances Self, and Ping
+ * and Pong instance each other.
+ */
+
+#include "usaa_test.h"
+
+#define USAA_TEST_INNER     "11111111111111111111111111111111"
+#define USAA_TEST_OUTER     "22222222222222222222222222222222"
+#define USAA_TEST_SELF      "33333333333333333333333333333333"
+#define USAA_TEST_HOLDER    "44444444444444444444444444444444"
+#define USAA_TEST_PING      "66666666666666666666666666666666"
+#define USAA_TEST_PONG      "77777777777777777777777777777777"
+
+/* The fileIDs of Inner. */
+#define USAA_TEST_GAME_OBJECT   INT64_C(1000)
+#define USAA_TEST_TRANSFORM     INT64_C(-8679921383154817045)
+#define USAA_TEST_COLLIDER      INT64_C(1002)
+#define USAA_TEST_BEHAVIOUR     INT64_C(1003)
+
+/* The PrefabInstance of Outer. */
+#define USAA_TEST_INSTANCE      INT64_C(5000)
+
+/* The fileID of an object an instance brings in.
+ */
+static int64_t usaa_test_file_id_(int64_t instance, int64_t source)
+{
+    return (int64_t)(((uint64_t)instance ^ (uint64_t)source) & INT64_MAX);
+}
+
+static const usaa_resolved_t *usaa_test_get_(usaa_prefab_cache_t *cache, const char *text, int expected)
+{
+    const usaa_resolved_t *resolved = NULL;
+    usaa_guid_t guid;
+
+    USAA_TEST_REQUIRE(!usaa_guid_parse(&guid, text, strlen(text)));
+    USAA_TEST_CHECK(usaa_prefab_cache_get(cache, &guid, &resolved) == expected);
+    USAA_TEST_CHECK(!expected == !!resolved);
+    return resolved;
+}
+
+static int usaa_test_value_is_(const usaa_modification_t *modification, const char *value)
+{
+    return modification && modification->value_length == strlen(value)
+        && !memcmp(modification->value, value, modification->value_length);
+}
+
+int main(int argc, char *argv[])
+{
+    const usaa_resolved_t *outer;
+    const usaa_resolved_t *holder;
+    const usaa_resolved_object_t *object;
+    usaa_prefab_cache_t *cache;
+    usaa_project_t project;
+
+    USAA_TEST_REQUIRE(argc == 2);
+    USAA_TEST_REQUIRE(!usaa_project_open(&project, argv[1], 1));
+    USAA_TEST_REQUIRE(!usaa_prefab_cache_create(&cache, &project));
+
+    outer = usaa_test_get_(cache, USAA_TEST_OUTER, USAA_EOK);
+    USAA_TEST_REQUIRE(outer);
+    USAA_TEST_CHECK(outer->instances == 1 && outer->missing == 0);
+
+    /* The instance itself, then the objects of Inner but the removed BoxCollider. */
+    USAA_TEST_CHECK(outer->count == 4);
+    USAA_TEST_CHECK(usaa_resolved_find(outer, USAA_TEST_INSTANCE) != NULL);
+    USAA_TEST_CHECK(!usaa_resolved_find(outer, usaa_test_file_id_(USAA_TEST_INSTANCE, USAA_TEST_COLLIDER)));
+
+    /* The fileIDs are the XOR of the instance and source ones, kept positive. */
+    object = usaa_resolved_find(outer, usaa_test_file_id_(USAA_TEST_INSTANCE, USAA_TEST_TRANSFORM));
+    USAA_TEST_REQUIRE(object);
+    USAA_TEST_CHECK(object->file_id >= 0);
+    USAA_TEST_CHECK(object->file_id == (int64_t)(((uint64_t)USAA_TEST_INSTANCE ^ (uint64_t)USAA_TEST_TRANSFORM) & INT64_MAX));
+    USAA_TEST_CHECK(object->class_id == USAA_TRANSFORM && object->instance == USAA_TEST_INSTANCE);
+    USAA_TEST_CHECK(object->modification_count == 0);
+
+    /* The overrides land on their targets, the last one of a property wins. */
+    object = usaa_resolved_find(outer, usaa_test_file_id_(USAA_TEST_INSTANCE, USAA_TEST_GAME_OBJECT));
+    USAA_TEST_REQUIRE(object);
+    USAA_TEST_CHECK(object->class_id == USAA_GAME_OBJECT);
+    USAA_TEST_CHECK(usaa_test_value_is_(usaa_resolved_override(outer, object, "m_Name", 6), "Renamed"));
+    USAA_TEST_CHECK(!usaa_resolved_override(outer, object, "m_Speed", 7));
+
+    object = usaa_resolved_find(outer, usaa_test_file_id_(USAA_TEST_INSTANCE, USAA_TEST_BEHAVIOUR));
+    USAA_TEST_REQUIRE(object);
+    USAA_TEST_CHECK(object->modification_count == 2);
+    USAA_TEST_CHECK(usaa_test_value_is_(usaa_resolved_override(outer, object, "m_Speed", 7), "3"));
+
+    /* A prefab nesting itself fails, one holding it only misses it. */
+    usaa_test_get_(cache, USAA_TEST_SELF, USAA_EFORMAT);
+    holder = usaa_test_get_(cache, USAA_TEST_HOLDER, USAA_EOK);
+    USAA_TEST_REQUIRE(holder);
+    USAA_TEST_CHECK(holder->instances == 1 && holder->missing == 1);
+    USAA_TEST_CHECK(holder->count == 2);
+
+    /* Both prefabs of a longer cycle nest themselves. */
+    usaa_test_get_(cache, USAA_TEST_PING, USAA_EFORMAT);
+    usaa_test_get_(cache, USAA_TEST_PONG, USAA_EFORMAT);
+
+    /* Inner was resolved once, for Outer. */
+    USAA_TEST_CHECK(usaa_test_get_(cache, USAA_TEST_INNER, USAA_EOK)->count == 4);
+
+    usaa_prefab_cache_destroy(cache);
+
+    /* The same when Holder comes first and Self is met while resolving it. */
+    USAA_TEST_REQUIRE(!usaa_prefab_cache_create(&cache, &project));
+    holder = usaa_test_get_(cache, USAA_TEST_HOLDER, USAA_EOK);
+    USAA_TEST_CHECK(holder && holder->missing == 1);
+    usaa_test_get_(cache, USAA_TEST_SELF, USAA_EFORMAT);
+    usaa_prefab_cache_destroy(cache);
+
+    usaa_project_destroy(&project);
+    return USAA_TEST_RESULT();
+}
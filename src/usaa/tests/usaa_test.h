@@ -0,0 +1,36 @@
+#ifndef BE_USAA_TEST_H_
+#define BE_USAA_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "usaa.h"
+
+/** The checks failed so far, the exit status of a test.
+ */
+static int usaa_test_failures_;
+
+/** Report a check that does not hold and go on.
+ */
+#define USAA_TEST_CHECK(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        usaa_test_failures_++; \
+    } \
+} while (0)
+
+/** Stop a test that cannot go on.
+ */
+#define USAA_TEST_REQUIRE(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: requirement failed: %s\n", __FILE__, __LINE__, #condition); \
+        exit(EXIT_FAILURE); \
+    } \
+} while (0)
+
+/** The exit status of a test.
+ */
+#define USAA_TEST_RESULT() (usaa_test_failures_ ? EXIT_FAILURE : EXIT_SUCCESS)
+
+#endif /* !BE_USAA_TEST_H_ */
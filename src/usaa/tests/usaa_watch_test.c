@@ -0,0 +1,155 @@
+/* A watched project of its own, in the build directory: a refresh picks up
+ * a new prefab, and closing saves the index even when the last refresh
+ * changed nothing, but leaves an index it did not change alone.
+ */
+
+#if !defined(_POSIX_C_SOURCE)
+# define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "usaa_test.h"
+
+#define USAA_TEST_PREFAB \
+    "%YAML 1.1\n" \
+    "%TAG !u! tag:unity3d.com,2011:\n" \
+    "--- !u!1 &1000\n" \
+    "GameObject:\n" \
+    "  m_Name: Test\n"
+
+static void usaa_test_write_(const char *root, const char *name, const char *text)
+{
+    char path[4096];
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    file = fopen(path, "wb");
+    USAA_TEST_REQUIRE(file);
+    USAA_TEST_REQUIRE(fputs(text, file) >= 0);
+    fclose(file);
+}
+
+/* A prefab and then its .meta, the file a refresh waits for.
+ */
+static void usaa_test_prefab_(const char *root, const char *name, const char *guid)
+{
+    char path[256];
+    char meta[256];
+
+    snprintf(path, sizeof(path), "Assets/%s.prefab", name);
+    usaa_test_write_(root, path, USAA_TEST_PREFAB);
+    snprintf(path, sizeof(path), "Assets/%s.prefab.meta", name);
+    snprintf(meta, sizeof(meta), "fileFormatVersion: 2\nguid: %s\nPrefabImporter:\n  userData: \n", guid);
+    usaa_test_write_(root, path, meta);
+}
+
+static void usaa_test_remove_(const char *root, const char *name)
+{
+    char path[4096];
+
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    remove(path);
+}
+
+static void *usaa_test_run_(void *data)
+{
+    USAA_TEST_CHECK(usaa_watch_run((usaa_watch_t *)data, NULL, NULL) == USAA_EOK);
+    return NULL;
+}
+
+/* Wait for the refresh of a generation, and tell how many files its index has.
+ */
+static size_t usaa_test_wait_(usaa_watch_t *watch, uint64_t generation, int *changed)
+{
+    int tries;
+
+    for (tries = 0; tries < 1000; tries++) {
+        struct timespec pause = { 0, 10000000 };
+        const usaa_snapshot_t *snapshot;
+        int ticket;
+
+        snapshot = usaa_watch_acquire(watch, &ticket);
+        if (snapshot->generation >= generation) {
+            size_t count = snapshot->index.count;
+
+            *changed = snapshot->index.changed;
+            usaa_watch_release(watch, ticket);
+            return count;
+        }
+        usaa_watch_release(watch, ticket);
+        nanosleep(&pause, NULL);
+    }
+    USAA_TEST_REQUIRE(!"the refresh came in time");
+    return 0;
+}
+
+static ino_t usaa_test_inode_(const char *path)
+{
+    struct stat status;
+
+    USAA_TEST_REQUIRE(!stat(path, &status));
+    return status.st_ino;
+}
+
+int main(int argc, char *argv[])
+{
+    char root[2048];
+    char path[4096];
+    char index_path[4096];
+    usaa_watch_t *watch;
+    usaa_index_t index;
+    pthread_t thread;
+    ino_t inode;
+    int changed;
+
+    USAA_TEST_REQUIRE(argc == 2);
+    snprintf(root, sizeof(root), "%s/usaa_watch_XXXXXX", argv[1]);
+    USAA_TEST_REQUIRE(mkdtemp(root));
+    snprintf(path, sizeof(path), "%s/Assets", root);
+    USAA_TEST_REQUIRE(!mkdir(path, 0755));
+    snprintf(index_path, sizeof(index_path), "%s/project.idx", root);
+    usaa_test_prefab_(root, "First", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+    USAA_TEST_REQUIRE(!usaa_watch_open(&watch, root, index_path, 2, 20));
+    USAA_TEST_CHECK(usaa_test_wait_(watch, 0, &changed) == 1 && changed);
+    USAA_TEST_REQUIRE(!pthread_create(&thread, NULL, usaa_test_run_, watch));
+
+    /* A new prefab is refreshed into the index. */
+    usaa_test_prefab_(root, "Second", "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+    USAA_TEST_CHECK(usaa_test_wait_(watch, 1, &changed) == 2 && changed);
+
+    /* A directory without assets refreshes the index into the same one. */
+    snprintf(path, sizeof(path), "%s/Assets/Empty", root);
+    USAA_TEST_REQUIRE(!mkdir(path, 0755));
+    USAA_TEST_CHECK(usaa_test_wait_(watch, 2, &changed) == 2 && !changed);
+
+    /* Closing still saves the prefab of the refresh before. */
+    usaa_watch_stop(watch);
+    USAA_TEST_REQUIRE(!pthread_join(thread, NULL));
+    usaa_watch_close(watch);
+    USAA_TEST_REQUIRE(!usaa_index_load(&index, index_path));
+    USAA_TEST_CHECK(index.count == 2);
+    USAA_TEST_CHECK(usaa_index_find(&index, "Assets/Second.prefab", 20) != NULL);
+    usaa_index_destroy(&index);
+
+    /* An index that comes back the same is not written again. */
+    inode = usaa_test_inode_(index_path);
+    USAA_TEST_REQUIRE(!usaa_watch_open(&watch, root, index_path, 2, 20));
+    USAA_TEST_CHECK(usaa_test_wait_(watch, 0, &changed) == 2 && !changed);
+    usaa_watch_close(watch);
+    USAA_TEST_CHECK(usaa_test_inode_(index_path) == inode);
+
+    usaa_test_remove_(root, "Assets/First.prefab");
+    usaa_test_remove_(root, "Assets/First.prefab.meta");
+    usaa_test_remove_(root, "Assets/Second.prefab");
+    usaa_test_remove_(root, "Assets/Second.prefab.meta");
+    usaa_test_remove_(root, "Assets/Empty");
+    usaa_test_remove_(root, "Assets");
+    usaa_test_remove_(root, "project.idx");
+    rmdir(root);
+    return USAA_TEST_RESULT();
+}
@@ -0,0 +1,184 @@
+/* Scan the YAML files of a Unity project and report the throughput.
+ *
+ *     usaa_scan [-j threads] [-i index] [-v] [-u] <project>
+ */
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(_POSIX_C_SOURCE)
+# define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+#include "usaa.h"
+
+/* A monotonic clock, which a change of the wall clock does not disturb.
+ */
+static double usaa_scan_now_(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+static void usaa_scan_usage_(const char *program)
+{
+    fprintf(stderr, "usage: %s [-j threads] [-i index] [-v] [-u] <project>\n"
+        "  -j threads  the threads to use, all processors by default\n"
+        "  -i index    only scan the files changed since the index was saved, then update it\n"
+        "  -v          list the files, the largest first\n"
+        "  -u          list the assets no build includes, the largest first\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *root = NULL;
+    const char *saved = NULL;
+    usaa_project_t project;
+    usaa_scan_t scan;
+    usaa_graph_t graph;
+    usaa_index_t index;
+    double start;
+    double indexed;
+    double sized;
+    double scanned;
+    int threads = 0;
+    int verbose = 0;
+    int unused = 0;
+    int error;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc) {
+            saved = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-v")) {
+            verbose = 1;
+        }
+        else if (!strcmp(argv[i], "-u")) {
+            unused = 1;
+        }
+        else if (argv[i][0] != '-' && !root) {
+            root = argv[i];
+        }
+        else {
+            usaa_scan_usage_(argv[0]);
+            return 2;
+        }
+    }
+    if (!root) {
+        usaa_scan_usage_(argv[0]);
+        return 2;
+    }
+
+    start = usaa_scan_now_();
+    error = usaa_project_open(&project, root, threads);
+    if (error) {
+        fprintf(stderr, "%s: cannot index the project (%d)\n", root, error);
+        return 1;
+    }
+    indexed = usaa_scan_now_();
+
+    error = usaa_scan_init(&scan, &project, threads);
+    sized = usaa_scan_now_();
+    memset(&index, 0, sizeof(usaa_index_t));
+    if (!error && saved) {
+        /* A missing or outdated index is rebuilt from scratch. */
+        usaa_index_load(&index, saved);
+        error = usaa_index_update(&index, &scan);
+        if (!error && index.changed && usaa_index_save(&index, saved))
+            fprintf(stderr, "%s: cannot save the index\n", saved);
+        if (!error && unused)
+            error = usaa_graph_build_index(&graph, &project, &index);
+    }
+    else if (!error && unused) {
+        error = usaa_graph_build(&graph, &scan);
+    }
+    else if (!error) {
+        error = usaa_scan_run(&scan, NULL, NULL);
+    }
+    scanned = usaa_scan_now_();
+    if (error) {
+        fprintf(stderr, "%s: cannot scan the project (%d)\n", root, error);
+        usaa_index_destroy(&index);
+        usaa_scan_destroy(&scan);
+        usaa_project_destroy(&project);
+        return 1;
+    }
+
+    if (verbose) {
+        for (i = 0; i < (int)scan.count; i++) {
+            const usaa_scan_file_t *file = scan.files + i;
+
+            printf("%12llu %8lu %3d %s\n", (unsigned long long)file->size,
+                (unsigned long)file->objects, file->error, file->asset->path);
+        }
+    }
+
+    printf("threads  %d\n", scan.threads);
+    printf("assets   %lu (%lu duplicate GUIDs) in %.3f s\n",
+        (unsigned long)project.count, (unsigned long)project.duplicates, indexed - start);
+    printf("sized    %lu files in %.3f s\n", (unsigned long)scan.count, sized - indexed);
+    printf("scanned  %lu files, %llu objects, %.1f MB, %lu failed in %.3f s\n",
+        (unsigned long)(scan.count - scan.failed - scan.skipped), (unsigned long long)scan.objects,
+        (double)scan.bytes / 1e6, (unsigned long)scan.failed, scanned - sized);
+    if (saved) {
+        printf("index    %lu files kept, %lu parsed, %lu objects, %lu references\n",
+            (unsigned long)index.reused, (unsigned long)index.parsed,
+            (unsigned long)index.object_count, (unsigned long)index.reference_count);
+    }
+    if (scanned > sized) {
+        printf("rate     %.0f files/s, %.1f MB/s\n",
+            (double)(scan.count - scan.failed - scan.skipped) / (scanned - sized),
+            (double)scan.bytes / 1e6 / (scanned - sized));
+    }
+
+    if (unused) {
+        usaa_unused_t report;
+        double found;
+
+        error = usaa_unused_find(&report, &graph, threads);
+        found = usaa_scan_now_();
+        if (error) {
+            fprintf(stderr, "%s: cannot find the unused assets (%d)\n", root, error);
+        }
+        else {
+            for (i = 0; i < (int)report.count; i++) {
+                printf("%12llu %s\n", (unsigned long long)report.assets[i].size,
+                    report.assets[i].asset->path);
+            }
+            printf("graph    %lu nodes, %lu edges\n", (unsigned long)graph.count, (unsigned long)graph.edges);
+            printf("roots    %lu scenes, %lu in Resources, %lu in AssetBundles\n",
+                (unsigned long)report.scenes, (unsigned long)report.resources, (unsigned long)report.bundles);
+            printf("unused   %lu assets, %.1f MB, %lu reached in %.3f s\n", (unsigned long)report.count,
+                (double)report.bytes / 1e6, (unsigned long)report.reached, found - scanned);
+            usaa_unused_destroy(&report);
+        }
+        usaa_graph_destroy(&graph);
+    }
+
+    usaa_index_destroy(&index);
+    usaa_scan_destroy(&scan);
+    usaa_project_destroy(&project);
+    return error ? 1 : 0;
+}
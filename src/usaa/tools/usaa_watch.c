@@ -0,0 +1,294 @@
+/* Keep the analysis of a Unity project live and answer queries about it on
+ * a Unix socket, one request per line, each answer ending with an empty line.
+ *
+ *     usaa_watch [-j threads] [-d debounce] [-i index] <project> <socket>
+ *
+ *     stats                   the sizes of the current snapshot
+ *     objects <asset>         the objects of a scanned file
+ *     deps <asset>            the assets an asset pulls in, directly or not
+ *     users <asset>           the assets referencing an asset directly
+ *     reaches <asset> <asset> if the first asset pulls the second one in
+ *
+ * Assets are given by path from the project root or by GUID.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "usaa.h"
+
+static usaa_watch_t *usaa_watch_;
+static int usaa_listener_ = -1;
+
+/* The connected clients, shut down on exit so that no snapshot is held
+ * anymore when the watch closes.
+ */
+static pthread_mutex_t usaa_clients_lock_ = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t usaa_clients_gone_ = PTHREAD_COND_INITIALIZER;
+static int usaa_clients_[64];
+static int usaa_client_count_;
+
+static void usaa_watch_signal_(int number)
+{
+    (void)number;
+    usaa_watch_stop(usaa_watch_);
+    shutdown(usaa_listener_, SHUT_RDWR);
+}
+
+/* Find the node of an asset given by path or GUID.
+ */
+static uint32_t usaa_watch_node_(const usaa_snapshot_t *snapshot, const char *name)
+{
+    const usaa_asset_t *asset;
+    usaa_guid_t guid;
+
+    if (!usaa_guid_parse(&guid, name, strlen(name)))
+        return usaa_graph_find(&snapshot->graph, &guid);
+    asset = usaa_project_find_path(&snapshot->project, name, strlen(name));
+    return asset ? (uint32_t)(asset - snapshot->project.assets) : USAA_GRAPH_NONE;
+}
+
+/* Write a node as its GUID and path, if it is an asset of the project.
+ */
+static void usaa_watch_print_node_(FILE *out, const usaa_snapshot_t *snapshot, uint32_t node)
+{
+    char text[33];
+
+    usaa_guid_format(&snapshot->graph.guids[node], text);
+    fprintf(out, "%s %s\n", text, node < snapshot->project.count ? snapshot->project.assets[node].path : "-");
+}
+
+static void usaa_watch_answer_(FILE *out, const usaa_snapshot_t *snapshot, char *line)
+{
+    char *command = strtok(line, " \t\r\n");
+    char *first = strtok(NULL, " \t\r\n");
+    char *second = strtok(NULL, " \t\r\n");
+    uint32_t node = USAA_GRAPH_NONE;
+    uint32_t *nodes;
+    size_t count;
+    size_t i;
+
+    if (!command) {
+        fprintf(out, "error empty request\n");
+        return;
+    }
+    if (!strcmp(command, "stats")) {
+        fprintf(out, "generation %llu\nassets %lu\nfiles %lu\nobjects %lu\nreferences %lu\nnodes %lu\nedges %lu\n",
+            (unsigned long long)snapshot->generation, (unsigned long)snapshot->project.count,
+            (unsigned long)snapshot->index.count, (unsigned long)snapshot->index.object_count,
+            (unsigned long)snapshot->index.reference_count, (unsigned long)snapshot->graph.count,
+            (unsigned long)snapshot->graph.edges);
+        return;
+    }
+
+    if (first)
+        node = usaa_watch_node_(snapshot, first);
+    if (node == USAA_GRAPH_NONE) {
+        fprintf(out, "error unknown asset\n");
+        return;
+    }
+
+    if (!strcmp(command, "objects") && node < snapshot->project.count) {
+        const usaa_asset_t *asset = snapshot->project.assets + node;
+        const usaa_index_file_t *file = usaa_index_find(&snapshot->index, asset->path, strlen(asset->path));
+
+        if (!file) {
+            fprintf(out, "error not scanned\n");
+            return;
+        }
+        for (i = file->objects; i < file->objects + file->object_count; i++) {
+            const usaa_index_object_t *object = snapshot->index.objects + i;
+            const char *name = usaa_class_name(object->class_id);
+
+            fprintf(out, "%lld %d %s%s\n", (long long)object->file_id, object->class_id,
+                name ? name : "?", object->stripped ? " stripped" : "");
+        }
+    }
+    else if (!strcmp(command, "deps")) {
+        if (usaa_graph_closure(&snapshot->graph, &node, 1, USAA_GRAPH_FORWARD, &nodes, &count)) {
+            fprintf(out, "error out of memory\n");
+            return;
+        }
+        for (i = 1; i < count; i++)
+            usaa_watch_print_node_(out, snapshot, nodes[i]);
+        free(nodes);
+    }
+    else if (!strcmp(command, "users")) {
+        const uint32_t *users = USAA_GRAPH_TARGETS(&snapshot->graph, USAA_GRAPH_REVERSE, node);
+
+        count = USAA_GRAPH_DEGREE(&snapshot->graph, USAA_GRAPH_REVERSE, node);
+        for (i = 0; i < count; i++)
+            usaa_watch_print_node_(out, snapshot, users[i]);
+    }
+    else if (!strcmp(command, "reaches") && second) {
+        uint32_t target = usaa_watch_node_(snapshot, second);
+
+        fprintf(out, "%s\n", target != USAA_GRAPH_NONE
+            && usaa_graph_reaches(&snapshot->graph, node, target) == 1 ? "yes" : "no");
+    }
+    else {
+        fprintf(out, "error unknown request\n");
+    }
+}
+
+static void *usaa_watch_serve_(void *data)
+{
+    int client = (int)(intptr_t)data;
+    FILE *in = fdopen(client, "r");
+    FILE *out = fdopen(dup(client), "w");
+    char line[4096];
+    int i;
+
+    while (in && out && fgets(line, sizeof(line), in)) {
+        int ticket;
+        const usaa_snapshot_t *snapshot = usaa_watch_acquire(usaa_watch_, &ticket);
+
+        usaa_watch_answer_(out, snapshot, line);
+        usaa_watch_release(usaa_watch_, ticket);
+        fputc('\n', out);
+        if (fflush(out))
+            break;
+    }
+
+    pthread_mutex_lock(&usaa_clients_lock_);
+    for (i = 0; usaa_clients_[i] != client; i++)
+        ;
+    usaa_clients_[i] = usaa_clients_[--usaa_client_count_];
+    if (!usaa_client_count_)
+        pthread_cond_signal(&usaa_clients_gone_);
+    pthread_mutex_unlock(&usaa_clients_lock_);
+
+    if (out)
+        fclose(out);
+    if (in)
+        fclose(in);
+    else
+        close(client);
+    return NULL;
+}
+
+static void usaa_watch_report_(void *data, int error)
+{
+    (void)data;
+    fprintf(stderr, "usaa_watch: a refresh failed (%d), the snapshot before it is kept\n", error);
+}
+
+static void *usaa_watch_refresh_(void *data)
+{
+    if (usaa_watch_run((usaa_watch_t *)data, usaa_watch_report_, NULL))
+        fprintf(stderr, "usaa_watch: cannot wait for changes anymore\n");
+    return NULL;
+}
+
+static void usaa_watch_usage_(const char *program)
+{
+    fprintf(stderr, "usage: %s [-j threads] [-d debounce] [-i index] <project> <socket>\n"
+        "  -j threads   the threads to scan with, all processors by default\n"
+        "  -d debounce  the milliseconds without change before a refresh, 200 by default\n"
+        "  -i index     the index to start from and save on exit\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *root = NULL;
+    const char *socket_path = NULL;
+    const char *index_path = NULL;
+    struct sockaddr_un address;
+    struct sigaction action;
+    pthread_t refresher;
+    int threads = 0;
+    int debounce = 200;
+    int error;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-j") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            debounce = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            index_path = argv[++i];
+        else if (argv[i][0] != '-' && !root)
+            root = argv[i];
+        else if (argv[i][0] != '-' && !socket_path)
+            socket_path = argv[i];
+        else
+            break;
+    }
+    if (i < argc || !root || !socket_path || strlen(socket_path) >= sizeof(address.sun_path)) {
+        usaa_watch_usage_(argv[0]);
+        return 2;
+    }
+
+    error = usaa_watch_open(&usaa_watch_, root, index_path, threads, debounce);
+    if (error) {
+        fprintf(stderr, "%s: cannot watch the project (%d)\n", root, error);
+        return 1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+    unlink(socket_path);
+    usaa_listener_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (usaa_listener_ < 0 || bind(usaa_listener_, (struct sockaddr *)&address, sizeof(address))
+            || listen(usaa_listener_, 16)) {
+        fprintf(stderr, "%s: cannot listen (%s)\n", socket_path, strerror(errno));
+        usaa_watch_close(usaa_watch_);
+        return 1;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = usaa_watch_signal_;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (pthread_create(&refresher, NULL, usaa_watch_refresh_, usaa_watch_)) {
+        fprintf(stderr, "usaa_watch: cannot start the refresh thread\n");
+        usaa_watch_close(usaa_watch_);
+        return 1;
+    }
+
+    /* Each client gets a thread of its own, reading never waits for a refresh. */
+    for (;;) {
+        pthread_t server;
+        int client = accept(usaa_listener_, NULL, NULL);
+
+        if (client < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        pthread_mutex_lock(&usaa_clients_lock_);
+        if (usaa_client_count_ < (int)(sizeof(usaa_clients_) / sizeof(usaa_clients_[0]))
+                && !pthread_create(&server, NULL, usaa_watch_serve_, (void *)(intptr_t)client)) {
+            usaa_clients_[usaa_client_count_++] = client;
+            pthread_detach(server);
+        }
+        else
+            close(client);
+        pthread_mutex_unlock(&usaa_clients_lock_);
+    }
+
+    pthread_mutex_lock(&usaa_clients_lock_);
+    for (i = 0; i < usaa_client_count_; i++)
+        shutdown(usaa_clients_[i], SHUT_RDWR);
+    while (usaa_client_count_)
+        pthread_cond_wait(&usaa_clients_gone_, &usaa_clients_lock_);
+    pthread_mutex_unlock(&usaa_clients_lock_);
+
+    usaa_watch_stop(usaa_watch_);
+    pthread_join(refresher, NULL);
+    close(usaa_listener_);
+    unlink(socket_path);
+    usaa_watch_close(usaa_watch_);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "usaa_private.h"
+
+char *usaa_arena_strndup(usaa_arena_t **arena, const char *string, size_t length)
+{
+    usaa_arena_t *block = *arena;
+    char *copy;
+
+    if (!block || block->size - block->used < length + 1) {
+        size_t size = length + 1 > 65536 ? length + 1 : 65536;
+
+        block = (usaa_arena_t *)malloc(sizeof(usaa_arena_t) + size);
+        if (!block)
+            return NULL;
+        block->next = *arena;
+        block->used = 0;
+        block->size = size;
+        *arena = block;
+    }
+
+    copy = block->data + block->used;
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    block->used += length + 1;
+    return copy;
+}
+
+void usaa_arena_splice(usaa_arena_t **arena, usaa_arena_t **blocks)
+{
+    usaa_arena_t *last = *blocks;
+
+    if (!last)
+        return;
+    while (last->next)
+        last = last->next;
+    last->next = *arena;
+    *arena = *blocks;
+    *blocks = NULL;
+}
+
+void usaa_arena_destroy(usaa_arena_t **arena)
+{
+    while (*arena) {
+        usaa_arena_t *next = (*arena)->next;
+
+        free(*arena);
+        *arena = next;
+    }
+}
@@ -0,0 +1,308 @@
+#include "usaa_private.h"
+
+/* The slot of a class id in the packed table: the runtime ids run up to 290,
+ * the editor ones from 1001 follow right after them.
+ */
+#define USAA_CLASS_LAST_RUNTIME     USAA_ASSET_BUNDLE_MANIFEST
+#define USAA_CLASS_FIRST_EDITOR     MSAA_PREFAB
+#define USAA_CLASS_LAST_EDITOR      MSAA_LIGHTMAP_SNAPSHOT
+#define USAA_CLASS_SLOT(id) \
+    ((id) <= USAA_CLASS_LAST_RUNTIME ? (id) : (id) - USAA_CLASS_FIRST_EDITOR + USAA_CLASS_LAST_RUNTIME + 1)
+#define USAA_CLASS_SLOTS \
+    (USAA_CLASS_SLOT(USAA_CLASS_LAST_EDITOR) + 1)
+#define USAA_CLASS_ID(slot) \
+    ((slot) <= USAA_CLASS_LAST_RUNTIME ? (slot) : (slot) - USAA_CLASS_LAST_RUNTIME - 1 + USAA_CLASS_FIRST_EDITOR)
+
+/* The classes by slot, with the ids of usaa.h. Unused slots have no name.
+ * `enter` and `leave` number the hierarchy in a pre-order walk from Object,
+ * the children of a class in slot order; usaa_class_test checks them against
+ * the bases, so a class added here needs the classes after it renumbered.
+ */
+static const usaa_class_t usaa_classes_[USAA_CLASS_SLOTS] = {
+    [USAA_CLASS_SLOT(USAA_GAME_OBJECT)] = { "GameObject", USAA_EDITOR_EXTENSION, 0, 2, 3 },
+    [USAA_CLASS_SLOT(USAA_COMPONENT)] = { "Component", USAA_EDITOR_EXTENSION, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 3, 109 },
+    [USAA_CLASS_SLOT(USAA_LEVEL_GAME_MANAGER)] = { "LevelGameManager", USAA_GAME_MANAGER, USAA_CLASS_MANAGER | USAA_CLASS_ABSTRACT, 110, 116 },
+    [USAA_CLASS_SLOT(USAA_TRANSFORM)] = { "Transform", USAA_COMPONENT, USAA_CLASS_COMPONENT, 4, 6 },
+    [USAA_CLASS_SLOT(USAA_TIME_MANAGER)] = { "TimeManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 117, 118 },
+    [USAA_CLASS_SLOT(USAA_GLOBAL_GAME_MANAGER)] = { "GlobalGameManager", USAA_GAME_MANAGER, USAA_CLASS_MANAGER | USAA_CLASS_ABSTRACT, 116, 135 },
+    [USAA_CLASS_SLOT(USAA_BEHAVIOUR)] = { "Behaviour", USAA_COMPONENT, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 6, 61 },
+    [USAA_CLASS_SLOT(USAA_GAME_MANAGER)] = { "GameManager", USAA_EDITOR_EXTENSION, USAA_CLASS_MANAGER | USAA_CLASS_ABSTRACT, 109, 135 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_MANAGER)] = { "AudioManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 118, 119 },
+    [USAA_CLASS_SLOT(USAA_PARTICLE_ANIMATOR)] = { "ParticleAnimator", USAA_COMPONENT, USAA_CLASS_COMPONENT, 61, 62 },
+    [USAA_CLASS_SLOT(USAA_INPUT_MANAGER)] = { "InputManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 119, 120 },
+    [USAA_CLASS_SLOT(USAA_ELLIPSOID_PARTICLE_EMITTER)] = { "EllipsoidParticleEmitter", USAA_PARTICLE_EMITTER, USAA_CLASS_COMPONENT, 94, 95 },
+    [USAA_CLASS_SLOT(USAA_PIPELINE)] = { "Pipeline", USAA_COMPONENT, USAA_CLASS_COMPONENT, 62, 63 },
+    [USAA_CLASS_SLOT(USAA_EDITOR_EXTENSION)] = { "EditorExtension", 0, USAA_CLASS_ABSTRACT, 1, 235 },
+    [USAA_CLASS_SLOT(USAA_PHYSICS2D_SETTINGS)] = { "Physics2DSettings", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 120, 121 },
+    [USAA_CLASS_SLOT(USAA_CAMERA)] = { "Camera", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 7, 8 },
+    [USAA_CLASS_SLOT(USAA_MATERIAL)] = { "Material", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 136, 138 },
+    [USAA_CLASS_SLOT(USAA_MESH_RENDERER)] = { "MeshRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 64, 65 },
+    [USAA_CLASS_SLOT(USAA_RENDERER)] = { "Renderer", USAA_COMPONENT, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 63, 73 },
+    [USAA_CLASS_SLOT(USAA_PARTICLE_RENDERER)] = { "ParticleRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 65, 66 },
+    [USAA_CLASS_SLOT(USAA_TEXTURE)] = { "Texture", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_ABSTRACT, 138, 147 },
+    [USAA_CLASS_SLOT(USAA_TEXTURE2D)] = { "Texture2D", USAA_TEXTURE, USAA_CLASS_ASSET, 139, 142 },
+    [USAA_CLASS_SLOT(USAA_SCENE_SETTINGS)] = { "SceneSettings", USAA_LEVEL_GAME_MANAGER, USAA_CLASS_MANAGER, 111, 112 },
+    [USAA_CLASS_SLOT(USAA_GRAPHICS_SETTINGS)] = { "GraphicsSettings", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 121, 122 },
+    [USAA_CLASS_SLOT(USAA_MESH_FILTER)] = { "MeshFilter", USAA_COMPONENT, USAA_CLASS_COMPONENT, 73, 74 },
+    [USAA_CLASS_SLOT(USAA_OCCLUSION_PORTAL)] = { "OcclusionPortal", USAA_COMPONENT, USAA_CLASS_COMPONENT, 74, 75 },
+    [USAA_CLASS_SLOT(USAA_MESH)] = { "Mesh", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 147, 148 },
+    [USAA_CLASS_SLOT(USAA_SKYBOX)] = { "Skybox", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 8, 9 },
+    [USAA_CLASS_SLOT(USAA_QUALITY_SETTINGS)] = { "QualitySettings", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 122, 123 },
+    [USAA_CLASS_SLOT(USAA_SHADER)] = { "Shader", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 148, 149 },
+    [USAA_CLASS_SLOT(USAA_TEXT_ASSET)] = { "TextAsset", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 149, 152 },
+    [USAA_CLASS_SLOT(USAA_RIGIDBODY2D)] = { "Rigidbody2D", USAA_COMPONENT, USAA_CLASS_COMPONENT, 75, 76 },
+    [USAA_CLASS_SLOT(USAA_PHYSICS2D_MANAGER)] = { "Physics2DManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 123, 124 },
+    [USAA_CLASS_SLOT(USAA_COLLIDER2D)] = { "Collider2D", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 9, 15 },
+    [USAA_CLASS_SLOT(USAA_RIGIDBODY)] = { "Rigidbody", USAA_COMPONENT, USAA_CLASS_COMPONENT, 76, 77 },
+    [USAA_CLASS_SLOT(USAA_PHYSICS_MANAGER)] = { "PhysicsManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 124, 125 },
+    [USAA_CLASS_SLOT(USAA_COLLIDER)] = { "Collider", USAA_COMPONENT, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 77, 86 },
+    [USAA_CLASS_SLOT(USAA_JOINT)] = { "Joint", USAA_COMPONENT, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 86, 92 },
+    [USAA_CLASS_SLOT(USAA_CIRCLE_COLLIDER2D)] = { "CircleCollider2D", USAA_COLLIDER2D, USAA_CLASS_COMPONENT, 10, 11 },
+    [USAA_CLASS_SLOT(USAA_HINGE_JOINT)] = { "HingeJoint", USAA_JOINT, USAA_CLASS_COMPONENT, 87, 88 },
+    [USAA_CLASS_SLOT(USAA_POLYGON_COLLIDER2D)] = { "PolygonCollider2D", USAA_COLLIDER2D, USAA_CLASS_COMPONENT, 11, 12 },
+    [USAA_CLASS_SLOT(USAA_BOX_COLLIDER2D)] = { "BoxCollider2D", USAA_COLLIDER2D, USAA_CLASS_COMPONENT, 12, 13 },
+    [USAA_CLASS_SLOT(USAA_PHYSICS_MATERIAL2D)] = { "PhysicsMaterial2D", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 152, 153 },
+    [USAA_CLASS_SLOT(USAA_MESH_COLLIDER)] = { "MeshCollider", USAA_COLLIDER, USAA_CLASS_COMPONENT, 78, 79 },
+    [USAA_CLASS_SLOT(USAA_BOX_COLLIDER)] = { "BoxCollider", USAA_COLLIDER, USAA_CLASS_COMPONENT, 79, 80 },
+    [USAA_CLASS_SLOT(USAA_SPRITE_COLLIDER2D)] = { "SpriteCollider2D", USAA_COLLIDER2D, USAA_CLASS_COMPONENT, 13, 14 },
+    [USAA_CLASS_SLOT(USAA_EDGE_COLLIDER2D)] = { "EdgeCollider2D", USAA_COLLIDER2D, USAA_CLASS_COMPONENT, 14, 15 },
+    [USAA_CLASS_SLOT(USAA_COMPUTE_SHADER)] = { "ComputeShader", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 153, 154 },
+    [USAA_CLASS_SLOT(USAA_ANIMATION_CLIP)] = { "AnimationClip", USAA_MOTION, USAA_CLASS_ASSET, 171, 172 },
+    [USAA_CLASS_SLOT(USAA_CONSTANT_FORCE)] = { "ConstantForce", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 15, 16 },
+    [USAA_CLASS_SLOT(USAA_WORLD_PARTICLE_COLLIDER)] = { "WorldParticleCollider", USAA_COMPONENT, USAA_CLASS_COMPONENT, 92, 93 },
+    [USAA_CLASS_SLOT(USAA_TAG_MANAGER)] = { "TagManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 125, 126 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_LISTENER)] = { "AudioListener", USAA_AUDIO_BEHAVIOUR, USAA_CLASS_COMPONENT, 32, 33 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_SOURCE)] = { "AudioSource", USAA_AUDIO_BEHAVIOUR, USAA_CLASS_COMPONENT, 33, 34 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_CLIP)] = { "AudioClip", USAA_SAMPLE_CLIP, USAA_CLASS_ASSET, 183, 184 },
+    [USAA_CLASS_SLOT(USAA_RENDER_TEXTURE)] = { "RenderTexture", USAA_TEXTURE2D, USAA_CLASS_ASSET, 140, 141 },
+    [USAA_CLASS_SLOT(USAA_MESH_PARTICLE_EMITTER)] = { "MeshParticleEmitter", USAA_PARTICLE_EMITTER, USAA_CLASS_COMPONENT, 95, 96 },
+    [USAA_CLASS_SLOT(USAA_PARTICLE_EMITTER)] = { "ParticleEmitter", USAA_COMPONENT, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 93, 96 },
+    [USAA_CLASS_SLOT(USAA_CUBEMAP)] = { "Cubemap", USAA_TEXTURE2D, USAA_CLASS_ASSET, 141, 142 },
+    [USAA_CLASS_SLOT(USAA_AVATAR)] = { "Avatar", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 154, 155 },
+    [USAA_CLASS_SLOT(USAA_ANIMATOR_CONTROLLER)] = { "AnimatorController", USAA_RUNTIME_ANIMATOR_CONTROLLER, USAA_CLASS_ASSET, 156, 157 },
+    [USAA_CLASS_SLOT(USAA_GUI_LAYER)] = { "GUILayer", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 16, 17 },
+    [USAA_CLASS_SLOT(USAA_RUNTIME_ANIMATOR_CONTROLLER)] = { "RuntimeAnimatorController", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_ABSTRACT, 155, 158 },
+    [USAA_CLASS_SLOT(USAA_SCRIPT_MAPPER)] = { "ScriptMapper", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 126, 127 },
+    [USAA_CLASS_SLOT(USAA_ANIMATOR)] = { "Animator", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 17, 18 },
+    [USAA_CLASS_SLOT(USAA_TRAIL_RENDERER)] = { "TrailRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 66, 67 },
+    [USAA_CLASS_SLOT(USAA_DELAYED_CALL_MANAGER)] = { "DelayedCallManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 127, 128 },
+    [USAA_CLASS_SLOT(USAA_TEXT_MESH)] = { "TextMesh", USAA_COMPONENT, USAA_CLASS_COMPONENT, 96, 97 },
+    [USAA_CLASS_SLOT(USAA_RENDER_SETTINGS)] = { "RenderSettings", USAA_LEVEL_GAME_MANAGER, USAA_CLASS_MANAGER, 112, 113 },
+    [USAA_CLASS_SLOT(USAA_LIGHT)] = { "Light", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 18, 19 },
+    [USAA_CLASS_SLOT(USAA_CGPROGRAM)] = { "CGProgram", USAA_TEXT_ASSET, USAA_CLASS_ASSET, 150, 151 },
+    [USAA_CLASS_SLOT(USAA_BASE_ANIMATION_TRACK)] = { "BaseAnimationTrack", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_ABSTRACT, 158, 160 },
+    [USAA_CLASS_SLOT(USAA_ANIMATION)] = { "Animation", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 19, 20 },
+    [USAA_CLASS_SLOT(USAA_MONO_BEHAVIOUR)] = { "MonoBehaviour", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 20, 21 },
+    [USAA_CLASS_SLOT(USAA_MONO_SCRIPT)] = { "MonoScript", USAA_TEXT_ASSET, USAA_CLASS_ASSET, 151, 152 },
+    [USAA_CLASS_SLOT(USAA_MONO_MANAGER)] = { "MonoManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 128, 129 },
+    [USAA_CLASS_SLOT(USAA_TEXTURE3D)] = { "Texture3D", USAA_TEXTURE, USAA_CLASS_ASSET, 142, 143 },
+    [USAA_CLASS_SLOT(USAA_NEW_ANIMATION_TRACK)] = { "NewAnimationTrack", USAA_BASE_ANIMATION_TRACK, USAA_CLASS_ASSET, 159, 160 },
+    [USAA_CLASS_SLOT(USAA_PROJECTOR)] = { "Projector", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 21, 22 },
+    [USAA_CLASS_SLOT(USAA_LINE_RENDERER)] = { "LineRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 67, 68 },
+    [USAA_CLASS_SLOT(USAA_FLARE)] = { "Flare", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 160, 161 },
+    [USAA_CLASS_SLOT(USAA_HALO)] = { "Halo", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 22, 23 },
+    [USAA_CLASS_SLOT(USAA_LENS_FLARE)] = { "LensFlare", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 23, 24 },
+    [USAA_CLASS_SLOT(USAA_FLARE_LAYER)] = { "FlareLayer", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 24, 25 },
+    [USAA_CLASS_SLOT(USAA_HALO_LAYER)] = { "HaloLayer", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 25, 26 },
+    [USAA_CLASS_SLOT(USAA_NAV_MESH_AREAS)] = { "NavMeshAreas", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 129, 130 },
+    [USAA_CLASS_SLOT(USAA_HALO_MANAGER)] = { "HaloManager", USAA_LEVEL_GAME_MANAGER, USAA_CLASS_MANAGER, 113, 114 },
+    [USAA_CLASS_SLOT(USAA_FONT)] = { "Font", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 161, 162 },
+    [USAA_CLASS_SLOT(USAA_PLAYER_SETTINGS)] = { "PlayerSettings", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 130, 131 },
+    [USAA_CLASS_SLOT(USAA_NAMED_OBJECT)] = { "NamedObject", USAA_EDITOR_EXTENSION, USAA_CLASS_ASSET | USAA_CLASS_ABSTRACT, 135, 222 },
+    [USAA_CLASS_SLOT(USAA_GUI_TEXTURE)] = { "GUITexture", USAA_GUI_ELEMENT, USAA_CLASS_COMPONENT, 27, 28 },
+    [USAA_CLASS_SLOT(USAA_GUI_TEXT)] = { "GUIText", USAA_GUI_ELEMENT, USAA_CLASS_COMPONENT, 28, 29 },
+    [USAA_CLASS_SLOT(USAA_GUI_ELEMENT)] = { "GUIElement", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 26, 29 },
+    [USAA_CLASS_SLOT(USAA_PHYSIC_MATERIAL)] = { "PhysicMaterial", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 162, 163 },
+    [USAA_CLASS_SLOT(USAA_SPHERE_COLLIDER)] = { "SphereCollider", USAA_COLLIDER, USAA_CLASS_COMPONENT, 80, 81 },
+    [USAA_CLASS_SLOT(USAA_CAPSULE_COLLIDER)] = { "CapsuleCollider", USAA_COLLIDER, USAA_CLASS_COMPONENT, 81, 82 },
+    [USAA_CLASS_SLOT(USAA_SKINNED_MESH_RENDERER)] = { "SkinnedMeshRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 68, 69 },
+    [USAA_CLASS_SLOT(USAA_FIXED_JOINT)] = { "FixedJoint", USAA_JOINT, USAA_CLASS_COMPONENT, 88, 89 },
+    [USAA_CLASS_SLOT(USAA_RAYCAST_COLLIDER)] = { "RaycastCollider", USAA_COLLIDER, USAA_CLASS_COMPONENT, 82, 83 },
+    [USAA_CLASS_SLOT(USAA_BUILD_SETTINGS)] = { "BuildSettings", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 131, 132 },
+    [USAA_CLASS_SLOT(USAA_ASSET_BUNDLE)] = { "AssetBundle", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 163, 164 },
+    [USAA_CLASS_SLOT(USAA_CHARACTER_CONTROLLER)] = { "CharacterController", USAA_COLLIDER, USAA_CLASS_COMPONENT, 83, 84 },
+    [USAA_CLASS_SLOT(USAA_CHARACTER_JOINT)] = { "CharacterJoint", USAA_JOINT, USAA_CLASS_COMPONENT, 89, 90 },
+    [USAA_CLASS_SLOT(USAA_SPRING_JOINT)] = { "SpringJoint", USAA_JOINT, USAA_CLASS_COMPONENT, 90, 91 },
+    [USAA_CLASS_SLOT(USAA_WHEEL_COLLIDER)] = { "WheelCollider", USAA_COLLIDER, USAA_CLASS_COMPONENT, 84, 85 },
+    [USAA_CLASS_SLOT(USAA_RESOURCE_MANAGER)] = { "ResourceManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 132, 133 },
+    [USAA_CLASS_SLOT(USAA_NETWORK_VIEW)] = { "NetworkView", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 29, 30 },
+    [USAA_CLASS_SLOT(USAA_NETWORK_MANAGER)] = { "NetworkManager", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 133, 134 },
+    [USAA_CLASS_SLOT(USAA_PRELOAD_DATA)] = { "PreloadData", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 164, 165 },
+    [USAA_CLASS_SLOT(USAA_MOVIE_TEXTURE)] = { "MovieTexture", USAA_TEXTURE, USAA_CLASS_ASSET, 143, 144 },
+    [USAA_CLASS_SLOT(USAA_CONFIGURABLE_JOINT)] = { "ConfigurableJoint", USAA_JOINT, USAA_CLASS_COMPONENT, 91, 92 },
+    [USAA_CLASS_SLOT(USAA_TERRAIN_COLLIDER)] = { "TerrainCollider", USAA_COLLIDER, USAA_CLASS_COMPONENT, 85, 86 },
+    [USAA_CLASS_SLOT(USAA_MASTER_SERVER_INTERFACE)] = { "MasterServerInterface", USAA_GLOBAL_GAME_MANAGER, USAA_CLASS_MANAGER, 134, 135 },
+    [USAA_CLASS_SLOT(USAA_TERRAIN_DATA)] = { "TerrainData", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 165, 166 },
+    [USAA_CLASS_SLOT(USAA_LIGHTMAP_SETTINGS)] = { "LightmapSettings", USAA_LEVEL_GAME_MANAGER, USAA_CLASS_MANAGER, 114, 115 },
+    [USAA_CLASS_SLOT(USAA_WEBCAM_TEXTURE)] = { "WebCamTexture", USAA_TEXTURE, USAA_CLASS_ASSET, 144, 145 },
+    [USAA_CLASS_SLOT(USAA_EDITOR_SETTINGS)] = { "EditorSettings", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 222, 223 },
+    [USAA_CLASS_SLOT(USAA_INTERACTIVE_CLOTH)] = { "InteractiveCloth", USAA_COMPONENT, USAA_CLASS_COMPONENT, 97, 98 },
+    [USAA_CLASS_SLOT(USAA_CLOTH_RENDERER)] = { "ClothRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 69, 70 },
+    [USAA_CLASS_SLOT(USAA_EDITOR_USER_SETTINGS)] = { "EditorUserSettings", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 223, 224 },
+    [USAA_CLASS_SLOT(USAA_SKINNED_CLOTH)] = { "SkinnedCloth", USAA_COMPONENT, USAA_CLASS_COMPONENT, 98, 99 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_REVERB_FILTER)] = { "AudioReverbFilter", USAA_AUDIO_FILTER, USAA_CLASS_COMPONENT, 35, 36 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_HIGH_PASS_FILTER)] = { "AudioHighPassFilter", USAA_AUDIO_FILTER, USAA_CLASS_COMPONENT, 36, 37 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_CHORUS_FILTER)] = { "AudioChorusFilter", USAA_AUDIO_FILTER, USAA_CLASS_COMPONENT, 37, 38 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_REVERB_ZONE)] = { "AudioReverbZone", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 30, 31 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_ECHO_FILTER)] = { "AudioEchoFilter", USAA_AUDIO_FILTER, USAA_CLASS_COMPONENT, 38, 39 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_LOW_PASS_FILTER)] = { "AudioLowPassFilter", USAA_AUDIO_FILTER, USAA_CLASS_COMPONENT, 39, 40 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_DISTORTION_FILTER)] = { "AudioDistortionFilter", USAA_AUDIO_FILTER, USAA_CLASS_COMPONENT, 40, 41 },
+    [USAA_CLASS_SLOT(USAA_SPARSE_TEXTURE)] = { "SparseTexture", USAA_TEXTURE, USAA_CLASS_ASSET, 145, 146 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_BEHAVIOUR)] = { "AudioBehaviour", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 31, 34 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_FILTER)] = { "AudioFilter", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 34, 41 },
+    [USAA_CLASS_SLOT(USAA_WIND_ZONE)] = { "WindZone", USAA_COMPONENT, USAA_CLASS_COMPONENT, 99, 100 },
+    [USAA_CLASS_SLOT(USAA_CLOTH)] = { "Cloth", USAA_COMPONENT, USAA_CLASS_COMPONENT, 100, 101 },
+    [USAA_CLASS_SLOT(USAA_SUBSTANCE_ARCHIVE)] = { "SubstanceArchive", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 166, 167 },
+    [USAA_CLASS_SLOT(USAA_PROCEDURAL_MATERIAL)] = { "ProceduralMaterial", USAA_MATERIAL, USAA_CLASS_ASSET, 137, 138 },
+    [USAA_CLASS_SLOT(USAA_PROCEDURAL_TEXTURE)] = { "ProceduralTexture", USAA_TEXTURE, USAA_CLASS_ASSET, 146, 147 },
+    [USAA_CLASS_SLOT(USAA_OFF_MESH_LINK)] = { "OffMeshLink", USAA_COMPONENT, USAA_CLASS_COMPONENT, 101, 102 },
+    [USAA_CLASS_SLOT(USAA_OCCLUSION_AREA)] = { "OcclusionArea", USAA_COMPONENT, USAA_CLASS_COMPONENT, 102, 103 },
+    [USAA_CLASS_SLOT(USAA_TREE)] = { "Tree", USAA_COMPONENT, USAA_CLASS_COMPONENT, 103, 104 },
+    [USAA_CLASS_SLOT(USAA_NAV_MESH_OBSOLETE)] = { "NavMeshObsolete", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 167, 168 },
+    [USAA_CLASS_SLOT(USAA_NAV_MESH_AGENT)] = { "NavMeshAgent", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 41, 42 },
+    [USAA_CLASS_SLOT(USAA_NAV_MESH_SETTINGS)] = { "NavMeshSettings", USAA_LEVEL_GAME_MANAGER, USAA_CLASS_MANAGER, 115, 116 },
+    [USAA_CLASS_SLOT(USAA_LIGHT_PROBES_LEGACY)] = { "LightProbesLegacy", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 168, 169 },
+    [USAA_CLASS_SLOT(USAA_PARTICLE_SYSTEM)] = { "ParticleSystem", USAA_COMPONENT, USAA_CLASS_COMPONENT, 104, 105 },
+    [USAA_CLASS_SLOT(USAA_PARTICLE_SYSTEM_RENDERER)] = { "ParticleSystemRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 70, 71 },
+    [USAA_CLASS_SLOT(USAA_SHADER_VARIANT_COLLECTION)] = { "ShaderVariantCollection", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 169, 170 },
+    [USAA_CLASS_SLOT(USAA_LOD_GROUP)] = { "LODGroup", USAA_COMPONENT, USAA_CLASS_COMPONENT, 105, 106 },
+    [USAA_CLASS_SLOT(USAA_BLENDTREE)] = { "BlendTree", USAA_MOTION, USAA_CLASS_ASSET, 172, 173 },
+    [USAA_CLASS_SLOT(USAA_MOTION)] = { "Motion", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_ABSTRACT, 170, 173 },
+    [USAA_CLASS_SLOT(USAA_NAV_MESH_OBSTACLE)] = { "NavMeshObstacle", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 42, 43 },
+    [USAA_CLASS_SLOT(USAA_TERRAIN_INSTANCE)] = { "TerrainInstance", USAA_COMPONENT, USAA_CLASS_COMPONENT, 106, 107 },
+    [USAA_CLASS_SLOT(USAA_SPRITE_RENDERER)] = { "SpriteRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 71, 72 },
+    [USAA_CLASS_SLOT(USAA_SPRITE)] = { "Sprite", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 173, 174 },
+    [USAA_CLASS_SLOT(USAA_CACHED_SPRITE_ATLAS)] = { "CachedSpriteAtlas", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 174, 175 },
+    [USAA_CLASS_SLOT(USAA_REFLECTION_PROBE)] = { "ReflectionProbe", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 43, 44 },
+    [USAA_CLASS_SLOT(USAA_REFLECTION_PROBES)] = { "ReflectionProbes", USAA_COMPONENT, USAA_CLASS_COMPONENT, 107, 108 },
+    [USAA_CLASS_SLOT(USAA_LIGHT_PROBE_GROUP)] = { "LightProbeGroup", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 44, 45 },
+    [USAA_CLASS_SLOT(USAA_ANIMATOR_OVERRIDE_CONTROLLER)] = { "AnimatorOverrideController", USAA_RUNTIME_ANIMATOR_CONTROLLER, USAA_CLASS_ASSET, 157, 158 },
+    [USAA_CLASS_SLOT(USAA_CANVAS_RENDERER)] = { "CanvasRenderer", USAA_COMPONENT, USAA_CLASS_COMPONENT, 108, 109 },
+    [USAA_CLASS_SLOT(USAA_CANVAS)] = { "Canvas", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 45, 46 },
+    [USAA_CLASS_SLOT(USAA_RECT_TRANSFORM)] = { "RectTransform", USAA_TRANSFORM, USAA_CLASS_COMPONENT, 5, 6 },
+    [USAA_CLASS_SLOT(USAA_CANVAS_GROUP)] = { "CanvasGroup", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT, 46, 47 },
+    [USAA_CLASS_SLOT(USAA_BILLBOARD_ASSET)] = { "BillboardAsset", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 175, 176 },
+    [USAA_CLASS_SLOT(USAA_BILLBOARD_RENDERER)] = { "BillboardRenderer", USAA_RENDERER, USAA_CLASS_COMPONENT, 72, 73 },
+    [USAA_CLASS_SLOT(USAA_SPEEDTREE_WIND_ASSET)] = { "SpeedTreeWindAsset", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 176, 177 },
+    [USAA_CLASS_SLOT(USAA_ANCHORED_JOINT2D)] = { "AnchoredJoint2D", USAA_JOINT2D, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 48, 54 },
+    [USAA_CLASS_SLOT(USAA_JOINT2D)] = { "Joint2D", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 47, 54 },
+    [USAA_CLASS_SLOT(USAA_SPRING_JOINT2D)] = { "SpringJoint2D", USAA_ANCHORED_JOINT2D, USAA_CLASS_COMPONENT, 49, 50 },
+    [USAA_CLASS_SLOT(USAA_DISTANCE_JOINT2D)] = { "DistanceJoint2D", USAA_ANCHORED_JOINT2D, USAA_CLASS_COMPONENT, 50, 51 },
+    [USAA_CLASS_SLOT(USAA_HINGE_JOINT2D)] = { "HingeJoint2D", USAA_ANCHORED_JOINT2D, USAA_CLASS_COMPONENT, 51, 52 },
+    [USAA_CLASS_SLOT(USAA_SLIDER_JOINT2D)] = { "SliderJoint2D", USAA_ANCHORED_JOINT2D, USAA_CLASS_COMPONENT, 52, 53 },
+    [USAA_CLASS_SLOT(USAA_WHEEL_JOINT2D)] = { "WheelJoint2D", USAA_ANCHORED_JOINT2D, USAA_CLASS_COMPONENT, 53, 54 },
+    [USAA_CLASS_SLOT(USAA_NAV_MESH_DATA)] = { "NavMeshData", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 177, 178 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_MIXER)] = { "AudioMixer", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 178, 180 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_MIXER_CONTROLLER)] = { "AudioMixerController", USAA_AUDIO_MIXER, USAA_CLASS_ASSET, 179, 180 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_MIXER_GROUP_CONTROLLER)] = { "AudioMixerGroupController", USAA_AUDIO_MIXER_GROUP, USAA_CLASS_ASSET, 187, 188 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_MIXER_EFFECT_CONTROLLER)] = { "AudioMixerEffectController", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 180, 181 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_MIXER_SNAPSHOT_CONTROLLER)] = { "AudioMixerSnapshotController", USAA_AUDIO_MIXER_SNAPSHOT, USAA_CLASS_ASSET, 185, 186 },
+    [USAA_CLASS_SLOT(USAA_PHYSICS_UPDATE_BEHAVIOUR2D)] = { "PhysicsUpdateBehaviour2D", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 54, 56 },
+    [USAA_CLASS_SLOT(USAA_CONSTANT_FORCE2D)] = { "ConstantForce2D", USAA_PHYSICS_UPDATE_BEHAVIOUR2D, USAA_CLASS_COMPONENT, 55, 56 },
+    [USAA_CLASS_SLOT(USAA_EFFECTOR2D)] = { "Effector2D", USAA_BEHAVIOUR, USAA_CLASS_COMPONENT | USAA_CLASS_ABSTRACT, 56, 61 },
+    [USAA_CLASS_SLOT(USAA_AREA_EFFECTOR2D)] = { "AreaEffector2D", USAA_EFFECTOR2D, USAA_CLASS_COMPONENT, 57, 58 },
+    [USAA_CLASS_SLOT(USAA_POINT_EFFECTOR2D)] = { "PointEffector2D", USAA_EFFECTOR2D, USAA_CLASS_COMPONENT, 58, 59 },
+    [USAA_CLASS_SLOT(USAA_PLATFORM_EFFECTOR2D)] = { "PlatformEffector2D", USAA_EFFECTOR2D, USAA_CLASS_COMPONENT, 59, 60 },
+    [USAA_CLASS_SLOT(USAA_SURFACE_EFFECTOR2D)] = { "SurfaceEffector2D", USAA_EFFECTOR2D, USAA_CLASS_COMPONENT, 60, 61 },
+    [USAA_CLASS_SLOT(USAA_LIGHT_PROBES)] = { "LightProbes", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 181, 182 },
+    [USAA_CLASS_SLOT(USAA_SAMPLE_CLIP)] = { "SampleClip", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 182, 184 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_MIXER_SNAPSHOT)] = { "AudioMixerSnapshot", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 184, 186 },
+    [USAA_CLASS_SLOT(USAA_AUDIO_MIXER_GROUP)] = { "AudioMixerGroup", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 186, 188 },
+    [USAA_CLASS_SLOT(USAA_ASSET_BUNDLE_MANIFEST)] = { "AssetBundleManifest", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 188, 189 },
+    [USAA_CLASS_SLOT(MSAA_PREFAB)] = { "Prefab", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 224, 225 },
+    [USAA_CLASS_SLOT(MSAA_EDITOR_EXTENSION_IMPL)] = { "EditorExtensionImpl", 0, USAA_CLASS_EDITOR, 235, 236 },
+    [USAA_CLASS_SLOT(MSAA_ASSET_IMPORTER)] = { "AssetImporter", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_EDITOR | USAA_CLASS_ABSTRACT, 189, 211 },
+    [USAA_CLASS_SLOT(MSAA_ASSET_DATABASE)] = { "AssetDatabase", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 225, 226 },
+    [USAA_CLASS_SLOT(MSAA_MESH_3DS_IMPORTER)] = { "Mesh3DSImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 190, 191 },
+    [USAA_CLASS_SLOT(MSAA_TEXTURE_IMPORTER)] = { "TextureImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 191, 192 },
+    [USAA_CLASS_SLOT(MSAA_SHADER_IMPORTER)] = { "ShaderImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 192, 193 },
+    [USAA_CLASS_SLOT(MSAA_COMPUTE_SHADER_IMPORTER)] = { "ComputeShaderImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 193, 194 },
+    [USAA_CLASS_SLOT(MSAA_AVATAR_MASK)] = { "AvatarMask", USAA_NAMED_OBJECT, USAA_CLASS_ASSET, 211, 212 },
+    [USAA_CLASS_SLOT(MSAA_AUDIO_IMPORTER)] = { "AudioImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 194, 195 },
+    [USAA_CLASS_SLOT(MSAA_HIERARCHY_STATE)] = { "HierarchyState", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 226, 227 },
+    [USAA_CLASS_SLOT(MSAA_GUID_SERIALIZER)] = { "GUIDSerializer", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 227, 228 },
+    [USAA_CLASS_SLOT(MSAA_ASSET_METADATA)] = { "AssetMetaData", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 228, 229 },
+    [USAA_CLASS_SLOT(MSAA_DEFAULT_ASSET)] = { "DefaultAsset", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 212, 214 },
+    [USAA_CLASS_SLOT(MSAA_DEFAULT_IMPORTER)] = { "DefaultImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 195, 196 },
+    [USAA_CLASS_SLOT(MSAA_TEXT_SCRIPT_IMPORTER)] = { "TextScriptImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 196, 197 },
+    [USAA_CLASS_SLOT(MSAA_SCENE_ASSET)] = { "SceneAsset", MSAA_DEFAULT_ASSET, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 213, 214 },
+    [USAA_CLASS_SLOT(MSAA_NATIVE_FORMAT_IMPORTER)] = { "NativeFormatImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 197, 198 },
+    [USAA_CLASS_SLOT(MSAA_MONO_IMPORTER)] = { "MonoImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 198, 199 },
+    [USAA_CLASS_SLOT(MSAA_ASSET_SERVER_CACHE)] = { "AssetServerCache", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 229, 230 },
+    [USAA_CLASS_SLOT(MSAA_LIBRARY_ASSET_IMPORTER)] = { "LibraryAssetImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 199, 200 },
+    [USAA_CLASS_SLOT(MSAA_MODEL_IMPORTER)] = { "ModelImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 200, 202 },
+    [USAA_CLASS_SLOT(MSAA_FBX_IMPORTER)] = { "FBXImporter", MSAA_MODEL_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 201, 202 },
+    [USAA_CLASS_SLOT(MSAA_TRUETYPE_FONT_IMPORTER)] = { "TrueTypeFontImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 202, 203 },
+    [USAA_CLASS_SLOT(MSAA_MOVIE_IMPORTER)] = { "MovieImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 203, 204 },
+    [USAA_CLASS_SLOT(MSAA_EDITOR_BUILD_SETTINGS)] = { "EditorBuildSettings", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 230, 231 },
+    [USAA_CLASS_SLOT(MSAA_DDS_IMPORTER)] = { "DDSImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 204, 205 },
+    [USAA_CLASS_SLOT(MSAA_INSPECTOR_EXPANDED_STATE)] = { "InspectorExpandedState", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 231, 232 },
+    [USAA_CLASS_SLOT(MSAA_ANNOTATION_MANAGER)] = { "AnnotationManager", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 232, 233 },
+    [USAA_CLASS_SLOT(MSAA_PLUGIN_IMPORTER)] = { "PluginImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 205, 206 },
+    [USAA_CLASS_SLOT(MSAA_EDITOR_USER_BUILD_SETTINGS)] = { "EditorUserBuildSettings", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 233, 234 },
+    [USAA_CLASS_SLOT(MSAA_PVR_IMPORTER)] = { "PVRImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 206, 207 },
+    [USAA_CLASS_SLOT(MSAA_ASTC_IMPORTER)] = { "ASTCImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 207, 208 },
+    [USAA_CLASS_SLOT(MSAA_KTX_IMPORTER)] = { "KTXImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 208, 209 },
+    [USAA_CLASS_SLOT(MSAA_ANIMATOR_STATE_TRANSITION)] = { "AnimatorStateTransition", MSAA_ANIMATOR_TRANSITION_BASE, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 218, 219 },
+    [USAA_CLASS_SLOT(MSAA_ANIMATOR_STATE)] = { "AnimatorState", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 214, 215 },
+    [USAA_CLASS_SLOT(MSAA_HUMAN_TEMPLATE)] = { "HumanTemplate", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 215, 216 },
+    [USAA_CLASS_SLOT(MSAA_ANIMATOR_STATE_MACHINE)] = { "AnimatorStateMachine", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 216, 217 },
+    [USAA_CLASS_SLOT(MSAA_PREVIEW_ASSET_TYPE)] = { "PreviewAssetType", USAA_EDITOR_EXTENSION, USAA_CLASS_EDITOR, 234, 235 },
+    [USAA_CLASS_SLOT(MSAA_ANIMATOR_TRANSITION)] = { "AnimatorTransition", MSAA_ANIMATOR_TRANSITION_BASE, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 219, 220 },
+    [USAA_CLASS_SLOT(MSAA_SPEEDTREE_IMPORTER)] = { "SpeedTreeImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 209, 210 },
+    [USAA_CLASS_SLOT(MSAA_ANIMATOR_TRANSITION_BASE)] = { "AnimatorTransitionBase", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_EDITOR | USAA_CLASS_ABSTRACT, 217, 220 },
+    [USAA_CLASS_SLOT(MSAA_SUBSTANCE_IMPORTER)] = { "SubstanceImporter", MSAA_ASSET_IMPORTER, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 210, 211 },
+    [USAA_CLASS_SLOT(MSAA_LIGHTMAP_PARAMETERS)] = { "LightmapParameters", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 220, 221 },
+    [USAA_CLASS_SLOT(MSAA_LIGHTMAP_SNAPSHOT)] = { "LightmapSnapshot", USAA_NAMED_OBJECT, USAA_CLASS_ASSET | USAA_CLASS_EDITOR, 221, 222 },
+};
+
+const usaa_class_t *usaa_class_get(int class_id)
+{
+    const usaa_class_t *info;
+
+    if (class_id <= 0 || class_id > USAA_CLASS_LAST_EDITOR
+            || (class_id > USAA_CLASS_LAST_RUNTIME && class_id < USAA_CLASS_FIRST_EDITOR))
+        return NULL;
+
+    info = usaa_classes_ + USAA_CLASS_SLOT(class_id);
+    return info->name ? info : NULL;
+}
+
+const char *usaa_class_name(int class_id)
+{
+    const usaa_class_t *info = usaa_class_get(class_id);
+
+    return info ? info->name : NULL;
+}
+
+unsigned usaa_class_flags(int class_id)
+{
+    const usaa_class_t *info = usaa_class_get(class_id);
+
+    return info ? info->flags : 0;
+}
+
+int usaa_class_is_a(int class_id, int base_id)
+{
+    const usaa_class_t *info = usaa_class_get(class_id);
+    const usaa_class_t *base = usaa_class_get(base_id);
+
+    if (!info || !base)
+        return 0;
+    return info->enter >= base->enter && info->enter < base->leave;
+}
+
+int usaa_class_find(const char *name, size_t length)
+{
+    int slot;
+
+    if (!length)
+        return 0;
+    for (slot = 0; slot < USAA_CLASS_SLOTS; slot++) {
+        const char *candidate = usaa_classes_[slot].name;
+
+        if (candidate && candidate[0] == name[0] && !strncmp(candidate, name, length) && !candidate[length])
+            return USAA_CLASS_ID(slot);
+    }
+    return 0;
+}
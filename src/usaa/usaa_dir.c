@@ -0,0 +1,208 @@
+#include <stdio.h>
+
+#include "usaa_private.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+# include <fcntl.h>
+# include <io.h>
+#else
+# include <dirent.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/stat.h>
+#endif
+
+struct usaa_dir_s {
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE find;
+    WIN32_FIND_DATAA data;
+    int pending;
+#else
+    DIR *dir;
+    char path[4096];
+#endif
+};
+
+usaa_dir_t *usaa_dir_open(const char *path)
+{
+    usaa_dir_t *dir = (usaa_dir_t *)malloc(sizeof(usaa_dir_t));
+
+    if (!dir)
+        return NULL;
+
+#if defined(_WIN32) || defined(_WIN64)
+    {
+        char pattern[MAX_PATH];
+
+        if (snprintf(pattern, sizeof(pattern), "%s\\*", path) >= (int)sizeof(pattern)) {
+            free(dir);
+            return NULL;
+        }
+        dir->find = FindFirstFileExA(pattern, FindExInfoBasic, &dir->data,
+            FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+        if (dir->find == INVALID_HANDLE_VALUE) {
+            free(dir);
+            return NULL;
+        }
+        dir->pending = 1;
+    }
+#else
+    dir->dir = opendir(path);
+    if (!dir->dir) {
+        free(dir);
+        return NULL;
+    }
+#endif
+    return dir;
+}
+
+const char *usaa_dir_next(usaa_dir_t *dir, const char *path, int *is_dir)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    (void)path;
+    for (;;) {
+        const char *name;
+
+        if (!dir->pending && !FindNextFileA(dir->find, &dir->data))
+            return NULL;
+        dir->pending = 0;
+
+        name = dir->data.cFileName;
+        if (!strcmp(name, ".") || !strcmp(name, ".."))
+            continue;
+        *is_dir = (dir->data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        return name;
+    }
+#else
+    struct dirent *entry;
+
+    while ((entry = readdir(dir->dir)) != NULL) {
+        const char *name = entry->d_name;
+
+        if (!strcmp(name, ".") || !strcmp(name, ".."))
+            continue;
+
+# if defined(DT_DIR)
+        if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK) {
+            *is_dir = entry->d_type == DT_DIR;
+            return name;
+        }
+# endif
+        /* The file system does not tell the type, ask for it. */
+        {
+            struct stat st;
+
+            if (snprintf(dir->path, sizeof(dir->path), "%s/%s", path, name) >= (int)sizeof(dir->path)
+                    || stat(dir->path, &st))
+                continue;
+            *is_dir = S_ISDIR(st.st_mode);
+        }
+        return name;
+    }
+    return NULL;
+#endif
+}
+
+void usaa_dir_close(usaa_dir_t *dir)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    FindClose(dir->find);
+#else
+    closedir(dir->dir);
+#endif
+    free(dir);
+}
+
+long usaa_read_head(const char *path, char *buffer, size_t size)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    int fd = _open(path, _O_RDONLY | _O_BINARY);
+    int count;
+
+    if (fd < 0)
+        return -1;
+    count = _read(fd, buffer, (unsigned int)size);
+    _close(fd);
+    return count;
+#else
+    int fd = open(path, O_RDONLY);
+    size_t total = 0;
+
+    if (fd < 0)
+        return -1;
+    while (total < size) {
+        ssize_t count = read(fd, buffer + total, size - total);
+
+        if (count <= 0) {
+            if (count < 0 && total == 0) {
+                close(fd);
+                return -1;
+            }
+            break;
+        }
+        total += (size_t)count;
+    }
+    close(fd);
+    return (long)total;
+#endif
+}
+
+int usaa_file_stat(const char *path, uint64_t *size, uint64_t *mtime)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data))
+        return USAA_EIO;
+    *size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    *mtime = (((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime) * 100;
+#else
+    struct stat st;
+
+    if (stat(path, &st))
+        return USAA_EIO;
+    *size = (uint64_t)st.st_size;
+# if defined(__APPLE__)
+    *mtime = (uint64_t)st.st_mtimespec.tv_sec * 1000000000 + (uint64_t)st.st_mtimespec.tv_nsec;
+# else
+    *mtime = (uint64_t)st.st_mtim.tv_sec * 1000000000 + (uint64_t)st.st_mtim.tv_nsec;
+# endif
+#endif
+    return USAA_EOK;
+}
+
+long usaa_read_tail(const char *path, char *buffer, size_t size)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    int fd = _open(path, _O_RDONLY | _O_BINARY);
+    __int64 end;
+    int count;
+
+    if (fd < 0)
+        return -1;
+    end = _lseeki64(fd, 0, SEEK_END);
+    if (end < 0 || _lseeki64(fd, end > (__int64)size ? end - (__int64)size : 0, SEEK_SET) < 0) {
+        _close(fd);
+        return -1;
+    }
+    count = _read(fd, buffer, (unsigned int)size);
+    _close(fd);
+    return count;
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    off_t start;
+    ssize_t count;
+
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &st)) {
+        close(fd);
+        return -1;
+    }
+    start = st.st_size > (off_t)size ? st.st_size - (off_t)size : 0;
+    count = pread(fd, buffer, size, start);
+    close(fd);
+    return (long)count;
+#endif
+}
@@ -0,0 +1,580 @@
+#include "usaa_private.h"
+
+/* A reference found by a thread, before the GUIDs become nodes.
+ */
+typedef struct {
+    uint32_t source;
+    usaa_guid_t target;
+} usaa_graph_ref_t;
+
+typedef struct {
+    usaa_graph_ref_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_graph_refs_t;
+
+typedef struct {
+    usaa_guid_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_graph_guids_t;
+
+typedef struct {
+    uint32_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_graph_nodes_t;
+
+typedef struct {
+    const usaa_project_t *project;
+    usaa_graph_refs_t *refs;    /* One list per thread. */
+} usaa_graph_builder_t;
+
+static int usaa_graph_visit_(void *data, int worker, const usaa_scan_file_t *file,
+        const char *text, const usaa_objects_t *objects)
+{
+    usaa_graph_builder_t *builder = (usaa_graph_builder_t *)data;
+    usaa_graph_refs_t *refs = builder->refs + worker;
+    uint32_t source = (uint32_t)(file->asset - builder->project->assets);
+    const usaa_object_t *last;
+    const char *p;
+    const char *end;
+    usaa_reference_t reference;
+    size_t first = refs->count;
+    int error;
+
+    if (!objects->count)
+        return USAA_EOK;
+    last = objects->start + objects->count - 1;
+    p = text + objects->start[0].body;
+    end = text + last->offset + last->length;
+
+    while (usaa_reference_next(&p, end, &reference)) {
+        if (!reference.external || USAA_GUID_EQUAL(&reference.guid, &file->asset->guid))
+            continue;
+
+        /* The objects of a file often reference the same asset in a row. */
+        if (refs->count > first && USAA_GUID_EQUAL(&refs->start[refs->count - 1].target, &reference.guid))
+            continue;
+
+        USAA_ARRAY_RESERVE(&error, refs, usaa_graph_ref_t, 1);
+        if (error)
+            return error;
+        refs->start[refs->count].source = source;
+        refs->start[refs->count].target = reference.guid;
+        refs->count++;
+    }
+    return USAA_EOK;
+}
+
+/* Find the slot of a GUID out of the project in the table.
+ */
+static size_t usaa_graph_slot_(const usaa_graph_t *graph, const usaa_guid_t *guid)
+{
+    size_t slot = usaa_guid_hash(guid) & graph->mask;
+
+    while (graph->table[slot] && !USAA_GUID_EQUAL(&graph->guids[graph->table[slot] - 1], guid))
+        slot = (slot + 1) & graph->mask;
+    return slot;
+}
+
+/* Make a node of a GUID out of the project, if it is not one yet.
+ */
+static int usaa_graph_intern_(usaa_graph_t *graph, usaa_graph_guids_t *guids,
+        const usaa_guid_t *guid, uint32_t *node)
+{
+    size_t slot;
+    int error;
+
+    /* Keep the table at most half full. */
+    if ((guids->count - graph->project->count + 1) * 2 > graph->mask + 1) {
+        size_t capacity = (graph->mask + 1) * 2;
+        uint32_t *table = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+        size_t i;
+
+        if (!table)
+            return USAA_EMEMORY;
+        free(graph->table);
+        graph->table = table;
+        graph->mask = capacity - 1;
+        for (i = graph->project->count; i < guids->count; i++)
+            graph->table[usaa_graph_slot_(graph, guids->start + i)] = (uint32_t)i + 1;
+    }
+
+    slot = usaa_graph_slot_(graph, guid);
+    if (!graph->table[slot]) {
+        USAA_ARRAY_RESERVE(&error, guids, usaa_guid_t, 1);
+        if (error)
+            return error;
+        graph->guids = guids->start;
+        guids->start[guids->count] = *guid;
+        graph->table[slot] = (uint32_t)++guids->count;
+    }
+    *node = graph->table[slot] - 1;
+    return USAA_EOK;
+}
+
+static int usaa_node_compare_(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+/* Lay the edges out as rows of sources, each sorted and without repeats.
+ */
+static int usaa_graph_forward_(usaa_graph_t *graph, const uint32_t *sources, const uint32_t *targets, size_t count)
+{
+    usaa_edges_t *edges = graph->direction + USAA_GRAPH_FORWARD;
+    uint32_t *cursor;
+    size_t node;
+    size_t kept = 0;
+    size_t i;
+
+    edges->offsets = (uint32_t *)calloc(graph->count + 1, sizeof(uint32_t));
+    edges->targets = (uint32_t *)malloc((count ? count : 1) * sizeof(uint32_t));
+    cursor = (uint32_t *)malloc((graph->count + 1) * sizeof(uint32_t));
+    if (!edges->offsets || !edges->targets || !cursor) {
+        free(cursor);
+        return USAA_EMEMORY;
+    }
+
+    for (i = 0; i < count; i++)
+        edges->offsets[sources[i] + 1]++;
+    for (node = 0; node < graph->count; node++)
+        edges->offsets[node + 1] += edges->offsets[node];
+    memcpy(cursor, edges->offsets, (graph->count + 1) * sizeof(uint32_t));
+    for (i = 0; i < count; i++)
+        edges->targets[cursor[sources[i]]++] = targets[i];
+    free(cursor);
+
+    for (node = 0; node < graph->count; node++) {
+        uint32_t *row = edges->targets + edges->offsets[node];
+        size_t degree = edges->offsets[node + 1] - edges->offsets[node];
+
+        edges->offsets[node] = (uint32_t)kept;
+        if (degree > 1)
+            qsort(row, degree, sizeof(uint32_t), usaa_node_compare_);
+        for (i = 0; i < degree; i++) {
+            if (!i || row[i] != row[i - 1])
+                edges->targets[kept++] = row[i];
+        }
+    }
+    edges->offsets[graph->count] = (uint32_t)kept;
+    graph->edges = kept;
+    return USAA_EOK;
+}
+
+/* Turn the forward rows around, the sources come in order so the rows are sorted.
+ */
+static int usaa_graph_reverse_(usaa_graph_t *graph)
+{
+    const usaa_edges_t *forward = graph->direction + USAA_GRAPH_FORWARD;
+    usaa_edges_t *reverse = graph->direction + USAA_GRAPH_REVERSE;
+    uint32_t *cursor;
+    size_t node;
+    size_t i;
+
+    reverse->offsets = (uint32_t *)calloc(graph->count + 1, sizeof(uint32_t));
+    reverse->targets = (uint32_t *)malloc((graph->edges ? graph->edges : 1) * sizeof(uint32_t));
+    cursor = (uint32_t *)malloc((graph->count + 1) * sizeof(uint32_t));
+    if (!reverse->offsets || !reverse->targets || !cursor) {
+        free(cursor);
+        return USAA_EMEMORY;
+    }
+
+    for (i = 0; i < graph->edges; i++)
+        reverse->offsets[forward->targets[i] + 1]++;
+    for (node = 0; node < graph->count; node++)
+        reverse->offsets[node + 1] += reverse->offsets[node];
+    memcpy(cursor, reverse->offsets, (graph->count + 1) * sizeof(uint32_t));
+    for (node = 0; node < graph->count; node++) {
+        for (i = forward->offsets[node]; i < forward->offsets[node + 1]; i++)
+            reverse->targets[cursor[forward->targets[i]]++] = (uint32_t)node;
+    }
+    free(cursor);
+    return USAA_EOK;
+}
+
+/* Turn the references found into nodes and edges.
+ */
+static int usaa_graph_link_(usaa_graph_t *graph, const usaa_graph_refs_t *lists, int count_lists)
+{
+    const usaa_project_t *project = graph->project;
+    usaa_graph_guids_t guids = { NULL, 0, 0 };
+    uint32_t *sources = NULL;
+    uint32_t *targets = NULL;
+    size_t count = 0;
+    size_t i;
+    size_t j;
+    int w;
+    int error;
+
+    /* The assets come first, with their index as node. */
+    USAA_ARRAY_RESERVE(&error, &guids, usaa_guid_t, project->count + 1);
+    if (error)
+        return error;
+    for (i = 0; i < project->count; i++)
+        guids.start[i] = project->assets[i].guid;
+    guids.count = project->count;
+    graph->guids = guids.start;
+
+    graph->table = (uint32_t *)calloc(16, sizeof(uint32_t));
+    graph->mask = 15;
+    for (w = 0; w < count_lists; w++)
+        count += lists[w].count;
+    sources = (uint32_t *)malloc((count ? count : 1) * sizeof(uint32_t));
+    targets = (uint32_t *)malloc((count ? count : 1) * sizeof(uint32_t));
+    if (!graph->table || !sources || !targets)
+        error = USAA_EMEMORY;
+
+    count = 0;
+    for (w = 0; w < count_lists && !error; w++) {
+        const usaa_graph_refs_t *refs = lists + w;
+
+        for (j = 0; j < refs->count && !error; j++) {
+            const usaa_asset_t *asset = usaa_project_find(project, &refs->start[j].target);
+
+            if (asset)
+                targets[count] = (uint32_t)(asset - project->assets);
+            else
+                error = usaa_graph_intern_(graph, &guids, &refs->start[j].target, targets + count);
+            sources[count++] = refs->start[j].source;
+        }
+    }
+    graph->guids = guids.start;
+    graph->count = guids.count;
+
+    if (!error)
+        error = usaa_graph_forward_(graph, sources, targets, count);
+    free(sources);
+    free(targets);
+    if (!error)
+        error = usaa_graph_reverse_(graph);
+    return error;
+}
+
+int usaa_graph_build(usaa_graph_t *graph, usaa_scan_t *scan)
+{
+    usaa_graph_builder_t builder;
+    int w;
+    int error;
+
+    memset(graph, 0, sizeof(usaa_graph_t));
+    graph->project = scan->project;
+
+    builder.project = scan->project;
+    builder.refs = (usaa_graph_refs_t *)calloc(scan->threads, sizeof(usaa_graph_refs_t));
+    if (!builder.refs)
+        return USAA_EMEMORY;
+
+    error = usaa_scan_run(scan, usaa_graph_visit_, &builder);
+    if (!error)
+        error = usaa_graph_link_(graph, builder.refs, scan->threads);
+
+    for (w = 0; w < scan->threads; w++)
+        free(builder.refs[w].start);
+    free(builder.refs);
+
+    if (error)
+        usaa_graph_destroy(graph);
+    return error;
+}
+
+int usaa_graph_build_index(usaa_graph_t *graph, const usaa_project_t *project, const usaa_index_t *index)
+{
+    usaa_graph_refs_t refs = { NULL, 0, 0 };
+    size_t i;
+    size_t j;
+    int error = USAA_EOK;
+
+    memset(graph, 0, sizeof(usaa_graph_t));
+    graph->project = project;
+
+    for (i = 0; i < index->count && !error; i++) {
+        const usaa_index_file_t *file = index->files + i;
+        const usaa_asset_t *asset = usaa_project_find(project, &file->guid);
+        size_t first = refs.count;
+
+        if (!asset)
+            continue;
+        for (j = file->references; j < file->references + file->reference_count; j++) {
+            const usaa_index_reference_t *reference = index->references + j;
+
+            if (!reference->external || USAA_GUID_EQUAL(&reference->guid, &file->guid))
+                continue;
+            if (refs.count > first && USAA_GUID_EQUAL(&refs.start[refs.count - 1].target, &reference->guid))
+                continue;
+
+            USAA_ARRAY_RESERVE(&error, &refs, usaa_graph_ref_t, 1);
+            if (error)
+                break;
+            refs.start[refs.count].source = (uint32_t)(asset - project->assets);
+            refs.start[refs.count].target = reference->guid;
+            refs.count++;
+        }
+    }
+
+    if (!error)
+        error = usaa_graph_link_(graph, &refs, 1);
+    free(refs.start);
+
+    if (error)
+        usaa_graph_destroy(graph);
+    return error;
+}
+
+void usaa_graph_destroy(usaa_graph_t *graph)
+{
+    int dir;
+
+    for (dir = 0; dir < 2; dir++) {
+        free(graph->direction[dir].offsets);
+        free(graph->direction[dir].targets);
+    }
+    free(graph->guids);
+    free(graph->table);
+    memset(graph, 0, sizeof(usaa_graph_t));
+}
+
+uint32_t usaa_graph_find(const usaa_graph_t *graph, const usaa_guid_t *guid)
+{
+    const usaa_asset_t *asset = usaa_project_find(graph->project, guid);
+    size_t slot;
+
+    if (asset)
+        return (uint32_t)(asset - graph->project->assets);
+    if (!graph->table)
+        return USAA_GRAPH_NONE;
+    slot = usaa_graph_slot_(graph, guid);
+    return graph->table[slot] ? graph->table[slot] - 1 : USAA_GRAPH_NONE;
+}
+
+int usaa_graph_closure(const usaa_graph_t *graph, const uint32_t *roots, size_t count,
+        int dir, uint32_t **nodes, size_t *reached)
+{
+    const usaa_edges_t *edges = graph->direction + dir;
+    unsigned char *seen = (unsigned char *)calloc(graph->count / 8 + 1, 1);
+    uint32_t *queue = (uint32_t *)malloc((graph->count + 1) * sizeof(uint32_t));
+    size_t head;
+    size_t tail = 0;
+    size_t i;
+
+#define USAA_GRAPH_VISIT(node) do { \
+    uint32_t node_ = (node); \
+    if (!(seen[node_ >> 3] & (1 << (node_ & 7)))) { \
+        seen[node_ >> 3] |= (unsigned char)(1 << (node_ & 7)); \
+        queue[tail++] = node_; \
+    } \
+} while (0)
+
+    if (!seen || !queue) {
+        free(seen);
+        free(queue);
+        return USAA_EMEMORY;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (roots[i] < graph->count)
+            USAA_GRAPH_VISIT(roots[i]);
+    }
+    for (head = 0; head < tail; head++) {
+        uint32_t node = queue[head];
+
+        for (i = edges->offsets[node]; i < edges->offsets[node + 1]; i++)
+            USAA_GRAPH_VISIT(edges->targets[i]);
+    }
+
+#undef USAA_GRAPH_VISIT
+
+    free(seen);
+    *nodes = queue;
+    *reached = tail;
+    return USAA_EOK;
+}
+
+/* The nodes of a level handed out at a time.
+ */
+#define USAA_GRAPH_CHUNK    256
+
+/* One level of a parallel search.
+ */
+typedef struct {
+    const usaa_edges_t *edges;
+    uint64_t *reached;
+
+    const uint32_t *frontier;
+    size_t count;
+    uint64_t next;
+    uint64_t workers;
+
+    usaa_graph_nodes_t *found;  /* The nodes found by each thread. */
+    int error;
+} usaa_graph_level_t;
+
+/* Set the bit of a node unless another thread did.
+ * Returns 1 if this thread did.
+ */
+static int usaa_graph_claim_(uint64_t *reached, uint32_t node)
+{
+    uint64_t *word = reached + (node >> 6);
+    uint64_t bit = (uint64_t)1 << (node & 63);
+
+    for (;;) {
+        uint64_t old = usaa_atomic_load(word);
+
+        if (old & bit)
+            return 0;
+        if (usaa_atomic_cas(word, old, old | bit))
+            return 1;
+    }
+}
+
+static void usaa_graph_level_run_(void *data)
+{
+    usaa_graph_level_t *level = (usaa_graph_level_t *)data;
+    usaa_graph_nodes_t *found = level->found + usaa_atomic_add(&level->workers, 1);
+    const usaa_edges_t *edges = level->edges;
+    int error = USAA_EOK;
+
+    for (;;) {
+        size_t first = (size_t)usaa_atomic_add(&level->next, USAA_GRAPH_CHUNK);
+        size_t i;
+
+        if (first >= level->count)
+            break;
+        for (i = first; i < first + USAA_GRAPH_CHUNK && i < level->count; i++) {
+            uint32_t node = level->frontier[i];
+            uint32_t j;
+
+            for (j = edges->offsets[node]; j < edges->offsets[node + 1]; j++) {
+                uint32_t next = edges->targets[j];
+
+                /* Most targets are already seen, look before claiming. */
+                if (usaa_atomic_load(level->reached + (next >> 6)) & ((uint64_t)1 << (next & 63)))
+                    continue;
+                if (!usaa_graph_claim_(level->reached, next))
+                    continue;
+                USAA_ARRAY_RESERVE(&error, found, uint32_t, 1);
+                if (error) {
+                    level->error = error;
+                    return;
+                }
+                found->start[found->count++] = next;
+            }
+        }
+    }
+}
+
+int usaa_graph_reach(const usaa_graph_t *graph, const uint32_t *roots, size_t count,
+        int dir, int threads, uint64_t *reached)
+{
+    usaa_graph_level_t level;
+    uint32_t *frontier;
+    size_t size = 0;
+    size_t i;
+    int w;
+    int error = USAA_EOK;
+
+    threads = usaa_thread_count(threads);
+    frontier = (uint32_t *)malloc((graph->count + 1) * sizeof(uint32_t));
+    level.found = (usaa_graph_nodes_t *)calloc(threads, sizeof(usaa_graph_nodes_t));
+    if (!frontier || !level.found) {
+        free(frontier);
+        free(level.found);
+        return USAA_EMEMORY;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (roots[i] < graph->count && usaa_graph_claim_(reached, roots[i]))
+            frontier[size++] = roots[i];
+    }
+
+    level.edges = graph->direction + dir;
+    level.reached = reached;
+    level.error = USAA_EOK;
+    while (size && !error) {
+        int used = (int)(size / USAA_GRAPH_CHUNK) + 1;
+
+        level.frontier = frontier;
+        level.count = size;
+        level.next = 0;
+        level.workers = 0;
+        usaa_thread_run(used < threads ? used : threads, usaa_graph_level_run_, &level);
+        error = level.error;
+
+        /* The next frontier is what the threads found, it replaces the current one. */
+        size = 0;
+        for (w = 0; w < threads; w++) {
+            if (level.found[w].count)
+                memcpy(frontier + size, level.found[w].start, level.found[w].count * sizeof(uint32_t));
+            size += level.found[w].count;
+            level.found[w].count = 0;
+        }
+    }
+
+    for (w = 0; w < threads; w++)
+        free(level.found[w].start);
+    free(level.found);
+    free(frontier);
+    return error;
+}
+
+int usaa_graph_reaches(const usaa_graph_t *graph, uint32_t from, uint32_t to)
+{
+    unsigned char *seen;
+    uint32_t *queues[2];
+    size_t head[2] = { 0, 0 };
+    size_t tail[2] = { 1, 1 };
+    int found = 0;
+
+    if (from >= graph->count || to >= graph->count)
+        return 0;
+    if (from == to)
+        return 1;
+
+    /* Bit `1 << dir` marks the nodes seen from `from` forward or from `to` back. */
+    seen = (unsigned char *)calloc(graph->count, 1);
+    queues[0] = (uint32_t *)malloc(graph->count * 2 * sizeof(uint32_t));
+    if (!seen || !queues[0]) {
+        free(seen);
+        free(queues[0]);
+        return USAA_EMEMORY;
+    }
+    queues[1] = queues[0] + graph->count;
+    queues[0][0] = from;
+    queues[1][0] = to;
+    seen[from] = 1 << USAA_GRAPH_FORWARD;
+    seen[to] = 1 << USAA_GRAPH_REVERSE;
+
+    /* Go one level deeper on the side with the smaller frontier until the sides meet. */
+    while (!found && head[0] < tail[0] && head[1] < tail[1]) {
+        int dir = tail[0] - head[0] <= tail[1] - head[1] ? USAA_GRAPH_FORWARD : USAA_GRAPH_REVERSE;
+        const usaa_edges_t *edges = graph->direction + dir;
+        uint32_t *queue = queues[dir];
+        size_t level = tail[dir];
+
+        for (; head[dir] < level && !found; head[dir]++) {
+            uint32_t node = queue[head[dir]];
+            uint32_t i;
+
+            for (i = edges->offsets[node]; i < edges->offsets[node + 1]; i++) {
+                uint32_t next = edges->targets[i];
+
+                if (seen[next] & (1 << !dir)) {
+                    found = 1;
+                    break;
+                }
+                if (!(seen[next] & (1 << dir))) {
+                    seen[next] |= (unsigned char)(1 << dir);
+                    queue[tail[dir]++] = next;
+                }
+            }
+        }
+    }
+
+    free(seen);
+    free(queues[0]);
+    return found;
+}
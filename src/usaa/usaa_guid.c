@@ -0,0 +1,57 @@
+#include "usaa_private.h"
+
+/* The value of a hex digit, -1 for other characters.
+ */
+static int usaa_hex_value_(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+int usaa_guid_parse(usaa_guid_t *guid, const char *text, size_t length)
+{
+    uint64_t half[2] = { 0, 0 };
+    size_t i;
+
+    if (length != 32)
+        return USAA_EFORMAT;
+
+    for (i = 0; i < 32; i++) {
+        int value = usaa_hex_value_(text[i]);
+
+        if (value < 0)
+            return USAA_EFORMAT;
+        half[i >> 4] = (half[i >> 4] << 4) | (uint64_t)value;
+    }
+
+    guid->high = half[0];
+    guid->low = half[1];
+    return USAA_EOK;
+}
+
+void usaa_guid_format(const usaa_guid_t *guid, char *text)
+{
+    static const char hex[] = "0123456789abcdef";
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        text[i] = hex[(guid->high >> (60 - 4 * i)) & 0x0F];
+        text[16 + i] = hex[(guid->low >> (60 - 4 * i)) & 0x0F];
+    }
+    text[32] = '\0';
+}
+
+size_t usaa_guid_hash(const usaa_guid_t *guid)
+{
+    uint64_t hash = guid->low ^ (guid->high * 0x9E3779B97F4A7C15ULL);
+
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+    return (size_t)hash;
+}
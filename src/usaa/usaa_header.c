@@ -0,0 +1,109 @@
+#include "usaa_private.h"
+
+/* The header of a document, up to the class id.
+ */
+#define USAA_HEADER         "--- !u!"
+#define USAA_HEADER_LENGTH  7
+
+int usaa_parse_int64(const char **pointer, const char *end, int64_t *value)
+{
+    const char *p = *pointer;
+    uint64_t magnitude = 0;
+    int negative = 0;
+
+    if (p != end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9')
+        return 0;
+    while (p != end && *p >= '0' && *p <= '9')
+        magnitude = magnitude * 10 + (uint64_t)(*p++ - '0');
+
+    *value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    *pointer = p;
+    return 1;
+}
+
+/* Parse the rest of a header line after `--- !u!`.
+ * Returns the end of the line, or NULL if this is not a header.
+ */
+static const char *usaa_parse_header_(const char *p, const char *end, usaa_object_t *object)
+{
+    int64_t value;
+
+    if (!usaa_parse_int64(&p, end, &value) || value < 0 || value > INT32_MAX)
+        return NULL;
+    object->class_id = (int)value;
+
+    if (p == end || *p++ != ' ' || p == end || *p++ != '&')
+        return NULL;
+    if (!usaa_parse_int64(&p, end, &object->file_id))
+        return NULL;
+
+    object->stripped = 0;
+    if (end - p >= 9 && !memcmp(p, " stripped", 9)) {
+        object->stripped = 1;
+        p += 9;
+    }
+
+    if (p != end && *p == '\r')
+        p++;
+    if (p == end)
+        return p;
+    return *p == '\n' ? p + 1 : NULL;
+}
+
+int usaa_objects_scan(usaa_objects_t *objects, const char *data, size_t size)
+{
+    const char *end = data + size;
+    const char *p = data;
+    usaa_object_t *last = NULL;
+    size_t first = objects->count;
+    int error;
+
+    /* Tags only show up in the headers, so the bodies go by at memchr() speed. */
+    while ((p = (const char *)memchr(p, '!', end - p)) != NULL) {
+        const char *line = p - 4;
+        usaa_object_t object;
+        const char *next;
+
+        if (line < data || (line != data && line[-1] != '\n')
+                || end - line < USAA_HEADER_LENGTH || memcmp(line, USAA_HEADER, USAA_HEADER_LENGTH)) {
+            p++;
+            continue;
+        }
+
+        next = usaa_parse_header_(line + USAA_HEADER_LENGTH, end, &object);
+        if (!next) {
+            p++;
+            continue;
+        }
+
+        USAA_ARRAY_RESERVE(&error, objects, usaa_object_t, 1);
+        if (error)
+            return error;
+
+        object.offset = line - data;
+        object.body = next - data;
+        object.length = 0;
+        if (objects->count > first) {
+            last = objects->start + objects->count - 1;
+            last->length = object.offset - last->offset;
+        }
+        objects->start[objects->count++] = object;
+        p = next;
+    }
+
+    if (objects->count > first) {
+        last = objects->start + objects->count - 1;
+        last->length = size - last->offset;
+    }
+    return USAA_EOK;
+}
+
+void usaa_objects_destroy(usaa_objects_t *objects)
+{
+    free(objects->start);
+    memset(objects, 0, sizeof(usaa_objects_t));
+}
@@ -0,0 +1,256 @@
+#include "usaa_private.h"
+
+/* A child listed in the `m_Children` of a node.
+ */
+typedef struct {
+    uint32_t parent;
+    int64_t file_id;
+} usaa_hierarchy_child_t;
+
+typedef struct {
+    usaa_hierarchy_child_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_hierarchy_children_t;
+
+/* Check if a line starts with a field of a Transform, at the indentation of its members.
+ */
+#define USAA_HIERARCHY_FIELD(line, stop, name) \
+    ((size_t)((stop) - (line)) >= sizeof(name) - 1 && !memcmp((line), (name), sizeof(name) - 1))
+
+/* Spread a fileID over the bits of a hash.
+ */
+static size_t usaa_file_id_hash_(int64_t file_id)
+{
+    uint64_t hash = (uint64_t)file_id * 0x9E3779B97F4A7C15ULL;
+
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+    return (size_t)hash;
+}
+
+/* Find the slot of a fileID in the table, the one holding it or the free
+ * one ending its probe.
+ */
+static size_t usaa_hierarchy_slot_(const usaa_hierarchy_t *hierarchy, int64_t file_id)
+{
+    size_t slot = usaa_file_id_hash_(file_id) & hierarchy->mask;
+
+    while (hierarchy->table[slot]) {
+        const usaa_hierarchy_node_t *node = hierarchy->nodes + hierarchy->table[slot] - 1;
+
+        if (node->file_id == file_id || node->game_object == file_id)
+            break;
+        slot = (slot + 1) & hierarchy->mask;
+    }
+    return slot;
+}
+
+/* The node of a Transform by its own fileID only.
+ */
+static uint32_t usaa_hierarchy_transform_(const usaa_hierarchy_t *hierarchy, int64_t file_id)
+{
+    uint32_t node = usaa_hierarchy_find(hierarchy, file_id);
+
+    return node != USAA_HIERARCHY_NONE && hierarchy->nodes[node].file_id == file_id ? node : USAA_HIERARCHY_NONE;
+}
+
+/* The fileID of the reference on a line, 0 if there is none.
+ */
+static int64_t usaa_hierarchy_reference_(const char *line, const char *stop)
+{
+    usaa_reference_t reference;
+
+    return usaa_reference_next(&line, stop, &reference) ? reference.file_id : 0;
+}
+
+/* Read the GameObject, children and father of a Transform. Unity writes
+ * `m_Father` after `m_Children`, the rest of the body is skipped.
+ */
+static int usaa_hierarchy_parse_(usaa_hierarchy_node_t *node, uint32_t index, const char *body,
+        const char *end, usaa_hierarchy_children_t *children, int64_t *father)
+{
+    const char *line;
+    int listing = 0;
+    int error;
+
+    for (line = body; line < end; ) {
+        const char *eol = (const char *)memchr(line, '\n', end - line);
+        const char *stop = eol ? eol : end;
+
+        if (listing && USAA_HIERARCHY_FIELD(line, stop, "  - ")) {
+            USAA_ARRAY_RESERVE(&error, children, usaa_hierarchy_child_t, 1);
+            if (error)
+                return error;
+            children->start[children->count].parent = index;
+            children->start[children->count++].file_id = usaa_hierarchy_reference_(line, stop);
+        }
+        else {
+            listing = 0;
+            if (USAA_HIERARCHY_FIELD(line, stop, "  m_GameObject: "))
+                node->game_object = usaa_hierarchy_reference_(line, stop);
+            else if (USAA_HIERARCHY_FIELD(line, stop, "  m_Children:"))
+                listing = 1;
+            else if (USAA_HIERARCHY_FIELD(line, stop, "  m_Father: ")) {
+                *father = usaa_hierarchy_reference_(line, stop);
+                break;
+            }
+        }
+        line = stop + 1;
+    }
+    return USAA_EOK;
+}
+
+/* Make a node the first child of another, unless it has a parent already
+ * or the link would close a cycle.
+ */
+static void usaa_hierarchy_link_(usaa_hierarchy_t *hierarchy, uint32_t parent, uint32_t child)
+{
+    usaa_hierarchy_node_t *nodes = hierarchy->nodes;
+    uint32_t ancestor;
+
+    if (parent == USAA_HIERARCHY_NONE || child == USAA_HIERARCHY_NONE
+            || nodes[child].parent != USAA_HIERARCHY_NONE)
+        return;
+    for (ancestor = parent; ancestor != USAA_HIERARCHY_NONE; ancestor = nodes[ancestor].parent) {
+        if (ancestor == child)
+            return;
+    }
+
+    nodes[child].parent = parent;
+    nodes[child].next_sibling = nodes[parent].first_child;
+    nodes[parent].first_child = child;
+}
+
+int usaa_hierarchy_build(usaa_hierarchy_t *hierarchy, const char *text, const usaa_objects_t *objects)
+{
+    usaa_hierarchy_children_t children = { NULL, 0, 0 };
+    usaa_hierarchy_node_t *nodes;
+    int64_t *fathers = NULL;
+    size_t capacity = 16;
+    size_t count = 0;
+    size_t i;
+    uint32_t node;
+    int error = USAA_EOK;
+
+    memset(hierarchy, 0, sizeof(usaa_hierarchy_t));
+    hierarchy->first_root = USAA_HIERARCHY_NONE;
+    for (i = 0; i < objects->count; i++) {
+        if (usaa_class_is_a(objects->start[i].class_id, USAA_TRANSFORM))
+            count++;
+    }
+    if (count >= USAA_HIERARCHY_NONE)
+        return USAA_EMEMORY;
+
+    /* Two keys a node, the table at most half full. */
+    while (capacity < count * 4)
+        capacity *= 2;
+    hierarchy->nodes = (usaa_hierarchy_node_t *)malloc((count ? count : 1) * sizeof(usaa_hierarchy_node_t));
+    hierarchy->table = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+    hierarchy->mask = capacity - 1;
+    fathers = (int64_t *)calloc(count ? count : 1, sizeof(int64_t));
+    if (!hierarchy->nodes || !hierarchy->table || !fathers) {
+        error = USAA_EMEMORY;
+        goto cleanup;
+    }
+
+    /* One pass over the Transforms for their fields. */
+    nodes = hierarchy->nodes;
+    for (i = 0; i < objects->count && !error; i++) {
+        const usaa_object_t *object = objects->start + i;
+        usaa_hierarchy_node_t *current = nodes + hierarchy->count;
+
+        if (!usaa_class_is_a(object->class_id, USAA_TRANSFORM))
+            continue;
+        current->file_id = object->file_id;
+        current->game_object = 0;
+        current->object = i;
+        current->parent = USAA_HIERARCHY_NONE;
+        current->first_child = USAA_HIERARCHY_NONE;
+        current->next_sibling = USAA_HIERARCHY_NONE;
+        current->depth = 0;
+        error = usaa_hierarchy_parse_(current, (uint32_t)hierarchy->count, text + object->body,
+            text + object->offset + object->length, &children, fathers + hierarchy->count);
+        hierarchy->count++;
+    }
+    if (error)
+        goto cleanup;
+
+    /* The first node with a fileID keeps it. */
+    for (i = 0; i < hierarchy->count; i++) {
+        size_t slot = usaa_hierarchy_slot_(hierarchy, nodes[i].file_id);
+
+        if (!hierarchy->table[slot])
+            hierarchy->table[slot] = (uint32_t)i + 1;
+        if (nodes[i].game_object) {
+            slot = usaa_hierarchy_slot_(hierarchy, nodes[i].game_object);
+            if (!hierarchy->table[slot])
+                hierarchy->table[slot] = (uint32_t)i + 1;
+        }
+    }
+
+    /* The children are prepended, so the links go backwards to keep their
+     * order. The ones only `m_Father` knows go after the listed ones, the
+     * depth marks the listed ones meanwhile. */
+    for (i = 0; i < children.count; i++) {
+        node = usaa_hierarchy_transform_(hierarchy, children.start[i].file_id);
+        if (node != USAA_HIERARCHY_NONE)
+            nodes[node].depth = 1;
+    }
+    for (i = hierarchy->count; i-- > 0; ) {
+        if (!nodes[i].depth && fathers[i])
+            usaa_hierarchy_link_(hierarchy, usaa_hierarchy_transform_(hierarchy, fathers[i]), (uint32_t)i);
+    }
+    for (i = children.count; i-- > 0; ) {
+        usaa_hierarchy_link_(hierarchy, children.start[i].parent,
+            usaa_hierarchy_transform_(hierarchy, children.start[i].file_id));
+    }
+
+    for (i = hierarchy->count; i-- > 0; ) {
+        if (nodes[i].parent == USAA_HIERARCHY_NONE) {
+            nodes[i].next_sibling = hierarchy->first_root;
+            hierarchy->first_root = (uint32_t)i;
+        }
+    }
+
+    /* Walk the trees depth first without a stack for the depths. */
+    node = hierarchy->first_root;
+    while (node != USAA_HIERARCHY_NONE) {
+        nodes[node].depth = nodes[node].parent == USAA_HIERARCHY_NONE ? 0 : nodes[nodes[node].parent].depth + 1;
+        if (nodes[node].first_child != USAA_HIERARCHY_NONE) {
+            node = nodes[node].first_child;
+            continue;
+        }
+        while (node != USAA_HIERARCHY_NONE && nodes[node].next_sibling == USAA_HIERARCHY_NONE)
+            node = nodes[node].parent;
+        if (node != USAA_HIERARCHY_NONE)
+            node = nodes[node].next_sibling;
+    }
+
+cleanup:
+    free(children.start);
+    free(fathers);
+    if (error)
+        usaa_hierarchy_destroy(hierarchy);
+    return error;
+}
+
+void usaa_hierarchy_destroy(usaa_hierarchy_t *hierarchy)
+{
+    free(hierarchy->nodes);
+    free(hierarchy->table);
+    memset(hierarchy, 0, sizeof(usaa_hierarchy_t));
+    hierarchy->first_root = USAA_HIERARCHY_NONE;
+}
+
+uint32_t usaa_hierarchy_find(const usaa_hierarchy_t *hierarchy, int64_t file_id)
+{
+    size_t slot;
+
+    /* fileID 0 is the null reference. */
+    if (!hierarchy->table || !file_id)
+        return USAA_HIERARCHY_NONE;
+    slot = usaa_hierarchy_slot_(hierarchy, file_id);
+    return hierarchy->table[slot] ? hierarchy->table[slot] - 1 : USAA_HIERARCHY_NONE;
+}
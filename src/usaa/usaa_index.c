@@ -0,0 +1,495 @@
+#include <stdio.h>
+
+#include "usaa_private.h"
+
+#define USAA_INDEX_MAGIC        "USAAIDX"
+#define USAA_INDEX_BYTE_ORDER   0x01020304
+
+/* The start of an index file, followed by the files, the objects, the
+ * references and the strings.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t file_count;
+    uint64_t object_count;
+    uint64_t reference_count;
+    uint64_t strings_size;
+} usaa_index_header_t;
+
+typedef struct {
+    usaa_index_object_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_index_objects_t;
+
+typedef struct {
+    usaa_index_reference_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_index_references_t;
+
+/* What one thread extracted.
+ */
+typedef struct {
+    usaa_index_objects_t objects;
+    usaa_index_references_t references;
+} usaa_index_worker_t;
+
+/* Where the records of a file of the scan come from.
+ */
+typedef struct {
+    const usaa_index_file_t *old;
+    uint64_t hash;
+    int worker;                 /* -1 if the records of the old index are kept. */
+    size_t objects;
+    size_t object_count;
+    size_t references;
+    size_t reference_count;
+} usaa_index_entry_t;
+
+typedef struct {
+    const usaa_scan_t *scan;
+    usaa_index_entry_t *entries;
+    usaa_index_worker_t *workers;
+} usaa_index_updater_t;
+
+/* Hash the content of a file 8 bytes at a time.
+ */
+static uint64_t usaa_index_hash_(const char *data, size_t size)
+{
+    uint64_t hash = (uint64_t)size * 0x9E3779B97F4A7C15ULL;
+    uint64_t x;
+    size_t i;
+
+    for (i = 0; i + 8 <= size; i += 8) {
+        memcpy(&x, data + i, 8);
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 31;
+        hash = (hash ^ x) * 0x94D049BB133111EBULL;
+    }
+    if (i < size) {
+        x = 0;
+        memcpy(&x, data + i, size - i);
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 31;
+        hash = (hash ^ x) * 0x94D049BB133111EBULL;
+    }
+
+    hash ^= hash >> 32;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    return hash ^ (hash >> 29);
+}
+
+/* The bytes of an index with the given records.
+ */
+static size_t usaa_index_size_(size_t files, size_t objects, size_t references, size_t strings)
+{
+    return sizeof(usaa_index_header_t) + files * sizeof(usaa_index_file_t)
+        + objects * sizeof(usaa_index_object_t) + references * sizeof(usaa_index_reference_t) + strings;
+}
+
+/* Point the arrays of an index into a block laid out as the file, checking
+ * that it is one.
+ */
+static int usaa_index_attach_(usaa_index_t *index, const char *data, size_t size)
+{
+    const usaa_index_header_t *header = (const usaa_index_header_t *)data;
+    size_t i;
+
+    if (size < sizeof(usaa_index_header_t) || memcmp(header->magic, USAA_INDEX_MAGIC, 8)
+            || header->version != USAA_INDEX_VERSION || header->byte_order != USAA_INDEX_BYTE_ORDER
+            || header->file_count > UINT32_MAX || header->object_count > UINT32_MAX
+            || header->reference_count > UINT32_MAX || header->strings_size > UINT32_MAX
+            || usaa_index_size_((size_t)header->file_count, (size_t)header->object_count,
+                (size_t)header->reference_count, (size_t)header->strings_size) != size)
+        return USAA_EFORMAT;
+
+    index->count = (size_t)header->file_count;
+    index->object_count = (size_t)header->object_count;
+    index->reference_count = (size_t)header->reference_count;
+    index->strings_size = (size_t)header->strings_size;
+    index->files = (const usaa_index_file_t *)(header + 1);
+    index->objects = (const usaa_index_object_t *)(index->files + index->count);
+    index->references = (const usaa_index_reference_t *)(index->objects + index->object_count);
+    index->strings = (const char *)(index->references + index->reference_count);
+    index->size = size;
+
+    /* The ranges are trusted from here on. */
+    for (i = 0; i < index->count; i++) {
+        const usaa_index_file_t *file = index->files + i;
+
+        if ((uint64_t)file->path + file->path_length >= index->strings_size
+                || index->strings[file->path + file->path_length]
+                || (uint64_t)file->objects + file->object_count > index->object_count
+                || (uint64_t)file->references + file->reference_count > index->reference_count)
+            return USAA_EFORMAT;
+    }
+    return USAA_EOK;
+}
+
+int usaa_index_load(usaa_index_t *index, const char *path)
+{
+    int error;
+
+    memset(index, 0, sizeof(usaa_index_t));
+    error = usaa_map_open(&index->map, path);
+    if (error)
+        return error;
+
+    error = usaa_index_attach_(index, index->map.data, index->map.size);
+    if (error)
+        usaa_index_destroy(index);
+    return error;
+}
+
+const usaa_index_file_t *usaa_index_find(const usaa_index_t *index, const char *path, size_t length)
+{
+    size_t low = 0;
+    size_t high = index->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        const usaa_index_file_t *file = index->files + middle;
+        int order = memcmp(index->strings + file->path, path,
+            file->path_length < length ? file->path_length : length);
+
+        if (!order)
+            order = file->path_length < length ? -1 : file->path_length > length;
+        if (!order)
+            return file;
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return NULL;
+}
+
+/* Extract the objects and references of a file unless its content did not change.
+ */
+static int usaa_index_visit_(void *data, int worker, const usaa_scan_file_t *file,
+        const char *text, const usaa_objects_t *objects)
+{
+    usaa_index_updater_t *updater = (usaa_index_updater_t *)data;
+    usaa_index_entry_t *entry = updater->entries + (file - updater->scan->files);
+    usaa_index_worker_t *records = updater->workers + worker;
+    size_t i;
+    int error;
+
+    entry->hash = usaa_index_hash_(text, (size_t)file->size);
+    if (entry->old && !entry->old->error && entry->old->size == file->size && entry->old->hash == entry->hash)
+        return USAA_EOK;
+
+    entry->worker = worker;
+    entry->objects = records->objects.count;
+    entry->object_count = objects->count;
+    entry->references = records->references.count;
+
+    USAA_ARRAY_RESERVE(&error, &records->objects, usaa_index_object_t, objects->count);
+    if (error)
+        return error;
+    for (i = 0; i < objects->count; i++) {
+        const usaa_object_t *object = objects->start + i;
+        usaa_index_object_t *record = records->objects.start + records->objects.count++;
+        const char *p = text + object->body;
+        const char *end = text + object->offset + object->length;
+        usaa_reference_t reference;
+
+        record->class_id = object->class_id;
+        record->stripped = object->stripped;
+        record->file_id = object->file_id;
+        record->offset = object->offset;
+        record->body = object->body;
+        record->length = object->length;
+
+        while (usaa_reference_next(&p, end, &reference)) {
+            usaa_index_reference_t *kept;
+
+            USAA_ARRAY_RESERVE(&error, &records->references, usaa_index_reference_t, 1);
+            if (error)
+                return error;
+            kept = records->references.start + records->references.count++;
+            kept->object = (uint32_t)i;
+            kept->type = reference.type;
+            kept->file_id = reference.file_id;
+            kept->guid = reference.guid;
+            kept->external = (uint32_t)reference.external;
+            kept->reserved = 0;
+        }
+    }
+    entry->reference_count = records->references.count - entry->references;
+    return USAA_EOK;
+}
+
+static int usaa_scan_file_path_compare_(const void *a, const void *b)
+{
+    return strcmp((*(const usaa_scan_file_t *const *)a)->asset->path,
+        (*(const usaa_scan_file_t *const *)b)->asset->path);
+}
+
+/* Lay a new index out in one block, the files in path order, taking the
+ * records kept from the previous index.
+ */
+static int usaa_index_assemble_(usaa_index_t *fresh, const usaa_index_t *previous,
+        const usaa_scan_t *scan, const usaa_index_updater_t *updater)
+{
+    const usaa_scan_file_t **order;
+    usaa_index_header_t *header;
+    size_t size;
+    size_t reused = 0;
+    size_t parsed = 0;
+    int changed = scan->count != previous->count;
+    usaa_index_file_t *files;
+    usaa_index_object_t *objects;
+    usaa_index_reference_t *references;
+    char *strings;
+    size_t object_count = 0;
+    size_t reference_count = 0;
+    size_t strings_size = 0;
+    size_t i;
+
+    order = (const usaa_scan_file_t **)malloc((scan->count + 1) * sizeof(usaa_scan_file_t *));
+    if (!order)
+        return USAA_EMEMORY;
+    for (i = 0; i < scan->count; i++) {
+        const usaa_index_entry_t *entry = updater->entries + i;
+
+        order[i] = scan->files + i;
+        if (entry->worker >= 0) {
+            object_count += entry->object_count;
+            reference_count += entry->reference_count;
+        }
+        else if (entry->old && !scan->files[i].error) {
+            object_count += entry->old->object_count;
+            reference_count += entry->old->reference_count;
+        }
+        strings_size += strlen(scan->files[i].asset->path) + 1;
+    }
+    qsort(order, scan->count, sizeof(usaa_scan_file_t *), usaa_scan_file_path_compare_);
+
+    size = usaa_index_size_(scan->count, object_count, reference_count, strings_size);
+    header = (usaa_index_header_t *)malloc(size);
+    if (!header) {
+        free(order);
+        return USAA_EMEMORY;
+    }
+
+    memset(header, 0, sizeof(usaa_index_header_t));
+    memcpy(header->magic, USAA_INDEX_MAGIC, 8);
+    header->version = USAA_INDEX_VERSION;
+    header->byte_order = USAA_INDEX_BYTE_ORDER;
+    header->file_count = scan->count;
+    header->object_count = object_count;
+    header->reference_count = reference_count;
+    header->strings_size = strings_size;
+    files = (usaa_index_file_t *)(header + 1);
+    objects = (usaa_index_object_t *)(files + scan->count);
+    references = (usaa_index_reference_t *)(objects + object_count);
+    strings = (char *)(references + reference_count);
+
+    object_count = 0;
+    reference_count = 0;
+    strings_size = 0;
+    for (i = 0; i < scan->count; i++) {
+        const usaa_scan_file_t *scanned = order[i];
+        const usaa_index_entry_t *entry = updater->entries + (scanned - scan->files);
+        usaa_index_file_t *file = files + i;
+        size_t length = strlen(scanned->asset->path);
+
+        memset(file, 0, sizeof(usaa_index_file_t));
+        file->mtime = scanned->mtime;
+        file->size = scanned->size;
+        file->guid = scanned->asset->guid;
+        file->path = (uint32_t)strings_size;
+        file->path_length = (uint32_t)length;
+        file->objects = (uint32_t)object_count;
+        file->references = (uint32_t)reference_count;
+        memcpy(strings + strings_size, scanned->asset->path, length + 1);
+        strings_size += length + 1;
+
+        if (entry->worker >= 0) {
+            const usaa_index_worker_t *records = updater->workers + entry->worker;
+
+            file->hash = entry->hash;
+            file->object_count = (uint32_t)entry->object_count;
+            file->reference_count = (uint32_t)entry->reference_count;
+            if (entry->object_count)
+                memcpy(objects + object_count, records->objects.start + entry->objects,
+                    entry->object_count * sizeof(usaa_index_object_t));
+            if (entry->reference_count)
+                memcpy(references + reference_count, records->references.start + entry->references,
+                    entry->reference_count * sizeof(usaa_index_reference_t));
+            parsed++;
+            changed = 1;
+        }
+        else if (entry->old && !scanned->error) {
+            file->hash = entry->old->hash;
+            file->error = entry->old->error;
+            file->object_count = entry->old->object_count;
+            file->reference_count = entry->old->reference_count;
+            memcpy(objects + object_count, previous->objects + entry->old->objects,
+                entry->old->object_count * sizeof(usaa_index_object_t));
+            memcpy(references + reference_count, previous->references + entry->old->references,
+                entry->old->reference_count * sizeof(usaa_index_reference_t));
+            reused++;
+            changed |= file->mtime != entry->old->mtime;
+        }
+        else {
+            file->error = scanned->error;
+            changed = 1;
+        }
+        object_count += file->object_count;
+        reference_count += file->reference_count;
+    }
+    free(order);
+
+    memset(fresh, 0, sizeof(usaa_index_t));
+    fresh->memory = header;
+    fresh->reused = reused;
+    fresh->parsed = parsed;
+    fresh->changed = changed;
+    if (usaa_index_attach_(fresh, (const char *)header, size)) {
+        usaa_index_destroy(fresh);
+        return USAA_EFAILD;
+    }
+    return USAA_EOK;
+}
+
+/* Check if the scan found anything the index does not already have.
+ */
+static int usaa_index_changed_(const usaa_index_t *index, const usaa_scan_t *scan,
+        const usaa_index_updater_t *updater)
+{
+    size_t i;
+
+    if (scan->count != index->count)
+        return 1;
+    for (i = 0; i < scan->count; i++) {
+        const usaa_index_entry_t *entry = updater->entries + i;
+
+        if (entry->worker >= 0 || !entry->old || scan->files[i].error
+                || entry->old->mtime != scan->files[i].mtime)
+            return 1;
+    }
+    return 0;
+}
+
+/* Scan the files of a scan that changed since the previous index.
+ */
+static int usaa_index_collect_(const usaa_index_t *previous, usaa_scan_t *scan, usaa_index_updater_t *updater)
+{
+    size_t i;
+
+    updater->scan = scan;
+    updater->entries = (usaa_index_entry_t *)calloc(scan->count + 1, sizeof(usaa_index_entry_t));
+    updater->workers = (usaa_index_worker_t *)calloc(scan->threads, sizeof(usaa_index_worker_t));
+    if (!updater->entries || !updater->workers)
+        return USAA_EMEMORY;
+
+    /* Files that kept their mtime and size are not even opened. Binary ones
+     * stay binary, only a read error is tried again. */
+    for (i = 0; i < scan->count; i++) {
+        usaa_scan_file_t *file = scan->files + i;
+        usaa_index_entry_t *entry = updater->entries + i;
+
+        entry->worker = -1;
+        entry->old = usaa_index_find(previous, file->asset->path, strlen(file->asset->path));
+        file->skip = entry->old && !file->error && entry->old->mtime == file->mtime
+            && entry->old->size == file->size && entry->old->error != USAA_EIO;
+    }
+
+    return usaa_scan_run(scan, usaa_index_visit_, updater);
+}
+
+static void usaa_index_release_(usaa_scan_t *scan, usaa_index_updater_t *updater)
+{
+    size_t i;
+    int w;
+
+    for (i = 0; i < scan->count; i++)
+        scan->files[i].skip = 0;
+    for (w = 0; updater->workers && w < scan->threads; w++) {
+        free(updater->workers[w].objects.start);
+        free(updater->workers[w].references.start);
+    }
+    free(updater->workers);
+    free(updater->entries);
+}
+
+int usaa_index_update(usaa_index_t *index, usaa_scan_t *scan)
+{
+    usaa_index_updater_t updater;
+    usaa_index_t fresh;
+    int error;
+
+    error = usaa_index_collect_(index, scan, &updater);
+    if (!error && !usaa_index_changed_(index, scan, &updater)) {
+        /* A warm rescan keeps the index as it is mapped. */
+        index->reused = scan->count;
+        index->parsed = 0;
+        index->changed = 0;
+    }
+    else if (!error) {
+        error = usaa_index_assemble_(&fresh, index, scan, &updater);
+        if (!error) {
+            usaa_index_destroy(index);
+            *index = fresh;
+        }
+    }
+    usaa_index_release_(scan, &updater);
+    return error;
+}
+
+int usaa_index_rebuild(usaa_index_t *index, const usaa_index_t *previous, usaa_scan_t *scan)
+{
+    usaa_index_updater_t updater;
+    int error;
+
+    memset(index, 0, sizeof(usaa_index_t));
+    error = usaa_index_collect_(previous, scan, &updater);
+    if (!error)
+        error = usaa_index_assemble_(index, previous, scan, &updater);
+    usaa_index_release_(scan, &updater);
+    return error;
+}
+
+int usaa_index_save(const usaa_index_t *index, const char *path)
+{
+    const void *data = index->memory ? index->memory : (const void *)index->map.data;
+    char temporary[USAA_PATH_MAX];
+    FILE *file;
+    int error = USAA_EOK;
+
+    if (!data || snprintf(temporary, sizeof(temporary), "%s.tmp", path) >= (int)sizeof(temporary))
+        return USAA_EIO;
+
+    /* Readers mapping the old file keep it until they close it. */
+    file = fopen(temporary, "wb");
+    if (!file)
+        return USAA_EIO;
+    if (fwrite(data, 1, index->size, file) != index->size)
+        error = USAA_EIO;
+    if (fclose(file))
+        error = USAA_EIO;
+
+#if defined(_WIN32) || defined(_WIN64)
+    if (!error && !MoveFileExA(temporary, path, MOVEFILE_REPLACE_EXISTING))
+        error = USAA_EIO;
+#else
+    if (!error && rename(temporary, path))
+        error = USAA_EIO;
+#endif
+    if (error)
+        remove(temporary);
+    return error;
+}
+
+void usaa_index_destroy(usaa_index_t *index)
+{
+    if (index->map.data)
+        usaa_map_close(&index->map);
+    free(index->memory);
+    memset(index, 0, sizeof(usaa_index_t));
+}
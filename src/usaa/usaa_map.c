@@ -0,0 +1,96 @@
+#include "usaa_private.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+int usaa_map_open(usaa_map_t *map, const char *path)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file;
+    HANDLE mapping;
+    LARGE_INTEGER size;
+
+    memset(map, 0, sizeof(usaa_map_t));
+
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return USAA_EIO;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return USAA_EIO;
+    }
+
+    /* Empty files cannot be mapped, there is nothing to read anyway. */
+    if (!size.QuadPart) {
+        CloseHandle(file);
+        map->data = "";
+        return USAA_EOK;
+    }
+
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping)
+        return USAA_EIO;
+    map->data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!map->data)
+        return USAA_EIO;
+
+    map->size = (size_t)size.QuadPart;
+    map->handle = (void *)map->data;
+    return USAA_EOK;
+#else
+    struct stat st;
+    void *data;
+    int fd;
+
+    memset(map, 0, sizeof(usaa_map_t));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return USAA_EIO;
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return USAA_EIO;
+    }
+
+    /* Empty files cannot be mapped, there is nothing to read anyway. */
+    if (!st.st_size) {
+        close(fd);
+        map->data = "";
+        return USAA_EOK;
+    }
+
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return USAA_EIO;
+
+    /* The text is read once from start to end. */
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    map->data = (const char *)data;
+    map->size = (size_t)st.st_size;
+    map->handle = data;
+    return USAA_EOK;
+#endif
+}
+
+void usaa_map_close(usaa_map_t *map)
+{
+    if (map->handle) {
+#if defined(_WIN32) || defined(_WIN64)
+        UnmapViewOfFile(map->handle);
+#else
+        munmap(map->handle, map->size);
+#endif
+    }
+    memset(map, 0, sizeof(usaa_map_t));
+}
@@ -0,0 +1,640 @@
+#include <stdio.h>
+
+#include "usaa_private.h"
+
+/* A prefab of the cache, resolved by the first thread asking for it.
+ */
+typedef struct usaa_prefab_s usaa_prefab_t;
+
+struct usaa_prefab_s {
+    usaa_guid_t guid;
+    int done;
+    int error;
+    usaa_map_t map;
+    usaa_resolved_t resolved;
+    usaa_prefab_t *waiting;     /* The prefab its resolution waits for, to break cycles. */
+    int nested;                 /* It turned out to nest itself while being resolved. */
+};
+
+struct usaa_prefab_cache_s {
+    const usaa_project_t *project;
+    usaa_mutex_t lock;
+    usaa_cond_t resolved;
+    usaa_prefab_t **table;      /* Open addressing by GUID. */
+    size_t count;
+    size_t mask;
+};
+
+/* A PrefabInstance of a text, its overrides and removals as ranges of the
+ * lists of the text.
+ */
+typedef struct {
+    int64_t file_id;
+    usaa_guid_t source;
+    int expanded;               /* `m_SourcePrefab` is given, the objects live in the source only. */
+    int legacy;                 /* `m_ParentPrefab` is given, the objects are copied in the text. */
+    size_t modifications;
+    size_t modification_count;
+    size_t removed;
+    size_t removed_count;
+} usaa_instance_t;
+
+/* An override of an instance and the source object it targets.
+ */
+typedef struct {
+    size_t object;
+    size_t order;
+} usaa_target_t;
+
+typedef struct {
+    usaa_resolved_object_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_resolved_objects_t;
+
+typedef struct {
+    usaa_modification_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_modifications_t;
+
+typedef struct {
+    usaa_instance_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_instances_t;
+
+typedef struct {
+    int64_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_removed_t;
+
+/* The lists of a text being resolved.
+ */
+typedef struct {
+    usaa_resolved_objects_t objects;
+    usaa_modifications_t modifications;
+    usaa_instances_t instances;
+    usaa_modifications_t overrides;
+    usaa_removed_t removed;
+} usaa_resolve_lists_t;
+
+/* Check if a line starts with a field, at the indentation Unity writes it with.
+ */
+#define USAA_PREFAB_FIELD(line, stop, name) \
+    ((size_t)((stop) - (line)) >= sizeof(name) - 1 && !memcmp((line), (name), sizeof(name) - 1))
+
+static int usaa_resolve_(usaa_resolved_t *resolved, usaa_prefab_cache_t *cache, const char *text,
+        const usaa_objects_t *objects, usaa_prefab_t *resolving);
+
+/* Spread a fileID over the bits of a hash.
+ */
+static size_t usaa_prefab_file_id_hash_(int64_t file_id)
+{
+    uint64_t hash = (uint64_t)file_id * 0x9E3779B97F4A7C15ULL;
+
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+    return (size_t)hash;
+}
+
+/* The reference on a line, zeroed if there is none.
+ */
+static void usaa_prefab_reference_(const char *line, const char *stop, usaa_reference_t *reference)
+{
+    if (!usaa_reference_next(&line, stop, reference))
+        memset(reference, 0, sizeof(usaa_reference_t));
+}
+
+/* Read a PrefabInstance: its source, overrides and removed objects.
+ */
+static int usaa_prefab_instance_(usaa_resolve_lists_t *lists, const usaa_object_t *object, const char *text)
+{
+    const char *end = text + object->offset + object->length;
+    usaa_modification_t *modification = NULL;
+    usaa_instance_t *instance;
+    usaa_reference_t reference;
+    const char *line;
+    int section = 0;            /* 1 in `m_Modifications`, 2 in the removed lists. */
+    int value = 0;              /* The value of the last override may go on. */
+    int error;
+
+    USAA_ARRAY_RESERVE(&error, &lists->instances, usaa_instance_t, 1);
+    if (error)
+        return error;
+    instance = lists->instances.start + lists->instances.count++;
+    memset(instance, 0, sizeof(usaa_instance_t));
+    instance->file_id = object->file_id;
+    instance->modifications = lists->overrides.count;
+    instance->removed = lists->removed.count;
+
+    for (line = text + object->body; line < end; ) {
+        const char *eol = (const char *)memchr(line, '\n', end - line);
+        const char *next = eol ? eol + 1 : end;
+        const char *stop = eol ? eol : end;
+
+        if (stop > line && stop[-1] == '\r')
+            stop--;
+
+        /* Multi-line scalars go on indented deeper than the fields of an override. */
+        if (value && (stop == line || USAA_PREFAB_FIELD(line, stop, "       "))) {
+            modification->value_length = stop - modification->value;
+            line = next;
+            continue;
+        }
+        value = 0;
+
+        if (section == 1 && USAA_PREFAB_FIELD(line, stop, "    - target: ")) {
+            USAA_ARRAY_RESERVE(&error, &lists->overrides, usaa_modification_t, 1);
+            if (error)
+                return error;
+            modification = lists->overrides.start + lists->overrides.count++;
+            memset(modification, 0, sizeof(usaa_modification_t));
+            usaa_prefab_reference_(line, stop, &modification->target);
+        }
+        else if (section == 1 && modification && USAA_PREFAB_FIELD(line, stop, "      propertyPath: ")) {
+            modification->property_path = line + 20;
+            modification->property_length = stop - modification->property_path;
+        }
+        else if (section == 1 && modification && USAA_PREFAB_FIELD(line, stop, "      value:")) {
+            modification->value = line + 12 < stop && line[12] == ' ' ? line + 13 : line + 12;
+            modification->value_length = stop - modification->value;
+            value = 1;
+        }
+        else if (section == 1 && modification && USAA_PREFAB_FIELD(line, stop, "      objectReference: ")) {
+            usaa_prefab_reference_(line, stop, &modification->object_reference);
+        }
+        else if (section == 2 && USAA_PREFAB_FIELD(line, stop, "    - ")) {
+            usaa_prefab_reference_(line, stop, &reference);
+            USAA_ARRAY_RESERVE(&error, &lists->removed, int64_t, 1);
+            if (error)
+                return error;
+            lists->removed.start[lists->removed.count++] = reference.file_id;
+        }
+        else if (USAA_PREFAB_FIELD(line, stop, "    m_Modifications:")) {
+            section = 1;
+        }
+        else if (USAA_PREFAB_FIELD(line, stop, "    m_RemovedComponents:")
+                || USAA_PREFAB_FIELD(line, stop, "    m_RemovedGameObjects:")) {
+            section = 2;
+        }
+        else if (USAA_PREFAB_FIELD(line, stop, "  m_SourcePrefab: ")) {
+            usaa_prefab_reference_(line, stop, &reference);
+            instance->source = reference.guid;
+            instance->expanded = reference.external;
+        }
+        else if (USAA_PREFAB_FIELD(line, stop, "  m_ParentPrefab: ")) {
+            usaa_prefab_reference_(line, stop, &reference);
+            instance->legacy = reference.external;
+        }
+        else if (!USAA_PREFAB_FIELD(line, stop, "      ")) {
+            section = 0;
+            modification = NULL;
+        }
+        line = next;
+    }
+
+    instance->modification_count = lists->overrides.count - instance->modifications;
+    instance->removed_count = lists->removed.count - instance->removed;
+    return USAA_EOK;
+}
+
+/* Sort the overrides of an instance by their target, keeping their order.
+ */
+static int usaa_target_compare_(const void *a, const void *b)
+{
+    const usaa_target_t *x = (const usaa_target_t *)a;
+    const usaa_target_t *y = (const usaa_target_t *)b;
+
+    if (x->object != y->object)
+        return x->object < y->object ? -1 : 1;
+    return x->order < y->order ? -1 : x->order > y->order;
+}
+
+/* Check if an instance removes an object of its source.
+ */
+static int usaa_instance_removes_(const usaa_resolve_lists_t *lists, const usaa_instance_t *instance,
+        int64_t file_id)
+{
+    size_t i;
+
+    for (i = instance->removed; i < instance->removed + instance->removed_count; i++) {
+        if (lists->removed.start[i] == file_id)
+            return 1;
+    }
+    return 0;
+}
+
+/* Bring in the objects of the source of an instance with their overrides,
+ * those of the source first.
+ */
+static int usaa_instance_expand_(usaa_resolve_lists_t *lists, const usaa_instance_t *instance,
+        const usaa_resolved_t *source)
+{
+    usaa_target_t *targets = NULL;
+    size_t count = 0;
+    size_t k = 0;
+    size_t i;
+    int error = USAA_EOK;
+
+    if (instance->modification_count) {
+        targets = (usaa_target_t *)malloc(instance->modification_count * sizeof(usaa_target_t));
+        if (!targets)
+            return USAA_EMEMORY;
+    }
+    for (i = 0; i < instance->modification_count; i++) {
+        const usaa_modification_t *modification = lists->overrides.start + instance->modifications + i;
+        const usaa_resolved_object_t *object = usaa_resolved_find(source, modification->target.file_id);
+
+        if (!object)
+            continue;
+        targets[count].object = object - source->objects;
+        targets[count++].order = i;
+    }
+    if (count > 1)
+        qsort(targets, count, sizeof(usaa_target_t), usaa_target_compare_);
+
+    for (i = 0; i < source->count; i++) {
+        const usaa_resolved_object_t *from = source->objects + i;
+        usaa_resolved_object_t *object;
+        size_t last = k;
+
+        while (last < count && targets[last].object == i)
+            last++;
+        if (usaa_instance_removes_(lists, instance, from->file_id)) {
+            k = last;
+            continue;
+        }
+
+        USAA_ARRAY_RESERVE(&error, &lists->objects, usaa_resolved_object_t, 1);
+        if (!error)
+            USAA_ARRAY_RESERVE(&error, &lists->modifications, usaa_modification_t,
+                from->modification_count + last - k);
+        if (error)
+            break;
+
+        object = lists->objects.start + lists->objects.count++;
+        *object = *from;
+        object->file_id = (int64_t)(((uint64_t)instance->file_id ^ (uint64_t)from->file_id) & INT64_MAX);
+        object->instance = instance->file_id;
+        object->modifications = lists->modifications.count;
+        if (from->modification_count) {
+            memcpy(lists->modifications.start + lists->modifications.count,
+                source->modifications + from->modifications, from->modification_count * sizeof(usaa_modification_t));
+            lists->modifications.count += from->modification_count;
+        }
+        for (; k < last; k++)
+            lists->modifications.start[lists->modifications.count++] =
+                lists->overrides.start[instance->modifications + targets[k].order];
+        object->modification_count = lists->modifications.count - object->modifications;
+    }
+
+    free(targets);
+    return error;
+}
+
+/* Find the slot of a GUID in the table of a cache.
+ */
+static size_t usaa_prefab_slot_(const usaa_prefab_cache_t *cache, const usaa_guid_t *guid)
+{
+    size_t slot = usaa_guid_hash(guid) & cache->mask;
+
+    while (cache->table[slot] && !USAA_GUID_EQUAL(&cache->table[slot]->guid, guid))
+        slot = (slot + 1) & cache->mask;
+    return slot;
+}
+
+/* Add a prefab to be resolved to a cache, under its lock.
+ */
+static int usaa_prefab_insert_(usaa_prefab_cache_t *cache, const usaa_guid_t *guid, usaa_prefab_t **prefab)
+{
+    size_t i;
+
+    /* Keep the table at most half full. */
+    if ((cache->count + 1) * 2 > cache->mask + 1) {
+        size_t capacity = (cache->mask + 1) * 2;
+        usaa_prefab_t **old = cache->table;
+        size_t mask = cache->mask;
+
+        cache->table = (usaa_prefab_t **)calloc(capacity, sizeof(usaa_prefab_t *));
+        if (!cache->table) {
+            cache->table = old;
+            return USAA_EMEMORY;
+        }
+        cache->mask = capacity - 1;
+        for (i = 0; i <= mask; i++) {
+            if (old[i])
+                cache->table[usaa_prefab_slot_(cache, &old[i]->guid)] = old[i];
+        }
+        free(old);
+    }
+
+    *prefab = (usaa_prefab_t *)calloc(1, sizeof(usaa_prefab_t));
+    if (!*prefab)
+        return USAA_EMEMORY;
+    (*prefab)->guid = *guid;
+    cache->table[usaa_prefab_slot_(cache, guid)] = *prefab;
+    cache->count++;
+    return USAA_EOK;
+}
+
+/* Read and resolve a prefab, without the lock of the cache.
+ */
+static int usaa_prefab_load_(usaa_prefab_cache_t *cache, usaa_prefab_t *prefab)
+{
+    const usaa_asset_t *asset = usaa_project_find(cache->project, &prefab->guid);
+    usaa_objects_t objects = { NULL, 0, 0 };
+    char path[USAA_PATH_MAX];
+    int error;
+
+    if (!asset || snprintf(path, sizeof(path), "%s/%s", cache->project->root, asset->path) >= (int)sizeof(path)
+            || usaa_map_open(&prefab->map, path))
+        return USAA_EIO;
+
+    error = usaa_objects_scan(&objects, prefab->map.data, prefab->map.size);
+    if (!error)
+        error = usaa_resolve_(&prefab->resolved, cache, prefab->map.data, &objects, prefab);
+    usaa_objects_destroy(&objects);
+    return error;
+}
+
+/* Get a prefab of a cache for the one being resolved, if any.
+ */
+static int usaa_prefab_get_(usaa_prefab_cache_t *cache, const usaa_guid_t *guid, usaa_prefab_t *resolving,
+        usaa_prefab_t **found)
+{
+    usaa_prefab_t *prefab;
+    int error;
+
+    usaa_mutex_lock(&cache->lock);
+    prefab = cache->table[usaa_prefab_slot_(cache, guid)];
+    if (!prefab) {
+        error = usaa_prefab_insert_(cache, guid, &prefab);
+        if (error) {
+            usaa_mutex_unlock(&cache->lock);
+            return error;
+        }
+        if (resolving)
+            resolving->waiting = prefab;
+        usaa_mutex_unlock(&cache->lock);
+
+        error = usaa_prefab_load_(cache, prefab);
+
+        usaa_mutex_lock(&cache->lock);
+        prefab->error = error;
+        prefab->done = 1;
+        if (resolving)
+            resolving->waiting = NULL;
+        usaa_cond_broadcast(&cache->resolved);
+    }
+    else if (!prefab->done) {
+        usaa_prefab_t *next;
+
+        /* Waiting for a prefab that waits, maybe through others, for the
+         * one being resolved would never end: it nests itself. */
+        for (next = prefab; next && next != resolving; next = next->waiting)
+            ;
+        if (resolving && next == resolving) {
+            for (next = prefab; next != resolving; next = next->waiting)
+                next->nested = 1;
+            resolving->nested = 1;
+            usaa_mutex_unlock(&cache->lock);
+            return USAA_EFORMAT;
+        }
+
+        if (resolving)
+            resolving->waiting = prefab;
+        while (!prefab->done)
+            usaa_cond_wait(&cache->resolved, &cache->lock);
+        if (resolving)
+            resolving->waiting = NULL;
+    }
+    error = prefab->error;
+    usaa_mutex_unlock(&cache->lock);
+
+    *found = prefab;
+    return error;
+}
+
+/* Check if a prefab being resolved is on a cycle of instances.
+ */
+static int usaa_prefab_nested_(usaa_prefab_cache_t *cache, const usaa_prefab_t *prefab)
+{
+    int nested;
+
+    usaa_mutex_lock(&cache->lock);
+    nested = prefab->nested;
+    usaa_mutex_unlock(&cache->lock);
+    return nested;
+}
+
+/* Index the resolved objects by fileID, the first one keeping it.
+ */
+static int usaa_resolved_hash_(usaa_resolved_t *resolved)
+{
+    size_t capacity = 16;
+    size_t i;
+
+    while (capacity < resolved->count * 2)
+        capacity *= 2;
+    resolved->table = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+    if (!resolved->table)
+        return USAA_EMEMORY;
+    resolved->mask = capacity - 1;
+
+    for (i = 0; i < resolved->count; i++) {
+        int64_t file_id = resolved->objects[i].file_id;
+        size_t slot = usaa_prefab_file_id_hash_(file_id) & resolved->mask;
+
+        while (resolved->table[slot] && resolved->objects[resolved->table[slot] - 1].file_id != file_id)
+            slot = (slot + 1) & resolved->mask;
+        if (!resolved->table[slot])
+            resolved->table[slot] = (uint32_t)i + 1;
+    }
+    return USAA_EOK;
+}
+
+static int usaa_resolve_(usaa_resolved_t *resolved, usaa_prefab_cache_t *cache, const char *text,
+        const usaa_objects_t *objects, usaa_prefab_t *resolving)
+{
+    usaa_resolve_lists_t lists;
+    size_t i;
+    int error = USAA_EOK;
+
+    memset(resolved, 0, sizeof(usaa_resolved_t));
+    memset(&lists, 0, sizeof(usaa_resolve_lists_t));
+
+    /* The stripped objects stand for the ones of the instances. */
+    for (i = 0; i < objects->count && !error; i++) {
+        const usaa_object_t *object = objects->start + i;
+        usaa_resolved_object_t *own;
+
+        if (object->stripped)
+            continue;
+        if (object->class_id == MSAA_PREFAB) {
+            error = usaa_prefab_instance_(&lists, object, text);
+            if (error)
+                break;
+        }
+
+        USAA_ARRAY_RESERVE(&error, &lists.objects, usaa_resolved_object_t, 1);
+        if (error)
+            break;
+        own = lists.objects.start + lists.objects.count++;
+        own->class_id = object->class_id;
+        own->file_id = object->file_id;
+        own->instance = 0;
+        own->text = text + object->offset;
+        own->length = object->length;
+        own->modifications = 0;
+        own->modification_count = 0;
+    }
+
+    for (i = 0; i < lists.instances.count && !error; i++) {
+        const usaa_instance_t *instance = lists.instances.start + i;
+        usaa_prefab_t *prefab;
+
+        /* Before 2018.3 the root of a prefab asset is a Prefab too, with no parent. */
+        if (instance->expanded || instance->legacy)
+            resolved->instances++;
+        if (!instance->expanded)
+            continue;
+
+        error = usaa_prefab_get_(cache, &instance->source, resolving, &prefab);
+        if (error == USAA_EMEMORY)
+            break;
+
+        /* A prefab nesting itself fails as a whole, the others only miss the instance. */
+        if (error && resolving && usaa_prefab_nested_(cache, resolving)) {
+            error = USAA_EFORMAT;
+            break;
+        }
+        if (error) {
+            error = USAA_EOK;
+            resolved->missing++;
+            continue;
+        }
+
+        resolved->instances += prefab->resolved.instances;
+        resolved->missing += prefab->resolved.missing;
+        error = usaa_instance_expand_(&lists, instance, &prefab->resolved);
+    }
+
+    if (!error && lists.objects.count >= UINT32_MAX)
+        error = USAA_EMEMORY;
+    if (!error) {
+        resolved->objects = lists.objects.start;
+        resolved->count = lists.objects.count;
+        resolved->modifications = lists.modifications.start;
+        resolved->modification_count = lists.modifications.count;
+        lists.objects.start = NULL;
+        lists.modifications.start = NULL;
+        error = usaa_resolved_hash_(resolved);
+    }
+
+    free(lists.objects.start);
+    free(lists.modifications.start);
+    free(lists.instances.start);
+    free(lists.overrides.start);
+    free(lists.removed.start);
+    if (error)
+        usaa_resolved_destroy(resolved);
+    return error;
+}
+
+int usaa_prefab_cache_create(usaa_prefab_cache_t **cache, const usaa_project_t *project)
+{
+    usaa_prefab_cache_t *self = (usaa_prefab_cache_t *)calloc(1, sizeof(usaa_prefab_cache_t));
+
+    *cache = NULL;
+    if (!self)
+        return USAA_EMEMORY;
+    self->table = (usaa_prefab_t **)calloc(16, sizeof(usaa_prefab_t *));
+    if (!self->table) {
+        free(self);
+        return USAA_EMEMORY;
+    }
+    self->mask = 15;
+    self->project = project;
+    usaa_mutex_init(&self->lock);
+    usaa_cond_init(&self->resolved);
+
+    *cache = self;
+    return USAA_EOK;
+}
+
+void usaa_prefab_cache_destroy(usaa_prefab_cache_t *cache)
+{
+    size_t i;
+
+    for (i = 0; i <= cache->mask; i++) {
+        usaa_prefab_t *prefab = cache->table[i];
+
+        if (!prefab)
+            continue;
+        usaa_resolved_destroy(&prefab->resolved);
+        usaa_map_close(&prefab->map);
+        free(prefab);
+    }
+    usaa_cond_destroy(&cache->resolved);
+    usaa_mutex_destroy(&cache->lock);
+    free(cache->table);
+    free(cache);
+}
+
+int usaa_prefab_cache_get(usaa_prefab_cache_t *cache, const usaa_guid_t *guid, const usaa_resolved_t **resolved)
+{
+    usaa_prefab_t *prefab;
+    int error = usaa_prefab_get_(cache, guid, NULL, &prefab);
+
+    *resolved = error ? NULL : &prefab->resolved;
+    return error;
+}
+
+int usaa_resolve(usaa_resolved_t *resolved, usaa_prefab_cache_t *cache, const char *text,
+        const usaa_objects_t *objects)
+{
+    return usaa_resolve_(resolved, cache, text, objects, NULL);
+}
+
+void usaa_resolved_destroy(usaa_resolved_t *resolved)
+{
+    free(resolved->objects);
+    free(resolved->modifications);
+    free(resolved->table);
+    memset(resolved, 0, sizeof(usaa_resolved_t));
+}
+
+const usaa_resolved_object_t *usaa_resolved_find(const usaa_resolved_t *resolved, int64_t file_id)
+{
+    size_t slot;
+
+    if (!resolved->table)
+        return NULL;
+    slot = usaa_prefab_file_id_hash_(file_id) & resolved->mask;
+    while (resolved->table[slot]) {
+        const usaa_resolved_object_t *object = resolved->objects + resolved->table[slot] - 1;
+
+        if (object->file_id == file_id)
+            return object;
+        slot = (slot + 1) & resolved->mask;
+    }
+    return NULL;
+}
+
+const usaa_modification_t *usaa_resolved_override(const usaa_resolved_t *resolved,
+        const usaa_resolved_object_t *object, const char *property_path, size_t length)
+{
+    size_t i;
+
+    /* The outer instances come last and win. */
+    for (i = object->modification_count; i-- > 0; ) {
+        const usaa_modification_t *modification = resolved->modifications + object->modifications + i;
+
+        if (modification->property_length == length && !memcmp(modification->property_path, property_path, length))
+            return modification;
+    }
+    return NULL;
+}
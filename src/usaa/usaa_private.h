@@ -0,0 +1,190 @@
+#ifndef BE_USAA_PRIVATE_H_
+#define BE_USAA_PRIVATE_H_
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+#include "usaa.h"
+
+/** The longest path handled.
+ */
+#define USAA_PATH_MAX   4096
+
+/** Grow an array of `type` held as start/count/capacity so `extra` more items fit.
+ *  Sets `error` to USAA_EMEMORY on failure.
+ */
+#define USAA_ARRAY_RESERVE(error, array, type, extra) do { \
+    if ((array)->capacity - (array)->count < (size_t)(extra)) { \
+        size_t capacity_ = (array)->capacity ? (array)->capacity : 64; \
+        type *start_; \
+        while (capacity_ - (array)->count < (size_t)(extra)) \
+            capacity_ *= 2; \
+        start_ = (type *)realloc((array)->start, capacity_ * sizeof(type)); \
+        if (!start_) { \
+            *(error) = USAA_EMEMORY; \
+            break; \
+        } \
+        (array)->start = start_; \
+        (array)->capacity = capacity_; \
+    } \
+    *(error) = USAA_EOK; \
+} while (0)
+
+/** Parse an optionally negative decimal number, leaving `pointer` after it.
+ *  Returns 0 if no digit is found.
+ */
+int usaa_parse_int64(const char **pointer, const char *end, int64_t *value);
+
+/** Spread a GUID over the bits of a hash.
+ */
+size_t usaa_guid_hash(const usaa_guid_t *guid);
+
+/** Threads, locks and condition variables.
+ */
+#if defined(_WIN32) || defined(_WIN64)
+typedef HANDLE usaa_thread_t;
+typedef CRITICAL_SECTION usaa_mutex_t;
+typedef CONDITION_VARIABLE usaa_cond_t;
+
+# define usaa_mutex_init(mutex)         InitializeCriticalSection(mutex)
+# define usaa_mutex_destroy(mutex)      DeleteCriticalSection(mutex)
+# define usaa_mutex_lock(mutex)         EnterCriticalSection(mutex)
+# define usaa_mutex_unlock(mutex)       LeaveCriticalSection(mutex)
+# define usaa_cond_init(cond)           InitializeConditionVariable(cond)
+# define usaa_cond_destroy(cond)        ((void)(cond))
+# define usaa_cond_wait(cond, mutex)    SleepConditionVariableCS((cond), (mutex), INFINITE)
+# define usaa_cond_signal(cond)         WakeConditionVariable(cond)
+# define usaa_cond_broadcast(cond)      WakeAllConditionVariable(cond)
+#else
+typedef pthread_t usaa_thread_t;
+typedef pthread_mutex_t usaa_mutex_t;
+typedef pthread_cond_t usaa_cond_t;
+
+# define usaa_mutex_init(mutex)         pthread_mutex_init((mutex), NULL)
+# define usaa_mutex_destroy(mutex)      pthread_mutex_destroy(mutex)
+# define usaa_mutex_lock(mutex)         pthread_mutex_lock(mutex)
+# define usaa_mutex_unlock(mutex)       pthread_mutex_unlock(mutex)
+# define usaa_cond_init(cond)           pthread_cond_init((cond), NULL)
+# define usaa_cond_destroy(cond)        pthread_cond_destroy(cond)
+# define usaa_cond_wait(cond, mutex)    pthread_cond_wait((cond), (mutex))
+# define usaa_cond_signal(cond)         pthread_cond_signal(cond)
+# define usaa_cond_broadcast(cond)      pthread_cond_broadcast(cond)
+#endif
+
+/** Atomic operations on uint64_t, sequentially consistent.
+ *  usaa_atomic_cas() returns non-zero if `*pointer` was `expected` and is now `desired`.
+ */
+#if defined(_MSC_VER)
+# define usaa_atomic_load(pointer) \
+    ((uint64_t)InterlockedCompareExchange64((volatile LONG64 *)(pointer), 0, 0))
+# define usaa_atomic_add(pointer, value) \
+    ((uint64_t)InterlockedExchangeAdd64((volatile LONG64 *)(pointer), (LONG64)(value)))
+# define usaa_atomic_cas(pointer, expected, desired) \
+    (InterlockedCompareExchange64((volatile LONG64 *)(pointer), (LONG64)(desired), (LONG64)(expected)) \
+        == (LONG64)(expected))
+#else
+# define usaa_atomic_load(pointer)      __atomic_load_n((pointer), __ATOMIC_SEQ_CST)
+# define usaa_atomic_add(pointer, value) __atomic_fetch_add((pointer), (value), __ATOMIC_SEQ_CST)
+# define usaa_atomic_cas(pointer, expected, desired) \
+    __sync_bool_compare_and_swap((pointer), (expected), (desired))
+#endif
+
+/** Start a thread running `run(data)`.
+ *  Returns USAA_EOK or USAA_EFAILD.
+ */
+int usaa_thread_start(usaa_thread_t *thread, void (*run)(void *data), void *data);
+
+/** Wait for a thread to end.
+ */
+void usaa_thread_join(usaa_thread_t thread);
+
+/** The number of threads to use for `threads`, the processors if not positive.
+ */
+int usaa_thread_count(int threads);
+
+/** Run `run(data)` on `threads` threads, the caller being one of them.
+ *  Falls back to fewer threads if some cannot be started.
+ */
+void usaa_thread_run(int threads, void (*run)(void *data), void *data);
+
+/** A directory being listed.
+ */
+typedef struct usaa_dir_s usaa_dir_t;
+
+/** Open a directory for listing.
+ *  Returns NULL if it cannot be opened.
+ */
+usaa_dir_t *usaa_dir_open(const char *path);
+
+/** The next entry of a directory, without "." and "..", or NULL at the end.
+ *  `is_dir` tells if the entry is a directory.
+ */
+const char *usaa_dir_next(usaa_dir_t *dir, const char *path, int *is_dir);
+
+/** Close a directory.
+ */
+void usaa_dir_close(usaa_dir_t *dir);
+
+/** Read up to `size` bytes from the start of a file.
+ *  Returns the bytes read, or -1 if the file cannot be read.
+ */
+long usaa_read_head(const char *path, char *buffer, size_t size);
+
+/** Read up to `size` bytes from the end of a file.
+ *  Returns the bytes read, or -1 if the file cannot be read.
+ */
+long usaa_read_tail(const char *path, char *buffer, size_t size);
+
+/** Get the size of a file and the time of its last change in nanoseconds.
+ *  Returns USAA_EOK, or USAA_EIO if the file cannot be found.
+ */
+int usaa_file_stat(const char *path, uint64_t *size, uint64_t *mtime);
+
+/** Check if Unity skips an entry of the Assets tree: hidden or ending in '~'.
+ */
+#define USAA_IS_IGNORED(name) \
+    ((name)[0] == '.' || (name)[strlen(name) - 1] == '~')
+
+/** A block of strings allocated together and freed at once.
+ */
+struct usaa_arena_s {
+    struct usaa_arena_s *next;
+    size_t used;
+    size_t size;
+    char data[1];
+};
+
+/** Copy `length` bytes and a NUL into an arena.
+ *  Returns NULL if memory runs out.
+ */
+char *usaa_arena_strndup(usaa_arena_t **arena, const char *string, size_t length);
+
+/** Move the blocks of an arena in front of another one.
+ */
+void usaa_arena_splice(usaa_arena_t **arena, usaa_arena_t **blocks);
+
+/** Free an arena.
+ */
+void usaa_arena_destroy(usaa_arena_t **arena);
+
+/** A directory of a project whose listing changed, and the ones under it if `deep`.
+ */
+typedef struct {
+    const char *path;       /* From the project root, '/' separated. */
+    int deep;
+} usaa_change_t;
+
+/** Index the assets of a project again from a previous index, listing only
+ *  the changed directories and keeping the other assets as they were.
+ *  Returns USAA_EOK, USAA_EIO if there is no Assets folder anymore, or USAA_EMEMORY.
+ */
+int usaa_project_refresh(usaa_project_t *project, const usaa_project_t *previous,
+        const usaa_change_t *changes, size_t count, int threads);
+
+#endif /* !BE_USAA_PRIVATE_H_ */
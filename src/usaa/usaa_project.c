@@ -0,0 +1,565 @@
+#include <stdio.h>
+
+#include "usaa_private.h"
+
+/* The bytes of a .meta file read to find the GUID and the importer.
+ */
+#define USAA_META_HEAD  4096
+
+typedef struct {
+    usaa_asset_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_assets_t;
+
+typedef struct {
+    char **start;
+    size_t count;
+    size_t capacity;
+} usaa_dirs_t;
+
+/* The directory walk shared by the threads.
+ */
+typedef struct {
+    const char *root;
+
+    usaa_mutex_t lock;
+    usaa_cond_t wake;
+    usaa_dirs_t dirs;       /* The directories to list, from the root. */
+    int busy;               /* The threads listing a directory. */
+    int error;
+
+    usaa_assets_t assets;
+    usaa_arena_t *strings;
+} usaa_walk_t;
+
+/* Find the GUID, the importer and whether this is a folder in the head of a .meta file.
+ */
+static int usaa_meta_parse_(const char *text, size_t size, usaa_asset_t *asset)
+{
+    const char *end = text + size;
+    const char *line = text;
+    int found = 0;
+
+    asset->importer = 0;
+    asset->folder = 0;
+
+    while (line < end) {
+        const char *eol = (const char *)memchr(line, '\n', end - line);
+        const char *stop = eol ? eol : end;
+
+        if (stop > line && stop[-1] == '\r')
+            stop--;
+
+        if (stop - line > 6 && !memcmp(line, "guid: ", 6)) {
+            if (usaa_guid_parse(&asset->guid, line + 6, stop - line - 6))
+                return USAA_EFORMAT;
+            found = 1;
+        }
+        else if (stop - line == 16 && !memcmp(line, "folderAsset: yes", 16)) {
+            asset->folder = 1;
+        }
+        else if (stop - line > 9 && stop[-1] == ':' && !memcmp(stop - 9, "Importer:", 9)) {
+            /* The importer settings come last, after the GUID. */
+            asset->importer = usaa_class_find(line, stop - line - 1);
+            break;
+        }
+
+        if (!eol)
+            break;
+        line = eol + 1;
+    }
+
+    return found ? USAA_EOK : USAA_EFORMAT;
+}
+
+/* Take a directory to list, waiting while others may still find some.
+ * Returns NULL when the walk is over.
+ */
+static char *usaa_walk_take_(usaa_walk_t *walk)
+{
+    char *dir = NULL;
+
+    usaa_mutex_lock(&walk->lock);
+    while (!walk->dirs.count && walk->busy && !walk->error)
+        usaa_cond_wait(&walk->wake, &walk->lock);
+    if (walk->dirs.count && !walk->error) {
+        dir = walk->dirs.start[--walk->dirs.count];
+        walk->busy++;
+    }
+    usaa_mutex_unlock(&walk->lock);
+    return dir;
+}
+
+/* Hand over the subdirectories found and the end of a listing.
+ */
+static void usaa_walk_give_(usaa_walk_t *walk, usaa_dirs_t *found, int error)
+{
+    size_t i;
+
+    usaa_mutex_lock(&walk->lock);
+    if (!error)
+        USAA_ARRAY_RESERVE(&error, &walk->dirs, char *, found->count);
+    if (error) {
+        walk->error = error;
+        for (i = 0; i < found->count; i++)
+            free(found->start[i]);
+    }
+    else if (found->count) {
+        memcpy(walk->dirs.start + walk->dirs.count, found->start, found->count * sizeof(char *));
+        walk->dirs.count += found->count;
+    }
+    found->count = 0;
+    walk->busy--;
+
+    /* Wake everyone when there is work for them or nothing left to wait for. */
+    if (walk->dirs.count || !walk->busy || walk->error)
+        usaa_cond_broadcast(&walk->wake);
+    usaa_mutex_unlock(&walk->lock);
+}
+
+/* List a directory, queueing its subdirectories if `found` is not NULL and
+ * reading its .meta files.
+ */
+static int usaa_walk_list_(usaa_walk_t *walk, const char *dir, usaa_dirs_t *found,
+        usaa_assets_t *assets, usaa_arena_t **strings)
+{
+    char path[USAA_PATH_MAX];
+    char head[USAA_META_HEAD];
+    size_t dir_length = strlen(dir);
+    size_t root_length = strlen(walk->root);
+    usaa_dir_t *listing;
+    const char *name;
+    int is_dir;
+    int error = USAA_EOK;
+
+    if (root_length + dir_length + 2 >= sizeof(path))
+        return USAA_EOK;
+    memcpy(path, walk->root, root_length);
+    path[root_length] = '/';
+    memcpy(path + root_length + 1, dir, dir_length + 1);
+
+    listing = usaa_dir_open(path);
+    if (!listing)
+        return USAA_EOK;
+
+    while (!error && (name = usaa_dir_next(listing, path, &is_dir)) != NULL) {
+        size_t name_length = strlen(name);
+        size_t relative_length = dir_length + 1 + name_length;
+        usaa_asset_t asset;
+        char *relative;
+        long size;
+
+        if (USAA_IS_IGNORED(name) || root_length + 1 + relative_length >= sizeof(path))
+            continue;
+
+        if (is_dir) {
+            if (!found)
+                continue;
+            relative = (char *)malloc(relative_length + 1);
+            USAA_ARRAY_RESERVE(&error, found, char *, 1);
+            if (!relative || error) {
+                free(relative);
+                error = USAA_EMEMORY;
+                break;
+            }
+            memcpy(relative, dir, dir_length);
+            relative[dir_length] = '/';
+            memcpy(relative + dir_length + 1, name, name_length + 1);
+            found->start[found->count++] = relative;
+            continue;
+        }
+
+        if (name_length <= 5 || memcmp(name + name_length - 5, ".meta", 5))
+            continue;
+
+        /* Read the file through the path of the directory. */
+        path[root_length + 1 + dir_length] = '/';
+        memcpy(path + root_length + 1 + dir_length + 1, name, name_length + 1);
+        size = usaa_read_head(path, head, sizeof(head));
+        if (size >= 0 && !usaa_meta_parse_(head, (size_t)size, &asset)) {
+            USAA_ARRAY_RESERVE(&error, assets, usaa_asset_t, 1);
+            relative = error ? NULL : usaa_arena_strndup(strings, path + root_length + 1, relative_length - 5);
+            if (relative) {
+                asset.path = relative;
+                assets->start[assets->count++] = asset;
+            }
+            else {
+                error = USAA_EMEMORY;
+            }
+        }
+        path[root_length + 1 + dir_length] = '\0';
+    }
+
+    usaa_dir_close(listing);
+    return error;
+}
+
+static void usaa_walk_run_(void *data)
+{
+    usaa_walk_t *walk = (usaa_walk_t *)data;
+    usaa_assets_t assets = { NULL, 0, 0 };
+    usaa_dirs_t found = { NULL, 0, 0 };
+    usaa_arena_t *strings = NULL;
+    char *dir;
+    int error = USAA_EOK;
+
+    while ((dir = usaa_walk_take_(walk)) != NULL) {
+        error = usaa_walk_list_(walk, dir, &found, &assets, &strings);
+        free(dir);
+        usaa_walk_give_(walk, &found, error);
+    }
+
+    /* Add what this thread found to the whole. */
+    usaa_mutex_lock(&walk->lock);
+    if (!walk->error)
+        USAA_ARRAY_RESERVE(&walk->error, &walk->assets, usaa_asset_t, assets.count);
+    if (!walk->error && assets.count) {
+        memcpy(walk->assets.start + walk->assets.count, assets.start, assets.count * sizeof(usaa_asset_t));
+        walk->assets.count += assets.count;
+    }
+    usaa_arena_splice(&walk->strings, &strings);
+    usaa_mutex_unlock(&walk->lock);
+
+    free(assets.start);
+    free(found.start);
+}
+
+static int usaa_asset_compare_(const void *a, const void *b)
+{
+    return strcmp(((const usaa_asset_t *)a)->path, ((const usaa_asset_t *)b)->path);
+}
+
+/* Index the assets by GUID, dropping the ones whose GUID comes again.
+ */
+static int usaa_project_index_(usaa_project_t *project)
+{
+    size_t capacity = 16;
+    size_t count = 0;
+    size_t i;
+
+    while (capacity < project->count * 2)
+        capacity *= 2;
+    project->table = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+    if (!project->table)
+        return USAA_EMEMORY;
+    project->mask = capacity - 1;
+
+    for (i = 0; i < project->count; i++) {
+        const usaa_asset_t *asset = project->assets + i;
+        size_t slot = usaa_guid_hash(&asset->guid) & project->mask;
+
+        while (project->table[slot]
+                && !USAA_GUID_EQUAL(&project->assets[project->table[slot] - 1].guid, &asset->guid))
+            slot = (slot + 1) & project->mask;
+
+        if (project->table[slot]) {
+            project->duplicates++;
+            continue;
+        }
+        project->assets[count] = *asset;
+        project->table[slot] = (uint32_t)++count;
+    }
+
+    project->count = count;
+    return USAA_EOK;
+}
+
+/* Take the root of a project, checking it has an Assets folder.
+ */
+static int usaa_project_root_(usaa_project_t *project, const char *root)
+{
+    char path[USAA_PATH_MAX];
+    usaa_dir_t *assets;
+    size_t length = strlen(root);
+
+    while (length > 1 && (root[length - 1] == '/' || root[length - 1] == '\\'))
+        length--;
+    project->root = (char *)malloc(length + 1);
+    if (!project->root)
+        return USAA_EMEMORY;
+    memcpy(project->root, root, length);
+    project->root[length] = '\0';
+
+    /* Without an Assets folder this is no project. */
+    if (snprintf(path, sizeof(path), "%s/Assets", project->root) >= (int)sizeof(path)
+            || (assets = usaa_dir_open(path)) == NULL)
+        return USAA_EIO;
+    usaa_dir_close(assets);
+    return USAA_EOK;
+}
+
+/* Queue a directory for the walk.
+ */
+static int usaa_walk_push_(usaa_walk_t *walk, const char *dir)
+{
+    char *copy = (char *)malloc(strlen(dir) + 1);
+    int error;
+
+    USAA_ARRAY_RESERVE(&error, &walk->dirs, char *, 1);
+    if (!copy || error) {
+        free(copy);
+        return USAA_EMEMORY;
+    }
+    strcpy(copy, dir);
+    walk->dirs.start[walk->dirs.count++] = copy;
+    return USAA_EOK;
+}
+
+/* Walk the queued directories on `threads` threads, unless the walk failed
+ * already, and index what it found along with the assets it had.
+ */
+static int usaa_project_walk_(usaa_project_t *project, usaa_walk_t *walk, int threads)
+{
+    size_t i;
+    int error;
+
+    if (!walk->error && walk->dirs.count) {
+        usaa_mutex_init(&walk->lock);
+        usaa_cond_init(&walk->wake);
+        usaa_thread_run(threads, usaa_walk_run_, walk);
+        usaa_cond_destroy(&walk->wake);
+        usaa_mutex_destroy(&walk->lock);
+    }
+    error = walk->error;
+
+    /* A failed walk may leave directories behind. */
+    for (i = 0; i < walk->dirs.count; i++)
+        free(walk->dirs.start[i]);
+    free(walk->dirs.start);
+
+    project->assets = walk->assets.start;
+    project->count = walk->assets.count;
+    project->strings = walk->strings;
+
+    if (!error) {
+        qsort(project->assets, project->count, sizeof(usaa_asset_t), usaa_asset_compare_);
+        error = usaa_project_index_(project);
+    }
+    return error;
+}
+
+int usaa_project_open(usaa_project_t *project, const char *root, int threads)
+{
+    static const char *const tops[] = { "Packages", "Assets" };
+    usaa_walk_t walk;
+    size_t i;
+    int error;
+
+    memset(project, 0, sizeof(usaa_project_t));
+    error = usaa_project_root_(project, root);
+    if (error) {
+        usaa_project_destroy(project);
+        return error;
+    }
+
+    memset(&walk, 0, sizeof(usaa_walk_t));
+    walk.root = project->root;
+    for (i = 0; i < sizeof(tops) / sizeof(tops[0]) && !walk.error; i++)
+        walk.error = usaa_walk_push_(&walk, tops[i]);
+
+    error = usaa_project_walk_(project, &walk, threads);
+    if (error)
+        usaa_project_destroy(project);
+    return error;
+}
+
+/* Order paths by their components, so the ones under a directory come right
+ * after it.
+ */
+static int usaa_change_order_(const char *a, size_t a_length, const char *b, size_t b_length)
+{
+    size_t i;
+
+    for (i = 0; i < a_length && i < b_length; i++) {
+        if (a[i] != b[i]) {
+            int x = a[i] == '/' ? 0 : (unsigned char)a[i] + 1;
+            int y = b[i] == '/' ? 0 : (unsigned char)b[i] + 1;
+
+            return x - y;
+        }
+    }
+    return (a_length > b_length) - (a_length < b_length);
+}
+
+static int usaa_change_compare_(const void *a, const void *b)
+{
+    const usaa_change_t *x = (const usaa_change_t *)a;
+    const usaa_change_t *y = (const usaa_change_t *)b;
+    int order = usaa_change_order_(x->path, strlen(x->path), y->path, strlen(y->path));
+
+    /* The deep change of a directory first, it covers the other. */
+    return order ? order : y->deep - x->deep;
+}
+
+/* Check if a path is a directory or under it.
+ */
+static int usaa_change_within_(const char *path, const char *dir)
+{
+    size_t length = strlen(dir);
+
+    return !strncmp(path, dir, length) && (!path[length] || path[length] == '/');
+}
+
+/* Sort the changes and drop the ones another covers.
+ * Returns the number of changes left.
+ */
+static size_t usaa_change_merge_(usaa_change_t *changes, size_t count)
+{
+    const char *cover = NULL;
+    size_t kept = 0;
+    size_t i;
+
+    qsort(changes, count, sizeof(usaa_change_t), usaa_change_compare_);
+    for (i = 0; i < count; i++) {
+        if ((cover && usaa_change_within_(changes[i].path, cover))
+                || (kept && !strcmp(changes[kept - 1].path, changes[i].path)))
+            continue;
+        changes[kept++] = changes[i];
+        if (changes[i].deep)
+            cover = changes[i].path;
+    }
+    return kept;
+}
+
+/* Find the change of a directory, NULL if there is none.
+ */
+static const usaa_change_t *usaa_change_find_(const usaa_change_t *changes, size_t count,
+        const char *path, size_t length)
+{
+    size_t low = 0;
+    size_t high = count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        int order = usaa_change_order_(changes[middle].path, strlen(changes[middle].path), path, length);
+
+        if (!order)
+            return changes + middle;
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return NULL;
+}
+
+/* Check if the changes list the directory of an asset again.
+ */
+static int usaa_change_covers_(const usaa_change_t *changes, size_t count, const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    const char *end;
+
+    for (end = strchr(path, '/'); end; end = strchr(end + 1, '/')) {
+        const usaa_change_t *change = usaa_change_find_(changes, count, path, end - path);
+
+        if (change && (change->deep || end == slash))
+            return 1;
+    }
+    return 0;
+}
+
+int usaa_project_refresh(usaa_project_t *project, const usaa_project_t *previous,
+        const usaa_change_t *changes, size_t count, int threads)
+{
+    usaa_change_t *merged;
+    usaa_walk_t walk;
+    size_t i;
+    int error;
+
+    /* The assets left out for their GUID may be the ones to keep now. */
+    if (previous->duplicates)
+        return usaa_project_open(project, previous->root, threads);
+
+    memset(project, 0, sizeof(usaa_project_t));
+    error = usaa_project_root_(project, previous->root);
+    merged = (usaa_change_t *)malloc((count ? count : 1) * sizeof(usaa_change_t));
+    if (error || !merged) {
+        free(merged);
+        usaa_project_destroy(project);
+        return error ? error : USAA_EMEMORY;
+    }
+    memcpy(merged, changes, count * sizeof(usaa_change_t));
+    count = usaa_change_merge_(merged, count);
+
+    /* Keep the assets of the directories left alone, their strings with the new ones. */
+    memset(&walk, 0, sizeof(usaa_walk_t));
+    walk.root = project->root;
+    USAA_ARRAY_RESERVE(&walk.error, &walk.assets, usaa_asset_t, previous->count);
+    for (i = 0; i < previous->count && !walk.error; i++) {
+        usaa_asset_t asset = previous->assets[i];
+
+        if (usaa_change_covers_(merged, count, asset.path))
+            continue;
+        asset.path = usaa_arena_strndup(&walk.strings, asset.path, strlen(asset.path));
+        if (!asset.path)
+            walk.error = USAA_EMEMORY;
+        else
+            walk.assets.start[walk.assets.count++] = asset;
+    }
+
+    /* List the changed directories here, and walk the changed trees. */
+    for (i = 0; i < count && !walk.error; i++) {
+        if (merged[i].deep)
+            walk.error = usaa_walk_push_(&walk, merged[i].path);
+        else
+            walk.error = usaa_walk_list_(&walk, merged[i].path, NULL, &walk.assets, &walk.strings);
+    }
+    free(merged);
+
+    error = usaa_project_walk_(project, &walk, threads);
+    if (error)
+        usaa_project_destroy(project);
+    return error;
+}
+
+void usaa_project_destroy(usaa_project_t *project)
+{
+    free(project->root);
+    free(project->assets);
+    free(project->table);
+    usaa_arena_destroy(&project->strings);
+    memset(project, 0, sizeof(usaa_project_t));
+}
+
+const usaa_asset_t *usaa_project_find(const usaa_project_t *project, const usaa_guid_t *guid)
+{
+    size_t slot;
+
+    if (!project->table)
+        return NULL;
+
+    slot = usaa_guid_hash(guid) & project->mask;
+    while (project->table[slot]) {
+        const usaa_asset_t *asset = project->assets + project->table[slot] - 1;
+
+        if (USAA_GUID_EQUAL(&asset->guid, guid))
+            return asset;
+        slot = (slot + 1) & project->mask;
+    }
+    return NULL;
+}
+
+const usaa_asset_t *usaa_project_find_path(const usaa_project_t *project, const char *path, size_t length)
+{
+    size_t low = 0;
+    size_t high = project->count;
+
+    /* The assets are sorted by path with strcmp(). */
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        const char *other = project->assets[middle].path;
+        int order = strncmp(other, path, length);
+
+        if (!order)
+            order = other[length] ? 1 : 0;
+        if (!order)
+            return project->assets + middle;
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return NULL;
+}
@@ -0,0 +1,58 @@
+#include "usaa_private.h"
+
+/* A reference, up to the file id.
+ */
+#define USAA_REFERENCE          "{fileID: "
+#define USAA_REFERENCE_LENGTH   9
+
+/* Parse the rest of a reference after `{fileID: `.
+ * Returns the end of the reference, or NULL if this is not one.
+ */
+static const char *usaa_parse_reference_(const char *p, const char *end, usaa_reference_t *reference)
+{
+    int64_t type;
+
+    memset(reference, 0, sizeof(usaa_reference_t));
+    if (!usaa_parse_int64(&p, end, &reference->file_id))
+        return NULL;
+
+    if (end - p >= 8 + 32 && !memcmp(p, ", guid: ", 8)) {
+        if (usaa_guid_parse(&reference->guid, p + 8, 32))
+            return NULL;
+        reference->external = 1;
+        p += 8 + 32;
+    }
+    if (end - p >= 8 && !memcmp(p, ", type: ", 8)) {
+        p += 8;
+        if (!usaa_parse_int64(&p, end, &type))
+            return NULL;
+        reference->type = (int)type;
+    }
+
+    return p != end && *p == '}' ? p + 1 : NULL;
+}
+
+int usaa_reference_next(const char **pointer, const char *end, usaa_reference_t *reference)
+{
+    const char *p = *pointer;
+
+    /* Flow mappings are rare outside of references. */
+    while ((p = (const char *)memchr(p, '{', end - p)) != NULL) {
+        const char *next;
+
+        if (end - p < USAA_REFERENCE_LENGTH || memcmp(p, USAA_REFERENCE, USAA_REFERENCE_LENGTH)) {
+            p++;
+            continue;
+        }
+        next = usaa_parse_reference_(p + USAA_REFERENCE_LENGTH, end, reference);
+        if (!next) {
+            p++;
+            continue;
+        }
+        *pointer = next;
+        return 1;
+    }
+
+    *pointer = end;
+    return 0;
+}
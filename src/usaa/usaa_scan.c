@@ -0,0 +1,285 @@
+#include <stdio.h>
+
+#include "usaa_private.h"
+
+/* The files handed out at a time to get their sizes.
+ */
+#define USAA_SCAN_CHUNK     64
+
+/* The extensions of the assets Unity serializes as YAML in text mode.
+ */
+static const char *const usaa_scan_extensions_[] = {
+    "anim", "asset", "brush", "controller", "cubemap", "flare", "fontsettings",
+    "giparams", "guiskin", "lighting", "mask", "mat", "mixer", "overrideController",
+    "physicMaterial", "physicsMaterial2D", "playable", "prefab", "preset",
+    "renderTexture", "signal", "spriteatlas", "terrainlayer", "unity"
+};
+
+/* The files taken by one thread.
+ * `range` holds the first index of `order` not taken in its high half and
+ * the end in its low half, the owner takes from the front and the others
+ * steal from the back, both with a compare and swap.
+ */
+typedef struct {
+    uint64_t range;
+
+    uint64_t bytes;
+    uint64_t objects;
+    size_t failed;
+    size_t skipped;
+    int error;
+
+    /* Keep the ranges of two threads out of the same cache line. */
+    char padding[64];
+} usaa_scan_worker_t;
+
+typedef struct {
+    usaa_scan_t *scan;
+    usaa_scan_visit_t visit;
+    void *data;
+
+    uint32_t *order;
+    usaa_scan_worker_t *workers;
+    uint64_t next;
+} usaa_scan_pool_t;
+
+/* Check if an asset is scanned by its extension.
+ */
+static int usaa_scan_wants_(const usaa_asset_t *asset)
+{
+    const char *dot = strrchr(asset->path, '.');
+    size_t i;
+
+    if (asset->folder || !dot || strchr(dot, '/'))
+        return 0;
+    for (i = 0; i < sizeof(usaa_scan_extensions_) / sizeof(usaa_scan_extensions_[0]); i++) {
+        if (!strcmp(dot + 1, usaa_scan_extensions_[i]))
+            return 1;
+    }
+    return 0;
+}
+
+/* Write the full path of a file.
+ * Returns 0 if it does not fit.
+ */
+static int usaa_scan_path_(const usaa_scan_t *scan, const usaa_scan_file_t *file, char *path)
+{
+    return snprintf(path, USAA_PATH_MAX, "%s/%s", scan->project->root, file->asset->path) < USAA_PATH_MAX;
+}
+
+static void usaa_scan_size_run_(void *data)
+{
+    usaa_scan_pool_t *pool = (usaa_scan_pool_t *)data;
+    usaa_scan_t *scan = pool->scan;
+    char path[USAA_PATH_MAX];
+
+    for (;;) {
+        size_t first = (size_t)usaa_atomic_add(&pool->next, USAA_SCAN_CHUNK);
+        size_t i;
+
+        if (first >= scan->count)
+            break;
+        for (i = first; i < first + USAA_SCAN_CHUNK && i < scan->count; i++) {
+            usaa_scan_file_t *file = scan->files + i;
+
+            if (!usaa_scan_path_(scan, file, path) || usaa_file_stat(path, &file->size, &file->mtime))
+                file->error = USAA_EIO;
+        }
+    }
+}
+
+static int usaa_scan_file_compare_(const void *a, const void *b)
+{
+    const usaa_scan_file_t *x = (const usaa_scan_file_t *)a;
+    const usaa_scan_file_t *y = (const usaa_scan_file_t *)b;
+
+    if (x->size != y->size)
+        return x->size > y->size ? -1 : 1;
+    return strcmp(x->asset->path, y->asset->path);
+}
+
+int usaa_scan_init(usaa_scan_t *scan, const usaa_project_t *project, int threads)
+{
+    usaa_scan_pool_t pool;
+    size_t i;
+
+    memset(scan, 0, sizeof(usaa_scan_t));
+    scan->project = project;
+    scan->threads = usaa_thread_count(threads);
+
+    for (i = 0; i < project->count; i++)
+        scan->count += usaa_scan_wants_(project->assets + i);
+    if (!scan->count)
+        return USAA_EOK;
+
+    scan->files = (usaa_scan_file_t *)calloc(scan->count, sizeof(usaa_scan_file_t));
+    if (!scan->files)
+        return USAA_EMEMORY;
+    scan->count = 0;
+    for (i = 0; i < project->count; i++) {
+        if (usaa_scan_wants_(project->assets + i))
+            scan->files[scan->count++].asset = project->assets + i;
+    }
+
+    memset(&pool, 0, sizeof(usaa_scan_pool_t));
+    pool.scan = scan;
+    threads = (int)(scan->count / USAA_SCAN_CHUNK) + 1;
+    usaa_thread_run(threads < scan->threads ? threads : scan->threads, usaa_scan_size_run_, &pool);
+
+    qsort(scan->files, scan->count, sizeof(usaa_scan_file_t), usaa_scan_file_compare_);
+    return USAA_EOK;
+}
+
+/* Take a file from the front of a range, or steal one from its back.
+ * Returns -1 if the range is empty.
+ */
+static long usaa_scan_take_(usaa_scan_worker_t *worker, int steal)
+{
+    for (;;) {
+        uint64_t range = usaa_atomic_load(&worker->range);
+        uint32_t first = (uint32_t)(range >> 32);
+        uint32_t end = (uint32_t)range;
+
+        if (first >= end)
+            return -1;
+        if (!steal && usaa_atomic_cas(&worker->range, range, range + ((uint64_t)1 << 32)))
+            return first;
+        if (steal && usaa_atomic_cas(&worker->range, range, range - 1))
+            return end - 1;
+    }
+}
+
+/* Map and scan one file.
+ */
+static void usaa_scan_file_(usaa_scan_pool_t *pool, int index, usaa_scan_worker_t *worker,
+        usaa_scan_file_t *file, usaa_objects_t *objects)
+{
+    char path[USAA_PATH_MAX];
+    usaa_map_t map;
+
+    if (file->skip) {
+        worker->skipped++;
+        return;
+    }
+    if (file->error) {
+        worker->failed++;
+        return;
+    }
+    if (!usaa_scan_path_(pool->scan, file, path) || usaa_map_open(&map, path)) {
+        file->error = USAA_EIO;
+        worker->failed++;
+        return;
+    }
+
+    /* The size may have changed since it was taken, the mapping tells. */
+    file->size = map.size;
+
+    /* Assets serialized as binary have no YAML directive. */
+    if (map.size < 5 || memcmp(map.data, "%YAML", 5)) {
+        file->error = USAA_EFORMAT;
+    }
+    else {
+        objects->count = 0;
+        file->error = usaa_objects_scan(objects, map.data, map.size);
+        if (!file->error) {
+            file->objects = objects->count;
+            if (pool->visit)
+                file->error = pool->visit(pool->data, index, file, map.data, objects);
+        }
+        if (file->error == USAA_EMEMORY)
+            worker->error = USAA_EMEMORY;
+    }
+    usaa_map_close(&map);
+
+    if (file->error) {
+        worker->failed++;
+    }
+    else {
+        worker->bytes += file->size;
+        worker->objects += file->objects;
+    }
+}
+
+static void usaa_scan_run_(void *data)
+{
+    usaa_scan_pool_t *pool = (usaa_scan_pool_t *)data;
+    int threads = pool->scan->threads;
+    int index = (int)usaa_atomic_add(&pool->next, 1);
+    usaa_scan_worker_t *worker = pool->workers + index;
+    usaa_objects_t objects = { NULL, 0, 0 };
+
+    for (;;) {
+        long taken = usaa_scan_take_(worker, 0);
+        int tries;
+
+        /* Out of files, steal from the next thread that has some. No file is
+         * added on the way, so when all are empty the scan is over. */
+        for (tries = 1; taken < 0 && tries < threads; tries++)
+            taken = usaa_scan_take_(pool->workers + (index + tries) % threads, 1);
+        if (taken < 0)
+            break;
+
+        usaa_scan_file_(pool, index, worker, pool->scan->files + pool->order[taken], &objects);
+    }
+
+    usaa_objects_destroy(&objects);
+}
+
+int usaa_scan_run(usaa_scan_t *scan, usaa_scan_visit_t visit, void *data)
+{
+    usaa_scan_pool_t pool;
+    size_t first = 0;
+    size_t i;
+    int w;
+    int error = USAA_EOK;
+
+    if (!scan->count)
+        return USAA_EOK;
+
+    memset(&pool, 0, sizeof(usaa_scan_pool_t));
+    pool.scan = scan;
+    pool.visit = visit;
+    pool.data = data;
+    pool.order = (uint32_t *)malloc(scan->count * sizeof(uint32_t));
+    pool.workers = (usaa_scan_worker_t *)calloc(scan->threads, sizeof(usaa_scan_worker_t));
+    if (!pool.order || !pool.workers) {
+        free(pool.order);
+        free(pool.workers);
+        return USAA_EMEMORY;
+    }
+
+    /* Deal the files around so every thread starts with large ones. */
+    for (w = 0; w < scan->threads; w++) {
+        size_t last = first;
+
+        for (i = (size_t)w; i < scan->count; i += (size_t)scan->threads)
+            pool.order[last++] = (uint32_t)i;
+        pool.workers[w].range = ((uint64_t)first << 32) | last;
+        first = last;
+    }
+
+    usaa_thread_run(scan->threads, usaa_scan_run_, &pool);
+
+    scan->bytes = 0;
+    scan->objects = 0;
+    scan->failed = 0;
+    scan->skipped = 0;
+    for (w = 0; w < scan->threads; w++) {
+        scan->bytes += pool.workers[w].bytes;
+        scan->objects += pool.workers[w].objects;
+        scan->failed += pool.workers[w].failed;
+        scan->skipped += pool.workers[w].skipped;
+        if (pool.workers[w].error)
+            error = pool.workers[w].error;
+    }
+
+    free(pool.workers);
+    free(pool.order);
+    return error;
+}
+
+void usaa_scan_destroy(usaa_scan_t *scan)
+{
+    free(scan->files);
+    memset(scan, 0, sizeof(usaa_scan_t));
+}
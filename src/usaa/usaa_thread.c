@@ -0,0 +1,101 @@
+#include "usaa_private.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+# include <unistd.h>
+#endif
+
+/* What a new thread runs.
+ */
+typedef struct {
+    void (*run)(void *data);
+    void *data;
+} usaa_thread_start_t;
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI usaa_thread_main_(LPVOID data)
+#else
+static void *usaa_thread_main_(void *data)
+#endif
+{
+    usaa_thread_start_t start = *(usaa_thread_start_t *)data;
+
+    free(data);
+    start.run(start.data);
+#if defined(_WIN32) || defined(_WIN64)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+int usaa_thread_start(usaa_thread_t *thread, void (*run)(void *data), void *data)
+{
+    usaa_thread_start_t *start = (usaa_thread_start_t *)malloc(sizeof(usaa_thread_start_t));
+
+    if (!start)
+        return USAA_EMEMORY;
+    start->run = run;
+    start->data = data;
+
+#if defined(_WIN32) || defined(_WIN64)
+    *thread = CreateThread(NULL, 0, usaa_thread_main_, start, 0, NULL);
+    if (!*thread) {
+        free(start);
+        return USAA_EFAILD;
+    }
+#else
+    if (pthread_create(thread, NULL, usaa_thread_main_, start)) {
+        free(start);
+        return USAA_EFAILD;
+    }
+#endif
+    return USAA_EOK;
+}
+
+void usaa_thread_join(usaa_thread_t thread)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+int usaa_thread_count(int threads)
+{
+    if (threads > 0)
+        return threads;
+#if defined(_WIN32) || defined(_WIN64)
+    {
+        SYSTEM_INFO info;
+
+        GetSystemInfo(&info);
+        threads = (int)info.dwNumberOfProcessors;
+    }
+#else
+    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return threads > 0 ? threads : 1;
+}
+
+void usaa_thread_run(int threads, void (*run)(void *data), void *data)
+{
+    usaa_thread_t *handles = NULL;
+    int started = 0;
+    int i;
+
+    threads = usaa_thread_count(threads);
+    if (threads > 1)
+        handles = (usaa_thread_t *)malloc((threads - 1) * sizeof(usaa_thread_t));
+    for (i = 0; handles && i < threads - 1; i++) {
+        if (!usaa_thread_start(handles + started, run, data))
+            started++;
+    }
+
+    run(data);
+
+    for (i = 0; i < started; i++)
+        usaa_thread_join(handles[i]);
+    free(handles);
+}
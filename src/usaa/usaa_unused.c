@@ -0,0 +1,262 @@
+#include <stdio.h>
+
+#include "usaa_private.h"
+
+/* The bytes read from the end of a .meta file, where its AssetBundle is.
+ */
+#define USAA_META_TAIL      512
+
+/* The .meta files handed out at a time.
+ */
+#define USAA_UNUSED_CHUNK   64
+
+typedef struct {
+    uint32_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_unused_roots_t;
+
+typedef struct {
+    const usaa_project_t *project;
+    unsigned char *bundled;
+    uint64_t next;
+} usaa_unused_pool_t;
+
+/* Check if an asset lives in an Editor folder, left out of builds.
+ */
+static int usaa_is_editor_(const char *path)
+{
+    return strstr(path, "/Editor/") || strstr(path, "/Editor Default Resources/");
+}
+
+/* Check if an asset is reported when no root reaches it.
+ */
+static int usaa_unused_reported_(const usaa_asset_t *asset)
+{
+    return !asset->folder && !strncmp(asset->path, "Assets/", 7) && !usaa_is_editor_(asset->path)
+        && asset->importer != MSAA_MONO_IMPORTER && asset->importer != MSAA_PLUGIN_IMPORTER;
+}
+
+/* Check if the tail of a .meta file names an AssetBundle.
+ */
+static int usaa_meta_bundled_(const char *text, size_t size)
+{
+    const char *end = text + size;
+    const char *p = text;
+
+    while ((p = (const char *)memchr(p, 'a', end - p)) != NULL) {
+        if (end - p > 17 && !memcmp(p, "assetBundleName: ", 17) && (p == text || p[-1] == ' '))
+            return p[17] != '\n' && p[17] != '\r';
+        p++;
+    }
+    return 0;
+}
+
+static void usaa_unused_meta_run_(void *data)
+{
+    usaa_unused_pool_t *pool = (usaa_unused_pool_t *)data;
+    const usaa_project_t *project = pool->project;
+    char path[USAA_PATH_MAX];
+    char tail[USAA_META_TAIL];
+
+    for (;;) {
+        size_t first = (size_t)usaa_atomic_add(&pool->next, USAA_UNUSED_CHUNK);
+        size_t i;
+
+        if (first >= project->count)
+            break;
+        for (i = first; i < first + USAA_UNUSED_CHUNK && i < project->count; i++) {
+            long size;
+
+            if (snprintf(path, sizeof(path), "%s/%s.meta", project->root,
+                    project->assets[i].path) >= (int)sizeof(path))
+                continue;
+            size = usaa_read_tail(path, tail, sizeof(tail));
+            pool->bundled[i] = size > 0 && usaa_meta_bundled_(tail, (size_t)size);
+        }
+    }
+}
+
+/* Add the scenes enabled in the build settings to the roots.
+ */
+static int usaa_unused_scenes_(usaa_unused_t *unused, const usaa_graph_t *graph, usaa_unused_roots_t *roots)
+{
+    const usaa_project_t *project = graph->project;
+    char path[USAA_PATH_MAX];
+    usaa_map_t map;
+    const char *line;
+    const char *end;
+    int enabled = 0;
+    int found = 0;
+    int error = USAA_EOK;
+
+    if (snprintf(path, sizeof(path), "%s/ProjectSettings/EditorBuildSettings.asset", project->root)
+            >= (int)sizeof(path) || usaa_map_open(&map, path))
+        return USAA_EOK;
+
+    /* Each scene is `- enabled: 1`, then its path and, since 5.6, its guid. */
+    end = map.data + map.size;
+    for (line = map.data; line < end && !error; ) {
+        const char *eol = (const char *)memchr(line, '\n', end - line);
+        const char *stop = eol ? eol : end;
+        uint32_t node = USAA_GRAPH_NONE;
+        usaa_guid_t guid;
+
+        while (line < stop && *line == ' ')
+            line++;
+        if (stop > line && stop[-1] == '\r')
+            stop--;
+
+        if (stop - line > 11 && !memcmp(line, "- enabled: ", 11)) {
+            enabled = line[11] == '1';
+            found = 0;
+        }
+        else if (enabled && !found && stop - line > 6 && !memcmp(line, "path: ", 6)) {
+            const usaa_asset_t *asset = usaa_project_find_path(project, line + 6, stop - line - 6);
+
+            if (asset)
+                node = (uint32_t)(asset - project->assets);
+        }
+        else if (enabled && !found && stop - line > 6 && !memcmp(line, "guid: ", 6)
+                && !usaa_guid_parse(&guid, line + 6, stop - line - 6)) {
+            node = usaa_graph_find(graph, &guid);
+        }
+
+        if (node != USAA_GRAPH_NONE) {
+            USAA_ARRAY_RESERVE(&error, roots, uint32_t, 1);
+            if (!error) {
+                roots->start[roots->count++] = node;
+                unused->scenes++;
+                found = 1;
+            }
+        }
+        line = eol ? eol + 1 : end;
+    }
+
+    usaa_map_close(&map);
+    return error;
+}
+
+/* Check if a folder above an asset has an AssetBundle.
+ */
+static int usaa_in_bundled_folder_(const usaa_project_t *project, const unsigned char *bundled, const char *path)
+{
+    const char *slash = path;
+
+    while ((slash = strchr(slash + 1, '/')) != NULL) {
+        const usaa_asset_t *folder = usaa_project_find_path(project, path, slash - path);
+
+        if (folder && bundled[folder - project->assets])
+            return 1;
+    }
+    return 0;
+}
+
+static int usaa_unused_asset_compare_(const void *a, const void *b)
+{
+    const usaa_unused_asset_t *x = (const usaa_unused_asset_t *)a;
+    const usaa_unused_asset_t *y = (const usaa_unused_asset_t *)b;
+
+    if (x->size != y->size)
+        return x->size > y->size ? -1 : 1;
+    return strcmp(x->asset->path, y->asset->path);
+}
+
+int usaa_unused_find(usaa_unused_t *unused, const usaa_graph_t *graph, int threads)
+{
+    const usaa_project_t *project = graph->project;
+    usaa_unused_roots_t roots = { NULL, 0, 0 };
+    usaa_unused_pool_t pool;
+    uint64_t *reached = NULL;
+    char path[USAA_PATH_MAX];
+    int folders = 0;
+    size_t i;
+    int error = USAA_EOK;
+
+    memset(unused, 0, sizeof(usaa_unused_t));
+    threads = usaa_thread_count(threads);
+
+    memset(&pool, 0, sizeof(usaa_unused_pool_t));
+    pool.project = project;
+    pool.bundled = (unsigned char *)calloc(project->count + 1, 1);
+    reached = (uint64_t *)calloc(graph->count / 64 + 1, sizeof(uint64_t));
+    if (!pool.bundled || !reached) {
+        error = USAA_EMEMORY;
+        goto done;
+    }
+
+    /* The AssetBundle is at the end of the .meta file. */
+    usaa_thread_run(threads, usaa_unused_meta_run_, &pool);
+    for (i = 0; i < project->count; i++)
+        folders |= pool.bundled[i] && project->assets[i].folder;
+
+    error = usaa_unused_scenes_(unused, graph, &roots);
+    if (error)
+        goto done;
+
+    for (i = 0; i < project->count; i++) {
+        const usaa_asset_t *asset = project->assets + i;
+        int resource;
+        int bundle;
+
+        if (asset->folder || usaa_is_editor_(asset->path))
+            continue;
+        resource = strstr(asset->path, "/Resources/") != NULL;
+        bundle = pool.bundled[i] || (folders && usaa_in_bundled_folder_(project, pool.bundled, asset->path));
+        if (!resource && !bundle)
+            continue;
+
+        USAA_ARRAY_RESERVE(&error, &roots, uint32_t, 1);
+        if (error)
+            goto done;
+        roots.start[roots.count++] = (uint32_t)i;
+        unused->resources += resource;
+        unused->bundles += !resource;
+    }
+
+    error = usaa_graph_reach(graph, roots.start, roots.count, USAA_GRAPH_FORWARD, threads, reached);
+    if (error)
+        goto done;
+
+    for (i = 0; i < project->count; i++) {
+        if (reached[i >> 6] & ((uint64_t)1 << (i & 63)))
+            unused->reached++;
+    }
+    unused->assets = (usaa_unused_asset_t *)malloc((project->count - unused->reached + 1)
+        * sizeof(usaa_unused_asset_t));
+    if (!unused->assets) {
+        error = USAA_EMEMORY;
+        goto done;
+    }
+
+    for (i = 0; i < project->count; i++) {
+        const usaa_asset_t *asset = project->assets + i;
+        usaa_unused_asset_t *entry;
+        uint64_t mtime;
+
+        if ((reached[i >> 6] & ((uint64_t)1 << (i & 63))) || !usaa_unused_reported_(asset))
+            continue;
+
+        entry = unused->assets + unused->count++;
+        entry->asset = asset;
+        entry->size = 0;
+        if (snprintf(path, sizeof(path), "%s/%s", project->root, asset->path) < (int)sizeof(path))
+            usaa_file_stat(path, &entry->size, &mtime);
+        unused->bytes += entry->size;
+    }
+    qsort(unused->assets, unused->count, sizeof(usaa_unused_asset_t), usaa_unused_asset_compare_);
+
+done:
+    free(roots.start);
+    free(reached);
+    free(pool.bundled);
+    if (error)
+        usaa_unused_destroy(unused);
+    return error;
+}
+
+void usaa_unused_destroy(usaa_unused_t *unused)
+{
+    free(unused->assets);
+    memset(unused, 0, sizeof(usaa_unused_t));
+}
@@ -0,0 +1,442 @@
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "usaa_private.h"
+
+/* The events of the watched directories that change the analysis.
+ */
+#define USAA_WATCH_EVENTS   (IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO \
+    | IN_DELETE_SELF | IN_ONLYDIR)
+
+/* A refresh waits for quiet, but no more than this many debounce delays
+ * after the first change.
+ */
+#define USAA_WATCH_PATIENCE 10
+
+typedef struct {
+    usaa_change_t *start;
+    size_t count;
+    size_t capacity;
+} usaa_watch_changes_t;
+
+/* Snapshots are replaced read-copy-update style. Readers count themselves
+ * in the half of `readers` picked by the parity of `epoch`, and load
+ * `current`. A refresh publishes the new snapshot, flips the epoch and
+ * waits for the readers of the old parity, the only ones that may still
+ * hold the old snapshot, before freeing it.
+ */
+struct usaa_watch_s {
+    char *root;
+    char *index_path;
+    int threads;
+    int debounce;
+
+    int inotify;
+    int wake[2];
+    char **dirs;                /* The relative path of each watch descriptor. */
+    size_t dir_count;
+
+    usaa_watch_changes_t changes;   /* The directories to list again at the next refresh. */
+    usaa_arena_t *paths;            /* Their paths. */
+    int overflow;                   /* Events were lost, the next refresh walks the whole project. */
+
+    usaa_snapshot_t *current;
+    int dirty;                      /* A refresh changed the index since it was saved. */
+    uint64_t epoch;
+    uint64_t readers[2];
+};
+
+static uint64_t usaa_watch_now_(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+/* Watch a directory and the ones under it.
+ */
+static int usaa_watch_add_(usaa_watch_t *watch, const char *relative)
+{
+    char path[USAA_PATH_MAX];
+    usaa_dir_t *dir;
+    const char *name;
+    int is_dir;
+    int wd;
+    int error = USAA_EOK;
+
+    if (snprintf(path, sizeof(path), "%s/%s", watch->root, relative) >= (int)sizeof(path))
+        return USAA_EOK;
+    wd = inotify_add_watch(watch->inotify, path, USAA_WATCH_EVENTS);
+    if (wd < 0)
+        return errno == ENOMEM || errno == ENOSPC ? USAA_EMEMORY : USAA_EOK;
+
+    if ((size_t)wd >= watch->dir_count) {
+        size_t count = (size_t)wd * 2 + 16;
+        char **dirs = (char **)realloc(watch->dirs, count * sizeof(char *));
+
+        if (!dirs)
+            return USAA_EMEMORY;
+        memset(dirs + watch->dir_count, 0, (count - watch->dir_count) * sizeof(char *));
+        watch->dirs = dirs;
+        watch->dir_count = count;
+    }
+    free(watch->dirs[wd]);
+    watch->dirs[wd] = strdup(relative);
+    if (!watch->dirs[wd])
+        return USAA_EMEMORY;
+
+    dir = usaa_dir_open(path);
+    if (!dir)
+        return USAA_EOK;
+    while (!error && (name = usaa_dir_next(dir, path, &is_dir)) != NULL) {
+        char child[USAA_PATH_MAX];
+
+        if (!is_dir || USAA_IS_IGNORED(name)
+                || snprintf(child, sizeof(child), "%s/%s", relative, name) >= (int)sizeof(child))
+            continue;
+        error = usaa_watch_add_(watch, child);
+    }
+    usaa_dir_close(dir);
+    return error;
+}
+
+/* Stop watching a directory and the ones under it.
+ */
+static void usaa_watch_drop_(usaa_watch_t *watch, const char *relative)
+{
+    size_t length = strlen(relative);
+    size_t wd;
+
+    for (wd = 0; wd < watch->dir_count; wd++) {
+        const char *dir = watch->dirs[wd];
+
+        if (dir && !strncmp(dir, relative, length) && (!dir[length] || dir[length] == '/')) {
+            inotify_rm_watch(watch->inotify, (int)wd);
+            free(watch->dirs[wd]);
+            watch->dirs[wd] = NULL;
+        }
+    }
+}
+
+/* Note a directory, or an entry of it if `name` is not NULL, to list again.
+ * Running out of memory only makes the next refresh walk everything.
+ */
+static void usaa_watch_change_(usaa_watch_t *watch, const char *dir, const char *name, int deep)
+{
+    char path[USAA_PATH_MAX];
+    usaa_change_t *last = watch->changes.count ? watch->changes.start + watch->changes.count - 1 : NULL;
+    int length;
+    int error;
+
+    length = name ? snprintf(path, sizeof(path), "%s/%s", dir, name) : snprintf(path, sizeof(path), "%s", dir);
+    if (length >= (int)sizeof(path) || watch->overflow)
+        return;
+
+    /* Bursts tend to hit the same directory over and over. */
+    if (last && last->deep == deep && !strcmp(last->path, path))
+        return;
+
+    USAA_ARRAY_RESERVE(&error, &watch->changes, usaa_change_t, 1);
+    if (!error) {
+        last = watch->changes.start + watch->changes.count;
+        last->path = usaa_arena_strndup(&watch->paths, path, (size_t)length);
+        last->deep = deep;
+        if (last->path)
+            watch->changes.count++;
+    }
+    if (error || !last->path)
+        watch->overflow = 1;
+}
+
+/* Index the project again from the previous snapshot if there is one,
+ * listing the changed directories and reusing the records of the unchanged files.
+ */
+static int usaa_watch_snapshot_(usaa_watch_t *watch, const usaa_snapshot_t *previous,
+        const usaa_index_t *index, usaa_snapshot_t **snapshot)
+{
+    usaa_snapshot_t *fresh = (usaa_snapshot_t *)calloc(1, sizeof(usaa_snapshot_t));
+    usaa_scan_t scan;
+    int error;
+
+    if (!fresh)
+        return USAA_EMEMORY;
+
+    if (previous && !watch->overflow)
+        error = usaa_project_refresh(&fresh->project, &previous->project,
+            watch->changes.start, watch->changes.count, watch->threads);
+    else
+        error = usaa_project_open(&fresh->project, watch->root, watch->threads);
+    if (!error) {
+        error = usaa_scan_init(&scan, &fresh->project, watch->threads);
+        if (!error)
+            error = usaa_index_rebuild(&fresh->index, index, &scan);
+        usaa_scan_destroy(&scan);
+    }
+
+    /* The changes are done with, a failed refresh leaves the next one to walk everything. */
+    watch->changes.count = 0;
+    usaa_arena_destroy(&watch->paths);
+    watch->overflow = error != USAA_EOK;
+
+    if (!error)
+        error = usaa_graph_build_index(&fresh->graph, &fresh->project, &fresh->index);
+
+    if (error) {
+        usaa_graph_destroy(&fresh->graph);
+        usaa_index_destroy(&fresh->index);
+        usaa_project_destroy(&fresh->project);
+        free(fresh);
+        return error;
+    }
+    *snapshot = fresh;
+    return USAA_EOK;
+}
+
+static void usaa_snapshot_destroy_(usaa_snapshot_t *snapshot)
+{
+    usaa_graph_destroy(&snapshot->graph);
+    usaa_index_destroy(&snapshot->index);
+    usaa_project_destroy(&snapshot->project);
+    free(snapshot);
+}
+
+/* Publish a new snapshot and free the old one once nobody reads it.
+ */
+static void usaa_watch_publish_(usaa_watch_t *watch, usaa_snapshot_t *snapshot)
+{
+    usaa_snapshot_t *old = watch->current;
+    uint64_t epoch;
+
+    snapshot->generation = old->generation + 1;
+    (void)usaa_atomic_cas(&watch->current, old, snapshot);
+    epoch = usaa_atomic_add(&watch->epoch, 1);
+    while (usaa_atomic_load(&watch->readers[epoch & 1])) {
+        struct timespec pause = { 0, 100000 };
+
+        nanosleep(&pause, NULL);
+    }
+    usaa_snapshot_destroy_(old);
+}
+
+int usaa_watch_open(usaa_watch_t **watch, const char *root, const char *index_path,
+        int threads, int debounce)
+{
+    usaa_watch_t *self = (usaa_watch_t *)calloc(1, sizeof(usaa_watch_t));
+    usaa_index_t saved;
+    int error;
+
+    *watch = NULL;
+    if (!self)
+        return USAA_EMEMORY;
+    self->inotify = -1;
+    self->wake[0] = -1;
+    self->wake[1] = -1;
+    self->threads = threads;
+    self->debounce = debounce > 0 ? debounce : 1;
+    self->root = strdup(root);
+    self->index_path = index_path ? strdup(index_path) : NULL;
+    if (!self->root || (index_path && !self->index_path)) {
+        usaa_watch_close(self);
+        return USAA_EMEMORY;
+    }
+
+    /* Watch first, so no change made while indexing is missed. */
+    self->inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (self->inotify < 0 || pipe(self->wake)) {
+        usaa_watch_close(self);
+        return USAA_EFAILD;
+    }
+    error = usaa_watch_add_(self, "Assets");
+    if (!error)
+        error = usaa_watch_add_(self, "Packages");
+
+    memset(&saved, 0, sizeof(usaa_index_t));
+    if (!error && self->index_path)
+        usaa_index_load(&saved, self->index_path);
+    if (!error)
+        error = usaa_watch_snapshot_(self, NULL, &saved, &self->current);
+    usaa_index_destroy(&saved);
+
+    if (error) {
+        usaa_watch_close(self);
+        return error;
+    }
+    self->dirty = self->current->index.changed;
+    *watch = self;
+    return USAA_EOK;
+}
+
+/* Read the pending events, noting the directories to list again and
+ * following the ones created, moved and lost.
+ * Returns 1 if any event matters.
+ */
+static int usaa_watch_read_(usaa_watch_t *watch)
+{
+    char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int changed = 0;
+    ssize_t length;
+
+    while ((length = read(watch->inotify, buffer, sizeof(buffer))) > 0) {
+        const char *p = buffer;
+
+        while (p < buffer + length) {
+            const struct inotify_event *event = (const struct inotify_event *)p;
+            const char *dir;
+
+            p += sizeof(struct inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW) {
+                /* Directories may have come meanwhile, watch them all again. */
+                watch->overflow = 1;
+                usaa_watch_add_(watch, "Assets");
+                usaa_watch_add_(watch, "Packages");
+                changed = 1;
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                if ((size_t)event->wd < watch->dir_count) {
+                    free(watch->dirs[event->wd]);
+                    watch->dirs[event->wd] = NULL;
+                }
+                continue;
+            }
+
+            /* The watches dropped may still have events queued. */
+            dir = (size_t)event->wd < watch->dir_count ? watch->dirs[event->wd] : NULL;
+            if (!dir || (event->len && USAA_IS_IGNORED(event->name)))
+                continue;
+            changed = 1;
+
+            if (!event->len)
+                usaa_watch_change_(watch, dir, NULL, 1);
+            else if (event->mask & IN_ISDIR) {
+                char child[USAA_PATH_MAX];
+
+                usaa_watch_change_(watch, dir, event->name, 1);
+                if (snprintf(child, sizeof(child), "%s/%s", dir, event->name) >= (int)sizeof(child))
+                    continue;
+                if (event->mask & IN_MOVED_FROM)
+                    usaa_watch_drop_(watch, child);
+                else if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    usaa_watch_add_(watch, child);
+            }
+            else if (strlen(event->name) > 5 && !strcmp(event->name + strlen(event->name) - 5, ".meta"))
+                usaa_watch_change_(watch, dir, NULL, 0);
+        }
+    }
+    return changed;
+}
+
+int usaa_watch_run(usaa_watch_t *watch, usaa_watch_report_t report, void *data)
+{
+    uint64_t first = 0;
+    uint64_t last = 0;
+
+    for (;;) {
+        struct pollfd fds[2];
+        int timeout = -1;
+        uint64_t now;
+
+        if (last) {
+            uint64_t quiet = last + (uint64_t)watch->debounce;
+            uint64_t limit = first + (uint64_t)watch->debounce * USAA_WATCH_PATIENCE;
+            uint64_t due = quiet < limit ? quiet : limit;
+
+            now = usaa_watch_now_();
+            timeout = due > now ? (int)(due - now) : 0;
+        }
+
+        fds[0].fd = watch->inotify;
+        fds[0].events = POLLIN;
+        fds[1].fd = watch->wake[0];
+        fds[1].events = POLLIN;
+        if (poll(fds, 2, timeout) < 0 && errno != EINTR)
+            return USAA_EFAILD;
+        if (fds[1].revents)
+            break;
+
+        now = usaa_watch_now_();
+        if ((fds[0].revents & POLLIN) && usaa_watch_read_(watch)) {
+            if (!last)
+                first = now;
+            last = now;
+        }
+
+        /* A burst of changes is over, or went on too long. */
+        if (last && (now >= last + (uint64_t)watch->debounce
+                || now >= first + (uint64_t)watch->debounce * USAA_WATCH_PATIENCE)) {
+            usaa_snapshot_t *snapshot;
+            int error = usaa_watch_snapshot_(watch, watch->current, &watch->current->index, &snapshot);
+
+            if (!error) {
+                /* A refresh with nothing new does not make the earlier changes saved. */
+                watch->dirty |= snapshot->index.changed;
+                usaa_watch_publish_(watch, snapshot);
+            }
+            else if (report)
+                report(data, error);
+            first = 0;
+            last = 0;
+        }
+    }
+    return USAA_EOK;
+}
+
+void usaa_watch_stop(usaa_watch_t *watch)
+{
+    char byte = 0;
+
+    /* Only async-signal-safe calls here. */
+    if (write(watch->wake[1], &byte, 1) < 0)
+        return;
+}
+
+const usaa_snapshot_t *usaa_watch_acquire(usaa_watch_t *watch, int *ticket)
+{
+    for (;;) {
+        uint64_t epoch = usaa_atomic_load(&watch->epoch);
+
+        usaa_atomic_add(&watch->readers[epoch & 1], 1);
+        if (usaa_atomic_load(&watch->epoch) == epoch) {
+            *ticket = (int)(epoch & 1);
+            return (const usaa_snapshot_t *)usaa_atomic_load(&watch->current);
+        }
+
+        /* A refresh flipped the epoch meanwhile, count in the other half. */
+        usaa_atomic_add(&watch->readers[epoch & 1], (uint64_t)-1);
+    }
+}
+
+void usaa_watch_release(usaa_watch_t *watch, int ticket)
+{
+    usaa_atomic_add(&watch->readers[ticket & 1], (uint64_t)-1);
+}
+
+void usaa_watch_close(usaa_watch_t *watch)
+{
+    size_t i;
+
+    if (watch->current) {
+        if (watch->index_path && watch->dirty && !usaa_index_save(&watch->current->index, watch->index_path))
+            watch->dirty = 0;
+        usaa_snapshot_destroy_(watch->current);
+    }
+    for (i = 0; i < watch->dir_count; i++)
+        free(watch->dirs[i]);
+    free(watch->dirs);
+    free(watch->changes.start);
+    usaa_arena_destroy(&watch->paths);
+    if (watch->inotify >= 0)
+        close(watch->inotify);
+    if (watch->wake[0] >= 0)
+        close(watch->wake[0]);
+    if (watch->wake[1] >= 0)
+        close(watch->wake[1]);
+    free(watch->index_path);
+    free(watch->root);
+    free(watch);
+}
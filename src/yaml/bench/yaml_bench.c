@@ -0,0 +1,632 @@
+/* Throughput and allocations of the scan, parse, load and dump stages over
+ * generated corpora shaped like the Unity assets we read and write.
+ *
+ * Built with YAML_BENCH_LIBYAML, the same program runs against the upstream
+ * libyaml instead, whose symbols clash with ours, as the baseline to compare
+ * with.
+ */
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(_POSIX_C_SOURCE)
+# define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <yaml.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+/* The two libraries differ in names and in what success is.
+ */
+#if defined(YAML_BENCH_LIBYAML)
+# define YAML_BENCH_LIBRARY					"libyaml"
+# define YAML_BENCH_OK(result)				((result) == 1)
+# define yaml_bench_parser_init				yaml_parser_initialize
+# define yaml_bench_parser_destroy			yaml_parser_delete
+# define yaml_bench_emitter_init			yaml_emitter_initialize
+# define yaml_bench_emitter_destroy			yaml_emitter_delete
+# define yaml_bench_token_destroy			yaml_token_delete
+# define yaml_bench_event_destroy			yaml_event_delete
+# define yaml_bench_document_destroy		yaml_document_delete
+# define YAML_BENCH_TOKEN_STREAM_END		YAML_STREAM_END_TOKEN
+# define YAML_BENCH_EVENT_STREAM_END		YAML_STREAM_END_EVENT
+# define YAML_BENCH_UTF8					YAML_UTF8_ENCODING
+# define YAML_BENCH_UTF16LE					YAML_UTF16LE_ENCODING
+#else
+# define YAML_BENCH_LIBRARY					"yaml"
+# define YAML_BENCH_OK(result)				((result) == YAML_EOK)
+# define yaml_bench_parser_init				yaml_parser_init
+# define yaml_bench_parser_destroy			yaml_parser_destroy
+# define yaml_bench_emitter_init			yaml_emitter_init
+# define yaml_bench_emitter_destroy			yaml_emitter_destroy
+# define yaml_bench_token_destroy			yaml_token_destroy
+# define yaml_bench_event_destroy			yaml_event_destroy
+# define yaml_bench_document_destroy		yaml_document_destroy
+# define YAML_BENCH_TOKEN_STREAM_END		YAML_TOKEN_STREAM_END
+# define YAML_BENCH_EVENT_STREAM_END		YAML_EVENT_STREAM_END
+# define YAML_BENCH_UTF8					YAML_ENCODING_UTF8
+# define YAML_BENCH_UTF16LE					YAML_ENCODING_UTF16LE
+#endif
+
+/* Allocations are counted by standing in front of the C library allocator,
+ * which sees the calls of both libraries alike.
+ */
+#if defined(__GLIBC__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static size_t yaml_bench_allocations_;
+static size_t yaml_bench_allocated_;
+
+void *malloc(size_t size) {
+	yaml_bench_allocations_++;
+	yaml_bench_allocated_ += size;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+	yaml_bench_allocations_++;
+	yaml_bench_allocated_ += count * size;
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+	yaml_bench_allocations_++;
+	yaml_bench_allocated_ += size;
+	return __libc_realloc(ptr, size);
+}
+
+# define YAML_BENCH_COUNTS_ALLOCATIONS
+#endif
+
+/* A growable block of generated input or emitted output.
+ */
+typedef struct {
+	unsigned char *start;
+	size_t size;
+	size_t capacity;
+} yaml_bench_buffer_t;
+
+static void yaml_bench_reserve_(yaml_bench_buffer_t *buffer, size_t size) {
+	size_t capacity = buffer->capacity ? buffer->capacity : 65536;
+	unsigned char *start = NULL;
+
+	if (buffer->capacity - buffer->size >= size)
+		return;
+	while (capacity - buffer->size < size && capacity <= (size_t)-1 / 2)
+		capacity *= 2;
+
+	/* The block stays with the buffer if it cannot grow, so it is not lost. */
+	if (capacity - buffer->size >= size)
+		start = (unsigned char *)realloc(buffer->start, capacity);
+	if (!start) {
+		fprintf(stderr, "yaml_bench: out of memory\n");
+		free(buffer->start);
+		exit(EXIT_FAILURE);
+	}
+	buffer->start = start;
+	buffer->capacity = capacity;
+}
+
+static void yaml_bench_append_(yaml_bench_buffer_t *buffer, const void *data, size_t size) {
+	yaml_bench_reserve_(buffer, size);
+	memcpy(buffer->start + buffer->size, data, size);
+	buffer->size += size;
+}
+
+static void yaml_bench_printf_(yaml_bench_buffer_t *buffer, const char *format, ...) {
+	va_list args;
+	int length;
+
+	yaml_bench_reserve_(buffer, 256);
+	for (;;) {
+		size_t room = buffer->capacity - buffer->size;
+
+		va_start(args, format);
+		length = vsnprintf((char *)buffer->start + buffer->size, room, format, args);
+		va_end(args);
+		if (length >= 0 && (size_t)length < room)
+			break;
+		yaml_bench_reserve_(buffer, length >= 0 ? (size_t)length + 1 : room * 2 + 1);
+	}
+	buffer->size += length;
+}
+
+#if defined(YAML_BENCH_LIBYAML)
+static int yaml_bench_write_handler_(void *data, unsigned char *buffer, size_t size) {
+	yaml_bench_append_((yaml_bench_buffer_t *)data, buffer, size);
+	return 1;
+}
+#endif
+
+/**********************************************************************
+ * CORPORA
+ */
+
+/* Block mappings nested 32 deep, the shape of serialized component trees.
+ */
+static void yaml_bench_deep_(yaml_bench_buffer_t *buffer, size_t size) {
+	size_t n;
+
+	for (n = 0; buffer->size < size; n++) {
+		int depth;
+
+		yaml_bench_printf_(buffer, "root_%zu:\n", n);
+		for (depth = 1; depth <= 32; depth++) {
+			yaml_bench_printf_(buffer, "%*slevel_%d:\n", depth * 2, "", depth);
+			yaml_bench_printf_(buffer, "%*sname: node %zu.%d\n", depth * 2 + 2, "", n, depth);
+			yaml_bench_printf_(buffer, "%*senabled: %d\n", depth * 2 + 2, "", depth & 1);
+		}
+	}
+}
+
+/* Flow sequences of a hundred thousand items, like baked mesh and curve data.
+ */
+static void yaml_bench_flow_(yaml_bench_buffer_t *buffer, size_t size) {
+	size_t n;
+
+	for (n = 0; buffer->size < size; n++) {
+		int i;
+
+		yaml_bench_printf_(buffer, "m_Data_%zu: [", n);
+		for (i = 0; i < 100000 && buffer->size < size; i++) {
+			if (i)
+				yaml_bench_append_(buffer, i % 16 ? ", " : ",\n  ", i % 16 ? 2 : 4);
+			switch (i % 4) {
+			case 0: yaml_bench_printf_(buffer, "%d", i); break;
+			case 1: yaml_bench_printf_(buffer, "%d.%03d", i / 7, i % 1000); break;
+			case 2: yaml_bench_printf_(buffer, "vertex_%d", i); break;
+			default: yaml_bench_printf_(buffer, "{x: %d, y: -%d}", i, i); break;
+			}
+		}
+		yaml_bench_append_(buffer, "]\n", 2);
+	}
+}
+
+/* Long literal scalars, as shader sources and embedded scripts are stored.
+ */
+static void yaml_bench_literal_(yaml_bench_buffer_t *buffer, size_t size) {
+	size_t n;
+
+	for (n = 0; buffer->size < size; n++) {
+		int line;
+
+		yaml_bench_printf_(buffer, "m_Script_%zu: |\n", n);
+		for (line = 0; line < 256; line++) {
+			yaml_bench_printf_(buffer, "  float4 frag_%d(v2f i) : SV_Target { return tex2D(_MainTex, i.uv) * _Color%d; }\n",
+				line, line % 8);
+		}
+	}
+}
+
+/* A multi-document scene: a GameObject and its Transform per object, tagged
+ * with the !u! class ids and anchored by file id.
+ */
+static void yaml_bench_scene_(yaml_bench_buffer_t *buffer, size_t size) {
+	size_t n;
+
+	yaml_bench_printf_(buffer, "%%YAML 1.1\n%%TAG !u! tag:unity3d.com,2011:\n");
+	for (n = 0; buffer->size < size; n++) {
+		unsigned long long id = 100000 + n * 2;
+
+		/* Strict readers forget the !u! handle after each document, so it is
+		 * declared again, which wants an explicit end of the previous one. */
+		if (n)
+			yaml_bench_printf_(buffer, "...\n%%TAG !u! tag:unity3d.com,2011:\n");
+		yaml_bench_printf_(buffer,
+			"--- !u!1 &%llu\n"
+			"GameObject:\n"
+			"  m_ObjectHideFlags: 0\n"
+			"  m_CorrespondingSourceObject: {fileID: 0}\n"
+			"  m_PrefabInstance: {fileID: 0}\n"
+			"  m_PrefabAsset: {fileID: 0}\n"
+			"  serializedVersion: 6\n"
+			"  m_Component:\n"
+			"  - component: {fileID: %llu}\n"
+			"  m_Layer: 0\n"
+			"  m_Name: \"Obj\xC3\xA9t \xE5\xAF\xBE\xE8\xB1\xA1 %zu\"\n"
+			"  m_TagString: Untagged\n"
+			"  m_Icon: {fileID: 0}\n"
+			"  m_NavMeshLayer: 0\n"
+			"  m_StaticEditorFlags: 0\n"
+			"  m_IsActive: 1\n",
+			id, id + 1, n);
+		yaml_bench_printf_(buffer, "...\n%%TAG !u! tag:unity3d.com,2011:\n");
+		yaml_bench_printf_(buffer,
+			"--- !u!4 &%llu\n"
+			"Transform:\n"
+			"  m_ObjectHideFlags: 0\n"
+			"  m_GameObject: {fileID: %llu}\n"
+			"  m_LocalRotation: {x: 0, y: 0.38268343, z: 0, w: 0.92387956}\n"
+			"  m_LocalPosition: {x: %zu.5, y: 0, z: -3.25}\n"
+			"  m_LocalScale: {x: 1, y: 1, z: 1}\n"
+			"  m_Children: []\n"
+			"  m_Father: {fileID: 0}\n"
+			"  m_RootOrder: %zu\n"
+			"  m_LocalEulerAnglesHint: {x: 0, y: 45, z: 0}\n",
+			id + 1, id, n % 1000, n);
+	}
+}
+
+/* The scene recoded to UTF-16LE with a BOM.
+ */
+static void yaml_bench_utf16_(yaml_bench_buffer_t *buffer, size_t size) {
+	yaml_bench_buffer_t scene = { NULL, 0, 0 };
+	const unsigned char *pointer;
+	const unsigned char *end;
+
+	yaml_bench_scene_(&scene, size / 2);
+	yaml_bench_reserve_(buffer, scene.size * 2 + 2);
+	yaml_bench_append_(buffer, "\xFF\xFE", 2);
+
+	pointer = scene.start;
+	end = scene.start + scene.size;
+	while (pointer < end) {
+		unsigned int value;
+		unsigned char unit[4];
+
+		if (pointer[0] < 0x80)
+			value = *pointer++;
+		else if (pointer[0] < 0xE0) {
+			value = ((pointer[0] & 0x1F) << 6) | (pointer[1] & 0x3F);
+			pointer += 2;
+		}
+		else if (pointer[0] < 0xF0) {
+			value = ((pointer[0] & 0x0F) << 12) | ((pointer[1] & 0x3F) << 6) | (pointer[2] & 0x3F);
+			pointer += 3;
+		}
+		else {
+			value = ((pointer[0] & 0x07) << 18) | ((pointer[1] & 0x3F) << 12)
+				| ((pointer[2] & 0x3F) << 6) | (pointer[3] & 0x3F);
+			pointer += 4;
+		}
+
+		if (value < 0x10000) {
+			unit[0] = value & 0xFF;
+			unit[1] = value >> 8;
+			yaml_bench_append_(buffer, unit, 2);
+		}
+		else {
+			value -= 0x10000;
+			unit[0] = (value >> 10) & 0xFF;
+			unit[1] = 0xD8 + (value >> 18);
+			unit[2] = value & 0xFF;
+			unit[3] = 0xDC + ((value >> 8) & 0x03);
+			yaml_bench_append_(buffer, unit, 4);
+		}
+	}
+
+	free(scene.start);
+}
+
+typedef struct {
+	const char *name;
+	void (*generate)(yaml_bench_buffer_t *buffer, size_t size);
+	int encoding;
+} yaml_bench_corpus_t;
+
+static const yaml_bench_corpus_t yaml_bench_corpora_[] = {
+	{ "deep", yaml_bench_deep_, YAML_BENCH_UTF8 },
+	{ "flow", yaml_bench_flow_, YAML_BENCH_UTF8 },
+	{ "literal", yaml_bench_literal_, YAML_BENCH_UTF8 },
+	{ "scene", yaml_bench_scene_, YAML_BENCH_UTF8 },
+	{ "utf16", yaml_bench_utf16_, YAML_BENCH_UTF16LE },
+};
+
+/**********************************************************************
+ * STAGES
+ */
+
+/* Scan the input into tokens.
+ */
+static int yaml_bench_scan_(const yaml_bench_corpus_t *corpus, const yaml_bench_buffer_t *input) {
+	yaml_parser_t parser;
+	yaml_token_t token;
+	int done = 0;
+	int ok;
+
+	(void)corpus;
+	if (!YAML_BENCH_OK(yaml_bench_parser_init(&parser)))
+		return 0;
+	yaml_parser_set_input_string(&parser, input->start, input->size);
+
+	do {
+		ok = YAML_BENCH_OK(yaml_parser_scan(&parser, &token));
+		if (ok) {
+			done = token.type == YAML_BENCH_TOKEN_STREAM_END;
+			yaml_bench_token_destroy(&token);
+		}
+	} while (ok && !done);
+
+	yaml_bench_parser_destroy(&parser);
+	return ok;
+}
+
+/* Parse the input into events.
+ */
+static int yaml_bench_parse_(const yaml_bench_corpus_t *corpus, const yaml_bench_buffer_t *input) {
+	yaml_parser_t parser;
+	yaml_event_t event;
+	int done = 0;
+	int ok;
+
+	(void)corpus;
+	if (!YAML_BENCH_OK(yaml_bench_parser_init(&parser)))
+		return 0;
+	yaml_parser_set_input_string(&parser, input->start, input->size);
+
+	do {
+		ok = YAML_BENCH_OK(yaml_parser_parse(&parser, &event));
+		if (ok) {
+			done = event.type == YAML_BENCH_EVENT_STREAM_END;
+			yaml_bench_event_destroy(&event);
+		}
+	} while (ok && !done);
+
+	yaml_bench_parser_destroy(&parser);
+	return ok;
+}
+
+/* Load the documents of the input, handing them over when asked to.
+ */
+static int yaml_bench_load_documents_(const yaml_bench_buffer_t *input,
+		yaml_document_t **documents, size_t *count) {
+	yaml_parser_t parser;
+	yaml_document_t document;
+	size_t capacity = 0;
+	int ok;
+
+	if (!YAML_BENCH_OK(yaml_bench_parser_init(&parser)))
+		return 0;
+	yaml_parser_set_input_string(&parser, input->start, input->size);
+
+	for (;;) {
+		ok = YAML_BENCH_OK(yaml_parser_load(&parser, &document));
+		if (!ok)
+			break;
+
+		/* An empty document marks the end of the stream. */
+		if (!yaml_document_get_root_node(&document)) {
+			yaml_bench_document_destroy(&document);
+			break;
+		}
+
+		if (!documents) {
+			yaml_bench_document_destroy(&document);
+			continue;
+		}
+		if (*count == capacity) {
+			yaml_document_t *grown;
+
+			/* On failure the documents loaded so far stay for the caller to release. */
+			grown = (yaml_document_t *)realloc(*documents, (capacity ? capacity * 2 : 64) * sizeof(yaml_document_t));
+			if (!grown) {
+				yaml_bench_document_destroy(&document);
+				ok = 0;
+				break;
+			}
+			*documents = grown;
+			capacity = capacity ? capacity * 2 : 64;
+		}
+		(*documents)[(*count)++] = document;
+	}
+
+	yaml_bench_parser_destroy(&parser);
+	return ok;
+}
+
+static int yaml_bench_load_(const yaml_bench_corpus_t *corpus, const yaml_bench_buffer_t *input) {
+	(void)corpus;
+	return yaml_bench_load_documents_(input, NULL, NULL);
+}
+
+/* Dump documents loaded beforehand into memory; the emitter consumes them.
+ */
+static int yaml_bench_dump_(const yaml_bench_corpus_t *corpus, yaml_document_t *documents, size_t count) {
+	yaml_emitter_t emitter;
+	size_t i;
+	int ok;
+#if defined(YAML_BENCH_LIBYAML)
+	yaml_bench_buffer_t output = { NULL, 0, 0 };
+#else
+	yaml_output_buffer_t output = { NULL, 0, 0 };
+#endif
+
+	if (!YAML_BENCH_OK(yaml_bench_emitter_init(&emitter))) {
+		for (i = 0; i < count; i++)
+			yaml_bench_document_destroy(documents + i);
+		return 0;
+	}
+#if defined(YAML_BENCH_LIBYAML)
+	yaml_emitter_set_output(&emitter, yaml_bench_write_handler_, &output);
+#else
+	yaml_emitter_set_output_buffer(&emitter, &output);
+#endif
+	yaml_emitter_set_encoding(&emitter, corpus->encoding);
+	yaml_emitter_set_unicode(&emitter, 1);
+
+	ok = YAML_BENCH_OK(yaml_emitter_open(&emitter));
+	for (i = 0; i < count; i++) {
+		if (ok)
+			ok = YAML_BENCH_OK(yaml_emitter_dump(&emitter, documents + i));
+		else
+			yaml_bench_document_destroy(documents + i);
+	}
+	if (ok)
+		ok = YAML_BENCH_OK(yaml_emitter_close(&emitter));
+
+	yaml_bench_emitter_destroy(&emitter);
+	free(output.start);
+	return ok;
+}
+
+/**********************************************************************
+ * DRIVER
+ */
+
+#define YAML_BENCH_SCAN		0
+#define YAML_BENCH_PARSE	1
+#define YAML_BENCH_LOAD		2
+#define YAML_BENCH_DUMP		3
+#define YAML_BENCH_STAGES	4
+
+static const char *const yaml_bench_stages_[YAML_BENCH_STAGES] = { "scan", "parse", "load", "dump" };
+
+static double yaml_bench_now_(void) {
+#if defined(_WIN32) || defined(_WIN64)
+	LARGE_INTEGER counter;
+	LARGE_INTEGER frequency;
+
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+typedef struct {
+	double seconds;
+	size_t allocations;
+	size_t allocated;
+	int ok;
+} yaml_bench_result_t;
+
+/* Run a stage once; dumping loads its documents first, outside the measure.
+ */
+static yaml_bench_result_t yaml_bench_run_(int stage, const yaml_bench_corpus_t *corpus,
+		const yaml_bench_buffer_t *input) {
+	yaml_bench_result_t result = { 0.0, 0, 0, 0 };
+	yaml_document_t *documents = NULL;
+	size_t count = 0;
+	double start;
+
+	if (stage == YAML_BENCH_DUMP && !yaml_bench_load_documents_(input, &documents, &count)) {
+		for (; count; count--)
+			yaml_bench_document_destroy(documents + count - 1);
+		free(documents);
+		return result;
+	}
+
+#if defined(YAML_BENCH_COUNTS_ALLOCATIONS)
+	yaml_bench_allocations_ = 0;
+	yaml_bench_allocated_ = 0;
+#endif
+	start = yaml_bench_now_();
+
+	switch (stage) {
+	case YAML_BENCH_SCAN: result.ok = yaml_bench_scan_(corpus, input); break;
+	case YAML_BENCH_PARSE: result.ok = yaml_bench_parse_(corpus, input); break;
+	case YAML_BENCH_LOAD: result.ok = yaml_bench_load_(corpus, input); break;
+	default: result.ok = yaml_bench_dump_(corpus, documents, count); break;
+	}
+
+	result.seconds = yaml_bench_now_() - start;
+#if defined(YAML_BENCH_COUNTS_ALLOCATIONS)
+	result.allocations = yaml_bench_allocations_;
+	result.allocated = yaml_bench_allocated_;
+#endif
+
+	free(documents);
+	return result;
+}
+
+static void yaml_bench_usage_(void) {
+	fprintf(stderr,
+		"usage: yaml_bench [--size MB] [--iterations N] [--corpus NAME] [--stage NAME]\n"
+		"  corpora: deep flow literal scene utf16\n"
+		"  stages:  scan parse load dump\n");
+}
+
+int main(int argc, char *argv[]) {
+	const char *corpus_filter = NULL;
+	const char *stage_filter = NULL;
+	double megabytes = 8.0;
+	int iterations = 3;
+	size_t c;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--size") && i + 1 < argc)
+			megabytes = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--iterations") && i + 1 < argc)
+			iterations = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--corpus") && i + 1 < argc)
+			corpus_filter = argv[++i];
+		else if (!strcmp(argv[i], "--stage") && i + 1 < argc)
+			stage_filter = argv[++i];
+		else {
+			yaml_bench_usage_();
+			return EXIT_FAILURE;
+		}
+	}
+	if (megabytes <= 0.0 || iterations <= 0) {
+		yaml_bench_usage_();
+		return EXIT_FAILURE;
+	}
+
+	printf("%-8s %-8s %-6s %9s %10s %12s %10s\n",
+		"library", "corpus", "stage", "MB", "MB/s", "allocations", "alloc MB");
+
+	for (c = 0; c < sizeof(yaml_bench_corpora_) / sizeof(yaml_bench_corpora_[0]); c++) {
+		const yaml_bench_corpus_t *corpus = yaml_bench_corpora_ + c;
+		yaml_bench_buffer_t input = { NULL, 0, 0 };
+		int stage;
+
+		if (corpus_filter && strcmp(corpus_filter, corpus->name))
+			continue;
+		corpus->generate(&input, (size_t)(megabytes * 1048576.0));
+
+		for (stage = 0; stage < YAML_BENCH_STAGES; stage++) {
+			yaml_bench_result_t best = { 0.0, 0, 0, 0 };
+			double mb = (double)input.size / 1048576.0;
+			int n;
+
+			if (stage_filter && strcmp(stage_filter, yaml_bench_stages_[stage]))
+				continue;
+
+			/* The fastest run is the one least disturbed. */
+			for (n = 0; n < iterations; n++) {
+				yaml_bench_result_t result = yaml_bench_run_(stage, corpus, &input);
+
+				if (!result.ok) {
+					best = result;
+					break;
+				}
+				if (!n || result.seconds < best.seconds)
+					best = result;
+			}
+
+			if (!best.ok) {
+				printf("%-8s %-8s %-6s %9.2f %10s\n",
+					YAML_BENCH_LIBRARY, corpus->name, yaml_bench_stages_[stage], mb, "failed");
+				continue;
+			}
+#if defined(YAML_BENCH_COUNTS_ALLOCATIONS)
+			printf("%-8s %-8s %-6s %9.2f %10.1f %12zu %10.1f\n",
+				YAML_BENCH_LIBRARY, corpus->name, yaml_bench_stages_[stage], mb,
+				best.seconds > 0.0 ? mb / best.seconds : 0.0,
+				best.allocations, (double)best.allocated / 1048576.0);
+#else
+			printf("%-8s %-8s %-6s %9.2f %10.1f %12s %10s\n",
+				YAML_BENCH_LIBRARY, corpus->name, yaml_bench_stages_[stage], mb,
+				best.seconds > 0.0 ? mb / best.seconds : 0.0, "-", "-");
+#endif
+			fflush(stdout);
+		}
+
+		free(input.start);
+	}
+
+	return EXIT_SUCCESS;
+}
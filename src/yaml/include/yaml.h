@@ -6,6 +6,7 @@
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -21,6 +22,8 @@
 #   else
 #     define YAML_DECL __declspec(dllimport)
 #   endif
+# else
+#   define YAML_DECL
 # endif
 #else
 # define YAML_DECL
@@ -122,7 +125,7 @@
 #define YAML_STACK_PUSH(ret, stack, type, value) do { \
 	*(ret) = ((stack)->top == (stack)->end) ? YAML_EMEMORY : YAML_EOK; \
 	if (*(ret)) \
-		YAML_STACK_EXTEND(&ret, stack, type); \
+		YAML_STACK_EXTEND((ret), stack, type); \
 	if (!*(ret)) \
 		*((stack)->top++) = (value); \
 } while (0)
@@ -164,6 +167,7 @@
 	ptrdiff_t head_offset = (queue)->head - (queue)->start; \
 	ptrdiff_t tail_offset = (queue)->tail - (queue)->start; \
 	\
+	*(ret) = YAML_EOK; \
 	/* Need resize the queue */ \
 	if (length == count) { \
 		type *new_start = (type *)YAML_REALLOC((queue)->start, new_count * sizeof(type)); \
@@ -184,29 +188,26 @@
 		(queue)->tail = (queue)->start + length; \
 		(queue)->head = (queue)->start; \
 	} \
-	*(ret) = YAML_EOK; \
 } while (0)
 
 #define YAML_QUEUE_ENQUEUE(ret, queue, type, value) do { \
 	*(ret) = ((queue)->tail == (queue)->end) ? YAML_EMEMORY : YAML_EOK; \
 	if (*(ret)) \
-		YAML_QUEUE_EXTEND(&ret, queue, type); \
+		YAML_QUEUE_EXTEND((ret), queue, type); \
 	if (!*(ret)) \
 		*((queue)->tail++) = (value); \
 } while (0)
 
 #define YAML_QUEUE_DEQUEUE(queue) (*((queue)->head++))
 
-#define YAML_QUEUE_INSERT(ret, queue, index, elem_type, value) do { \
-	type *insert_pos = (queue)->head + (index); \
-	ptrdiff_t right_len = (queue)->tail - (queue)->head - (index); \
-	\
+#define YAML_QUEUE_INSERT(ret, queue, index, type, value) do { \
 	*(ret) = ((queue)->tail == (queue)->end) ? YAML_EMEMORY : YAML_EOK; \
 	if (*(ret)) \
-		YAML_QUEUE_EXTEND(&ret, queue, type); \
+		YAML_QUEUE_EXTEND((ret), queue, type); \
 	if (!*(ret)) { \
-		memmove(insert_pos + 1, insert_pos, right_len * sizeof(type)); \
-		*insert_pos = value; \
+		memmove((queue)->head + (index) + 1, (queue)->head + (index), \
+			((queue)->tail - (queue)->head - (index)) * sizeof(type)); \
+		(queue)->head[(index)] = (value); \
 		(queue)->tail++; \
 	} \
 } while (0)
@@ -354,6 +355,9 @@ typedef struct {
 			int plain_implicit;
 			int quoted_implicit;
 			int style;
+			/* Set by producers of values known to be safe plain scalars
+			 * (identifiers, numbers): the emitter skips analyzing them. */
+			int trusted;
 		} scalar;
 		struct {
 			yaml_char_t *anchor;
@@ -397,11 +401,48 @@ typedef struct {
 /* The default mapping tag is !!map. */
 #define YAML_TAG_DEFAULT_MAPPING    YAML_TAG_MAP
 
+/* The interned IDs of the standard tags above.
+ * Every string table is seeded with them in this order, so comparing a node
+ * tag against a standard tag is a single integer compare.
+ */
+#define YAML_TAG_ID_NULL		1
+#define YAML_TAG_ID_BOOL		2
+#define YAML_TAG_ID_STR			3
+#define YAML_TAG_ID_INT			4
+#define YAML_TAG_ID_FLOAT		5
+#define YAML_TAG_ID_TIMESTAMP	6
+#define YAML_TAG_ID_SEQ			7
+#define YAML_TAG_ID_MAP			8
+
+typedef struct {
+	yaml_char_t *string;
+	size_t length;
+	uint64_t hash;
+} yaml_intern_entry_t;
+
+/* A string table mapping equal strings to one shared copy and a small
+ * integer ID. IDs start at 1; 0 is never a valid ID.
+ */
+typedef struct {
+	YAML_STACK_STRUCT(yaml_intern_entry_t) entries;
+
+	/* Open addressing hash of entry IDs, 0 marks an empty slot. */
+	int *slots;
+	size_t capacity;
+} yaml_intern_t;
+
 #define	YAML_NSTYLE_NO			0 /* An empty node style. */
 #define YAML_NSTYLE_SCALAR		1 /* A scalar node style. */
 #define YAML_NSTYLE_SEQUENCE	2 /* A sequence node style. */
 #define YAML_NSTYLE_MAPPING		3 /* A mapping node style. */
 
+#define YAML_RESOLVE_NONE		0 /* Not resolved yet. */
+#define YAML_RESOLVE_NULL		1 /* A !!null value. */
+#define YAML_RESOLVE_BOOL		2 /* A !!bool value. */
+#define YAML_RESOLVE_INT		3 /* A !!int value fitting int64_t. */
+#define YAML_RESOLVE_FLOAT		4 /* A !!float value, or an !!int one out of range. */
+#define YAML_RESOLVE_STR		5 /* Any other value. */
+
 typedef int yaml_node_item_t;
 
 typedef struct {
@@ -411,13 +452,22 @@ typedef struct {
 
 typedef struct {
 	int type;
-	yaml_char_t *tag;
+	yaml_char_t *tag; /* Shared with the document string table. */
+	int tag_id;
 
 	union {
 		struct {
 			yaml_char_t *value;
 			size_t length;
 			int style;
+			int value_id; /* Non-zero if value is shared with the string table. */
+			int implicit; /* Non-zero if the tag was not given and defaulted to !!str. */
+			int resolved; /* The cached YAML_RESOLVE_* type of the value. */
+			union {
+				int64_t integer;
+				double real;
+				int boolean;
+			} typed;
 		} scalar;
 
 		struct {
@@ -431,6 +481,9 @@ typedef struct {
 		} mapping;
 	} data;
 
+	/* The number of sequences and mappings holding the node. */
+	int references;
+
 	yaml_mark_t start_mark;
 	yaml_mark_t end_mark;
 } yaml_node_t;
@@ -446,6 +499,17 @@ typedef struct {
 	} tag_directives;
 
 	YAML_STACK_STRUCT(yaml_node_t) nodes;
+
+	/* Tags and mapping keys of all the nodes. */
+	yaml_intern_t strings;
+
+	/* The number of nodes referenced more than once, kept by the append
+	 * functions and the loader. 0 lets the emitter skip the anchors pass. */
+	int shared;
+
+	/* Set by code editing the items or pairs in place, bypassing the append
+	 * functions: shared is not trusted and the emitter counts the references anew. */
+	int shared_invalid;
 	
 	int start_implicit;
 	int end_implicit;
@@ -496,6 +560,29 @@ typedef struct {
 	yaml_mark_t mark;
 } yaml_alias_data_t;
 
+/* The stages of parsing timed by the statistics. Each stage is charged its own time,
+ * the stages it runs excluded, so the stages add up to the whole time spent.
+ */
+#define YAML_STATS_READER		0 /* Reading and decoding the input. */
+#define YAML_STATS_SCANNER		1 /* Producing tokens. */
+#define YAML_STATS_PARSER		2 /* Producing events from the tokens. */
+#define YAML_STATS_COMPOSER		3 /* Composing documents from the events. */
+#define YAML_STATS_STAGES		4
+
+/* Counters of the parser work, kept when the library is built with YAML_STATS.
+ */
+typedef struct {
+	size_t token_queue_extends;	/* Doublings of the token queue. */
+	size_t token_queue_moves;	/* Moves of the queued tokens to the queue start. */
+	size_t simple_key_saves;	/* Positions saved as possible simple keys. */
+	size_t refills;				/* Calls of the read handler. */
+	size_t bytes_read;			/* Octets given by the read handler. */
+	size_t allocations;			/* Blocks allocated or reallocated. */
+	size_t bytes_allocated;		/* Octets requested by these allocations. */
+	size_t scalars[YAML_SCALAR_FOLDED + 1]; /* Scalar tokens by style. */
+	uint64_t cycles[YAML_STATS_STAGES];	/* Time spent in each stage, in CPU cycles where available. */
+} yaml_parser_stats_t;
+
 typedef struct {
 	int error;
 	const char *problem;
@@ -556,11 +643,39 @@ typedef struct {
 	YAML_STACK_STRUCT(yaml_alias_data_t) aliases;
 
 	yaml_document_t *document;
+
+#if defined(YAML_STATS)
+	yaml_parser_stats_t stats;
+#endif
 } yaml_parser_t;
 
 /* The prototype of a write handler. */
 typedef int yaml_write_handler_t(void *data, unsigned char *buffer, size_t size);
 
+/* A segment of output, referencing either the emitter buffer or caller memory. */
+typedef struct {
+	const unsigned char *base;
+	size_t length;
+} yaml_iovec_t;
+
+/* The prototype of a scatter/gather write handler.
+ * The segments must be written in order, as if concatenated.
+ */
+typedef int yaml_writev_handler_t(void *data, const yaml_iovec_t *segments, size_t count);
+
+/* A growable in-memory output.
+ * The emitter owns the memory until yaml_emitter_close() hands it back;
+ * the caller then frees it with YAML_FREE().
+ */
+typedef struct {
+	unsigned char *start;
+	size_t size;
+	size_t capacity;
+} yaml_output_buffer_t;
+
+/* The default size from which scalars are passed to a writev handler by reference. */
+#define YAML_ZERO_COPY_THRESHOLD	4096
+
 #define YAML_ES_STREAM_START				0 /* Expect STREAM-START. */
 #define YAML_ES_FIRST_DOCUMENT_START		1 /* Expect the first DOCUMENT-START or STREAM-END. */
 #define YAML_ES_DOCUMENT_START				2 /* Expect DOCUMENT-START or STREAM-END. */
@@ -587,6 +702,12 @@ typedef struct {
 	yaml_write_handler_t *write_handler;
 	void *write_handler_data;
 
+	yaml_writev_handler_t *writev_handler;
+	void *writev_handler_data;
+
+	/* UTF-8 runs this long skip the buffer, 0 copies everything. */
+	size_t zero_copy_threshold;
+
 	union {
 		struct {
 			unsigned char *buffer;
@@ -595,6 +716,10 @@ typedef struct {
 		} string;
 
 		FILE *file;
+
+		int fd;
+
+		yaml_output_buffer_t *buffer;
 	} output;
 
 	YAML_BUFFER_STRUCT(yaml_char_t) buffer;
@@ -602,6 +727,7 @@ typedef struct {
 
 	int encoding;
 	int canonical;
+	int json;
 	int best_indent;
 	int best_width;
 	int unicode;
@@ -665,6 +791,161 @@ typedef struct {
 	yaml_document_t *document;
 } yaml_emitter_t;
 
+#define YAML_PATH_KEY		1 /* A mapping key: `name`. */
+#define YAML_PATH_INDEX		2 /* A sequence item: `[3]`. */
+#define YAML_PATH_ANY		3 /* Every item or value: `*` or `[*]`. */
+
+typedef struct {
+	int type;
+	yaml_char_t *key;
+	size_t length;
+	int index;
+} yaml_path_step_t;
+
+/* The state of a collection while matching events. */
+typedef struct {
+	int type;
+	int index;
+	int expect_key;
+	int key_matched;
+} yaml_path_frame_t;
+
+/* A compiled path expression such as `m_Component[*].component.fileID`.
+ */
+typedef struct {
+	struct {
+		yaml_path_step_t *start;
+		yaml_path_step_t *end;
+	} steps;
+
+	/* The keys of all the steps. */
+	yaml_char_t *keys;
+} yaml_path_t;
+
+/* The state of matching a path against one stream of events.
+ * A compiled path is only read, so threads may share it, each with a stream of its own.
+ */
+typedef struct {
+	const yaml_path_t *path;
+	struct {
+		yaml_path_frame_t *start;
+		yaml_path_frame_t *end;
+		yaml_path_frame_t *top;
+	} frames;
+	size_t skip;
+} yaml_path_stream_t;
+
+/* The prototype of a path match handler for composed documents.
+ * Return YAML_EOK to continue, anything else stops the evaluation and is returned.
+ */
+typedef int yaml_path_handler_t(void *data, yaml_document_t *document, int node);
+
+/* The prototype of a path match handler for streamed events.
+ * The event is the SCALAR, ALIAS or collection start event of the matched node.
+ */
+typedef int yaml_path_event_handler_t(void *data, yaml_event_t *event);
+
+/* An edit of a source, in bytes.
+ * The range [start, end) of the old source is replaced by length bytes.
+ */
+typedef struct {
+	size_t start;
+	size_t end;
+	size_t length;
+} yaml_edit_t;
+
+/* The version of the binary document image layout. */
+#define YAML_BINARY_VERSION		1
+
+/* The header of a binary document image.
+ * All the offsets are in bytes from the start of the image and 8-byte aligned.
+ */
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+
+	int32_t version_major;
+	int32_t version_minor;
+	int32_t start_implicit;
+	int32_t end_implicit;
+
+	uint64_t size;
+	uint64_t node_count;
+	uint64_t item_count;
+	uint64_t pair_count;
+	uint64_t string_count;
+	uint64_t slot_count;
+	uint64_t tag_directive_count;
+	uint64_t blob_size;
+
+	uint64_t nodes;
+	uint64_t items;
+	uint64_t pairs;
+	uint64_t strings;
+	uint64_t slots;
+	uint64_t tag_directives;
+	uint64_t blob;
+} yaml_binary_header_t;
+
+typedef struct {
+	uint64_t index;
+	uint64_t line;
+	uint64_t column;
+} yaml_binary_mark_t;
+
+/* A node of a binary document image.
+ * Scalars refer to their value in the blob, collections to a range of
+ * items or pairs.
+ */
+typedef struct {
+	uint32_t type;
+	uint32_t style;
+	uint32_t tag_id;
+	uint32_t value_id;
+	uint64_t start;
+	uint64_t length;
+	yaml_binary_mark_t start_mark;
+	yaml_binary_mark_t end_mark;
+} yaml_binary_node_t;
+
+typedef struct {
+	uint32_t key;
+	uint32_t value;
+} yaml_binary_pair_t;
+
+/* An interned string of a binary document image. */
+typedef struct {
+	uint64_t offset;
+	uint64_t length;
+	uint64_t hash;
+} yaml_binary_string_t;
+
+typedef struct {
+	uint64_t handle;
+	uint64_t prefix;
+} yaml_binary_tag_directive_t;
+
+/* A read-only view of a binary document image, queried in place.
+ */
+typedef struct {
+	const unsigned char *image;
+	size_t size;
+
+	const yaml_binary_header_t *header;
+	const yaml_binary_node_t *nodes;
+	const uint32_t *items;
+	const yaml_binary_pair_t *pairs;
+	const yaml_binary_string_t *strings;
+	const uint32_t *slots;
+	const yaml_binary_tag_directive_t *tag_directives;
+	const yaml_char_t *blob;
+
+	/* The mapping made by yaml_binary_open_file(), if any. */
+	void *mapping;
+	size_t mapping_size;
+} yaml_binary_document_t;
+
 /* Free any memory allocated for a token object.
  */
 YAML_DECL void yaml_token_destroy(yaml_token_t *token);
@@ -773,6 +1054,65 @@ YAML_DECL int yaml_document_append_sequence_item(yaml_document_t *document, int
  */
 YAML_DECL int yaml_document_append_mapping_pair(yaml_document_t *document, int mapping, int key, int value);
 
+/* Get the string ID of a mapping key or tag, adding it to the document string table.
+ * Returns the ID, or a negative error code.
+ */
+YAML_DECL int yaml_document_intern(yaml_document_t *document, const yaml_char_t *string, size_t length);
+
+/* Look up the string ID without adding it.
+ * Returns 0 if the string is not in the document string table. The standard
+ * tags are always there, so they have their YAML_TAG_ID_* even when no node
+ * of the document uses them.
+ */
+YAML_DECL int yaml_document_find_string(const yaml_document_t *document, const yaml_char_t *string, size_t length);
+
+/* Get the string of a string ID, or NULL if the ID is unknown.
+ */
+YAML_DECL const yaml_char_t *yaml_document_get_string(const yaml_document_t *document, int id);
+
+/* Resolve the type of a scalar node from its tag, or from its value for
+ * plain scalars with an implicit tag (YAML 1.2 core schema). An explicit
+ * !!str is never resolved by value.
+ * The result is cached in the node. Returns a YAML_RESOLVE_* type.
+ */
+YAML_DECL int yaml_node_resolve(yaml_node_t *node);
+
+/* Get the value of an !!int scalar node.
+ * Returns YAML_EOK, or YAML_EFAILD if the node is not an integer.
+ */
+YAML_DECL int yaml_node_as_int64(yaml_node_t *node, int64_t *value);
+
+/* Get the value of an !!int or !!float scalar node.
+ * Returns YAML_EOK, or YAML_EFAILD if the node is not a number.
+ */
+YAML_DECL int yaml_node_as_double(yaml_node_t *node, double *value);
+
+/* Get the value of a !!bool scalar node.
+ * Returns YAML_EOK, or YAML_EFAILD if the node is not a boolean.
+ */
+YAML_DECL int yaml_node_as_bool(yaml_node_t *node, int *value);
+
+/* Initialize a string table seeded with the standard tags.
+ */
+YAML_DECL int yaml_intern_init(yaml_intern_t *intern);
+
+/* Destroy a string table and all its strings.
+ */
+YAML_DECL void yaml_intern_destroy(yaml_intern_t *intern);
+
+/* Intern a string.
+ * Returns the ID of the string, or a negative error code.
+ */
+YAML_DECL int yaml_intern_add(yaml_intern_t *intern, const yaml_char_t *string, size_t length);
+
+/* Look up a string without interning it. Returns 0 if the string is unknown.
+ */
+YAML_DECL int yaml_intern_find(const yaml_intern_t *intern, const yaml_char_t *string, size_t length);
+
+/* Get the shared copy of an interned string, or NULL if the ID is unknown.
+ */
+YAML_DECL const yaml_char_t *yaml_intern_get(const yaml_intern_t *intern, int id);
+
 /* Initialize a parser.
  * Returns YAML_E_OK if the function succeeded.
  */
@@ -790,6 +1130,24 @@ YAML_DECL void yaml_parser_set_input_string(yaml_parser_t *parser, const unsigne
  */
 YAML_DECL void yaml_parser_set_input_file(yaml_parser_t *parser, FILE *file);
 
+/* Clear a parser for a new input, keeping the memory it has grown.
+ * The input and the encoding have to be set again.
+ */
+YAML_DECL int yaml_parser_reset(yaml_parser_t *parser);
+
+/* Get a ready parser from the pool of the calling thread, or a new one.
+ * Returns NULL if it cannot be allocated.
+ */
+YAML_DECL yaml_parser_t *yaml_parser_acquire(void);
+
+/* Reset a parser and give it back to the pool of the calling thread.
+ */
+YAML_DECL void yaml_parser_release(yaml_parser_t *parser);
+
+/* Destroy the parsers pooled by the calling thread, before it exits.
+ */
+YAML_DECL void yaml_parser_pool_clear(void);
+
 /* Set a generic input handler.
  */
 YAML_DECL void yaml_parser_set_input(yaml_parser_t *parser, yaml_read_handler_t *handler, void *data);
@@ -798,6 +1156,11 @@ YAML_DECL void yaml_parser_set_input(yaml_parser_t *parser, yaml_read_handler_t
  */
 YAML_DECL void yaml_parser_set_encoding(yaml_parser_t *parser, int encoding);
 
+/* Copy the statistics gathered since the parser was initialized or reset.
+ * Returns YAML_EFAILD, with zeroed statistics, if the library is built without YAML_STATS.
+ */
+YAML_DECL int yaml_parser_get_stats(const yaml_parser_t *parser, yaml_parser_stats_t *stats);
+
 /* Scan the input stream and produce the next token.
  */
 YAML_DECL int yaml_parser_scan(yaml_parser_t *parser, yaml_token_t *token);
@@ -810,6 +1173,16 @@ YAML_DECL int yaml_parser_parse(yaml_parser_t *parser, yaml_event_t *event);
  */
 YAML_DECL int yaml_parser_load(yaml_parser_t *parser, yaml_document_t *document);
 
+/* Update the documents of a stream after an edit of its source.
+ * Only the documents whose spans touch the edit are parsed again from the
+ * new source, the others are kept and their marks shifted. The documents
+ * array must come from YAML_MALLOC, it is replaced and the count updated.
+ * On error the documents are left untouched.
+ */
+YAML_DECL int yaml_parser_reload(yaml_document_t **documents, size_t *count,
+								 const unsigned char *input, size_t size,
+								 const yaml_edit_t *edit);
+
 /* Initialize an emitter.
  */
 YAML_DECL int yaml_emitter_init(yaml_emitter_t *emitter);
@@ -817,6 +1190,11 @@ YAML_DECL int yaml_emitter_init(yaml_emitter_t *emitter);
 /* Destroy an emitter. */
 YAML_DECL void yaml_emitter_destroy(yaml_emitter_t *emitter);
 
+/* Clear an emitter for a new output, keeping the memory it has grown.
+ * The output and the settings have to be set again.
+ */
+YAML_DECL int yaml_emitter_reset(yaml_emitter_t *emitter);
+
 /* Set a string output.
  */
 YAML_DECL void yaml_emitter_set_output_string(yaml_emitter_t *emitter,
@@ -831,6 +1209,26 @@ YAML_DECL void yaml_emitter_set_output_file(yaml_emitter_t *emitter, FILE *file)
 YAML_DECL void yaml_emitter_set_output(yaml_emitter_t *emitter,
 									   yaml_write_handler_t *handler, void *data);
 
+/* Set a growable memory output, filled without a write handler.
+ * A buffer left in the output by a previous emitter, allocated with
+ * YAML_MALLOC(), is reused. The output is valid after yaml_emitter_close().
+ */
+YAML_DECL void yaml_emitter_set_output_buffer(yaml_emitter_t *emitter, yaml_output_buffer_t *output);
+
+/* Set a file descriptor output, written with writev().
+ */
+YAML_DECL void yaml_emitter_set_output_fd(yaml_emitter_t *emitter, int fd);
+
+/* Set a generic scatter/gather output handler.
+ */
+YAML_DECL void yaml_emitter_set_output_writev(yaml_emitter_t *emitter,
+											  yaml_writev_handler_t *handler, void *data);
+
+/* Set the length from which UTF-8 scalar runs are written by reference
+ * instead of being copied into the output buffer. 0 disables it.
+ */
+YAML_DECL void yaml_emitter_set_zero_copy_threshold(yaml_emitter_t *emitter, size_t threshold);
+
 /* Set the output encoding.
  */
 YAML_DECL void yaml_emitter_set_encoding(yaml_emitter_t *emitter, int encoding);
@@ -839,6 +1237,10 @@ YAML_DECL void yaml_emitter_set_encoding(yaml_emitter_t *emitter, int encoding);
  */
 YAML_DECL void yaml_emitter_set_canonical(yaml_emitter_t *emitter, int canonical);
 
+/* Set if the output should be compact JSON instead of YAML.
+ */
+YAML_DECL void yaml_emitter_set_json(yaml_emitter_t *emitter, int json);
+
 /* Set the intendation increment.
  */
 YAML_DECL void yaml_emitter_set_indent(yaml_emitter_t *emitter, int indent);
@@ -856,6 +1258,8 @@ YAML_DECL void yaml_emitter_set_unicode(yaml_emitter_t *emitter, int unicode);
 YAML_DECL void yaml_emitter_set_break(yaml_emitter_t *emitter, int line_break);
 
 /* Emit an event.
+ * The emitter takes the event over, even when the call fails; events are
+ * held until the ones after them tell how they are written.
  */
 YAML_DECL int yaml_emitter_emit(yaml_emitter_t *emitter, yaml_event_t *event);
 
@@ -863,7 +1267,8 @@ YAML_DECL int yaml_emitter_emit(yaml_emitter_t *emitter, yaml_event_t *event);
  */
 YAML_DECL int yaml_emitter_open(yaml_emitter_t *emitter);
 
-/* Finish a YAML stream.
+/* Finish a YAML stream, flushing the output.
+ * A memory output is handed back to its yaml_output_buffer_t.
  */
 YAML_DECL int yaml_emitter_close(yaml_emitter_t *emitter);
 
@@ -871,8 +1276,118 @@ YAML_DECL int yaml_emitter_close(yaml_emitter_t *emitter);
  */
 YAML_DECL int yaml_emitter_dump(yaml_emitter_t *emitter, yaml_document_t *document);
 
+/* Emit a list of documents, building the output of each one in memory on a
+ * pool of threads and writing them in order. The output is the same as
+ * dumping the documents one by one, and the documents are destroyed alike.
+ * threads <= 0 uses one thread per processor, 1 dumps serially.
+ */
+YAML_DECL int yaml_emitter_dump_documents(yaml_emitter_t *emitter,
+										  yaml_document_t *documents, size_t count, int threads);
+
+/* Write JSON through the json mode of the emitter: one document a line,
+ * strings for the keys, literals resolved with the core schema, no tags,
+ * anchors or directives.
+ */
+#define YAML_TRANSCODE_JSON	0x01
+
+/* Pipe the events of a parser into an emitter until the end of the stream,
+ * without building documents. The emitter is left closed, a memory output
+ * handed back as by yaml_emitter_close().
+ */
+YAML_DECL int yaml_transcode(yaml_parser_t *parser, yaml_emitter_t *emitter, int flags);
+
 /* Flush the accumulated characters to the output.
  */
 YAML_DECL int yaml_emitter_flush(yaml_emitter_t *emitter);
 
+/* Write a document as a position independent binary image.
+ */
+YAML_DECL int yaml_document_save_binary(yaml_document_t *document,
+										yaml_write_handler_t *handler, void *data);
+
+/* Validate a binary image in memory and set up a view of it.
+ * Every string must lie in the blob and end in a NUL, so the queries hand
+ * them out unchecked. The image is used in place and must outlive the view.
+ */
+YAML_DECL int yaml_document_map_binary(yaml_binary_document_t *binary,
+									   const void *image, size_t size);
+
+/* Map a binary image file into memory and set up a view of it.
+ */
+YAML_DECL int yaml_binary_open_file(yaml_binary_document_t *binary, const char *path);
+
+/* Release a view, unmapping the file opened by yaml_binary_open_file().
+ */
+YAML_DECL void yaml_binary_close(yaml_binary_document_t *binary);
+
+/* Get a node of a binary document, or NULL if the index is out of range.
+ */
+YAML_DECL const yaml_binary_node_t *yaml_binary_get_node(const yaml_binary_document_t *binary, int index);
+
+/* Get the root node of a binary document, or NULL if it is empty.
+ */
+YAML_DECL const yaml_binary_node_t *yaml_binary_get_root_node(const yaml_binary_document_t *binary);
+
+/* Get the tag of a binary node.
+ */
+YAML_DECL const yaml_char_t *yaml_binary_node_tag(const yaml_binary_document_t *binary,
+												  const yaml_binary_node_t *node);
+
+/* Get the value of a scalar binary node, or NULL if it is not a scalar.
+ */
+YAML_DECL const yaml_char_t *yaml_binary_node_value(const yaml_binary_document_t *binary,
+													const yaml_binary_node_t *node, size_t *length);
+
+/* Get the node index of a sequence item, or 0 if it is out of range.
+ */
+YAML_DECL int yaml_binary_node_item(const yaml_binary_document_t *binary,
+									const yaml_binary_node_t *node, size_t index);
+
+/* Get a pair of a mapping node, or NULL if it is out of range.
+ */
+YAML_DECL const yaml_binary_pair_t *yaml_binary_node_pair(const yaml_binary_document_t *binary,
+														  const yaml_binary_node_t *node, size_t index);
+
+/* Look up the ID of a tag or mapping key, 0 if no node uses it.
+ */
+YAML_DECL int yaml_binary_find_string(const yaml_binary_document_t *binary,
+									  const yaml_char_t *string, size_t length);
+
+/* Compile a path expression.
+ * Steps are separated by '.', `[N]` selects a sequence item and `*` or `[*]`
+ * selects every child. An empty expression selects the root node.
+ */
+YAML_DECL int yaml_path_compile(yaml_path_t *path, const char *expression);
+
+/* Destroy a compiled path.
+ */
+YAML_DECL void yaml_path_destroy(yaml_path_t *path);
+
+/* Call the handler for every node of the document matched by the path.
+ * Nothing is allocated during the evaluation.
+ */
+YAML_DECL int yaml_path_eval(yaml_document_t *document, const yaml_path_t *path,
+							 yaml_path_handler_t *handler, void *data);
+
+/* Initialize the state of matching a compiled path against a stream of events.
+ * The path must outlive the stream.
+ */
+YAML_DECL int yaml_path_stream_init(yaml_path_stream_t *stream, const yaml_path_t *path);
+
+/* Destroy a path matching state.
+ */
+YAML_DECL void yaml_path_stream_destroy(yaml_path_stream_t *stream);
+
+/* Match one parsing event against the path, calling the handler on a match.
+ * Events must be fed in order, starting with STREAM-START or DOCUMENT-START.
+ */
+YAML_DECL int yaml_path_feed(yaml_path_stream_t *stream, yaml_event_t *event,
+							 yaml_path_event_handler_t *handler, void *data);
+
+/* Parse the whole input stream, calling the handler for every matched event,
+ * without composing any document.
+ */
+YAML_DECL int yaml_path_eval_parser(yaml_parser_t *parser, const yaml_path_t *path,
+									yaml_path_event_handler_t *handler, void *data);
+
 #endif /* !YAML_H_ */
@@ -0,0 +1,117 @@
+#include "yaml_test.h"
+
+/* A growable image, kept 8-byte aligned for yaml_document_map_binary().
+ */
+typedef struct {
+	uint64_t *words;
+	size_t size;
+	size_t capacity;
+} yaml_test_image_t;
+
+static int yaml_test_write_handler_(void *data, unsigned char *buffer, size_t size) {
+	yaml_test_image_t *image = (yaml_test_image_t *)data;
+
+	while (image->size + size > image->capacity) {
+		image->capacity = image->capacity ? image->capacity * 2 : 1024;
+		image->words = (uint64_t *)realloc(image->words, image->capacity);
+		YAML_TEST_REQUIRE(image->words);
+	}
+	memcpy((unsigned char *)image->words + image->size, buffer, size);
+	image->size += size;
+	return YAML_EOK;
+}
+
+static void yaml_test_save_(const char *input, yaml_test_image_t *image) {
+	yaml_parser_t parser;
+	yaml_document_t document;
+
+	memset(image, 0, sizeof(yaml_test_image_t));
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+	YAML_TEST_REQUIRE(yaml_parser_load(&parser, &document) == YAML_EOK);
+	YAML_TEST_REQUIRE(yaml_document_save_binary(&document, yaml_test_write_handler_, image) == YAML_EOK);
+	yaml_document_destroy(&document);
+	yaml_parser_destroy(&parser);
+}
+
+static const char yaml_test_input_[] =
+	"%TAG !u! tag:unity3d.com,2011:\n"
+	"--- !u!1 &100\n"
+	"GameObject:\n"
+	"  m_Name: Cube\n"
+	"  m_IsActive: 1\n";
+
+static void yaml_test_map_(void) {
+	yaml_test_image_t image;
+	yaml_binary_document_t binary;
+	const yaml_binary_node_t *root;
+	const yaml_binary_node_t *name;
+	const yaml_char_t *value;
+	size_t length;
+	int id;
+
+	yaml_test_save_(yaml_test_input_, &image);
+	YAML_TEST_REQUIRE(yaml_document_map_binary(&binary, image.words, image.size) == YAML_EOK);
+
+	root = yaml_binary_get_root_node(&binary);
+	YAML_TEST_REQUIRE(root && root->type == YAML_NSTYLE_MAPPING);
+	YAML_TEST_CHECK(!strcmp((const char *)yaml_binary_node_tag(&binary, root), "tag:unity3d.com,2011:1"));
+
+	id = yaml_binary_find_string(&binary, (const yaml_char_t *)"m_Name", 6);
+	YAML_TEST_CHECK(id > 0);
+	YAML_TEST_CHECK(!yaml_binary_find_string(&binary, (const yaml_char_t *)"m_Nope", 6));
+
+	name = yaml_binary_get_node(&binary, 5);
+	YAML_TEST_REQUIRE(name && name->type == YAML_NSTYLE_SCALAR);
+	value = yaml_binary_node_value(&binary, name, &length);
+	YAML_TEST_CHECK(value && length == 4 && !strcmp((const char *)value, "Cube"));
+
+	yaml_binary_close(&binary);
+	free(image.words);
+}
+
+/* An image whose strings do not end in their NUL is refused at open.
+ */
+static void yaml_test_corrupt_(void) {
+	yaml_test_image_t image;
+	yaml_binary_document_t binary;
+	yaml_binary_header_t *header;
+	yaml_binary_string_t *strings;
+	yaml_binary_node_t *nodes;
+	unsigned char *blob;
+
+	yaml_test_save_(yaml_test_input_, &image);
+	header = (yaml_binary_header_t *)image.words;
+	strings = (yaml_binary_string_t *)((unsigned char *)image.words + header->strings);
+	blob = (unsigned char *)image.words + header->blob;
+
+	/* An interned string losing its NUL. */
+	blob[strings[0].offset + strings[0].length] = 'x';
+	YAML_TEST_CHECK(yaml_document_map_binary(&binary, image.words, image.size) == YAML_EFAILD);
+	YAML_TEST_CHECK(!binary.header);
+	blob[strings[0].offset + strings[0].length] = '\0';
+	YAML_TEST_REQUIRE(yaml_document_map_binary(&binary, image.words, image.size) == YAML_EOK);
+
+	/* An interned string running to the blob end. */
+	strings[0].length = header->blob_size - strings[0].offset;
+	YAML_TEST_CHECK(yaml_document_map_binary(&binary, image.words, image.size) == YAML_EFAILD);
+	free(image.words);
+
+	/* A scalar value with a wrong length. */
+	yaml_test_save_(yaml_test_input_, &image);
+	header = (yaml_binary_header_t *)image.words;
+	nodes = (yaml_binary_node_t *)((unsigned char *)image.words + header->nodes);
+	YAML_TEST_REQUIRE(nodes[4].type == YAML_NSTYLE_SCALAR);
+	nodes[4].length--;
+	YAML_TEST_CHECK(yaml_document_map_binary(&binary, image.words, image.size) == YAML_EFAILD);
+	nodes[4].length++;
+	nodes[4].start = header->blob_size;
+	YAML_TEST_CHECK(yaml_document_map_binary(&binary, image.words, image.size) == YAML_EFAILD);
+	free(image.words);
+}
+
+int main(void) {
+	yaml_test_map_();
+	yaml_test_corrupt_();
+	return YAML_TEST_RESULT();
+}
@@ -0,0 +1,244 @@
+#include "yaml_test.h"
+
+static const char yaml_test_input_[] =
+	"GameObject:\n"
+	"  m_Name: Cube\n"
+	"  m_Component:\n"
+	"  - component: {fileID: 200}\n";
+
+/* Load the input and dump it again in an encoding.
+ */
+static void yaml_test_dump_(const char *input, int encoding, yaml_output_buffer_t *output) {
+	yaml_parser_t parser;
+	yaml_emitter_t emitter;
+	yaml_document_t document;
+
+	memset(output, 0, sizeof(yaml_output_buffer_t));
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+	YAML_TEST_REQUIRE(yaml_parser_load(&parser, &document) == YAML_EOK);
+	yaml_parser_destroy(&parser);
+
+	YAML_TEST_REQUIRE(yaml_emitter_init(&emitter) == YAML_EOK);
+	yaml_emitter_set_output_buffer(&emitter, output);
+	yaml_emitter_set_encoding(&emitter, encoding);
+	YAML_TEST_CHECK(yaml_emitter_dump(&emitter, &document) == YAML_EOK);
+	YAML_TEST_CHECK(yaml_emitter_close(&emitter) == YAML_EOK);
+	yaml_emitter_destroy(&emitter);
+}
+
+/* The BOM of a UTF-16 output takes no column, so the text is the one of UTF-8.
+ */
+static void yaml_test_bom_(void) {
+	yaml_output_buffer_t utf8;
+	yaml_output_buffer_t utf16;
+	size_t k;
+
+	yaml_test_dump_(yaml_test_input_, YAML_ENCODING_UTF8, &utf8);
+	yaml_test_dump_(yaml_test_input_, YAML_ENCODING_UTF16LE, &utf16);
+	YAML_TEST_REQUIRE(utf8.size && utf16.size);
+
+	YAML_TEST_CHECK(utf8.start[0] == 'G');
+	YAML_TEST_CHECK(utf16.size == 2 + 2 * utf8.size);
+	YAML_TEST_CHECK(utf16.start[0] == 0xFF && utf16.start[1] == 0xFE);
+	for (k = 0; k < utf8.size && 2 + 2 * k + 1 < utf16.size; k++) {
+		if (utf16.start[2 + 2 * k] != utf8.start[k] || utf16.start[2 + 2 * k + 1]) {
+			fprintf(stderr, "UTF-16 output differs at character %u\n", (unsigned)k);
+			YAML_TEST_CHECK(0);
+			break;
+		}
+	}
+
+	YAML_FREE(utf8.start);
+	YAML_FREE(utf16.start);
+}
+
+/* Load every document of the input.
+ */
+static yaml_document_t *yaml_test_load_all_(const char *input, size_t *count) {
+	yaml_parser_t parser;
+	yaml_document_t *documents = NULL;
+	size_t capacity = 0;
+
+	*count = 0;
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+	for (;;) {
+		if (*count == capacity) {
+			capacity = capacity ? capacity * 2 : 16;
+			documents = (yaml_document_t *)YAML_REALLOC(documents, capacity * sizeof(yaml_document_t));
+			YAML_TEST_REQUIRE(documents);
+		}
+		YAML_TEST_REQUIRE(yaml_parser_load(&parser, documents + *count) == YAML_EOK);
+		if (!yaml_document_get_root_node(documents + *count)) {
+			yaml_document_destroy(documents + *count);
+			break;
+		}
+		(*count)++;
+	}
+	yaml_parser_destroy(&parser);
+	return documents;
+}
+
+/* Dump the documents of the input one by one, or on threads.
+ */
+static void yaml_test_dump_all_(const char *input, int encoding, int threads, yaml_output_buffer_t *output) {
+	yaml_emitter_t emitter;
+	yaml_document_t *documents;
+	size_t count;
+	size_t k;
+
+	documents = yaml_test_load_all_(input, &count);
+	memset(output, 0, sizeof(yaml_output_buffer_t));
+	YAML_TEST_REQUIRE(yaml_emitter_init(&emitter) == YAML_EOK);
+	yaml_emitter_set_output_buffer(&emitter, output);
+	yaml_emitter_set_encoding(&emitter, encoding);
+	yaml_emitter_set_width(&emitter, 40);
+	if (threads < 0) {
+		for (k = 0; k < count; k++)
+			YAML_TEST_CHECK(yaml_emitter_dump(&emitter, documents + k) == YAML_EOK);
+	}
+	else
+		YAML_TEST_CHECK(yaml_emitter_dump_documents(&emitter, documents, count, threads) == YAML_EOK);
+	YAML_TEST_CHECK(yaml_emitter_close(&emitter) == YAML_EOK);
+	yaml_emitter_destroy(&emitter);
+	YAML_FREE(documents);
+}
+
+/* A parallel dump writes the same stream as a serial one.
+ */
+static void yaml_test_parallel_(void) {
+	static const int encodings[] = { YAML_ENCODING_UTF8, YAML_ENCODING_UTF16LE };
+	static const int threads[] = { 1, 2, 4, 0 };
+	char input[32768];
+	size_t length = 0;
+	yaml_output_buffer_t serial;
+	yaml_output_buffer_t parallel;
+	int k, e, t;
+
+	length += sprintf(input + length,
+		"%%TAG !u! tag:unity3d.com,2011:\n"
+		"--- !u!1 &1\n"
+		"GameObject:\n"
+		"  m_Name: Root\n");
+	for (k = 2; k < 64; k++) {
+		length += sprintf(input + length,
+			"--- !u!4 &%d\n"
+			"Transform:\n"
+			"  m_Name: \"transform %d with a name long enough to be folded by the emitter\"\n"
+			"  m_Children: [a, b, %d]\n"
+			"  m_Position: &p {x: %d, y: 1.5, z: -2}\n"
+			"  m_Target: *p\n", k, k, k, k);
+
+		/* A kept block scalar leaves its document open ended. */
+		if (k % 9 == 0)
+			length += sprintf(input + length, "  m_Script: |+\n    line\n\n");
+
+		/* Directives of their own are written in order. */
+		if (k % 13 == 0)
+			length += sprintf(input + length, "...\n%%TAG !u! tag:unity3d.com,2011:\n%%TAG !e! tag:example.com,2000:\n--- !e!x\nvalue: %d\n", k);
+	}
+
+	for (e = 0; e < 2; e++) {
+		yaml_test_dump_all_(input, encodings[e], -1, &serial);
+		YAML_TEST_REQUIRE(serial.size);
+		for (t = 0; t < 4; t++) {
+			yaml_test_dump_all_(input, encodings[e], threads[t], &parallel);
+			if (parallel.size != serial.size || memcmp(parallel.start, serial.start, serial.size)) {
+				fprintf(stderr, "encoding %d, %d threads: the parallel dump differs\n", encodings[e], threads[t]);
+				YAML_TEST_CHECK(0);
+			}
+			YAML_FREE(parallel.start);
+		}
+		YAML_FREE(serial.start);
+	}
+}
+
+/* Dump a document into a NUL terminated string.
+ */
+static char *yaml_test_dump_document_(yaml_document_t *document) {
+	yaml_output_buffer_t output;
+	yaml_emitter_t emitter;
+	char *text;
+
+	memset(&output, 0, sizeof(yaml_output_buffer_t));
+	YAML_TEST_REQUIRE(yaml_emitter_init(&emitter) == YAML_EOK);
+	yaml_emitter_set_output_buffer(&emitter, &output);
+	YAML_TEST_CHECK(yaml_emitter_dump(&emitter, document) == YAML_EOK);
+	YAML_TEST_CHECK(yaml_emitter_close(&emitter) == YAML_EOK);
+	yaml_emitter_destroy(&emitter);
+
+	text = (char *)malloc(output.size + 1);
+	YAML_TEST_REQUIRE(text);
+	memcpy(text, output.start, output.size);
+	text[output.size] = '\0';
+	YAML_FREE(output.start);
+	return text;
+}
+
+/* Build [{x: 1}, <the same mapping>], sharing it through the API or in place.
+ */
+static void yaml_test_build_(yaml_document_t *document, int share, int in_place) {
+	yaml_node_t *sequence;
+	int root, mapping, error;
+
+	YAML_TEST_REQUIRE(yaml_document_init(document, 0, 0, NULL, NULL, 1, 1) == YAML_EOK);
+	root = yaml_document_add_sequence(document, NULL, YAML_SEQUENCE_FLOW);
+	mapping = yaml_document_add_mapping(document, NULL, YAML_MAPPING_FLOW);
+	YAML_TEST_REQUIRE(root > 0 && mapping > 0);
+	YAML_TEST_REQUIRE(yaml_document_append_mapping_pair(document, mapping,
+		yaml_document_add_scalar(document, NULL, (yaml_char_t *)"x", 1, YAML_SCALAR_PLAIN),
+		yaml_document_add_scalar(document, NULL, (yaml_char_t *)"1", 1, YAML_SCALAR_PLAIN)) == YAML_EOK);
+	YAML_TEST_REQUIRE(yaml_document_append_sequence_item(document, root, mapping) == YAML_EOK);
+
+	if (!share)
+		return;
+	if (!in_place) {
+		YAML_TEST_REQUIRE(yaml_document_append_sequence_item(document, root, mapping) == YAML_EOK);
+		return;
+	}
+
+	sequence = yaml_document_get_node(document, root);
+	YAML_STACK_PUSH(&error, &sequence->data.sequence.items, yaml_node_item_t, mapping);
+	YAML_TEST_REQUIRE(!error);
+	document->shared_invalid = 1;
+}
+
+/* Only the documents sharing a node get anchors.
+ */
+static void yaml_test_shared_(void) {
+	yaml_document_t document;
+	char *text;
+
+	yaml_test_build_(&document, 0, 0);
+	YAML_TEST_CHECK(!document.shared);
+	text = yaml_test_dump_document_(&document);
+	YAML_TEST_CHECK(!strcmp(text, "[{x: 1}]\n"));
+	free(text);
+
+	yaml_test_build_(&document, 1, 0);
+	YAML_TEST_CHECK(document.shared == 1);
+	text = yaml_test_dump_document_(&document);
+	YAML_TEST_CHECK(!strcmp(text, "[&id001 {x: 1}, *id001]\n"));
+	free(text);
+
+	/* An edit in place invalidates the count, the emitter counts anew. */
+	yaml_test_build_(&document, 1, 1);
+	YAML_TEST_CHECK(!document.shared);
+	text = yaml_test_dump_document_(&document);
+	YAML_TEST_CHECK(!strcmp(text, "[&id001 {x: 1}, *id001]\n"));
+	free(text);
+
+	yaml_test_build_(&document, 0, 0);
+	document.shared_invalid = 1;
+	text = yaml_test_dump_document_(&document);
+	YAML_TEST_CHECK(!strcmp(text, "[{x: 1}]\n"));
+	free(text);
+}
+
+int main(void) {
+	yaml_test_bom_();
+	yaml_test_parallel_();
+	yaml_test_shared_();
+	return YAML_TEST_RESULT();
+}
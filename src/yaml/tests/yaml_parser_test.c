@@ -0,0 +1,265 @@
+#include "yaml_test.h"
+
+/* Append the properties of a node event.
+ */
+static void yaml_test_properties_(char *out, size_t size, const yaml_char_t *anchor, const yaml_char_t *tag) {
+	if (tag)
+		snprintf(out + strlen(out), size - strlen(out), " <%s>", (const char *)tag);
+	if (anchor)
+		snprintf(out + strlen(out), size - strlen(out), " &%s", (const char *)anchor);
+}
+
+/* Render the events of the parser input in the notation of the YAML test suite.
+ */
+static int yaml_test_render_(yaml_parser_t *parser, char *out, size_t size) {
+	static const char styles[] = "?:'\"|>";
+	yaml_event_t event;
+	int error;
+	int done;
+
+	out[0] = '\0';
+	do {
+		error = yaml_parser_parse(parser, &event);
+		if (error)
+			return error;
+
+		if (out[0])
+			snprintf(out + strlen(out), size - strlen(out), " ");
+		switch (event.type) {
+		case YAML_EVENT_STREAM_START:
+			snprintf(out + strlen(out), size - strlen(out), "+STR");
+			break;
+		case YAML_EVENT_STREAM_END:
+			snprintf(out + strlen(out), size - strlen(out), "-STR");
+			break;
+		case YAML_EVENT_DOCUMENT_START:
+			snprintf(out + strlen(out), size - strlen(out), "+DOC%s",
+				event.data.document_start.implicit ? "" : " ---");
+			break;
+		case YAML_EVENT_DOCUMENT_END:
+			snprintf(out + strlen(out), size - strlen(out), "-DOC%s",
+				event.data.document_end.implicit ? "" : " ...");
+			break;
+		case YAML_EVENT_MAPPING_START:
+			snprintf(out + strlen(out), size - strlen(out), "+MAP%s",
+				event.data.mapping_start.style == YAML_MAPPING_FLOW ? " {}" : "");
+			yaml_test_properties_(out, size, event.data.mapping_start.anchor, event.data.mapping_start.tag);
+			break;
+		case YAML_EVENT_MAPPING_END:
+			snprintf(out + strlen(out), size - strlen(out), "-MAP");
+			break;
+		case YAML_EVENT_SEQUENCE_START:
+			snprintf(out + strlen(out), size - strlen(out), "+SEQ%s",
+				event.data.sequence_start.style == YAML_SEQUENCE_FLOW ? " []" : "");
+			yaml_test_properties_(out, size, event.data.sequence_start.anchor, event.data.sequence_start.tag);
+			break;
+		case YAML_EVENT_SEQUENCE_END:
+			snprintf(out + strlen(out), size - strlen(out), "-SEQ");
+			break;
+		case YAML_EVENT_SCALAR:
+			snprintf(out + strlen(out), size - strlen(out), "=VAL");
+			yaml_test_properties_(out, size, event.data.scalar.anchor, event.data.scalar.tag);
+			snprintf(out + strlen(out), size - strlen(out), " %c%.*s", styles[event.data.scalar.style],
+				(int)event.data.scalar.length, (const char *)event.data.scalar.value);
+			break;
+		case YAML_EVENT_ALIAS:
+			snprintf(out + strlen(out), size - strlen(out), "=ALI *%s", (const char *)event.data.alias.anchor);
+			break;
+		}
+
+		done = event.type == YAML_EVENT_STREAM_END;
+		yaml_event_destroy(&event);
+	} while (!done);
+
+	return YAML_EOK;
+}
+
+static int yaml_test_parse_(const char *input, size_t length, char *out, size_t size) {
+	yaml_parser_t parser;
+	int error;
+
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)input, length);
+	error = yaml_test_render_(&parser, out, size);
+	yaml_parser_destroy(&parser);
+	return error;
+}
+
+/* Hand the input over one octet at a time, so every read splits a token.
+ */
+static int yaml_test_octet_read_handler_(void *data, unsigned char *buffer, size_t size, size_t *size_read) {
+	const char **input = (const char **)data;
+
+	*size_read = size && **input ? 1 : 0;
+	if (*size_read)
+		*buffer = (unsigned char)*(*input)++;
+	return YAML_EOK;
+}
+
+static const char yaml_test_unity_[] =
+	"%YAML 1.1\n"
+	"%TAG !u! tag:unity3d.com,2011:\n"
+	"--- !u!1 &100\n"
+	"GameObject:\n"
+	"  m_Name: Cube\n"
+	"  m_Component:\n"
+	"  - component: {fileID: 200}\n"
+	"  - component: {fileID: 300}\n"
+	"--- !u!4 &200\n"
+	"Transform:\n"
+	"  m_LocalPosition: {x: 0, y: 1.5, z: -2}\n"
+	"  m_Children: []\n"
+	"  m_Father: {fileID: 0}\n";
+
+static const char yaml_test_unity_events_[] =
+	"+STR"
+	" +DOC --- +MAP <tag:unity3d.com,2011:1> &100 =VAL :GameObject +MAP"
+	" =VAL :m_Name =VAL :Cube =VAL :m_Component +SEQ"
+	" +MAP =VAL :component +MAP {} =VAL :fileID =VAL :200 -MAP -MAP"
+	" +MAP =VAL :component +MAP {} =VAL :fileID =VAL :300 -MAP -MAP"
+	" -SEQ -MAP -MAP -DOC"
+	" +DOC --- +MAP <tag:unity3d.com,2011:4> &200 =VAL :Transform +MAP"
+	" =VAL :m_LocalPosition +MAP {} =VAL :x =VAL :0 =VAL :y =VAL :1.5 =VAL :z =VAL :-2 -MAP"
+	" =VAL :m_Children +SEQ [] -SEQ"
+	" =VAL :m_Father +MAP {} =VAL :fileID =VAL :0 -MAP"
+	" -MAP -MAP -DOC"
+	" -STR";
+
+static void yaml_test_unity_stream_(void) {
+	char out[2048];
+	yaml_parser_t parser;
+	yaml_event_t event;
+	const char *input = yaml_test_unity_;
+	int documents = 0;
+
+	YAML_TEST_CHECK(yaml_test_parse_(yaml_test_unity_, sizeof(yaml_test_unity_) - 1, out, sizeof(out)) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, yaml_test_unity_events_));
+
+	/* The same events when every read returns a single octet. */
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input(&parser, yaml_test_octet_read_handler_, &input);
+	YAML_TEST_CHECK(yaml_test_render_(&parser, out, sizeof(out)) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, yaml_test_unity_events_));
+	yaml_parser_destroy(&parser);
+
+	/* Only the first DOCUMENT-START carries the directives, the second inherits them. */
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)yaml_test_unity_, sizeof(yaml_test_unity_) - 1);
+	do {
+		YAML_TEST_REQUIRE(yaml_parser_parse(&parser, &event) == YAML_EOK);
+		if (event.type == YAML_EVENT_DOCUMENT_START) {
+			size_t count = event.data.document_start.tag_directives.end
+				- event.data.document_start.tag_directives.start;
+
+			YAML_TEST_CHECK(count == (documents ? 0u : 1u));
+			YAML_TEST_CHECK(event.data.document_start.version_directive.major == (documents ? 0 : 1));
+			documents++;
+		}
+		yaml_event_destroy(&event);
+	} while (!parser.stream_end_produced);
+	YAML_TEST_CHECK(documents == 2);
+	yaml_parser_destroy(&parser);
+}
+
+static void yaml_test_scalars_(void) {
+	static const char input[] =
+		"a: 'it''s'\n"
+		"b: \"x\\ty\\u00e9\"\n"
+		"c: |\n"
+		"  line1\n"
+		"  line2\n"
+		"d: >-\n"
+		"  folded\n"
+		"  text\n"
+		"e: plain\n"
+		"  continued\n"
+		"f: [a, *x, ! b]\n"
+		"g: http://example.com/a#b\n";
+	char out[1024];
+
+	YAML_TEST_CHECK(yaml_test_parse_(input, sizeof(input) - 1, out, sizeof(out)) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out,
+		"+STR +DOC +MAP"
+		" =VAL :a =VAL 'it's"
+		" =VAL :b =VAL \"x\ty\xc3\xa9"
+		" =VAL :c =VAL |line1\nline2\n"
+		" =VAL :d =VAL >folded text"
+		" =VAL :e =VAL :plain continued"
+		" =VAL :f +SEQ [] =VAL :a =ALI *x =VAL <!> :b -SEQ"
+		" =VAL :g =VAL :http://example.com/a#b"
+		" -MAP -DOC -STR"));
+}
+
+static void yaml_test_marks_(void) {
+	static const char input[] = "\xef\xbb\xbf\xc3\xa9: 1\nb: 2\n";
+	yaml_parser_t parser;
+	yaml_event_t event;
+	int scalars = 0;
+
+	/* The marks index the input octets, the BOM and the UTF-8 sequences included. */
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)input, sizeof(input) - 1);
+	do {
+		YAML_TEST_REQUIRE(yaml_parser_parse(&parser, &event) == YAML_EOK);
+		if (event.type == YAML_EVENT_SCALAR) {
+			if (scalars == 0)
+				YAML_TEST_CHECK(event.start_mark.index == 3 && event.end_mark.index == 5);
+			if (scalars == 2) {
+				YAML_TEST_CHECK(event.start_mark.index == 9);
+				YAML_TEST_CHECK(event.start_mark.line == 1 && event.start_mark.column == 0);
+			}
+			scalars++;
+		}
+		yaml_event_destroy(&event);
+	} while (!parser.stream_end_produced);
+	YAML_TEST_CHECK(scalars == 4);
+	yaml_parser_destroy(&parser);
+}
+
+static void yaml_test_utf16_(void) {
+	/* "a: \xe9\n" in UTF-16LE with a BOM. */
+	static const char input[] = "\xff\xfe" "a\0:\0 \0\xe9\0\n\0";
+	char out[256];
+
+	YAML_TEST_CHECK(yaml_test_parse_(input, sizeof(input) - 1, out, sizeof(out)) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, "+STR +DOC +MAP =VAL :a =VAL :\xc3\xa9 -MAP -DOC -STR"));
+}
+
+static void yaml_test_errors_(void) {
+	static const char redeclared[] =
+		"%TAG !u! tag:unity3d.com,2011:\n"
+		"--- !u!1\n"
+		"a\n"
+		"...\n"
+		"%TAG !e! tag:example.com,2000:\n"
+		"--- !u!1\n"
+		"b\n";
+	char out[1024];
+	yaml_parser_t parser;
+
+	/* A document declaring its own handles does not inherit the previous ones. */
+	YAML_TEST_CHECK(yaml_test_parse_(redeclared, sizeof(redeclared) - 1, out, sizeof(out)) == YAML_EPARSER);
+
+	YAML_TEST_CHECK(yaml_test_parse_("a: [1, 2", 8, out, sizeof(out)) == YAML_EPARSER);
+	YAML_TEST_CHECK(yaml_test_parse_("%TAG ! a\n%TAG ! b\n--- x\n", 24, out, sizeof(out)) == YAML_EPARSER);
+	YAML_TEST_CHECK(yaml_test_parse_("\"open\n", 6, out, sizeof(out)) == YAML_ESCANNER);
+	YAML_TEST_CHECK(yaml_test_parse_("a\xff: 1\n", 6, out, sizeof(out)) == YAML_EREADER);
+
+	/* The error is kept with its position. */
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)"a: 1\nb: c: d\n", 13);
+	YAML_TEST_CHECK(yaml_test_render_(&parser, out, sizeof(out)) == YAML_ESCANNER);
+	YAML_TEST_CHECK(parser.error == YAML_ESCANNER);
+	YAML_TEST_CHECK(parser.problem && !strcmp(parser.problem, "mapping values are not allowed in this context"));
+	YAML_TEST_CHECK(parser.problem_mark.line == 1 && parser.problem_mark.column == 4);
+	yaml_parser_destroy(&parser);
+}
+
+int main(void) {
+	yaml_test_unity_stream_();
+	yaml_test_scalars_();
+	yaml_test_marks_();
+	yaml_test_utf16_();
+	yaml_test_errors_();
+	return YAML_TEST_RESULT();
+}
@@ -0,0 +1,210 @@
+#include "yaml_test.h"
+
+static const char yaml_test_scene_[] =
+	"%YAML 1.1\n"
+	"%TAG !u! tag:unity3d.com,2011:\n"
+	"--- !u!1 &100\n"
+	"GameObject:\n"
+	"  m_Name: Cube\n"
+	"  m_Component:\n"
+	"  - component: {fileID: 200}\n"
+	"  - component: {fileID: 300}\n"
+	"  - {m_Name: nested, component: {fileID: 400}}\n"
+	"--- !u!1 &500\n"
+	"GameObject:\n"
+	"  m_Name: Light\n"
+	"  m_Component:\n"
+	"  - component: {fileID: 600}\n";
+
+/* Append the value of every matched scalar, '?' for the other nodes.
+ */
+static int yaml_test_event_handler_(void *data, yaml_event_t *event) {
+	char *out = (char *)data;
+
+	if (event->type == YAML_EVENT_SCALAR)
+		snprintf(out + strlen(out), 256 - strlen(out), "%s%.*s", out[0] ? " " : "",
+			(int)event->data.scalar.length, (const char *)event->data.scalar.value);
+	else
+		snprintf(out + strlen(out), 256 - strlen(out), "%s?", out[0] ? " " : "");
+	return YAML_EOK;
+}
+
+static int yaml_test_stop_handler_(void *data, yaml_event_t *event) {
+	(void)event;
+	return ++*(int *)data == 2 ? YAML_EFAILD : YAML_EOK;
+}
+
+static int yaml_test_eval_parser_(const char *expression, char *out) {
+	yaml_parser_t parser;
+	yaml_path_t path;
+	int error;
+
+	out[0] = '\0';
+	YAML_TEST_REQUIRE(yaml_path_compile(&path, expression) == YAML_EOK);
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)yaml_test_scene_, sizeof(yaml_test_scene_) - 1);
+	error = yaml_path_eval_parser(&parser, &path, yaml_test_event_handler_, out);
+	yaml_parser_destroy(&parser);
+	yaml_path_destroy(&path);
+	return error;
+}
+
+static void yaml_test_compile_(void) {
+	yaml_path_t path;
+
+	YAML_TEST_REQUIRE(yaml_path_compile(&path, "m_Component[*].component.fileID") == YAML_EOK);
+	YAML_TEST_CHECK(path.steps.end - path.steps.start == 4);
+	YAML_TEST_CHECK(path.steps.start[0].type == YAML_PATH_KEY && !strcmp((char *)path.steps.start[0].key, "m_Component"));
+	YAML_TEST_CHECK(path.steps.start[1].type == YAML_PATH_ANY);
+	YAML_TEST_CHECK(path.steps.start[3].type == YAML_PATH_KEY && path.steps.start[3].length == 6);
+	yaml_path_destroy(&path);
+
+	YAML_TEST_REQUIRE(yaml_path_compile(&path, "") == YAML_EOK);
+	YAML_TEST_CHECK(path.steps.end == path.steps.start);
+	yaml_path_destroy(&path);
+
+	YAML_TEST_CHECK(yaml_path_compile(&path, "a..b") == YAML_EFAILD);
+	YAML_TEST_CHECK(yaml_path_compile(&path, "a[x]") == YAML_EFAILD);
+	YAML_TEST_CHECK(yaml_path_compile(&path, "a[1") == YAML_EFAILD);
+	YAML_TEST_CHECK(yaml_path_compile(&path, "a[99999999999]") == YAML_EFAILD);
+}
+
+static void yaml_test_eval_parser_paths_(void) {
+	char out[256];
+	int count = 0;
+	yaml_parser_t parser;
+	yaml_path_t path;
+
+	YAML_TEST_CHECK(yaml_test_eval_parser_("GameObject.m_Component[*].component.fileID", out) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, "200 300 400 600"));
+	YAML_TEST_CHECK(yaml_test_eval_parser_("GameObject.m_Component[1].*.fileID", out) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, "300"));
+	YAML_TEST_CHECK(yaml_test_eval_parser_("GameObject.m_Name", out) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, "Cube Light"));
+	YAML_TEST_CHECK(yaml_test_eval_parser_("*.m_Component", out) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, "? ?"));
+	YAML_TEST_CHECK(yaml_test_eval_parser_("GameObject.m_Missing", out) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, ""));
+
+	/* A handler error stops the evaluation and is returned. */
+	YAML_TEST_REQUIRE(yaml_path_compile(&path, "GameObject.m_Name") == YAML_EOK);
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)yaml_test_scene_, sizeof(yaml_test_scene_) - 1);
+	YAML_TEST_CHECK(yaml_path_eval_parser(&parser, &path, yaml_test_stop_handler_, &count) == YAML_EFAILD);
+	YAML_TEST_CHECK(count == 2);
+	yaml_parser_destroy(&parser);
+	yaml_path_destroy(&path);
+}
+
+/* Two streams interleaved over one compiled path do not disturb each other.
+ */
+static void yaml_test_shared_path_(void) {
+	static const char other[] =
+		"GameObject:\n"
+		"  m_Component:\n"
+		"  - component: {fileID: 7}\n";
+	yaml_parser_t parsers[2];
+	yaml_path_stream_t streams[2];
+	char outs[2][256];
+	int done[2] = { 0, 0 };
+	yaml_path_t path;
+	yaml_event_t event;
+	int k;
+
+	YAML_TEST_REQUIRE(yaml_path_compile(&path, "GameObject.m_Component[*].component.fileID") == YAML_EOK);
+	for (k = 0; k < 2; k++) {
+		YAML_TEST_REQUIRE(yaml_parser_init(&parsers[k]) == YAML_EOK);
+		YAML_TEST_REQUIRE(yaml_path_stream_init(&streams[k], &path) == YAML_EOK);
+		outs[k][0] = '\0';
+	}
+	yaml_parser_set_input_string(&parsers[0], (const unsigned char *)yaml_test_scene_, sizeof(yaml_test_scene_) - 1);
+	yaml_parser_set_input_string(&parsers[1], (const unsigned char *)other, sizeof(other) - 1);
+
+	while (!done[0] || !done[1]) {
+		for (k = 0; k < 2; k++) {
+			if (done[k])
+				continue;
+			YAML_TEST_REQUIRE(yaml_parser_parse(&parsers[k], &event) == YAML_EOK);
+			done[k] = event.type == YAML_EVENT_STREAM_END;
+			YAML_TEST_CHECK(yaml_path_feed(&streams[k], &event, yaml_test_event_handler_, outs[k]) == YAML_EOK);
+			yaml_event_destroy(&event);
+		}
+	}
+	YAML_TEST_CHECK(!strcmp(outs[0], "200 300 400 600"));
+	YAML_TEST_CHECK(!strcmp(outs[1], "7"));
+
+	for (k = 0; k < 2; k++) {
+		yaml_path_stream_destroy(&streams[k]);
+		yaml_parser_destroy(&parsers[k]);
+	}
+	yaml_path_destroy(&path);
+}
+
+static int yaml_test_node_handler_(void *data, yaml_document_t *document, int node) {
+	char *out = (char *)data;
+	yaml_node_t *found = yaml_document_get_node(document, node);
+
+	if (found->type == YAML_NSTYLE_SCALAR)
+		snprintf(out + strlen(out), 256 - strlen(out), "%s%.*s", out[0] ? " " : "",
+			(int)found->data.scalar.length, (const char *)found->data.scalar.value);
+	return YAML_EOK;
+}
+
+static int yaml_test_add_scalar_(yaml_document_t *document, const char *value) {
+	return yaml_document_add_scalar(document, NULL, (yaml_char_t *)value, (int)strlen(value), YAML_SCALAR_PLAIN);
+}
+
+/* The composed evaluation over {m_Name: Cube, m_Component: [{component: 200}, {component: 300}]}.
+ */
+static void yaml_test_eval_document_(void) {
+	yaml_document_t document;
+	yaml_path_t path;
+	char out[256];
+	int root, components, item;
+	int k;
+
+	YAML_TEST_REQUIRE(yaml_document_init(&document, 0, 0, NULL, NULL, 1, 1) == YAML_EOK);
+	root = yaml_document_add_mapping(&document, NULL, YAML_MAPPING_BLOCK);
+	YAML_TEST_REQUIRE(root > 0);
+	YAML_TEST_REQUIRE(yaml_document_append_mapping_pair(&document, root,
+		yaml_test_add_scalar_(&document, "m_Name"), yaml_test_add_scalar_(&document, "Cube")) == YAML_EOK);
+	components = yaml_document_add_sequence(&document, NULL, YAML_SEQUENCE_BLOCK);
+	YAML_TEST_REQUIRE(components > 0);
+	YAML_TEST_REQUIRE(yaml_document_append_mapping_pair(&document, root,
+		yaml_test_add_scalar_(&document, "m_Component"), components) == YAML_EOK);
+	for (k = 0; k < 2; k++) {
+		item = yaml_document_add_mapping(&document, NULL, YAML_MAPPING_FLOW);
+		YAML_TEST_REQUIRE(item > 0);
+		YAML_TEST_REQUIRE(yaml_document_append_sequence_item(&document, components, item) == YAML_EOK);
+		YAML_TEST_REQUIRE(yaml_document_append_mapping_pair(&document, item,
+			yaml_test_add_scalar_(&document, "component"), yaml_test_add_scalar_(&document, k ? "300" : "200")) == YAML_EOK);
+	}
+
+	out[0] = '\0';
+	YAML_TEST_REQUIRE(yaml_path_compile(&path, "m_Component[*].component") == YAML_EOK);
+	YAML_TEST_CHECK(yaml_path_eval(&document, &path, yaml_test_node_handler_, out) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, "200 300"));
+	yaml_path_destroy(&path);
+
+	out[0] = '\0';
+	YAML_TEST_REQUIRE(yaml_path_compile(&path, "m_Component[1].component") == YAML_EOK);
+	YAML_TEST_CHECK(yaml_path_eval(&document, &path, yaml_test_node_handler_, out) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, "300"));
+	yaml_path_destroy(&path);
+
+	out[0] = '\0';
+	YAML_TEST_REQUIRE(yaml_path_compile(&path, "m_Name") == YAML_EOK);
+	YAML_TEST_CHECK(yaml_path_eval(&document, &path, yaml_test_node_handler_, out) == YAML_EOK);
+	YAML_TEST_CHECK(!strcmp(out, "Cube"));
+	yaml_path_destroy(&path);
+
+	yaml_document_destroy(&document);
+}
+
+int main(void) {
+	yaml_test_compile_();
+	yaml_test_eval_parser_paths_();
+	yaml_test_shared_path_();
+	yaml_test_eval_document_();
+	return YAML_TEST_RESULT();
+}
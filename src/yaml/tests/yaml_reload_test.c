@@ -0,0 +1,163 @@
+#include "yaml_test.h"
+
+static const char yaml_test_source_[] =
+	"%YAML 1.1\n"
+	"%TAG !u! tag:unity3d.com,2011:\n"
+	"--- !u!1 &1\n"
+	"GameObject:\n"
+	"  m_Name: Cube\n"
+	"--- !u!4 &2\n"
+	"Transform:\n"
+	"  m_Position: &p {x: 0, y: 1}\n"
+	"  m_Target: *p\n"
+	"...\n"
+	"%TAG !e! tag:example.com,2000:\n"
+	"--- !e!item &3\n"
+	"c: 3\n"
+	"--- !e!item &4\n"
+	"d: 4\n";
+
+/* Load every document of a source, as a reload of an empty stream does.
+ */
+static void yaml_test_load_(const char *input, size_t size, yaml_document_t **documents, size_t *count) {
+	yaml_edit_t edit = { 0, 0, 0 };
+
+	edit.length = size;
+	*documents = NULL;
+	*count = 0;
+	YAML_TEST_REQUIRE(yaml_parser_reload(documents, count, (const unsigned char *)input, size, &edit) == YAML_EOK);
+}
+
+static void yaml_test_free_(yaml_document_t *documents, size_t count) {
+	while (count)
+		yaml_document_destroy(documents + --count);
+	YAML_FREE(documents);
+}
+
+static int yaml_test_same_mark_(const yaml_mark_t *a, const yaml_mark_t *b) {
+	return a->index == b->index && a->line == b->line && a->column == b->column;
+}
+
+/* Check two documents hold the same nodes at the same places, with the same directives.
+ */
+static int yaml_test_same_(yaml_document_t *a, yaml_document_t *b) {
+	yaml_node_t *x, *y;
+	size_t k;
+
+	if (a->nodes.top - a->nodes.start != b->nodes.top - b->nodes.start
+			|| a->tag_directives.end - a->tag_directives.start != b->tag_directives.end - b->tag_directives.start
+			|| a->version_directive.major != b->version_directive.major
+			|| !yaml_test_same_mark_(&a->start_mark, &b->start_mark))
+		return 0;
+	for (k = 0; a->tag_directives.start + k != a->tag_directives.end; k++) {
+		if (strcmp((char *)a->tag_directives.start[k].handle, (char *)b->tag_directives.start[k].handle)
+				|| strcmp((char *)a->tag_directives.start[k].prefix, (char *)b->tag_directives.start[k].prefix))
+			return 0;
+	}
+	for (x = a->nodes.start, y = b->nodes.start; x != a->nodes.top; x++, y++) {
+		if (x->type != y->type || strcmp((char *)x->tag, (char *)y->tag) || x->references != y->references
+				|| !yaml_test_same_mark_(&x->start_mark, &y->start_mark)
+				|| !yaml_test_same_mark_(&x->end_mark, &y->end_mark))
+			return 0;
+		if (x->type == YAML_NSTYLE_SCALAR && (x->data.scalar.length != y->data.scalar.length
+				|| memcmp(x->data.scalar.value, y->data.scalar.value, x->data.scalar.length)))
+			return 0;
+	}
+	return 1;
+}
+
+/* Replace the first occurrence of a text and reload, checking against a full parse.
+ */
+static void yaml_test_edit_(yaml_document_t **documents, size_t *count, char *source,
+		const char *old_text, const char *new_text) {
+	char *at = strstr(source, old_text);
+	size_t old_length = strlen(old_text);
+	size_t new_length = strlen(new_text);
+	yaml_document_t *expected;
+	size_t expected_count;
+	yaml_edit_t edit;
+	size_t k;
+
+	YAML_TEST_REQUIRE(at);
+	edit.start = at - source;
+	edit.end = edit.start + old_length;
+	edit.length = new_length;
+	memmove(at + new_length, at + old_length, strlen(at + old_length) + 1);
+	memcpy(at, new_text, new_length);
+
+	YAML_TEST_REQUIRE(yaml_parser_reload(documents, count, (const unsigned char *)source, strlen(source), &edit) == YAML_EOK);
+
+	yaml_test_load_(source, strlen(source), &expected, &expected_count);
+	YAML_TEST_CHECK(*count == expected_count);
+	for (k = 0; k < *count && k < expected_count; k++) {
+		if (!yaml_test_same_(*documents + k, expected + k)) {
+			fprintf(stderr, "document %u differs after replacing `%s`\n", (unsigned)k, old_text);
+			YAML_TEST_CHECK(0);
+		}
+	}
+	yaml_test_free_(expected, expected_count);
+}
+
+static void yaml_test_load_stream_(void) {
+	yaml_document_t *documents;
+	yaml_node_t *root, *position, *target;
+	size_t count;
+
+	yaml_test_load_(yaml_test_source_, sizeof(yaml_test_source_) - 1, &documents, &count);
+	YAML_TEST_REQUIRE(count == 4);
+
+	/* The second document inherits the !u! handle, but declares nothing. */
+	root = yaml_document_get_root_node(documents + 1);
+	YAML_TEST_CHECK(!strcmp((char *)root->tag, "tag:unity3d.com,2011:4"));
+	YAML_TEST_CHECK(documents[1].tag_directives.start == documents[1].tag_directives.end);
+
+	/* The alias shares the anchored node. */
+	position = yaml_document_get_node(documents + 1, 5);
+	target = yaml_document_get_node(documents + 1, 10);
+	YAML_TEST_REQUIRE(position && target);
+	YAML_TEST_CHECK(position->type == YAML_NSTYLE_MAPPING && position->references == 2);
+	YAML_TEST_CHECK(target->type == YAML_NSTYLE_SCALAR && !strcmp((char *)target->data.scalar.value, "m_Target"));
+	YAML_TEST_CHECK(documents[1].shared == 1);
+
+	root = yaml_document_get_root_node(documents + 2);
+	YAML_TEST_CHECK(!strcmp((char *)root->tag, "tag:example.com,2000:item"));
+	YAML_TEST_CHECK(documents[2].tag_directives.end - documents[2].tag_directives.start == 1);
+
+	yaml_test_free_(documents, count);
+}
+
+static void yaml_test_reload_(void) {
+	char source[1024];
+	yaml_document_t *documents;
+	size_t count;
+
+	memcpy(source, yaml_test_source_, sizeof(yaml_test_source_));
+	yaml_test_load_(source, strlen(source), &documents, &count);
+
+	/* A document relying on the directives of the first one. */
+	yaml_test_edit_(&documents, &count, source, "y: 1", "y: 12");
+	YAML_TEST_CHECK(!strcmp((char *)yaml_document_get_root_node(documents + 1)->tag, "tag:unity3d.com,2011:4"));
+
+	/* A document declaring its own %TAG keeps it. */
+	yaml_test_edit_(&documents, &count, source, "c: 3", "c: 33");
+	YAML_TEST_REQUIRE(count == 4);
+	YAML_TEST_CHECK(documents[2].tag_directives.end - documents[2].tag_directives.start == 1);
+	YAML_TEST_CHECK(!strcmp((char *)documents[2].tag_directives.start->handle, "!e!"));
+
+	/* A document after it relies on that %TAG, not on the first one. */
+	yaml_test_edit_(&documents, &count, source, "d: 4", "d: 44\n");
+	YAML_TEST_CHECK(!strcmp((char *)yaml_document_get_root_node(documents + 3)->tag, "tag:example.com,2000:item"));
+
+	/* The first document and an edit across two documents. */
+	yaml_test_edit_(&documents, &count, source, "Cube", "Sphere");
+	yaml_test_edit_(&documents, &count, source, "m_Target: *p\n...\n", "m_Target: *p\n");
+	YAML_TEST_CHECK(count == 4);
+
+	yaml_test_free_(documents, count);
+}
+
+int main(void) {
+	yaml_test_load_stream_();
+	yaml_test_reload_();
+	return YAML_TEST_RESULT();
+}
@@ -0,0 +1,95 @@
+#include "yaml_test.h"
+
+static const char yaml_test_unity_[] =
+	"%YAML 1.1\n"
+	"%TAG !u! tag:unity3d.com,2011:\n"
+	"--- !u!1 &100\n"
+	"GameObject:\n"
+	"  m_Name: Cube\n"
+	"  m_Component:\n"
+	"  - component: {fileID: 200}\n"
+	"  - component: {fileID: 300}\n"
+	"--- !u!4 &200\n"
+	"Transform:\n"
+	"  m_LocalPosition: {x: 0, y: 1.5, z: -2}\n"
+	"  m_Father: {fileID: 0}\n";
+
+/* Hand the input over one octet at a time, so every octet takes a refill.
+ */
+static int yaml_test_octet_read_handler_(void *data, unsigned char *buffer, size_t size, size_t *size_read) {
+	const char **input = (const char **)data;
+
+	*size_read = size && **input ? 1 : 0;
+	if (*size_read)
+		*buffer = (unsigned char)*(*input)++;
+	return YAML_EOK;
+}
+
+/* Load every document of the input, read one octet at a time.
+ */
+static void yaml_test_load_(yaml_parser_t *parser, const char **input) {
+	yaml_document_t document;
+	int documents = 0;
+
+	YAML_TEST_REQUIRE(yaml_parser_init(parser) == YAML_EOK);
+	yaml_parser_set_input(parser, yaml_test_octet_read_handler_, input);
+	for (;;) {
+		YAML_TEST_REQUIRE(yaml_parser_load(parser, &document) == YAML_EOK);
+		if (!yaml_document_get_root_node(&document)) {
+			yaml_document_destroy(&document);
+			break;
+		}
+		yaml_document_destroy(&document);
+		documents++;
+	}
+	YAML_TEST_CHECK(documents == 2);
+}
+
+#if defined(YAML_STATS)
+
+static void yaml_test_counters_(void) {
+	const char *input = yaml_test_unity_;
+	yaml_parser_stats_t stats;
+	yaml_parser_t parser;
+	uint64_t total = 0;
+	int k;
+
+	yaml_test_load_(&parser, &input);
+	YAML_TEST_REQUIRE(yaml_parser_get_stats(&parser, &stats) == YAML_EOK);
+
+	/* Every octet is a read of its own, and the last read tells the end. */
+	YAML_TEST_CHECK(stats.bytes_read == sizeof(yaml_test_unity_) - 1);
+	YAML_TEST_CHECK(stats.refills == sizeof(yaml_test_unity_));
+
+	/* Each of the 14 keys was saved as a possible simple key at least. */
+	YAML_TEST_CHECK(stats.simple_key_saves >= 14);
+	YAML_TEST_CHECK(stats.scalars[YAML_SCALAR_PLAIN] == 21);
+	YAML_TEST_CHECK(stats.allocations > 0 && stats.bytes_allocated > 0);
+
+	for (k = 0; k < YAML_STATS_STAGES; k++)
+		total += stats.cycles[k];
+	YAML_TEST_CHECK(total > 0);
+
+	yaml_parser_destroy(&parser);
+}
+
+#else
+
+static void yaml_test_counters_(void) {
+	const char *input = yaml_test_unity_;
+	yaml_parser_stats_t stats;
+	yaml_parser_t parser;
+
+	/* Without the statistics the parser still works, and says there are none. */
+	yaml_test_load_(&parser, &input);
+	YAML_TEST_CHECK(yaml_parser_get_stats(&parser, &stats) == YAML_EFAILD);
+	YAML_TEST_CHECK(stats.bytes_read == 0 && stats.refills == 0);
+	yaml_parser_destroy(&parser);
+}
+
+#endif
+
+int main(void) {
+	yaml_test_counters_();
+	return YAML_TEST_RESULT();
+}
@@ -0,0 +1,101 @@
+#include "yaml_test.h"
+
+/* Transcode the input into a NUL terminated string, NULL on error.
+ */
+static char *yaml_test_transcode_(const char *input, int flags, int *error) {
+	yaml_parser_t parser;
+	yaml_emitter_t emitter;
+	yaml_output_buffer_t output;
+	char *text = NULL;
+
+	memset(&output, 0, sizeof(yaml_output_buffer_t));
+	YAML_TEST_REQUIRE(yaml_parser_init(&parser) == YAML_EOK);
+	yaml_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+	YAML_TEST_REQUIRE(yaml_emitter_init(&emitter) == YAML_EOK);
+	yaml_emitter_set_output_buffer(&emitter, &output);
+
+	*error = yaml_transcode(&parser, &emitter, flags);
+	if (!*error) {
+		/* The emitter is closed already. */
+		YAML_TEST_CHECK(yaml_emitter_close(&emitter) == YAML_EOK);
+		text = (char *)malloc(output.size + 1);
+		YAML_TEST_REQUIRE(text);
+		memcpy(text, output.start, output.size);
+		text[output.size] = '\0';
+	}
+
+	yaml_emitter_destroy(&emitter);
+	yaml_parser_destroy(&parser);
+	YAML_FREE(output.start);
+	return text;
+}
+
+static void yaml_test_json_(void) {
+	static const char input[] =
+		"a: 1\n"
+		"b: [true, null, 2.50, 0x1F, text, \"q\\\"x\\u00e9\\t\", '', 1e3, .inf]\n"
+		"c: {d: ~, 7: x}\n"
+		"---\n"
+		"- x\n"
+		"- |\n"
+		"  two\n"
+		"  lines\n";
+	char *text;
+	int error;
+
+	/* One document a line, the literals resolved with the core schema. */
+	text = yaml_test_transcode_(input, YAML_TRANSCODE_JSON, &error);
+	YAML_TEST_REQUIRE(text);
+	YAML_TEST_CHECK(!strcmp(text,
+		"{\"a\":1,\"b\":[true,null,2.50,31,\"text\",\"q\\\"x\xc3\xa9\\t\",\"\",1e3,\".inf\"],\"c\":{\"d\":null,\"7\":\"x\"}}\n"
+		"[\"x\",\"two\\nlines\\n\"]\n"));
+	free(text);
+
+	/* JSON has no aliases. */
+	YAML_TEST_CHECK(!yaml_test_transcode_("a: &x 1\nb: *x\n", YAML_TRANSCODE_JSON, &error));
+	YAML_TEST_CHECK(error == YAML_EEMITTER);
+
+	/* Parser errors are returned as they are. */
+	YAML_TEST_CHECK(!yaml_test_transcode_("a: [1\n", YAML_TRANSCODE_JSON, &error));
+	YAML_TEST_CHECK(error == YAML_EPARSER);
+}
+
+static void yaml_test_yaml_(void) {
+	static const char input[] =
+		"%TAG !u! tag:unity3d.com,2011:\n"
+		"--- !u!1 &100\n"
+		"GameObject:\n"
+		"  m_Name: Cube\n"
+		"  m_Component:\n"
+		"  - component: {fileID: 200}\n"
+		"--- !u!4 &200\n"
+		"Transform: {x: 0}\n";
+	char *text;
+	char *again;
+	int error;
+
+	text = yaml_test_transcode_(input, 0, &error);
+	YAML_TEST_REQUIRE(text);
+	YAML_TEST_CHECK(!strcmp(text,
+		"%TAG !u! tag:unity3d.com,2011:\n"
+		"--- &100 !u!1\n"
+		"GameObject:\n"
+		"  m_Name: Cube\n"
+		"  m_Component:\n"
+		"  - component: {fileID: 200}\n"
+		"--- &200 !<tag:unity3d.com,2011:4>\n"
+		"Transform: {x: 0}\n"));
+
+	/* The output reads back to itself. */
+	again = yaml_test_transcode_(text, 0, &error);
+	YAML_TEST_REQUIRE(again);
+	YAML_TEST_CHECK(!strcmp(text, again));
+	free(again);
+	free(text);
+}
+
+int main(void) {
+	yaml_test_json_();
+	yaml_test_yaml_();
+	return YAML_TEST_RESULT();
+}
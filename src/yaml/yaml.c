@@ -3,6 +3,20 @@
 #include <string.h>
 #include "yaml_private.h"
 
+yaml_char_t *yaml_strdup(const yaml_char_t *str) {
+	size_t length;
+	yaml_char_t *copy;
+
+	if (!str)
+		return NULL;
+
+	length = strlen((const char *)str);
+	copy = (yaml_char_t *)YAML_MALLOC(length + 1);
+	if (copy)
+		memcpy(copy, str, length + 1);
+	return copy;
+}
+
 void yaml_token_destroy(yaml_token_t *token) {
 	assert(token);
 
@@ -101,6 +115,9 @@ int yaml_parser_init(yaml_parser_t *parser) {
 	if (parser->error)
 		goto ERROR;
 	YAML_STACK_INIT(&parser->error, &parser->tag_directives, yaml_tag_directive_t, YAML_INITIAL_STACK_SIZE);
+	if (parser->error)
+		goto ERROR;
+	YAML_STACK_INIT(&parser->error, &parser->aliases, yaml_alias_data_t, YAML_INITIAL_STACK_SIZE);
 	if (parser->error)
 		goto ERROR;
 
@@ -115,10 +132,106 @@ ERROR:
 	YAML_STACK_DESTROY(&parser->states);
 	YAML_STACK_DESTROY(&parser->marks);
 	YAML_STACK_DESTROY(&parser->tag_directives);
+	YAML_STACK_DESTROY(&parser->aliases);
 	
 	return YAML_EFAILD;
 }
 
+/* Release what the parser holds in its queues and stacks, keeping their storage.
+ */
+static void yaml_parser_clear_(yaml_parser_t *parser) {
+	while (parser->tokens.head != parser->tokens.tail)
+		yaml_token_destroy(&YAML_QUEUE_DEQUEUE(&parser->tokens));
+	while (parser->tag_directives.top != parser->tag_directives.start) {
+		yaml_tag_directive_t tag_directive = YAML_STACK_POP(&parser->tag_directives);
+
+		YAML_FREE(tag_directive.handle);
+		YAML_FREE(tag_directive.prefix);
+	}
+	while (parser->aliases.top != parser->aliases.start)
+		YAML_FREE(YAML_STACK_POP(&parser->aliases).anchor);
+}
+
+void yaml_parser_destroy(yaml_parser_t *parser) {
+	assert(parser); /* Non-NULL parser object expected. */
+
+	yaml_parser_clear_(parser);
+
+	YAML_BUFFER_DESTROY(&parser->raw_buffer);
+	YAML_BUFFER_DESTROY(&parser->buffer);
+	YAML_QUEUE_DESTROY(&parser->tokens);
+	YAML_STACK_DESTROY(&parser->indents);
+	YAML_STACK_DESTROY(&parser->simple_keys);
+	YAML_STACK_DESTROY(&parser->states);
+	YAML_STACK_DESTROY(&parser->marks);
+	YAML_STACK_DESTROY(&parser->tag_directives);
+	YAML_STACK_DESTROY(&parser->aliases);
+
+	memset(parser, 0, sizeof(yaml_parser_t));
+}
+
+int yaml_parser_reset(yaml_parser_t *parser) {
+	yaml_parser_t grown;
+
+	assert(parser); /* Non-NULL parser object expected. */
+
+	yaml_parser_clear_(parser);
+
+	/* Start over with the storage of the previous run. */
+	grown = *parser;
+	memset(parser, 0, sizeof(yaml_parser_t));
+
+	parser->raw_buffer.start = grown.raw_buffer.start;
+	parser->raw_buffer.end = grown.raw_buffer.end;
+	parser->raw_buffer.pointer = parser->raw_buffer.last = grown.raw_buffer.start;
+	parser->buffer.start = grown.buffer.start;
+	parser->buffer.end = grown.buffer.end;
+	parser->buffer.pointer = parser->buffer.last = grown.buffer.start;
+	parser->tokens.start = grown.tokens.start;
+	parser->tokens.end = grown.tokens.end;
+	parser->tokens.head = parser->tokens.tail = grown.tokens.start;
+
+#define YAML_PARSER_RESET_STACK(stack) do { \
+	parser->stack.start = parser->stack.top = grown.stack.start; \
+	parser->stack.end = grown.stack.end; \
+} while (0)
+
+	YAML_PARSER_RESET_STACK(indents);
+	YAML_PARSER_RESET_STACK(simple_keys);
+	YAML_PARSER_RESET_STACK(states);
+	YAML_PARSER_RESET_STACK(marks);
+	YAML_PARSER_RESET_STACK(tag_directives);
+	YAML_PARSER_RESET_STACK(aliases);
+
+#undef YAML_PARSER_RESET_STACK
+
+	return YAML_EOK;
+}
+
+/* String read handler.
+ */
+static int yaml_string_read_handler(void *data, yaml_byte_t *buffer, size_t count, size_t *size_read) {
+	yaml_parser_t *parser = (yaml_parser_t *)data;
+	size_t left = parser->input.string.end - parser->input.string.current;
+
+	if (count > left)
+		count = left;
+	memcpy(buffer, parser->input.string.current, count);
+	parser->input.string.current += count;
+	*size_read = count;
+	return YAML_EOK;
+}
+
+void yaml_parser_set_input_string(yaml_parser_t *parser, const unsigned char *input, size_t size) {
+	assert(parser && !parser->read_handler && (input || !size));
+
+	parser->read_handler = yaml_string_read_handler;
+	parser->read_handler_data = parser;
+	parser->input.string.start = (unsigned char *)input;
+	parser->input.string.current = (unsigned char *)input;
+	parser->input.string.end = (unsigned char *)input + size;
+}
+
 /* File read handler.
  */
 static int yaml_file_read_handler(void *data, yaml_byte_t *buffer, size_t count, size_t *size_read) {
@@ -136,6 +249,19 @@ void yaml_parser_set_input_file(yaml_parser_t *parser, FILE *file) {
 	parser->input.file = file;
 }
 
+void yaml_parser_set_input(yaml_parser_t *parser, yaml_read_handler_t *handler, void *data) {
+	assert(parser && !parser->read_handler && handler);
+
+	parser->read_handler = handler;
+	parser->read_handler_data = data;
+}
+
+void yaml_parser_set_encoding(yaml_parser_t *parser, int encoding) {
+	assert(parser && !parser->encoding);
+
+	parser->encoding = encoding;
+}
+
 //yaml_stream_start_event_init(yaml_event_t *event, int encoding) {
 //	yaml_mark_t mark = { 0, 0, 0 };
 //
@@ -0,0 +1,542 @@
+#include "yaml_private.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+#define YAML_BINARY_MAGIC		"YAMLBIN"
+#define YAML_BINARY_BYTE_ORDER	0x01020304
+
+/* The number of nodes, items or pairs converted at once while saving.
+ */
+#define YAML_BINARY_CHUNK_SIZE	256
+
+#define YAML_BINARY_ALIGN(size)	(((size) + 7) & ~(uint64_t)7)
+
+typedef struct {
+	yaml_write_handler_t *handler;
+	void *data;
+	uint64_t offset;
+} yaml_binary_writer_t;
+
+static int yaml_binary_write_(yaml_binary_writer_t *writer, const void *buffer, size_t size) {
+	int error;
+
+	if (!size)
+		return YAML_EOK;
+
+	error = writer->handler(writer->data, (unsigned char *)buffer, size);
+	if (error)
+		return YAML_EWRITER;
+
+	writer->offset += size;
+	return YAML_EOK;
+}
+
+/* Pad the output up to the next section offset.
+ */
+static int yaml_binary_pad_(yaml_binary_writer_t *writer) {
+	static const unsigned char zeros[8] = { 0 };
+
+	return yaml_binary_write_(writer, zeros, (size_t)(YAML_BINARY_ALIGN(writer->offset) - writer->offset));
+}
+
+int yaml_document_save_binary(yaml_document_t *document,
+		yaml_write_handler_t *handler, void *data) {
+	yaml_binary_writer_t writer = { NULL, NULL, 0 };
+	yaml_binary_header_t header;
+	yaml_binary_node_t nodes[YAML_BINARY_CHUNK_SIZE];
+	yaml_binary_pair_t pairs[YAML_BINARY_CHUNK_SIZE];
+	uint32_t items[YAML_BINARY_CHUNK_SIZE];
+	yaml_binary_string_t string;
+	yaml_binary_tag_directive_t tag_directive;
+	yaml_tag_directive_t *directive;
+	yaml_intern_entry_t *entry;
+	yaml_node_t *node;
+	yaml_node_item_t *item;
+	yaml_node_pair_t *pair;
+	uint64_t *string_offsets = NULL;
+	uint32_t *slots = NULL;
+	uint64_t item_start = 0;
+	uint64_t pair_start = 0;
+	uint64_t blob_offset = 0;
+	uint64_t mask;
+	size_t count;
+	size_t id;
+	int error = YAML_EMEMORY;
+
+	assert(document && document->strings.slots); /* Initialized document is expected. */
+	assert(handler); /* Non-NULL write handler is expected. */
+
+	writer.handler = handler;
+	writer.data = data;
+
+	memset(&header, 0, sizeof(yaml_binary_header_t));
+	memcpy(header.magic, YAML_BINARY_MAGIC, sizeof(YAML_BINARY_MAGIC));
+	header.version = YAML_BINARY_VERSION;
+	header.byte_order = YAML_BINARY_BYTE_ORDER;
+	header.version_major = document->version_directive.major;
+	header.version_minor = document->version_directive.minor;
+	header.start_implicit = document->start_implicit;
+	header.end_implicit = document->end_implicit;
+
+	/* Size the sections. */
+	header.node_count = document->nodes.top - document->nodes.start;
+	header.string_count = document->strings.entries.top - document->strings.entries.start;
+	header.tag_directive_count = document->tag_directives.end - document->tag_directives.start;
+	for (header.slot_count = 1; header.slot_count < header.string_count * 2; header.slot_count *= 2)
+		;
+
+	string_offsets = (uint64_t *)YAML_MALLOC((size_t)header.string_count * sizeof(uint64_t) + 1);
+	slots = (uint32_t *)YAML_MALLOC((size_t)header.slot_count * sizeof(uint32_t));
+	if (!string_offsets || !slots)
+		goto ERROR;
+
+	/* The blob holds the interned strings, the other scalar values and the
+	 * tag directives, all NUL terminated. */
+	memset(slots, 0, (size_t)header.slot_count * sizeof(uint32_t));
+	mask = header.slot_count - 1;
+	for (entry = document->strings.entries.start, id = 1; entry != document->strings.entries.top; entry++, id++) {
+		uint64_t slot = entry->hash & mask;
+
+		while (slots[slot])
+			slot = (slot + 1) & mask;
+		slots[slot] = (uint32_t)id;
+		string_offsets[id - 1] = header.blob_size;
+		header.blob_size += entry->length + 1;
+	}
+	blob_offset = header.blob_size;
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		switch (node->type) {
+		case YAML_NSTYLE_SCALAR:
+			if (!node->data.scalar.value_id)
+				header.blob_size += node->data.scalar.length + 1;
+			break;
+		case YAML_NSTYLE_SEQUENCE:
+			header.item_count += node->data.sequence.items.top - node->data.sequence.items.start;
+			break;
+		case YAML_NSTYLE_MAPPING:
+			header.pair_count += node->data.mapping.pairs.top - node->data.mapping.pairs.start;
+			break;
+		}
+	}
+	for (directive = document->tag_directives.start; directive != document->tag_directives.end; directive++)
+		header.blob_size += strlen((char *)directive->handle) + strlen((char *)directive->prefix) + 2;
+
+	header.nodes = YAML_BINARY_ALIGN(sizeof(yaml_binary_header_t));
+	header.items = YAML_BINARY_ALIGN(header.nodes + header.node_count * sizeof(yaml_binary_node_t));
+	header.pairs = YAML_BINARY_ALIGN(header.items + header.item_count * sizeof(uint32_t));
+	header.strings = YAML_BINARY_ALIGN(header.pairs + header.pair_count * sizeof(yaml_binary_pair_t));
+	header.slots = YAML_BINARY_ALIGN(header.strings + header.string_count * sizeof(yaml_binary_string_t));
+	header.tag_directives = YAML_BINARY_ALIGN(header.slots + header.slot_count * sizeof(uint32_t));
+	header.blob = YAML_BINARY_ALIGN(header.tag_directives
+		+ header.tag_directive_count * sizeof(yaml_binary_tag_directive_t));
+	header.size = header.blob + header.blob_size;
+
+	error = yaml_binary_write_(&writer, &header, sizeof(yaml_binary_header_t));
+	if (error || (error = yaml_binary_pad_(&writer)))
+		goto ERROR;
+
+	/* Nodes. */
+	count = 0;
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		yaml_binary_node_t *copy = nodes + count;
+
+		memset(copy, 0, sizeof(yaml_binary_node_t));
+		copy->type = node->type;
+		copy->tag_id = node->tag_id;
+		copy->start_mark.index = node->start_mark.index;
+		copy->start_mark.line = node->start_mark.line;
+		copy->start_mark.column = node->start_mark.column;
+		copy->end_mark.index = node->end_mark.index;
+		copy->end_mark.line = node->end_mark.line;
+		copy->end_mark.column = node->end_mark.column;
+
+		switch (node->type) {
+		case YAML_NSTYLE_SCALAR:
+			copy->style = node->data.scalar.style;
+			copy->value_id = node->data.scalar.value_id;
+			copy->length = node->data.scalar.length;
+			if (node->data.scalar.value_id)
+				copy->start = string_offsets[node->data.scalar.value_id - 1];
+			else {
+				copy->start = blob_offset;
+				blob_offset += node->data.scalar.length + 1;
+			}
+			break;
+		case YAML_NSTYLE_SEQUENCE:
+			copy->style = node->data.sequence.style;
+			copy->start = item_start;
+			copy->length = node->data.sequence.items.top - node->data.sequence.items.start;
+			item_start += copy->length;
+			break;
+		case YAML_NSTYLE_MAPPING:
+			copy->style = node->data.mapping.style;
+			copy->start = pair_start;
+			copy->length = node->data.mapping.pairs.top - node->data.mapping.pairs.start;
+			pair_start += copy->length;
+			break;
+		}
+
+		if (++count == YAML_BINARY_CHUNK_SIZE) {
+			if ((error = yaml_binary_write_(&writer, nodes, count * sizeof(yaml_binary_node_t))))
+				goto ERROR;
+			count = 0;
+		}
+	}
+	if ((error = yaml_binary_write_(&writer, nodes, count * sizeof(yaml_binary_node_t)))
+			|| (error = yaml_binary_pad_(&writer)))
+		goto ERROR;
+
+	/* Sequence items. */
+	count = 0;
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		if (node->type != YAML_NSTYLE_SEQUENCE)
+			continue;
+		for (item = node->data.sequence.items.start; item != node->data.sequence.items.top; item++) {
+			items[count] = (uint32_t)*item;
+			if (++count == YAML_BINARY_CHUNK_SIZE) {
+				if ((error = yaml_binary_write_(&writer, items, count * sizeof(uint32_t))))
+					goto ERROR;
+				count = 0;
+			}
+		}
+	}
+	if ((error = yaml_binary_write_(&writer, items, count * sizeof(uint32_t)))
+			|| (error = yaml_binary_pad_(&writer)))
+		goto ERROR;
+
+	/* Mapping pairs. */
+	count = 0;
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		if (node->type != YAML_NSTYLE_MAPPING)
+			continue;
+		for (pair = node->data.mapping.pairs.start; pair != node->data.mapping.pairs.top; pair++) {
+			pairs[count].key = (uint32_t)pair->key;
+			pairs[count].value = (uint32_t)pair->value;
+			if (++count == YAML_BINARY_CHUNK_SIZE) {
+				if ((error = yaml_binary_write_(&writer, pairs, count * sizeof(yaml_binary_pair_t))))
+					goto ERROR;
+				count = 0;
+			}
+		}
+	}
+	if ((error = yaml_binary_write_(&writer, pairs, count * sizeof(yaml_binary_pair_t)))
+			|| (error = yaml_binary_pad_(&writer)))
+		goto ERROR;
+
+	/* String table and its hash slots. */
+	for (entry = document->strings.entries.start, id = 1; entry != document->strings.entries.top; entry++, id++) {
+		string.offset = string_offsets[id - 1];
+		string.length = entry->length;
+		string.hash = entry->hash;
+		if ((error = yaml_binary_write_(&writer, &string, sizeof(yaml_binary_string_t))))
+			goto ERROR;
+	}
+	if ((error = yaml_binary_pad_(&writer))
+			|| (error = yaml_binary_write_(&writer, slots, (size_t)header.slot_count * sizeof(uint32_t)))
+			|| (error = yaml_binary_pad_(&writer)))
+		goto ERROR;
+
+	/* Tag directives, their strings follow the scalar values. */
+	for (directive = document->tag_directives.start; directive != document->tag_directives.end; directive++) {
+		tag_directive.handle = blob_offset;
+		blob_offset += strlen((char *)directive->handle) + 1;
+		tag_directive.prefix = blob_offset;
+		blob_offset += strlen((char *)directive->prefix) + 1;
+		if ((error = yaml_binary_write_(&writer, &tag_directive, sizeof(yaml_binary_tag_directive_t))))
+			goto ERROR;
+	}
+	if ((error = yaml_binary_pad_(&writer)))
+		goto ERROR;
+
+	/* Blob. */
+	for (entry = document->strings.entries.start; entry != document->strings.entries.top; entry++) {
+		if ((error = yaml_binary_write_(&writer, entry->string, entry->length + 1)))
+			goto ERROR;
+	}
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		if (node->type != YAML_NSTYLE_SCALAR || node->data.scalar.value_id)
+			continue;
+		if ((error = yaml_binary_write_(&writer, node->data.scalar.value, node->data.scalar.length))
+				|| (error = yaml_binary_write_(&writer, "", 1)))
+			goto ERROR;
+	}
+	for (directive = document->tag_directives.start; directive != document->tag_directives.end; directive++) {
+		if ((error = yaml_binary_write_(&writer, directive->handle, strlen((char *)directive->handle) + 1))
+				|| (error = yaml_binary_write_(&writer, directive->prefix, strlen((char *)directive->prefix) + 1)))
+			goto ERROR;
+	}
+
+	assert(writer.offset == header.size);
+	error = YAML_EOK;
+
+ERROR:
+	YAML_FREE(string_offsets);
+	YAML_FREE(slots);
+
+	return error;
+}
+
+/* Check that a section of count elements fits in the image.
+ */
+static int yaml_binary_section_(uint64_t offset, uint64_t count, size_t element, size_t size) {
+	if (offset % 8 || offset > size)
+		return 0;
+	return count <= (size - offset) / element;
+}
+
+/* Check that a string lies in the blob and ends in its NUL there.
+ */
+static int yaml_binary_string_(const yaml_char_t *blob, uint64_t blob_size, uint64_t offset, uint64_t length) {
+	return offset < blob_size && length < blob_size - offset && !blob[offset + length];
+}
+
+/* Check every string of the image once, so the queries return them as they are.
+ */
+static int yaml_binary_check_strings_(const yaml_binary_document_t *binary) {
+	const yaml_binary_header_t *header = binary->header;
+	const yaml_binary_string_t *string;
+	const yaml_binary_tag_directive_t *tag_directive;
+	const yaml_binary_node_t *node;
+	uint64_t k;
+
+	for (k = 0, string = binary->strings; k < header->string_count; k++, string++) {
+		if (!yaml_binary_string_(binary->blob, header->blob_size, string->offset, string->length))
+			return 0;
+	}
+	for (k = 0, node = binary->nodes; k < header->node_count; k++, node++) {
+		if (node->tag_id > header->string_count)
+			return 0;
+		if (node->type == YAML_NSTYLE_SCALAR
+				&& !yaml_binary_string_(binary->blob, header->blob_size, node->start, node->length))
+			return 0;
+	}
+	for (k = 0, tag_directive = binary->tag_directives; k < header->tag_directive_count; k++, tag_directive++) {
+		if (tag_directive->handle >= header->blob_size || tag_directive->prefix >= header->blob_size
+				|| !memchr(binary->blob + tag_directive->handle, '\0', (size_t)(header->blob_size - tag_directive->handle))
+				|| !memchr(binary->blob + tag_directive->prefix, '\0', (size_t)(header->blob_size - tag_directive->prefix)))
+			return 0;
+	}
+	return 1;
+}
+
+int yaml_document_map_binary(yaml_binary_document_t *binary,
+		const void *image, size_t size) {
+	const yaml_binary_header_t *header = (const yaml_binary_header_t *)image;
+
+	assert(binary); /* Non-NULL binary document is expected. */
+	assert(image || !size);
+	memset(binary, 0, sizeof(yaml_binary_document_t));
+
+	if (size < sizeof(yaml_binary_header_t) || ((uintptr_t)image) % 8)
+		return YAML_EFAILD;
+	if (memcmp(header->magic, YAML_BINARY_MAGIC, sizeof(YAML_BINARY_MAGIC))
+			|| header->version != YAML_BINARY_VERSION
+			|| header->byte_order != YAML_BINARY_BYTE_ORDER
+			|| header->size > size)
+		return YAML_EFAILD;
+
+	size = (size_t)header->size;
+	if (!yaml_binary_section_(header->nodes, header->node_count, sizeof(yaml_binary_node_t), size)
+			|| !yaml_binary_section_(header->items, header->item_count, sizeof(uint32_t), size)
+			|| !yaml_binary_section_(header->pairs, header->pair_count, sizeof(yaml_binary_pair_t), size)
+			|| !yaml_binary_section_(header->strings, header->string_count, sizeof(yaml_binary_string_t), size)
+			|| !yaml_binary_section_(header->slots, header->slot_count, sizeof(uint32_t), size)
+			|| !yaml_binary_section_(header->tag_directives, header->tag_directive_count,
+				sizeof(yaml_binary_tag_directive_t), size)
+			|| !yaml_binary_section_(header->blob, header->blob_size, 1, size)
+			|| !header->slot_count || (header->slot_count & (header->slot_count - 1))
+			|| header->node_count > INT32_MAX)
+		return YAML_EFAILD;
+
+	binary->image = (const unsigned char *)image;
+	binary->size = size;
+	binary->header = header;
+	binary->nodes = (const yaml_binary_node_t *)(binary->image + header->nodes);
+	binary->items = (const uint32_t *)(binary->image + header->items);
+	binary->pairs = (const yaml_binary_pair_t *)(binary->image + header->pairs);
+	binary->strings = (const yaml_binary_string_t *)(binary->image + header->strings);
+	binary->slots = (const uint32_t *)(binary->image + header->slots);
+	binary->tag_directives = (const yaml_binary_tag_directive_t *)(binary->image + header->tag_directives);
+	binary->blob = binary->image + header->blob;
+
+	if (!yaml_binary_check_strings_(binary)) {
+		memset(binary, 0, sizeof(yaml_binary_document_t));
+		return YAML_EFAILD;
+	}
+
+	return YAML_EOK;
+}
+
+int yaml_binary_open_file(yaml_binary_document_t *binary, const char *path) {
+	void *mapping;
+	size_t size;
+	int error;
+
+	assert(binary); /* Non-NULL binary document is expected. */
+	assert(path); /* Non-NULL path is expected. */
+	memset(binary, 0, sizeof(yaml_binary_document_t));
+
+#if defined(_WIN32) || defined(_WIN64)
+	{
+		HANDLE file;
+		HANDLE section;
+		LARGE_INTEGER file_size;
+
+		file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return YAML_EREADER;
+		if (!GetFileSizeEx(file, &file_size) || !file_size.QuadPart) {
+			CloseHandle(file);
+			return YAML_EREADER;
+		}
+		size = (size_t)file_size.QuadPart;
+
+		section = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(file);
+		if (!section)
+			return YAML_EREADER;
+		mapping = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(section);
+		if (!mapping)
+			return YAML_EREADER;
+	}
+#else
+	{
+		struct stat st;
+		int fd = open(path, O_RDONLY);
+
+		if (fd < 0)
+			return YAML_EREADER;
+		if (fstat(fd, &st) || !st.st_size) {
+			close(fd);
+			return YAML_EREADER;
+		}
+		size = (size_t)st.st_size;
+
+		mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (mapping == MAP_FAILED)
+			return YAML_EREADER;
+	}
+#endif
+
+	error = yaml_document_map_binary(binary, mapping, size);
+	if (error) {
+#if defined(_WIN32) || defined(_WIN64)
+		UnmapViewOfFile(mapping);
+#else
+		munmap(mapping, size);
+#endif
+		return error;
+	}
+
+	binary->mapping = mapping;
+	binary->mapping_size = size;
+	return YAML_EOK;
+}
+
+void yaml_binary_close(yaml_binary_document_t *binary) {
+	assert(binary); /* Non-NULL binary document is expected. */
+
+	if (binary->mapping) {
+#if defined(_WIN32) || defined(_WIN64)
+		UnmapViewOfFile(binary->mapping);
+#else
+		munmap(binary->mapping, binary->mapping_size);
+#endif
+	}
+	memset(binary, 0, sizeof(yaml_binary_document_t));
+}
+
+const yaml_binary_node_t *yaml_binary_get_node(const yaml_binary_document_t *binary, int index) {
+	assert(binary && binary->header); /* Mapped binary document is expected. */
+
+	if (index <= 0 || (uint64_t)index > binary->header->node_count)
+		return NULL;
+	return binary->nodes + index - 1;
+}
+
+const yaml_binary_node_t *yaml_binary_get_root_node(const yaml_binary_document_t *binary) {
+	return yaml_binary_get_node(binary, 1);
+}
+
+const yaml_char_t *yaml_binary_node_tag(const yaml_binary_document_t *binary,
+		const yaml_binary_node_t *node) {
+	const yaml_binary_string_t *string;
+
+	assert(binary && binary->header); /* Mapped binary document is expected. */
+	assert(node); /* Non-NULL node is expected. */
+
+	if (!node->tag_id || node->tag_id > binary->header->string_count)
+		return NULL;
+	string = binary->strings + node->tag_id - 1;
+	return binary->blob + string->offset;
+}
+
+const yaml_char_t *yaml_binary_node_value(const yaml_binary_document_t *binary,
+		const yaml_binary_node_t *node, size_t *length) {
+	assert(binary && binary->header); /* Mapped binary document is expected. */
+	assert(node); /* Non-NULL node is expected. */
+
+	if (node->type != YAML_NSTYLE_SCALAR)
+		return NULL;
+	if (length)
+		*length = (size_t)node->length;
+	return binary->blob + node->start;
+}
+
+int yaml_binary_node_item(const yaml_binary_document_t *binary,
+		const yaml_binary_node_t *node, size_t index) {
+	assert(binary && binary->header); /* Mapped binary document is expected. */
+	assert(node); /* Non-NULL node is expected. */
+
+	if (node->type != YAML_NSTYLE_SEQUENCE || index >= node->length
+			|| node->start + index >= binary->header->item_count)
+		return 0;
+	return (int)binary->items[node->start + index];
+}
+
+const yaml_binary_pair_t *yaml_binary_node_pair(const yaml_binary_document_t *binary,
+		const yaml_binary_node_t *node, size_t index) {
+	assert(binary && binary->header); /* Mapped binary document is expected. */
+	assert(node); /* Non-NULL node is expected. */
+
+	if (node->type != YAML_NSTYLE_MAPPING || index >= node->length
+			|| node->start + index >= binary->header->pair_count)
+		return NULL;
+	return binary->pairs + node->start + index;
+}
+
+int yaml_binary_find_string(const yaml_binary_document_t *binary,
+		const yaml_char_t *string, size_t length) {
+	uint64_t hash = yaml_intern_hash(string, length);
+	uint64_t mask;
+	uint64_t slot;
+	uint64_t probes;
+
+	assert(binary && binary->header); /* Mapped binary document is expected. */
+	assert(string || !length);
+
+	mask = binary->header->slot_count - 1;
+	for (slot = hash & mask, probes = 0; probes <= mask; slot = (slot + 1) & mask, probes++) {
+		uint32_t id = binary->slots[slot];
+		const yaml_binary_string_t *entry;
+
+		if (!id || id > binary->header->string_count)
+			return 0;
+
+		entry = binary->strings + id - 1;
+		if (entry->hash != hash || entry->length != length)
+			continue;
+		if (!memcmp(binary->blob + entry->offset, string, length))
+			return (int)id;
+	}
+	return 0;
+}
@@ -0,0 +1,299 @@
+#include "yaml_private.h"
+
+int yaml_document_init(yaml_document_t *document, int major, int minor,
+		yaml_tag_directive_t *tag_directives_start,
+		yaml_tag_directive_t *tag_directives_end,
+		int start_implicit, int end_implicit) {
+	yaml_tag_directive_t *tag_directive;
+	yaml_tag_directive_t *copy;
+	size_t count = tag_directives_end - tag_directives_start;
+	int error;
+
+	assert(document); /* Non-NULL document object is expected. */
+	assert((tag_directives_start && tag_directives_end) ||
+		(tag_directives_start == tag_directives_end));
+	memset(document, 0, sizeof(yaml_document_t));
+
+	YAML_STACK_INIT(&error, &document->nodes, yaml_node_t, YAML_INITIAL_STACK_SIZE);
+	if (error)
+		return error;
+
+	error = yaml_intern_init(&document->strings);
+	if (error)
+		goto ERROR;
+
+	if (count) {
+		document->tag_directives.start = (yaml_tag_directive_t *)YAML_MALLOC(count * sizeof(yaml_tag_directive_t));
+		if (!document->tag_directives.start) {
+			error = YAML_EMEMORY;
+			goto ERROR;
+		}
+		memset(document->tag_directives.start, 0, count * sizeof(yaml_tag_directive_t));
+		document->tag_directives.end = document->tag_directives.start;
+
+		for (tag_directive = tag_directives_start; tag_directive != tag_directives_end; tag_directive++) {
+			assert(tag_directive->handle && tag_directive->prefix);
+
+			copy = document->tag_directives.end++;
+			copy->handle = yaml_strdup(tag_directive->handle);
+			copy->prefix = yaml_strdup(tag_directive->prefix);
+			if (!copy->handle || !copy->prefix) {
+				error = YAML_EMEMORY;
+				goto ERROR;
+			}
+		}
+	}
+
+	document->version_directive.major = major;
+	document->version_directive.minor = minor;
+	document->start_implicit = start_implicit;
+	document->end_implicit = end_implicit;
+
+	return YAML_EOK;
+
+ERROR:
+	for (tag_directive = document->tag_directives.start;
+		tag_directive != document->tag_directives.end; tag_directive++) {
+		YAML_FREE(tag_directive->handle);
+		YAML_FREE(tag_directive->prefix);
+	}
+	YAML_FREE(document->tag_directives.start);
+	yaml_intern_destroy(&document->strings);
+	YAML_STACK_DESTROY(&document->nodes);
+
+	return error;
+}
+
+void yaml_document_destroy(yaml_document_t *document) {
+	yaml_tag_directive_t *tag_directive;
+	yaml_node_t *node;
+
+	assert(document); /* Non-NULL document object is expected. */
+
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		/* Tags and interned scalars belong to the string table. */
+		switch (node->type) {
+		case YAML_NSTYLE_SCALAR:
+			if (!node->data.scalar.value_id)
+				YAML_FREE(node->data.scalar.value);
+			break;
+		case YAML_NSTYLE_SEQUENCE:
+			YAML_STACK_DESTROY(&node->data.sequence.items);
+			break;
+		case YAML_NSTYLE_MAPPING:
+			YAML_STACK_DESTROY(&node->data.mapping.pairs);
+			break;
+		default:
+			assert(0); /* Should not happen. */
+		}
+	}
+	YAML_STACK_DESTROY(&document->nodes);
+
+	for (tag_directive = document->tag_directives.start;
+		tag_directive != document->tag_directives.end; tag_directive++) {
+		YAML_FREE(tag_directive->handle);
+		YAML_FREE(tag_directive->prefix);
+	}
+	YAML_FREE(document->tag_directives.start);
+
+	yaml_intern_destroy(&document->strings);
+
+	memset(document, 0, sizeof(yaml_document_t));
+}
+
+yaml_node_t *yaml_document_get_node(yaml_document_t *document, int index) {
+	assert(document); /* Non-NULL document object is expected. */
+
+	if (index > 0 && document->nodes.start + index <= document->nodes.top)
+		return document->nodes.start + index - 1;
+	return NULL;
+}
+
+yaml_node_t *yaml_document_get_root_node(yaml_document_t *document) {
+	assert(document); /* Non-NULL document object is expected. */
+
+	if (document->nodes.top != document->nodes.start)
+		return document->nodes.start;
+	return NULL;
+}
+
+/* Intern a node tag, falling back to the default one.
+ */
+static int yaml_document_tag_(yaml_document_t *document, yaml_char_t *tag,
+		const char *default_tag, yaml_char_t **shared) {
+	int id;
+
+	if (!tag)
+		tag = (yaml_char_t *)default_tag;
+
+	id = yaml_intern_add(&document->strings, tag, strlen((char *)tag));
+	if (id > 0)
+		*shared = (yaml_char_t *)yaml_intern_get(&document->strings, id);
+	return id;
+}
+
+int yaml_document_add_scalar(yaml_document_t *document,
+		yaml_char_t *tag, yaml_char_t *value, int length,
+		int style) {
+	yaml_mark_t mark = { 0, 0, 0 };
+	yaml_char_t *tag_copy = NULL;
+	yaml_char_t *value_copy;
+	yaml_node_t node;
+	int tag_id;
+	int error;
+
+	assert(document); /* Non-NULL document object is expected. */
+	assert(value); /* Non-NULL value is expected. */
+
+	tag_id = yaml_document_tag_(document, tag, YAML_TAG_DEFAULT_SCALAR, &tag_copy);
+	if (tag_id < 0)
+		return tag_id;
+
+	if (length < 0)
+		length = (int)strlen((char *)value);
+
+	value_copy = (yaml_char_t *)YAML_MALLOC(length + 1);
+	if (!value_copy)
+		return YAML_EMEMORY;
+	memcpy(value_copy, value, length);
+	value_copy[length] = '\0';
+
+	YAML_SCALAR_NODE_INIT(&node, tag_copy, tag_id, value_copy, length, style, mark, mark);
+	node.data.scalar.implicit = !tag;
+	YAML_STACK_PUSH(&error, &document->nodes, yaml_node_t, node);
+	if (error) {
+		YAML_FREE(value_copy);
+		return error;
+	}
+
+	return (int)(document->nodes.top - document->nodes.start);
+}
+
+int yaml_document_add_sequence(yaml_document_t *document, yaml_char_t *tag, int style) {
+	yaml_mark_t mark = { 0, 0, 0 };
+	yaml_char_t *tag_copy = NULL;
+	YAML_STACK_STRUCT(yaml_node_item_t) items;
+	yaml_node_t node;
+	int tag_id;
+	int error;
+
+	assert(document); /* Non-NULL document object is expected. */
+
+	tag_id = yaml_document_tag_(document, tag, YAML_TAG_DEFAULT_SEQUENCE, &tag_copy);
+	if (tag_id < 0)
+		return tag_id;
+
+	YAML_STACK_INIT(&error, &items, yaml_node_item_t, YAML_INITIAL_STACK_SIZE);
+	if (error)
+		return error;
+
+	YAML_SEQUENCE_NODE_INIT(&node, tag_copy, tag_id, items.start, items.end, style, mark, mark);
+	YAML_STACK_PUSH(&error, &document->nodes, yaml_node_t, node);
+	if (error) {
+		YAML_STACK_DESTROY(&items);
+		return error;
+	}
+
+	return (int)(document->nodes.top - document->nodes.start);
+}
+
+int yaml_document_add_mapping(yaml_document_t *document, yaml_char_t *tag, int style) {
+	yaml_mark_t mark = { 0, 0, 0 };
+	yaml_char_t *tag_copy = NULL;
+	YAML_STACK_STRUCT(yaml_node_pair_t) pairs;
+	yaml_node_t node;
+	int tag_id;
+	int error;
+
+	assert(document); /* Non-NULL document object is expected. */
+
+	tag_id = yaml_document_tag_(document, tag, YAML_TAG_DEFAULT_MAPPING, &tag_copy);
+	if (tag_id < 0)
+		return tag_id;
+
+	YAML_STACK_INIT(&error, &pairs, yaml_node_pair_t, YAML_INITIAL_STACK_SIZE);
+	if (error)
+		return error;
+
+	YAML_MAPPING_NODE_INIT(&node, tag_copy, tag_id, pairs.start, pairs.end, style, mark, mark);
+	YAML_STACK_PUSH(&error, &document->nodes, yaml_node_t, node);
+	if (error) {
+		YAML_STACK_DESTROY(&pairs);
+		return error;
+	}
+
+	return (int)(document->nodes.top - document->nodes.start);
+}
+
+int yaml_document_append_sequence_item(yaml_document_t *document, int sequence, int item) {
+	yaml_node_t *node;
+	int error;
+
+	assert(document); /* Non-NULL document is required. */
+	assert(sequence > 0 && document->nodes.start + sequence <= document->nodes.top);
+	assert(document->nodes.start[sequence - 1].type == YAML_NSTYLE_SEQUENCE);
+	assert(item > 0 && document->nodes.start + item <= document->nodes.top);
+
+	node = document->nodes.start + sequence - 1;
+	YAML_STACK_PUSH(&error, &node->data.sequence.items, yaml_node_item_t, item);
+	if (error)
+		return error;
+	YAML_DOCUMENT_REFERENCE(document, item);
+
+	return YAML_EOK;
+}
+
+int yaml_document_append_mapping_pair(yaml_document_t *document, int mapping, int key, int value) {
+	yaml_node_t *node;
+	yaml_node_t *key_node;
+	yaml_node_pair_t pair;
+	int error;
+
+	assert(document); /* Non-NULL document is required. */
+	assert(mapping > 0 && document->nodes.start + mapping <= document->nodes.top);
+	assert(document->nodes.start[mapping - 1].type == YAML_NSTYLE_MAPPING);
+	assert(key > 0 && document->nodes.start + key <= document->nodes.top);
+	assert(value > 0 && document->nodes.start + value <= document->nodes.top);
+
+	/* Scalar keys repeat across mappings, share them through the string table. */
+	key_node = document->nodes.start + key - 1;
+	if (key_node->type == YAML_NSTYLE_SCALAR && !key_node->data.scalar.value_id) {
+		int id = yaml_intern_add(&document->strings,
+			key_node->data.scalar.value, key_node->data.scalar.length);
+
+		if (id < 0)
+			return id;
+		YAML_FREE(key_node->data.scalar.value);
+		key_node->data.scalar.value = (yaml_char_t *)yaml_intern_get(&document->strings, id);
+		key_node->data.scalar.value_id = id;
+	}
+
+	pair.key = key;
+	pair.value = value;
+	node = document->nodes.start + mapping - 1;
+	YAML_STACK_PUSH(&error, &node->data.mapping.pairs, yaml_node_pair_t, pair);
+	if (error)
+		return error;
+	YAML_DOCUMENT_REFERENCE(document, key);
+	YAML_DOCUMENT_REFERENCE(document, value);
+
+	return YAML_EOK;
+}
+
+int yaml_document_intern(yaml_document_t *document, const yaml_char_t *string, size_t length) {
+	assert(document); /* Non-NULL document is required. */
+
+	return yaml_intern_add(&document->strings, string, length);
+}
+
+int yaml_document_find_string(const yaml_document_t *document, const yaml_char_t *string, size_t length) {
+	assert(document); /* Non-NULL document is required. */
+
+	return yaml_intern_find(&document->strings, string, length);
+}
+
+const yaml_char_t *yaml_document_get_string(const yaml_document_t *document, int id) {
+	assert(document); /* Non-NULL document is required. */
+
+	return yaml_intern_get(&document->strings, id);
+}
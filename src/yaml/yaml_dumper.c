@@ -0,0 +1,401 @@
+#include <stdio.h>
+#include "yaml_private.h"
+
+#define YAML_ANCHOR_TEMPLATE		"id%03d"
+#define YAML_ANCHOR_TEMPLATE_LENGTH	16
+
+int yaml_emitter_open(yaml_emitter_t *emitter) {
+	yaml_event_t event;
+	yaml_mark_t mark = { 0, 0, 0 };
+	int error;
+
+	assert(emitter); /* Non-NULL emitter object is required. */
+	assert(!emitter->opened); /* Emitter should not be opened yet. */
+
+	YAML_EVENT_STREAM_START_INIT(&event, YAML_ENCODING_ANY, mark, mark);
+
+	error = yaml_emitter_emit(emitter, &event);
+	if (error)
+		return error;
+
+	emitter->opened = 1;
+	return YAML_EOK;
+}
+
+int yaml_emitter_close(yaml_emitter_t *emitter) {
+	yaml_event_t event;
+	yaml_mark_t mark = { 0, 0, 0 };
+	int error;
+
+	assert(emitter); /* Non-NULL emitter object is required. */
+	assert(emitter->opened); /* Emitter should be opened. */
+
+	if (emitter->closed)
+		return YAML_EOK;
+
+	YAML_EVENT_STREAM_END_INIT(&event, mark, mark);
+
+	error = yaml_emitter_emit(emitter, &event);
+	if (error)
+		return error;
+
+	emitter->closed = 1;
+	yaml_emitter_release_output(emitter);
+	return YAML_EOK;
+}
+
+/* Release the document and the anchors once it is dumped.
+ * The strings handed over to the events are no longer held by the nodes.
+ */
+static void yaml_emitter_delete_document_and_anchors_(yaml_emitter_t *emitter) {
+	yaml_document_destroy(emitter->document);
+	YAML_FREE(emitter->anchors);
+
+	emitter->anchors = NULL;
+	emitter->last_anchor_id = 0;
+	emitter->document = NULL;
+}
+
+/* Count the references to a node and give an anchor to the shared ones.
+ */
+static void yaml_emitter_anchor_node_(yaml_emitter_t *emitter, int index) {
+	yaml_node_t *node = emitter->document->nodes.start + index - 1;
+	yaml_node_item_t *item;
+	yaml_node_pair_t *pair;
+
+	emitter->anchors[index - 1].references++;
+
+	if (emitter->anchors[index - 1].references == 1) {
+		switch (node->type) {
+		case YAML_NSTYLE_SEQUENCE:
+			for (item = node->data.sequence.items.start; item < node->data.sequence.items.top; item++)
+				yaml_emitter_anchor_node_(emitter, *item);
+			break;
+		case YAML_NSTYLE_MAPPING:
+			for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
+				yaml_emitter_anchor_node_(emitter, pair->key);
+				yaml_emitter_anchor_node_(emitter, pair->value);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	else if (emitter->anchors[index - 1].references == 2) {
+		emitter->anchors[index - 1].anchor = ++emitter->last_anchor_id;
+	}
+}
+
+/* Count the references to every node in one pass over the collections,
+ * without following them, and tell if a node is held twice. The root is
+ * held by the document itself.
+ */
+static int yaml_emitter_count_references_(yaml_emitter_t *emitter, yaml_document_t *document) {
+	yaml_node_t *node;
+	yaml_node_item_t *item;
+	yaml_node_pair_t *pair;
+	int shared = 0;
+
+#define YAML_EMITTER_REFERENCE(index) do { \
+	if (++emitter->anchors[(index) - 1].references == 2) \
+		shared = 1; \
+} while (0)
+
+	YAML_EMITTER_REFERENCE(1);
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		if (node->type == YAML_NSTYLE_SEQUENCE) {
+			for (item = node->data.sequence.items.start; item < node->data.sequence.items.top; item++)
+				YAML_EMITTER_REFERENCE(*item);
+		}
+		else if (node->type == YAML_NSTYLE_MAPPING) {
+			for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
+				YAML_EMITTER_REFERENCE(pair->key);
+				YAML_EMITTER_REFERENCE(pair->value);
+			}
+		}
+	}
+
+#undef YAML_EMITTER_REFERENCE
+
+	return shared;
+}
+
+static yaml_char_t *yaml_emitter_generate_anchor_(yaml_emitter_t *emitter, int anchor_id) {
+	yaml_char_t *anchor = (yaml_char_t *)YAML_MALLOC(YAML_ANCHOR_TEMPLATE_LENGTH);
+
+	if (!anchor) {
+		emitter->error = YAML_EMEMORY;
+		return NULL;
+	}
+
+	sprintf((char *)anchor, YAML_ANCHOR_TEMPLATE, anchor_id);
+	return anchor;
+}
+
+/* Copy the tag of a node for an event, none if it is implied by the kind of the node.
+ */
+static int yaml_emitter_node_tag_(yaml_emitter_t *emitter, yaml_node_t *node, int implicit, yaml_char_t **tag) {
+	*tag = NULL;
+	if (implicit && !emitter->canonical)
+		return YAML_EOK;
+
+	*tag = yaml_strdup(node->tag);
+	if (!*tag) {
+		emitter->error = YAML_EMEMORY;
+		return YAML_EMEMORY;
+	}
+	return YAML_EOK;
+}
+
+static int yaml_emitter_dump_node_(yaml_emitter_t *emitter, int index);
+
+/* Build the DOCUMENT-START event, with copies of the directives it owns.
+ */
+static int yaml_emitter_document_start_(yaml_emitter_t *emitter, yaml_document_t *document, yaml_event_t *event) {
+	yaml_mark_t mark = { 0, 0, 0 };
+	yaml_tag_directive_t *tag_directives = NULL;
+	size_t count = document->tag_directives.end - document->tag_directives.start;
+	size_t i;
+
+	if (count) {
+		tag_directives = (yaml_tag_directive_t *)YAML_MALLOC(count * sizeof(yaml_tag_directive_t));
+		if (!tag_directives) {
+			emitter->error = YAML_EMEMORY;
+			return YAML_EMEMORY;
+		}
+		for (i = 0; i < count; i++) {
+			tag_directives[i].handle = yaml_strdup(document->tag_directives.start[i].handle);
+			tag_directives[i].prefix = yaml_strdup(document->tag_directives.start[i].prefix);
+			if (!tag_directives[i].handle || !tag_directives[i].prefix) {
+				count = i + 1;
+				for (i = 0; i < count; i++) {
+					YAML_FREE(tag_directives[i].handle);
+					YAML_FREE(tag_directives[i].prefix);
+				}
+				YAML_FREE(tag_directives);
+				emitter->error = YAML_EMEMORY;
+				return YAML_EMEMORY;
+			}
+		}
+	}
+
+	YAML_EVENT_DOCUMENT_START_INIT(event, document->version_directive, tag_directives,
+		tag_directives ? tag_directives + count : NULL, document->start_implicit, mark, mark);
+	return YAML_EOK;
+}
+
+static int yaml_emitter_dump_alias_(yaml_emitter_t *emitter, yaml_char_t *anchor) {
+	yaml_event_t event;
+	yaml_mark_t mark = { 0, 0, 0 };
+
+	YAML_EVENT_ALIAS_INIT(&event, anchor, mark, mark);
+
+	return yaml_emitter_emit(emitter, &event);
+}
+
+/* The value goes to the event: owned values are handed over, the
+ * ones in the string table are copied.
+ */
+static int yaml_emitter_dump_scalar_(yaml_emitter_t *emitter, yaml_node_t *node, yaml_char_t *anchor) {
+	yaml_event_t event;
+	yaml_mark_t mark = { 0, 0, 0 };
+	yaml_char_t *value;
+	yaml_char_t *tag;
+	int implicit = (node->tag_id == YAML_TAG_ID_STR && node->data.scalar.implicit);
+	int error;
+
+	error = yaml_emitter_node_tag_(emitter, node, implicit, &tag);
+	if (error) {
+		YAML_FREE(anchor);
+		return error;
+	}
+
+	if (node->data.scalar.value_id) {
+		value = (yaml_char_t *)YAML_MALLOC(node->data.scalar.length + 1);
+		if (!value) {
+			emitter->error = YAML_EMEMORY;
+			YAML_FREE(anchor);
+			YAML_FREE(tag);
+			return YAML_EMEMORY;
+		}
+		memcpy(value, node->data.scalar.value, node->data.scalar.length);
+		value[node->data.scalar.length] = '\0';
+	}
+	else {
+		value = node->data.scalar.value;
+		node->data.scalar.value = NULL;
+	}
+
+	YAML_EVENT_SCALAR_INIT(&event, anchor, tag, value, node->data.scalar.length,
+		implicit, implicit, node->data.scalar.style, mark, mark);
+
+	return yaml_emitter_emit(emitter, &event);
+}
+
+static int yaml_emitter_dump_sequence_(yaml_emitter_t *emitter, yaml_node_t *node, yaml_char_t *anchor) {
+	yaml_event_t event;
+	yaml_mark_t mark = { 0, 0, 0 };
+	yaml_node_item_t *item;
+	yaml_char_t *tag;
+	int implicit = (node->tag_id == YAML_TAG_ID_SEQ);
+	int error;
+
+	error = yaml_emitter_node_tag_(emitter, node, implicit, &tag);
+	if (error) {
+		YAML_FREE(anchor);
+		return error;
+	}
+
+	YAML_EVENT_SEQUENCE_START_INIT(&event, anchor, tag, implicit, node->data.sequence.style, mark, mark);
+	error = yaml_emitter_emit(emitter, &event);
+	if (error)
+		return error;
+
+	for (item = node->data.sequence.items.start; item < node->data.sequence.items.top; item++) {
+		error = yaml_emitter_dump_node_(emitter, *item);
+		if (error)
+			return error;
+	}
+
+	YAML_EVENT_SEQUENCE_END_INIT(&event, mark, mark);
+	return yaml_emitter_emit(emitter, &event);
+}
+
+static int yaml_emitter_dump_mapping_(yaml_emitter_t *emitter, yaml_node_t *node, yaml_char_t *anchor) {
+	yaml_event_t event;
+	yaml_mark_t mark = { 0, 0, 0 };
+	yaml_node_pair_t *pair;
+	yaml_char_t *tag;
+	int implicit = (node->tag_id == YAML_TAG_ID_MAP);
+	int error;
+
+	error = yaml_emitter_node_tag_(emitter, node, implicit, &tag);
+	if (error) {
+		YAML_FREE(anchor);
+		return error;
+	}
+
+	YAML_EVENT_MAPPING_START_INIT(&event, anchor, tag, implicit, node->data.mapping.style, mark, mark);
+	error = yaml_emitter_emit(emitter, &event);
+	if (error)
+		return error;
+
+	for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
+		error = yaml_emitter_dump_node_(emitter, pair->key);
+		if (error)
+			return error;
+		error = yaml_emitter_dump_node_(emitter, pair->value);
+		if (error)
+			return error;
+	}
+
+	YAML_EVENT_MAPPING_END_INIT(&event, mark, mark);
+	return yaml_emitter_emit(emitter, &event);
+}
+
+/* Without anchors every node is reached once and dumped in full.
+ */
+static int yaml_emitter_dump_node_(yaml_emitter_t *emitter, int index) {
+	yaml_node_t *node = emitter->document->nodes.start + index - 1;
+	yaml_char_t *anchor = NULL;
+
+	if (emitter->anchors) {
+		int anchor_id = emitter->anchors[index - 1].anchor;
+
+		if (anchor_id) {
+			anchor = yaml_emitter_generate_anchor_(emitter, anchor_id);
+			if (!anchor)
+				return YAML_EMEMORY;
+		}
+		if (emitter->anchors[index - 1].serialized)
+			return yaml_emitter_dump_alias_(emitter, anchor);
+		emitter->anchors[index - 1].serialized = 1;
+	}
+
+	switch (node->type) {
+	case YAML_NSTYLE_SCALAR:
+		return yaml_emitter_dump_scalar_(emitter, node, anchor);
+	case YAML_NSTYLE_SEQUENCE:
+		return yaml_emitter_dump_sequence_(emitter, node, anchor);
+	case YAML_NSTYLE_MAPPING:
+		return yaml_emitter_dump_mapping_(emitter, node, anchor);
+	default:
+		assert(0); /* Could not happen. */
+		break;
+	}
+
+	YAML_FREE(anchor);
+	return YAML_EFAILD;
+}
+
+int yaml_emitter_dump(yaml_emitter_t *emitter, yaml_document_t *document) {
+	yaml_event_t event;
+	yaml_mark_t mark = { 0, 0, 0 };
+	size_t count;
+	int error;
+
+	assert(emitter); /* Non-NULL emitter object is required. */
+	assert(document); /* Non-NULL document object is expected. */
+
+	emitter->document = document;
+
+	if (!emitter->opened) {
+		error = yaml_emitter_open(emitter);
+		if (error)
+			goto ERROR;
+	}
+
+	/* An empty document closes the stream. */
+	if (document->nodes.start == document->nodes.top) {
+		error = yaml_emitter_close(emitter);
+		yaml_emitter_delete_document_and_anchors_(emitter);
+		return error;
+	}
+
+	assert(emitter->opened); /* Emitter should be opened. */
+
+	/* Only documents sharing nodes need the anchors pass. */
+	if (document->shared || document->shared_invalid) {
+		count = document->nodes.top - document->nodes.start;
+		emitter->anchors = YAML_MALLOC(sizeof(*emitter->anchors) * count);
+		if (!emitter->anchors) {
+			emitter->error = YAML_EMEMORY;
+			error = YAML_EMEMORY;
+			goto ERROR;
+		}
+		memset(emitter->anchors, 0, sizeof(*emitter->anchors) * count);
+
+		/* The count is not kept through edits in place, check it first. */
+		if (document->shared_invalid && !yaml_emitter_count_references_(emitter, document)) {
+			YAML_FREE(emitter->anchors);
+			emitter->anchors = NULL;
+		}
+		else {
+			memset(emitter->anchors, 0, sizeof(*emitter->anchors) * count);
+			yaml_emitter_anchor_node_(emitter, 1);
+		}
+	}
+
+	error = yaml_emitter_document_start_(emitter, document, &event);
+	if (error)
+		goto ERROR;
+	error = yaml_emitter_emit(emitter, &event);
+	if (error)
+		goto ERROR;
+
+	error = yaml_emitter_dump_node_(emitter, 1);
+	if (error)
+		goto ERROR;
+
+	YAML_EVENT_DOCUMENT_END_INIT(&event, document->end_implicit, mark, mark);
+	error = yaml_emitter_emit(emitter, &event);
+	if (error)
+		goto ERROR;
+
+	yaml_emitter_delete_document_and_anchors_(emitter);
+	return YAML_EOK;
+
+ERROR:
+	yaml_emitter_delete_document_and_anchors_(emitter);
+	return error;
+}
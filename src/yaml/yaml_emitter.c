@@ -0,0 +1,1466 @@
+#include <limits.h>
+#include "yaml_private.h"
+
+int yaml_emitter_init(yaml_emitter_t *emitter) {
+	int error;
+
+	assert(emitter); /* Non-NULL emitter object expected. */
+	memset(emitter, 0, sizeof(yaml_emitter_t));
+
+	YAML_BUFFER_INIT(&emitter->error, &emitter->buffer, yaml_char_t, YAML_OUTPUT_BUFFER_SIZE);
+	if (emitter->error)
+		goto ERROR;
+	YAML_BUFFER_INIT(&emitter->error, &emitter->raw_buffer, yaml_byte_t, YAML_OUTPUT_RAW_BUFFER_SIZE);
+	if (emitter->error)
+		goto ERROR;
+	YAML_STACK_INIT(&emitter->error, &emitter->states, int, YAML_INITIAL_STACK_SIZE);
+	if (emitter->error)
+		goto ERROR;
+	YAML_QUEUE_INIT(&emitter->error, &emitter->events, yaml_event_t, YAML_INITIAL_QUEUE_SIZE);
+	if (emitter->error)
+		goto ERROR;
+	YAML_STACK_INIT(&emitter->error, &emitter->indents, int, YAML_INITIAL_STACK_SIZE);
+	if (emitter->error)
+		goto ERROR;
+	YAML_STACK_INIT(&emitter->error, &emitter->tag_directives, yaml_tag_directive_t, YAML_INITIAL_STACK_SIZE);
+	if (emitter->error)
+		goto ERROR;
+
+	emitter->zero_copy_threshold = YAML_ZERO_COPY_THRESHOLD;
+
+	return YAML_EOK;
+
+ERROR:
+	error = emitter->error;
+	YAML_BUFFER_DESTROY(&emitter->buffer);
+	YAML_BUFFER_DESTROY(&emitter->raw_buffer);
+	YAML_STACK_DESTROY(&emitter->states);
+	YAML_QUEUE_DESTROY(&emitter->events);
+	YAML_STACK_DESTROY(&emitter->indents);
+	YAML_STACK_DESTROY(&emitter->tag_directives);
+
+	return error;
+}
+
+void yaml_emitter_destroy(yaml_emitter_t *emitter) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	while (emitter->events.head != emitter->events.tail)
+		yaml_event_destroy(&YAML_QUEUE_DEQUEUE(&emitter->events));
+	while (emitter->tag_directives.top != emitter->tag_directives.start) {
+		yaml_tag_directive_t tag_directive = YAML_STACK_POP(&emitter->tag_directives);
+
+		YAML_FREE(tag_directive.handle);
+		YAML_FREE(tag_directive.prefix);
+	}
+
+	/* A memory output that was never handed back. */
+	if (emitter->write_handler == yaml_buffer_write_handler && emitter->output.buffer) {
+		YAML_FREE(emitter->output.buffer->start);
+		memset(emitter->output.buffer, 0, sizeof(yaml_output_buffer_t));
+	}
+
+	YAML_BUFFER_DESTROY(&emitter->buffer);
+	YAML_BUFFER_DESTROY(&emitter->raw_buffer);
+	YAML_STACK_DESTROY(&emitter->states);
+	YAML_QUEUE_DESTROY(&emitter->events);
+	YAML_STACK_DESTROY(&emitter->indents);
+	YAML_STACK_DESTROY(&emitter->tag_directives);
+	YAML_FREE(emitter->anchors);
+
+	memset(emitter, 0, sizeof(yaml_emitter_t));
+}
+
+int yaml_emitter_reset(yaml_emitter_t *emitter) {
+	yaml_emitter_t grown;
+	int error = YAML_EOK;
+
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	while (emitter->events.head != emitter->events.tail)
+		yaml_event_destroy(&YAML_QUEUE_DEQUEUE(&emitter->events));
+	while (emitter->tag_directives.top != emitter->tag_directives.start) {
+		yaml_tag_directive_t tag_directive = YAML_STACK_POP(&emitter->tag_directives);
+
+		YAML_FREE(tag_directive.handle);
+		YAML_FREE(tag_directive.prefix);
+	}
+	if (emitter->write_handler == yaml_buffer_write_handler && emitter->output.buffer) {
+		YAML_FREE(emitter->output.buffer->start);
+		memset(emitter->output.buffer, 0, sizeof(yaml_output_buffer_t));
+	}
+	YAML_FREE(emitter->anchors);
+
+	/* Start over with the storage of the previous run. */
+	grown = *emitter;
+	memset(emitter, 0, sizeof(yaml_emitter_t));
+
+	emitter->buffer.start = grown.buffer.start;
+	emitter->buffer.end = grown.buffer.end;
+	emitter->buffer.pointer = emitter->buffer.last = grown.buffer.start;
+	emitter->raw_buffer.start = grown.raw_buffer.start;
+	emitter->raw_buffer.end = grown.raw_buffer.end;
+	emitter->raw_buffer.pointer = emitter->raw_buffer.last = grown.raw_buffer.start;
+	emitter->events.start = grown.events.start;
+	emitter->events.end = grown.events.end;
+	emitter->events.head = emitter->events.tail = grown.events.start;
+	emitter->states.start = emitter->states.top = grown.states.start;
+	emitter->states.end = grown.states.end;
+	emitter->indents.start = emitter->indents.top = grown.indents.start;
+	emitter->indents.end = grown.indents.end;
+	emitter->tag_directives.start = emitter->tag_directives.top = grown.tag_directives.start;
+	emitter->tag_directives.end = grown.tag_directives.end;
+
+	emitter->zero_copy_threshold = YAML_ZERO_COPY_THRESHOLD;
+
+	/* A memory output took the buffer along. */
+	if (!emitter->buffer.start) {
+		YAML_BUFFER_INIT(&error, &emitter->buffer, yaml_char_t, YAML_OUTPUT_BUFFER_SIZE);
+		emitter->error = error;
+	}
+
+	return error;
+}
+
+/* String write handler.
+ */
+static int yaml_string_write_handler(void *data, unsigned char *buffer, size_t size) {
+	yaml_emitter_t *emitter = (yaml_emitter_t *)data;
+
+	if (emitter->output.string.size - *emitter->output.string.size_written < size) {
+		memcpy(emitter->output.string.buffer + *emitter->output.string.size_written, buffer,
+			emitter->output.string.size - *emitter->output.string.size_written);
+		*emitter->output.string.size_written = emitter->output.string.size;
+		return YAML_EFAILD;
+	}
+
+	memcpy(emitter->output.string.buffer + *emitter->output.string.size_written, buffer, size);
+	*emitter->output.string.size_written += size;
+	return YAML_EOK;
+}
+
+/* File write handler.
+ */
+static int yaml_file_write_handler(void *data, unsigned char *buffer, size_t size) {
+	yaml_emitter_t *emitter = (yaml_emitter_t *)data;
+
+	return fwrite(buffer, 1, size, emitter->output.file) == size ? YAML_EOK : YAML_EFAILD;
+}
+
+void yaml_emitter_set_output_string(yaml_emitter_t *emitter,
+		unsigned char *output, size_t size, size_t *size_written) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+	assert(!emitter->write_handler && !emitter->writev_handler); /* You can set the output only once. */
+	assert(output); /* Non-NULL output string expected. */
+
+	emitter->write_handler = yaml_string_write_handler;
+	emitter->write_handler_data = emitter;
+
+	emitter->output.string.buffer = output;
+	emitter->output.string.size = size;
+	emitter->output.string.size_written = size_written;
+	*size_written = 0;
+}
+
+void yaml_emitter_set_output_file(yaml_emitter_t *emitter, FILE *file) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+	assert(!emitter->write_handler && !emitter->writev_handler); /* You can set the output only once. */
+	assert(file); /* Non-NULL file object expected. */
+
+	emitter->write_handler = yaml_file_write_handler;
+	emitter->write_handler_data = emitter;
+	emitter->output.file = file;
+}
+
+void yaml_emitter_set_output(yaml_emitter_t *emitter,
+		yaml_write_handler_t *handler, void *data) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+	assert(!emitter->write_handler && !emitter->writev_handler); /* You can set the output only once. */
+	assert(handler); /* Non-NULL handler object expected. */
+
+	emitter->write_handler = handler;
+	emitter->write_handler_data = data;
+}
+
+void yaml_emitter_set_output_buffer(yaml_emitter_t *emitter, yaml_output_buffer_t *output) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+	assert(!emitter->write_handler && !emitter->writev_handler); /* You can set the output only once. */
+	assert(output); /* Non-NULL output buffer expected. */
+
+	/* Emit straight into the reused memory. */
+	if (output->start) {
+		YAML_FREE(emitter->buffer.start);
+		emitter->buffer.start = output->start;
+		emitter->buffer.pointer = output->start;
+		emitter->buffer.last = output->start;
+		emitter->buffer.end = output->start + output->capacity;
+	}
+	output->start = NULL;
+	output->size = 0;
+	output->capacity = 0;
+
+	emitter->write_handler = yaml_buffer_write_handler;
+	emitter->write_handler_data = emitter;
+	emitter->output.buffer = output;
+}
+
+void yaml_emitter_set_output_fd(yaml_emitter_t *emitter, int fd) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+	assert(!emitter->write_handler && !emitter->writev_handler); /* You can set the output only once. */
+	assert(fd >= 0); /* Valid file descriptor expected. */
+
+	emitter->writev_handler = yaml_fd_writev_handler;
+	emitter->writev_handler_data = emitter;
+	emitter->output.fd = fd;
+}
+
+void yaml_emitter_set_output_writev(yaml_emitter_t *emitter,
+		yaml_writev_handler_t *handler, void *data) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+	assert(!emitter->write_handler && !emitter->writev_handler); /* You can set the output only once. */
+	assert(handler); /* Non-NULL handler object expected. */
+
+	emitter->writev_handler = handler;
+	emitter->writev_handler_data = data;
+}
+
+void yaml_emitter_set_zero_copy_threshold(yaml_emitter_t *emitter, size_t threshold) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	emitter->zero_copy_threshold = threshold;
+}
+
+void yaml_emitter_set_encoding(yaml_emitter_t *emitter, int encoding) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+	assert(!emitter->encoding); /* You can set encoding only once. */
+
+	emitter->encoding = encoding;
+}
+
+void yaml_emitter_set_canonical(yaml_emitter_t *emitter, int canonical) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	emitter->canonical = (canonical != 0);
+}
+
+void yaml_emitter_set_json(yaml_emitter_t *emitter, int json) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	emitter->json = (json != 0);
+}
+
+void yaml_emitter_set_indent(yaml_emitter_t *emitter, int indent) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	emitter->best_indent = (1 < indent && indent < 10) ? indent : 2;
+}
+
+void yaml_emitter_set_width(yaml_emitter_t *emitter, int width) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	emitter->best_width = (width >= 0) ? width : -1;
+}
+
+void yaml_emitter_set_unicode(yaml_emitter_t *emitter, int unicode) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	emitter->unicode = (unicode != 0);
+}
+
+void yaml_emitter_set_break(yaml_emitter_t *emitter, int line_break) {
+	assert(emitter); /* Non-NULL emitter object expected. */
+
+	emitter->line_break = line_break;
+}
+
+/* Character classes of the scalar analyzer.
+ */
+#define YAML_CLASS_SPACE		0x01 /* ' ' */
+#define YAML_CLASS_BREAK		0x02 /* '\r', '\n' */
+#define YAML_CLASS_SPECIAL		0x04 /* Not printable: control characters, '\t', '\r', DEL. */
+#define YAML_CLASS_FIRST		0x08 /* An indicator at the start of a scalar. */
+#define YAML_CLASS_FLOW			0x10 /* A flow indicator anywhere: ",?[]{}". */
+#define YAML_CLASS_COLON		0x20 /* ':' */
+#define YAML_CLASS_COMMENT		0x40 /* '#' */
+#define YAML_CLASS_NON_ASCII	0x80
+
+static const unsigned char yaml_emitter_classes_[256] = {
+	0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x02, 0x04, 0x04, 0x06, 0x04, 0x04,
+	0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+	0x01, 0x08, 0x08, 0x48, 0x00, 0x08, 0x08, 0x08, 0x00, 0x00, 0x08, 0x00, 0x18, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x08, 0x10,
+	0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x18, 0x00, 0x00,
+	0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x08, 0x18, 0x00, 0x04,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+};
+
+/* Check that none of the 8 octets changes the analysis inside a scalar:
+ * all of them are printable ASCII, neither spaces nor indicators.
+ */
+static int yaml_emitter_swar_plain_(const yaml_char_t *pointer) {
+	uint64_t x;
+
+	memcpy(&x, pointer, sizeof(x));
+	return !((x & YAML_SWAR_HIGHS) | YAML_SWAR_HAS_LESS(x, 0x21) | YAML_SWAR_HAS(x, 0x7F)
+		| YAML_SWAR_HAS(x, ',') | YAML_SWAR_HAS(x, '?') | YAML_SWAR_HAS(x, ':') | YAML_SWAR_HAS(x, '#')
+		| YAML_SWAR_HAS(x, '[') | YAML_SWAR_HAS(x, ']') | YAML_SWAR_HAS(x, '{') | YAML_SWAR_HAS(x, '}'));
+}
+
+/* Check for a space, a tab, a break or the end of the value.
+ */
+static int yaml_emitter_is_blankz_(const yaml_char_t *pointer, const yaml_char_t *end) {
+	if (pointer >= end)
+		return 1;
+	return (yaml_emitter_classes_[*pointer] & (YAML_CLASS_SPACE | YAML_CLASS_BREAK))
+		|| *pointer == '\t' || !*pointer
+		|| YAML_IS_UNICODE_BREAK(pointer, end);
+}
+
+int yaml_emitter_analyze_scalar(yaml_emitter_t *emitter, yaml_char_t *value, size_t length) {
+	const yaml_char_t *start = value;
+	const yaml_char_t *end = value + length;
+	const yaml_char_t *pointer = value;
+	int block_indicators = 0;
+	int flow_indicators = 0;
+	int line_breaks = 0;
+	int special_characters = 0;
+	int leading_space = 0;
+	int leading_break = 0;
+	int trailing_space = 0;
+	int trailing_break = 0;
+	int break_space = 0;
+	int space_break = 0;
+	int preceded_by_whitespace;
+	int followed_by_whitespace;
+	int previous_space = 0;
+	int previous_break = 0;
+
+	assert(emitter); /* Non-NULL emitter object is expected. */
+
+	emitter->scalar_data.value = value;
+	emitter->scalar_data.length = length;
+
+	if (!length) {
+		emitter->scalar_data.multiline = 0;
+		emitter->scalar_data.flow_plain_allowed = 0;
+		emitter->scalar_data.block_plain_allowed = 1;
+		emitter->scalar_data.single_quoted_allowed = 1;
+		emitter->scalar_data.block_allowed = 0;
+		return YAML_EOK;
+	}
+
+	if (length >= 3 && ((value[0] == '-' && value[1] == '-' && value[2] == '-')
+			|| (value[0] == '.' && value[1] == '.' && value[2] == '.'))) {
+		block_indicators = 1;
+		flow_indicators = 1;
+	}
+
+	preceded_by_whitespace = 1;
+	followed_by_whitespace = yaml_emitter_is_blankz_(pointer + YAML_UTF8_WIDTH(*pointer), end);
+
+	while (pointer != end) {
+		int octet_class = yaml_emitter_classes_[*pointer];
+		int width = YAML_UTF8_WIDTH(*pointer);
+		int is_break;
+
+		/* Skip runs that cannot change the analysis 8 octets at a time. */
+		if (pointer != start) {
+			const yaml_char_t *skipped = pointer;
+
+			while (end - pointer >= 8 && yaml_emitter_swar_plain_(pointer))
+				pointer += 8;
+			if (pointer != skipped) {
+				preceded_by_whitespace = 0;
+				previous_space = 0;
+				previous_break = 0;
+				if (pointer == end)
+					break;
+				followed_by_whitespace = yaml_emitter_is_blankz_(pointer + YAML_UTF8_WIDTH(*pointer), end);
+				octet_class = yaml_emitter_classes_[*pointer];
+				width = YAML_UTF8_WIDTH(*pointer);
+			}
+		}
+
+		if (pointer == start) {
+			if (octet_class & YAML_CLASS_FIRST) {
+				flow_indicators = 1;
+				block_indicators = 1;
+			}
+			if (*pointer == '?' || *pointer == ':') {
+				flow_indicators = 1;
+				if (followed_by_whitespace)
+					block_indicators = 1;
+			}
+			if (*pointer == '-' && followed_by_whitespace) {
+				flow_indicators = 1;
+				block_indicators = 1;
+			}
+		}
+		else {
+			if (octet_class & YAML_CLASS_FLOW)
+				flow_indicators = 1;
+			if (octet_class & YAML_CLASS_COLON) {
+				flow_indicators = 1;
+				if (followed_by_whitespace)
+					block_indicators = 1;
+			}
+			if ((octet_class & YAML_CLASS_COMMENT) && preceded_by_whitespace) {
+				flow_indicators = 1;
+				block_indicators = 1;
+			}
+		}
+
+		is_break = (octet_class & YAML_CLASS_BREAK) != 0;
+		if (octet_class & YAML_CLASS_NON_ASCII) {
+			is_break = YAML_IS_UNICODE_BREAK(pointer, end);
+			if (!emitter->unicode || !YAML_IS_UNICODE_PRINTABLE(pointer, end))
+				special_characters = 1;
+		}
+		else if (octet_class & YAML_CLASS_SPECIAL)
+			special_characters = 1;
+
+		if (is_break)
+			line_breaks = 1;
+
+		if (octet_class & YAML_CLASS_SPACE) {
+			if (pointer == start)
+				leading_space = 1;
+			if (pointer + width >= end)
+				trailing_space = 1;
+			if (previous_break)
+				break_space = 1;
+			previous_space = 1;
+			previous_break = 0;
+		}
+		else if (is_break) {
+			if (pointer == start)
+				leading_break = 1;
+			if (pointer + width >= end)
+				trailing_break = 1;
+			if (previous_space)
+				space_break = 1;
+			previous_space = 0;
+			previous_break = 1;
+		}
+		else {
+			previous_space = 0;
+			previous_break = 0;
+		}
+
+		preceded_by_whitespace = yaml_emitter_is_blankz_(pointer, end);
+		pointer += width;
+		if (pointer < end)
+			followed_by_whitespace = yaml_emitter_is_blankz_(pointer + YAML_UTF8_WIDTH(*pointer), end);
+		else
+			pointer = end;
+	}
+
+	emitter->scalar_data.multiline = line_breaks;
+	emitter->scalar_data.flow_plain_allowed = 1;
+	emitter->scalar_data.block_plain_allowed = 1;
+	emitter->scalar_data.single_quoted_allowed = 1;
+	emitter->scalar_data.block_allowed = 1;
+
+	if (leading_space || leading_break || trailing_space || trailing_break) {
+		emitter->scalar_data.flow_plain_allowed = 0;
+		emitter->scalar_data.block_plain_allowed = 0;
+	}
+	if (trailing_space)
+		emitter->scalar_data.block_allowed = 0;
+	if (break_space) {
+		emitter->scalar_data.flow_plain_allowed = 0;
+		emitter->scalar_data.block_plain_allowed = 0;
+		emitter->scalar_data.single_quoted_allowed = 0;
+	}
+	if (space_break || special_characters) {
+		emitter->scalar_data.flow_plain_allowed = 0;
+		emitter->scalar_data.block_plain_allowed = 0;
+		emitter->scalar_data.single_quoted_allowed = 0;
+		emitter->scalar_data.block_allowed = 0;
+	}
+	if (line_breaks) {
+		emitter->scalar_data.flow_plain_allowed = 0;
+		emitter->scalar_data.block_plain_allowed = 0;
+	}
+	if (flow_indicators)
+		emitter->scalar_data.flow_plain_allowed = 0;
+	if (block_indicators)
+		emitter->scalar_data.block_plain_allowed = 0;
+
+	return YAML_EOK;
+}
+
+int yaml_emitter_analyze_scalar_event(yaml_emitter_t *emitter, yaml_event_t *event) {
+	assert(emitter); /* Non-NULL emitter object is expected. */
+	assert(event && event->type == YAML_EVENT_SCALAR); /* A SCALAR event is expected. */
+
+	/* The producer vouches for the value: no breaks, indicators or special characters. */
+	if (event->data.scalar.trusted && event->data.scalar.length) {
+		emitter->scalar_data.value = event->data.scalar.value;
+		emitter->scalar_data.length = event->data.scalar.length;
+		emitter->scalar_data.multiline = 0;
+		emitter->scalar_data.flow_plain_allowed = 1;
+		emitter->scalar_data.block_plain_allowed = 1;
+		emitter->scalar_data.single_quoted_allowed = 1;
+		emitter->scalar_data.block_allowed = 1;
+		return YAML_EOK;
+	}
+
+	return yaml_emitter_analyze_scalar(emitter, event->data.scalar.value, event->data.scalar.length);
+}
+
+/* Set the emitter error and return YAML_EEMITTER.
+ */
+static int yaml_emitter_set_emitter_error_(yaml_emitter_t *emitter, const char *problem) {
+	emitter->error = YAML_EEMITTER;
+	emitter->problem = problem;
+	return YAML_EEMITTER;
+}
+
+/* Check for an anchor or a tag handle character: [0-9A-Za-z_-].
+ */
+#define YAML_EMITTER_IS_ALPHA(octet) \
+	(((octet) >= '0' && (octet) <= '9') || ((octet) >= 'A' && (octet) <= 'Z') \
+	 || ((octet) >= 'a' && (octet) <= 'z') || (octet) == '_' || (octet) == '-')
+
+/* Check if the queued events are enough to decide how the head one is written:
+ * a document needs its root, a collection its first items.
+ */
+static int yaml_emitter_need_more_events_(yaml_emitter_t *emitter) {
+	yaml_event_t *event;
+	int accumulate;
+	int level = 0;
+
+	if (emitter->events.head == emitter->events.tail)
+		return 1;
+
+	switch (emitter->events.head->type) {
+	case YAML_EVENT_DOCUMENT_START:
+		accumulate = 1;
+		break;
+	case YAML_EVENT_SEQUENCE_START:
+		accumulate = 2;
+		break;
+	case YAML_EVENT_MAPPING_START:
+		accumulate = 3;
+		break;
+	default:
+		return 0;
+	}
+
+	if (emitter->events.tail - emitter->events.head > accumulate)
+		return 0;
+
+	for (event = emitter->events.head; event != emitter->events.tail; event++) {
+		switch (event->type) {
+		case YAML_EVENT_STREAM_START:
+		case YAML_EVENT_DOCUMENT_START:
+		case YAML_EVENT_SEQUENCE_START:
+		case YAML_EVENT_MAPPING_START:
+			level++;
+			break;
+		case YAML_EVENT_STREAM_END:
+		case YAML_EVENT_DOCUMENT_END:
+		case YAML_EVENT_SEQUENCE_END:
+		case YAML_EVENT_MAPPING_END:
+			level--;
+			break;
+		default:
+			break;
+		}
+		if (!level)
+			return 0;
+	}
+
+	return 1;
+}
+
+/* Add a tag directive of the document to the emitter, the default ones
+ * may be given again.
+ */
+static int yaml_emitter_append_tag_directive_(yaml_emitter_t *emitter,
+		yaml_tag_directive_t value, int allow_duplicates) {
+	yaml_tag_directive_t *tag_directive;
+	yaml_tag_directive_t copy;
+	int error;
+
+	for (tag_directive = emitter->tag_directives.start; tag_directive != emitter->tag_directives.top; tag_directive++) {
+		if (!strcmp((char *)value.handle, (char *)tag_directive->handle)) {
+			if (allow_duplicates)
+				return YAML_EOK;
+			return yaml_emitter_set_emitter_error_(emitter, "duplicate %TAG directive");
+		}
+	}
+
+	copy.handle = yaml_strdup(value.handle);
+	copy.prefix = yaml_strdup(value.prefix);
+	if (!copy.handle || !copy.prefix) {
+		YAML_FREE(copy.handle);
+		YAML_FREE(copy.prefix);
+		emitter->error = YAML_EMEMORY;
+		return YAML_EMEMORY;
+	}
+
+	YAML_STACK_PUSH(&error, &emitter->tag_directives, yaml_tag_directive_t, copy);
+	if (error) {
+		YAML_FREE(copy.handle);
+		YAML_FREE(copy.prefix);
+		emitter->error = error;
+	}
+	return error;
+}
+
+/* Push the current indentation and compute the one of the nested node.
+ */
+static int yaml_emitter_increase_indent_(yaml_emitter_t *emitter, int flow, int indentless) {
+	int error;
+
+	YAML_STACK_PUSH(&error, &emitter->indents, int, emitter->indent);
+	if (error) {
+		emitter->error = error;
+		return error;
+	}
+
+	if (emitter->indent < 0)
+		emitter->indent = flow ? emitter->best_indent : 0;
+	else if (!indentless)
+		emitter->indent += emitter->best_indent;
+	return YAML_EOK;
+}
+
+/* Push the state to return to once the nested node is written.
+ */
+static int yaml_emitter_push_state_(yaml_emitter_t *emitter, int state) {
+	int error;
+
+	YAML_STACK_PUSH(&error, &emitter->states, int, state);
+	if (error)
+		emitter->error = error;
+	return error;
+}
+
+static int yaml_emitter_check_empty_sequence_(yaml_emitter_t *emitter) {
+	return emitter->events.tail - emitter->events.head >= 2
+		&& emitter->events.head[0].type == YAML_EVENT_SEQUENCE_START
+		&& emitter->events.head[1].type == YAML_EVENT_SEQUENCE_END;
+}
+
+static int yaml_emitter_check_empty_mapping_(yaml_emitter_t *emitter) {
+	return emitter->events.tail - emitter->events.head >= 2
+		&& emitter->events.head[0].type == YAML_EVENT_MAPPING_START
+		&& emitter->events.head[1].type == YAML_EVENT_MAPPING_END;
+}
+
+/* Check if the head event fits a simple key: a single line of at most 128 characters.
+ */
+static int yaml_emitter_check_simple_key_(yaml_emitter_t *emitter) {
+	yaml_event_t *event = emitter->events.head;
+	size_t length = 0;
+
+	switch (event->type) {
+	case YAML_EVENT_ALIAS:
+		length += emitter->anchor_data.anchor_length;
+		break;
+	case YAML_EVENT_SCALAR:
+		if (emitter->scalar_data.multiline)
+			return 0;
+		length += emitter->anchor_data.anchor_length + emitter->tag_data.handle_length
+			+ emitter->tag_data.suffix_length + emitter->scalar_data.length;
+		break;
+	case YAML_EVENT_SEQUENCE_START:
+		if (!yaml_emitter_check_empty_sequence_(emitter))
+			return 0;
+		length += emitter->anchor_data.anchor_length + emitter->tag_data.handle_length
+			+ emitter->tag_data.suffix_length;
+		break;
+	case YAML_EVENT_MAPPING_START:
+		if (!yaml_emitter_check_empty_mapping_(emitter))
+			return 0;
+		length += emitter->anchor_data.anchor_length + emitter->tag_data.handle_length
+			+ emitter->tag_data.suffix_length;
+		break;
+	default:
+		return 0;
+	}
+
+	return length <= 128;
+}
+
+/* Choose the style of a scalar from the one asked for and what its value allows.
+ */
+static int yaml_emitter_select_scalar_style_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	int style = event->data.scalar.style;
+	int no_tag = (!emitter->tag_data.handle && !emitter->tag_data.suffix);
+
+	if (no_tag && !event->data.scalar.plain_implicit && !event->data.scalar.quoted_implicit)
+		return yaml_emitter_set_emitter_error_(emitter, "neither tag nor implicit flags are specified");
+
+	if (style == YAML_SCALAR_ANY)
+		style = YAML_SCALAR_PLAIN;
+	if (emitter->canonical)
+		style = YAML_SCALAR_DOUBLE_QUOTED;
+	if (emitter->simple_key_context && emitter->scalar_data.multiline)
+		style = YAML_SCALAR_DOUBLE_QUOTED;
+
+	if (style == YAML_SCALAR_PLAIN) {
+		if ((emitter->flow_level && !emitter->scalar_data.flow_plain_allowed)
+				|| (!emitter->flow_level && !emitter->scalar_data.block_plain_allowed))
+			style = YAML_SCALAR_SINGLE_QUOTED;
+		if (!emitter->scalar_data.length && (emitter->flow_level || emitter->simple_key_context))
+			style = YAML_SCALAR_SINGLE_QUOTED;
+		if (no_tag && !event->data.scalar.plain_implicit)
+			style = YAML_SCALAR_SINGLE_QUOTED;
+	}
+	if (style == YAML_SCALAR_SINGLE_QUOTED && !emitter->scalar_data.single_quoted_allowed)
+		style = YAML_SCALAR_DOUBLE_QUOTED;
+	if (style == YAML_SCALAR_LITERAL || style == YAML_SCALAR_FOLDED) {
+		if (!emitter->scalar_data.block_allowed || emitter->flow_level || emitter->simple_key_context)
+			style = YAML_SCALAR_DOUBLE_QUOTED;
+	}
+
+	/* A quoted scalar would resolve to !!str without its tag. */
+	if (no_tag && !event->data.scalar.quoted_implicit && style != YAML_SCALAR_PLAIN) {
+		emitter->tag_data.handle = (yaml_char_t *)"!";
+		emitter->tag_data.handle_length = 1;
+	}
+
+	emitter->scalar_data.style = style;
+	return YAML_EOK;
+}
+
+static int yaml_emitter_process_anchor_(yaml_emitter_t *emitter) {
+	int error;
+
+	if (!emitter->anchor_data.anchor)
+		return YAML_EOK;
+
+	error = yaml_emitter_write_indicator(emitter, emitter->anchor_data.alias ? "*" : "&", 1, 0, 0);
+	if (error)
+		return error;
+	return yaml_emitter_write_anchor(emitter, emitter->anchor_data.anchor, emitter->anchor_data.anchor_length);
+}
+
+static int yaml_emitter_process_tag_(yaml_emitter_t *emitter) {
+	int error;
+
+	if (!emitter->tag_data.handle && !emitter->tag_data.suffix)
+		return YAML_EOK;
+
+	if (emitter->tag_data.handle) {
+		error = yaml_emitter_write_tag_handle(emitter, emitter->tag_data.handle, emitter->tag_data.handle_length);
+		if (!error && emitter->tag_data.suffix)
+			error = yaml_emitter_write_tag_content(emitter, emitter->tag_data.suffix,
+				emitter->tag_data.suffix_length, 0);
+		return error;
+	}
+
+	error = yaml_emitter_write_indicator(emitter, "!<", 1, 0, 0);
+	if (!error)
+		error = yaml_emitter_write_tag_content(emitter, emitter->tag_data.suffix, emitter->tag_data.suffix_length, 0);
+	if (!error)
+		error = yaml_emitter_write_indicator(emitter, ">", 0, 0, 0);
+	return error;
+}
+
+static int yaml_emitter_process_scalar_(yaml_emitter_t *emitter) {
+	switch (emitter->scalar_data.style) {
+	case YAML_SCALAR_PLAIN:
+		return yaml_emitter_write_plain_scalar(emitter, emitter->scalar_data.value,
+			emitter->scalar_data.length, !emitter->simple_key_context);
+	case YAML_SCALAR_SINGLE_QUOTED:
+		return yaml_emitter_write_single_quoted_scalar(emitter, emitter->scalar_data.value,
+			emitter->scalar_data.length, !emitter->simple_key_context);
+	case YAML_SCALAR_DOUBLE_QUOTED:
+		return yaml_emitter_write_double_quoted_scalar(emitter, emitter->scalar_data.value,
+			emitter->scalar_data.length, !emitter->simple_key_context);
+	case YAML_SCALAR_LITERAL:
+		return yaml_emitter_write_literal_scalar(emitter, emitter->scalar_data.value, emitter->scalar_data.length);
+	case YAML_SCALAR_FOLDED:
+		return yaml_emitter_write_folded_scalar(emitter, emitter->scalar_data.value, emitter->scalar_data.length);
+	default:
+		assert(0); /* Impossible. */
+		break;
+	}
+
+	return YAML_EFAILD;
+}
+
+static int yaml_emitter_analyze_version_directive_(yaml_emitter_t *emitter, int major, int minor) {
+	if (major != 1 || (minor != 1 && minor != 2))
+		return yaml_emitter_set_emitter_error_(emitter, "incompatible %YAML directive");
+	return YAML_EOK;
+}
+
+static int yaml_emitter_analyze_tag_directive_(yaml_emitter_t *emitter, yaml_tag_directive_t tag_directive) {
+	size_t handle_length = strlen((char *)tag_directive.handle);
+	size_t i;
+
+	if (!handle_length)
+		return yaml_emitter_set_emitter_error_(emitter, "tag handle must not be empty");
+	if (tag_directive.handle[0] != '!')
+		return yaml_emitter_set_emitter_error_(emitter, "tag handle must start with '!'");
+	if (tag_directive.handle[handle_length - 1] != '!')
+		return yaml_emitter_set_emitter_error_(emitter, "tag handle must end with '!'");
+	for (i = 1; i + 1 < handle_length; i++) {
+		if (!YAML_EMITTER_IS_ALPHA(tag_directive.handle[i]))
+			return yaml_emitter_set_emitter_error_(emitter, "tag handle must contain alphanumerical characters only");
+	}
+	if (!*tag_directive.prefix)
+		return yaml_emitter_set_emitter_error_(emitter, "tag prefix must not be empty");
+	return YAML_EOK;
+}
+
+static int yaml_emitter_analyze_anchor_(yaml_emitter_t *emitter, yaml_char_t *anchor, int alias) {
+	size_t length = strlen((char *)anchor);
+	size_t i;
+
+	if (!length)
+		return yaml_emitter_set_emitter_error_(emitter, alias
+			? "alias value must not be empty" : "anchor value must not be empty");
+	for (i = 0; i < length; i++) {
+		if (!YAML_EMITTER_IS_ALPHA(anchor[i]))
+			return yaml_emitter_set_emitter_error_(emitter, alias
+				? "alias value must contain alphanumerical characters only"
+				: "anchor value must contain alphanumerical characters only");
+	}
+
+	emitter->anchor_data.anchor = anchor;
+	emitter->anchor_data.anchor_length = length;
+	emitter->anchor_data.alias = alias;
+	return YAML_EOK;
+}
+
+/* Split a tag into the handle of the longest matching directive and a suffix.
+ */
+static int yaml_emitter_analyze_tag_(yaml_emitter_t *emitter, yaml_char_t *tag) {
+	yaml_tag_directive_t *tag_directive;
+	size_t tag_length = strlen((char *)tag);
+
+	if (!tag_length)
+		return yaml_emitter_set_emitter_error_(emitter, "tag value must not be empty");
+
+	for (tag_directive = emitter->tag_directives.start; tag_directive != emitter->tag_directives.top; tag_directive++) {
+		size_t prefix_length = strlen((char *)tag_directive->prefix);
+
+		if (prefix_length < tag_length && !strncmp((char *)tag_directive->prefix, (char *)tag, prefix_length)) {
+			emitter->tag_data.handle = tag_directive->handle;
+			emitter->tag_data.handle_length = strlen((char *)tag_directive->handle);
+			emitter->tag_data.suffix = tag + prefix_length;
+			emitter->tag_data.suffix_length = tag_length - prefix_length;
+			return YAML_EOK;
+		}
+	}
+
+	emitter->tag_data.suffix = tag;
+	emitter->tag_data.suffix_length = tag_length;
+	return YAML_EOK;
+}
+
+/* Check the anchor, the tag and the value of the head event before it is written.
+ */
+static int yaml_emitter_analyze_event_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	yaml_char_t *anchor = NULL;
+	yaml_char_t *tag = NULL;
+	int error;
+
+	memset(&emitter->anchor_data, 0, sizeof(emitter->anchor_data));
+	memset(&emitter->tag_data, 0, sizeof(emitter->tag_data));
+	memset(&emitter->scalar_data, 0, sizeof(emitter->scalar_data));
+
+	switch (event->type) {
+	case YAML_EVENT_ALIAS:
+		return yaml_emitter_analyze_anchor_(emitter, event->data.alias.anchor, 1);
+	case YAML_EVENT_SCALAR:
+		anchor = event->data.scalar.anchor;
+		if (emitter->canonical || (!event->data.scalar.plain_implicit && !event->data.scalar.quoted_implicit))
+			tag = event->data.scalar.tag;
+		break;
+	case YAML_EVENT_SEQUENCE_START:
+		anchor = event->data.sequence_start.anchor;
+		if (emitter->canonical || !event->data.sequence_start.implicit)
+			tag = event->data.sequence_start.tag;
+		break;
+	case YAML_EVENT_MAPPING_START:
+		anchor = event->data.mapping_start.anchor;
+		if (emitter->canonical || !event->data.mapping_start.implicit)
+			tag = event->data.mapping_start.tag;
+		break;
+	default:
+		return YAML_EOK;
+	}
+
+	if (anchor) {
+		error = yaml_emitter_analyze_anchor_(emitter, anchor, 0);
+		if (error)
+			return error;
+	}
+	if (tag) {
+		error = yaml_emitter_analyze_tag_(emitter, tag);
+		if (error)
+			return error;
+	}
+	if (event->type == YAML_EVENT_SCALAR)
+		return yaml_emitter_analyze_scalar_event(emitter, event);
+	return YAML_EOK;
+}
+
+static int yaml_emitter_emit_stream_start_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	if (event->type != YAML_EVENT_STREAM_START)
+		return yaml_emitter_set_emitter_error_(emitter, "expected STREAM-START");
+
+	if (!emitter->encoding)
+		emitter->encoding = event->data.stream_start.encoding;
+	if (!emitter->encoding)
+		emitter->encoding = YAML_ENCODING_UTF8;
+	if (emitter->best_indent < 2 || emitter->best_indent > 9)
+		emitter->best_indent = 2;
+	if (emitter->best_width >= 0 && emitter->best_width <= emitter->best_indent * 2)
+		emitter->best_width = 80;
+	if (emitter->best_width < 0)
+		emitter->best_width = INT_MAX;
+	if (!emitter->line_break)
+		emitter->line_break = YAML_BREAK_LN;
+
+	emitter->indent = -1;
+	emitter->line = 0;
+	emitter->column = 0;
+	emitter->whitespace = 1;
+	emitter->indention = 1;
+	emitter->state = YAML_ES_FIRST_DOCUMENT_START;
+
+	if (emitter->encoding != YAML_ENCODING_UTF8)
+		return yaml_emitter_write_bom(emitter);
+	return YAML_EOK;
+}
+
+static int yaml_emitter_emit_document_start_(yaml_emitter_t *emitter, yaml_event_t *event, int first) {
+	static yaml_tag_directive_t default_tag_directives[] = {
+		{ (yaml_char_t *)"!", (yaml_char_t *)"!" },
+		{ (yaml_char_t *)"!!", (yaml_char_t *)"tag:yaml.org,2002:" }
+	};
+	yaml_tag_directive_t *tag_directive;
+	int implicit;
+	int error;
+	size_t i;
+
+	if (event->type == YAML_EVENT_STREAM_END) {
+		/* A block scalar kept its trailing breaks at the end of the stream. */
+		if (emitter->open_ended == 2) {
+			error = yaml_emitter_write_indicator(emitter, "...", 1, 0, 0);
+			if (error)
+				return error;
+			emitter->open_ended = 0;
+			error = yaml_emitter_write_indent(emitter);
+			if (error)
+				return error;
+		}
+		error = yaml_emitter_flush(emitter);
+		if (error)
+			return error;
+		emitter->state = YAML_ES_END_STATE;
+		return YAML_EOK;
+	}
+
+	if (event->type != YAML_EVENT_DOCUMENT_START)
+		return yaml_emitter_set_emitter_error_(emitter, "expected DOCUMENT-START or STREAM-END");
+
+	if (event->data.document_start.version_directive.major) {
+		error = yaml_emitter_analyze_version_directive_(emitter,
+			event->data.document_start.version_directive.major,
+			event->data.document_start.version_directive.minor);
+		if (error)
+			return error;
+	}
+	for (tag_directive = event->data.document_start.tag_directives.start;
+			tag_directive != event->data.document_start.tag_directives.end; tag_directive++) {
+		error = yaml_emitter_analyze_tag_directive_(emitter, *tag_directive);
+		if (!error)
+			error = yaml_emitter_append_tag_directive_(emitter, *tag_directive, 0);
+		if (error)
+			return error;
+	}
+	for (i = 0; i < sizeof(default_tag_directives) / sizeof(default_tag_directives[0]); i++) {
+		error = yaml_emitter_append_tag_directive_(emitter, default_tag_directives[i], 1);
+		if (error)
+			return error;
+	}
+
+	implicit = event->data.document_start.implicit;
+	if (!first || emitter->canonical)
+		implicit = 0;
+
+	/* Directives after an open ended document need it closed first. */
+	if ((event->data.document_start.version_directive.major
+			|| event->data.document_start.tag_directives.start != event->data.document_start.tag_directives.end)
+			&& emitter->open_ended) {
+		error = yaml_emitter_write_indicator(emitter, "...", 1, 0, 0);
+		if (!error)
+			error = yaml_emitter_write_indent(emitter);
+		if (error)
+			return error;
+	}
+	emitter->open_ended = 0;
+
+	if (event->data.document_start.version_directive.major) {
+		char version[16];
+
+		implicit = 0;
+		sprintf(version, "%d.%d", event->data.document_start.version_directive.major,
+			event->data.document_start.version_directive.minor);
+		error = yaml_emitter_write_indicator(emitter, "%YAML", 1, 0, 0);
+		if (!error)
+			error = yaml_emitter_write_indicator(emitter, version, 1, 0, 0);
+		if (!error)
+			error = yaml_emitter_write_indent(emitter);
+		if (error)
+			return error;
+	}
+
+	for (tag_directive = event->data.document_start.tag_directives.start;
+			tag_directive != event->data.document_start.tag_directives.end; tag_directive++) {
+		implicit = 0;
+		error = yaml_emitter_write_indicator(emitter, "%TAG", 1, 0, 0);
+		if (!error)
+			error = yaml_emitter_write_tag_handle(emitter, tag_directive->handle, strlen((char *)tag_directive->handle));
+		if (!error)
+			error = yaml_emitter_write_tag_content(emitter, tag_directive->prefix, strlen((char *)tag_directive->prefix), 1);
+		if (!error)
+			error = yaml_emitter_write_indent(emitter);
+		if (error)
+			return error;
+	}
+
+	if (!implicit) {
+		error = yaml_emitter_write_indent(emitter);
+		if (!error)
+			error = yaml_emitter_write_indicator(emitter, "---", 1, 0, 0);
+		if (!error && emitter->canonical)
+			error = yaml_emitter_write_indent(emitter);
+		if (error)
+			return error;
+	}
+
+	emitter->state = YAML_ES_DOCUMENT_CONTENT;
+	emitter->open_ended = 0;
+	return YAML_EOK;
+}
+
+static int yaml_emitter_emit_node_(yaml_emitter_t *emitter, yaml_event_t *event,
+	int root, int sequence, int mapping, int simple_key);
+
+static int yaml_emitter_emit_document_content_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	int error;
+
+	error = yaml_emitter_push_state_(emitter, YAML_ES_DOCUMENT_END);
+	if (error)
+		return error;
+	return yaml_emitter_emit_node_(emitter, event, 1, 0, 0, 0);
+}
+
+static int yaml_emitter_emit_document_end_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	int error;
+
+	if (event->type != YAML_EVENT_DOCUMENT_END)
+		return yaml_emitter_set_emitter_error_(emitter, "expected DOCUMENT-END");
+
+	error = yaml_emitter_write_indent(emitter);
+	if (error)
+		return error;
+	if (!event->data.document_end.implicit) {
+		error = yaml_emitter_write_indent(emitter);
+		if (!error)
+			error = yaml_emitter_write_indicator(emitter, "...", 1, 0, 0);
+		emitter->open_ended = 0;
+		if (!error)
+			error = yaml_emitter_write_indent(emitter);
+		if (error)
+			return error;
+	}
+	else if (!emitter->open_ended)
+		emitter->open_ended = 1;
+
+	error = yaml_emitter_flush(emitter);
+	if (error)
+		return error;
+
+	emitter->state = YAML_ES_DOCUMENT_START;
+
+	while (emitter->tag_directives.top != emitter->tag_directives.start) {
+		yaml_tag_directive_t tag_directive = YAML_STACK_POP(&emitter->tag_directives);
+
+		YAML_FREE(tag_directive.handle);
+		YAML_FREE(tag_directive.prefix);
+	}
+	return YAML_EOK;
+}
+
+static int yaml_emitter_emit_flow_sequence_item_(yaml_emitter_t *emitter, yaml_event_t *event, int first) {
+	int error;
+
+	if (first) {
+		error = yaml_emitter_write_indicator(emitter, "[", 1, 1, 0);
+		if (!error)
+			error = yaml_emitter_increase_indent_(emitter, 1, 0);
+		if (error)
+			return error;
+		emitter->flow_level++;
+	}
+
+	if (event->type == YAML_EVENT_SEQUENCE_END) {
+		emitter->flow_level--;
+		emitter->indent = YAML_STACK_POP(&emitter->indents);
+		if (emitter->canonical && !first) {
+			error = yaml_emitter_write_indicator(emitter, ",", 0, 0, 0);
+			if (!error)
+				error = yaml_emitter_write_indent(emitter);
+			if (error)
+				return error;
+		}
+		error = yaml_emitter_write_indicator(emitter, "]", 0, 0, 0);
+		if (error)
+			return error;
+		emitter->state = YAML_STACK_POP(&emitter->states);
+		return YAML_EOK;
+	}
+
+	if (!first) {
+		error = yaml_emitter_write_indicator(emitter, ",", 0, 0, 0);
+		if (error)
+			return error;
+	}
+	if (emitter->canonical || emitter->column > emitter->best_width) {
+		error = yaml_emitter_write_indent(emitter);
+		if (error)
+			return error;
+	}
+
+	error = yaml_emitter_push_state_(emitter, YAML_ES_FLOW_SEQUENCE_ITEM);
+	if (error)
+		return error;
+	return yaml_emitter_emit_node_(emitter, event, 0, 1, 0, 0);
+}
+
+static int yaml_emitter_emit_flow_mapping_key_(yaml_emitter_t *emitter, yaml_event_t *event, int first) {
+	int error;
+
+	if (first) {
+		error = yaml_emitter_write_indicator(emitter, "{", 1, 1, 0);
+		if (!error)
+			error = yaml_emitter_increase_indent_(emitter, 1, 0);
+		if (error)
+			return error;
+		emitter->flow_level++;
+	}
+
+	if (event->type == YAML_EVENT_MAPPING_END) {
+		emitter->flow_level--;
+		emitter->indent = YAML_STACK_POP(&emitter->indents);
+		if (emitter->canonical && !first) {
+			error = yaml_emitter_write_indicator(emitter, ",", 0, 0, 0);
+			if (!error)
+				error = yaml_emitter_write_indent(emitter);
+			if (error)
+				return error;
+		}
+		error = yaml_emitter_write_indicator(emitter, "}", 0, 0, 0);
+		if (error)
+			return error;
+		emitter->state = YAML_STACK_POP(&emitter->states);
+		return YAML_EOK;
+	}
+
+	if (!first) {
+		error = yaml_emitter_write_indicator(emitter, ",", 0, 0, 0);
+		if (error)
+			return error;
+	}
+	if (emitter->canonical || emitter->column > emitter->best_width) {
+		error = yaml_emitter_write_indent(emitter);
+		if (error)
+			return error;
+	}
+
+	if (!emitter->canonical && yaml_emitter_check_simple_key_(emitter)) {
+		error = yaml_emitter_push_state_(emitter, YAML_ES_FLOW_MAPPING_SIMPLE_VALUE);
+		if (error)
+			return error;
+		return yaml_emitter_emit_node_(emitter, event, 0, 0, 1, 1);
+	}
+
+	error = yaml_emitter_write_indicator(emitter, "?", 1, 0, 0);
+	if (!error)
+		error = yaml_emitter_push_state_(emitter, YAML_ES_FLOW_MAPPING_VALUE);
+	if (error)
+		return error;
+	return yaml_emitter_emit_node_(emitter, event, 0, 0, 1, 0);
+}
+
+static int yaml_emitter_emit_flow_mapping_value_(yaml_emitter_t *emitter, yaml_event_t *event, int simple) {
+	int error;
+
+	if (simple)
+		error = yaml_emitter_write_indicator(emitter, ":", 0, 0, 0);
+	else {
+		error = YAML_EOK;
+		if (emitter->canonical || emitter->column > emitter->best_width)
+			error = yaml_emitter_write_indent(emitter);
+		if (!error)
+			error = yaml_emitter_write_indicator(emitter, ":", 1, 0, 0);
+	}
+	if (!error)
+		error = yaml_emitter_push_state_(emitter, YAML_ES_FLOW_MAPPING_KEY);
+	if (error)
+		return error;
+	return yaml_emitter_emit_node_(emitter, event, 0, 0, 1, 0);
+}
+
+static int yaml_emitter_emit_block_sequence_item_(yaml_emitter_t *emitter, yaml_event_t *event, int first) {
+	int error;
+
+	if (first) {
+		error = yaml_emitter_increase_indent_(emitter, 0, emitter->mapping_context && !emitter->indention);
+		if (error)
+			return error;
+	}
+
+	if (event->type == YAML_EVENT_SEQUENCE_END) {
+		emitter->indent = YAML_STACK_POP(&emitter->indents);
+		emitter->state = YAML_STACK_POP(&emitter->states);
+		return YAML_EOK;
+	}
+
+	error = yaml_emitter_write_indent(emitter);
+	if (!error)
+		error = yaml_emitter_write_indicator(emitter, "-", 1, 0, 1);
+	if (!error)
+		error = yaml_emitter_push_state_(emitter, YAML_ES_BLOCK_SEQUENCE_ITEM);
+	if (error)
+		return error;
+	return yaml_emitter_emit_node_(emitter, event, 0, 1, 0, 0);
+}
+
+static int yaml_emitter_emit_block_mapping_key_(yaml_emitter_t *emitter, yaml_event_t *event, int first) {
+	int error;
+
+	if (first) {
+		error = yaml_emitter_increase_indent_(emitter, 0, 0);
+		if (error)
+			return error;
+	}
+
+	if (event->type == YAML_EVENT_MAPPING_END) {
+		emitter->indent = YAML_STACK_POP(&emitter->indents);
+		emitter->state = YAML_STACK_POP(&emitter->states);
+		return YAML_EOK;
+	}
+
+	error = yaml_emitter_write_indent(emitter);
+	if (error)
+		return error;
+
+	if (yaml_emitter_check_simple_key_(emitter)) {
+		error = yaml_emitter_push_state_(emitter, YAML_ES_BLOCK_MAPPING_SIMPLE_VALUE);
+		if (error)
+			return error;
+		return yaml_emitter_emit_node_(emitter, event, 0, 0, 1, 1);
+	}
+
+	error = yaml_emitter_write_indicator(emitter, "?", 1, 0, 1);
+	if (!error)
+		error = yaml_emitter_push_state_(emitter, YAML_ES_BLOCK_MAPPING_VALUE);
+	if (error)
+		return error;
+	return yaml_emitter_emit_node_(emitter, event, 0, 0, 1, 0);
+}
+
+static int yaml_emitter_emit_block_mapping_value_(yaml_emitter_t *emitter, yaml_event_t *event, int simple) {
+	int error;
+
+	if (simple)
+		error = yaml_emitter_write_indicator(emitter, ":", 0, 0, 0);
+	else {
+		error = yaml_emitter_write_indent(emitter);
+		if (!error)
+			error = yaml_emitter_write_indicator(emitter, ":", 1, 0, 1);
+	}
+	if (!error)
+		error = yaml_emitter_push_state_(emitter, YAML_ES_BLOCK_MAPPING_KEY);
+	if (error)
+		return error;
+	return yaml_emitter_emit_node_(emitter, event, 0, 0, 1, 0);
+}
+
+static int yaml_emitter_emit_alias_(yaml_emitter_t *emitter) {
+	int error;
+
+	error = yaml_emitter_process_anchor_(emitter);
+	if (error)
+		return error;
+	/* The key indicator would read as a part of the alias. */
+	if (emitter->simple_key_context) {
+		error = yaml_emitter_write_indicator(emitter, " ", 0, 1, 0);
+		if (error)
+			return error;
+	}
+	emitter->state = YAML_STACK_POP(&emitter->states);
+	return YAML_EOK;
+}
+
+static int yaml_emitter_emit_scalar_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	int error;
+
+	error = yaml_emitter_select_scalar_style_(emitter, event);
+	if (!error)
+		error = yaml_emitter_process_anchor_(emitter);
+	if (!error)
+		error = yaml_emitter_process_tag_(emitter);
+	if (!error)
+		error = yaml_emitter_increase_indent_(emitter, 1, 0);
+	if (!error)
+		error = yaml_emitter_process_scalar_(emitter);
+	if (error)
+		return error;
+
+	emitter->indent = YAML_STACK_POP(&emitter->indents);
+	emitter->state = YAML_STACK_POP(&emitter->states);
+	return YAML_EOK;
+}
+
+static int yaml_emitter_emit_sequence_start_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	int error;
+
+	error = yaml_emitter_process_anchor_(emitter);
+	if (!error)
+		error = yaml_emitter_process_tag_(emitter);
+	if (error)
+		return error;
+
+	if (emitter->flow_level || emitter->canonical || event->data.sequence_start.style == YAML_SEQUENCE_FLOW
+			|| yaml_emitter_check_empty_sequence_(emitter))
+		emitter->state = YAML_ES_FLOW_SEQUENCE_FIRST_ITEM;
+	else
+		emitter->state = YAML_ES_BLOCK_SEQUENCE_FIRST_ITEM;
+	return YAML_EOK;
+}
+
+static int yaml_emitter_emit_mapping_start_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	int error;
+
+	error = yaml_emitter_process_anchor_(emitter);
+	if (!error)
+		error = yaml_emitter_process_tag_(emitter);
+	if (error)
+		return error;
+
+	if (emitter->flow_level || emitter->canonical || event->data.mapping_start.style == YAML_MAPPING_FLOW
+			|| yaml_emitter_check_empty_mapping_(emitter))
+		emitter->state = YAML_ES_FLOW_MAPPING_FIRST_KEY;
+	else
+		emitter->state = YAML_ES_BLOCK_MAPPING_FIRST_KEY;
+	return YAML_EOK;
+}
+
+static int yaml_emitter_emit_node_(yaml_emitter_t *emitter, yaml_event_t *event,
+		int root, int sequence, int mapping, int simple_key) {
+	emitter->root_context = root;
+	emitter->sequence_context = sequence;
+	emitter->mapping_context = mapping;
+	emitter->simple_key_context = simple_key;
+
+	switch (event->type) {
+	case YAML_EVENT_ALIAS:
+		return yaml_emitter_emit_alias_(emitter);
+	case YAML_EVENT_SCALAR:
+		return yaml_emitter_emit_scalar_(emitter, event);
+	case YAML_EVENT_SEQUENCE_START:
+		return yaml_emitter_emit_sequence_start_(emitter, event);
+	case YAML_EVENT_MAPPING_START:
+		return yaml_emitter_emit_mapping_start_(emitter, event);
+	default:
+		return yaml_emitter_set_emitter_error_(emitter, "expected SCALAR, SEQUENCE-START, MAPPING-START, or ALIAS");
+	}
+}
+
+static int yaml_emitter_state_machine_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	switch (emitter->state) {
+	case YAML_ES_STREAM_START:
+		return yaml_emitter_emit_stream_start_(emitter, event);
+	case YAML_ES_FIRST_DOCUMENT_START:
+		return yaml_emitter_emit_document_start_(emitter, event, 1);
+	case YAML_ES_DOCUMENT_START:
+		return yaml_emitter_emit_document_start_(emitter, event, 0);
+	case YAML_ES_DOCUMENT_CONTENT:
+		return yaml_emitter_emit_document_content_(emitter, event);
+	case YAML_ES_DOCUMENT_END:
+		return yaml_emitter_emit_document_end_(emitter, event);
+	case YAML_ES_FLOW_SEQUENCE_FIRST_ITEM:
+		return yaml_emitter_emit_flow_sequence_item_(emitter, event, 1);
+	case YAML_ES_FLOW_SEQUENCE_ITEM:
+		return yaml_emitter_emit_flow_sequence_item_(emitter, event, 0);
+	case YAML_ES_FLOW_MAPPING_FIRST_KEY:
+		return yaml_emitter_emit_flow_mapping_key_(emitter, event, 1);
+	case YAML_ES_FLOW_MAPPING_KEY:
+		return yaml_emitter_emit_flow_mapping_key_(emitter, event, 0);
+	case YAML_ES_FLOW_MAPPING_SIMPLE_VALUE:
+		return yaml_emitter_emit_flow_mapping_value_(emitter, event, 1);
+	case YAML_ES_FLOW_MAPPING_VALUE:
+		return yaml_emitter_emit_flow_mapping_value_(emitter, event, 0);
+	case YAML_ES_BLOCK_SEQUENCE_FIRST_ITEM:
+		return yaml_emitter_emit_block_sequence_item_(emitter, event, 1);
+	case YAML_ES_BLOCK_SEQUENCE_ITEM:
+		return yaml_emitter_emit_block_sequence_item_(emitter, event, 0);
+	case YAML_ES_BLOCK_MAPPING_FIRST_KEY:
+		return yaml_emitter_emit_block_mapping_key_(emitter, event, 1);
+	case YAML_ES_BLOCK_MAPPING_KEY:
+		return yaml_emitter_emit_block_mapping_key_(emitter, event, 0);
+	case YAML_ES_BLOCK_MAPPING_SIMPLE_VALUE:
+		return yaml_emitter_emit_block_mapping_value_(emitter, event, 1);
+	case YAML_ES_BLOCK_MAPPING_VALUE:
+		return yaml_emitter_emit_block_mapping_value_(emitter, event, 0);
+	case YAML_ES_END_STATE:
+		return yaml_emitter_set_emitter_error_(emitter, "expected nothing after STREAM-END");
+	default:
+		assert(0); /* Invalid state. */
+		break;
+	}
+
+	return YAML_EFAILD;
+}
+
+int yaml_emitter_emit(yaml_emitter_t *emitter, yaml_event_t *event) {
+	int error;
+
+	assert(emitter); /* Non-NULL emitter object is expected. */
+	assert(event); /* Non-NULL event object is expected. */
+
+	/* JSON needs no lookahead, the events are written as they come. */
+	if (emitter->json)
+		return yaml_emitter_emit_json(emitter, event);
+
+	YAML_QUEUE_ENQUEUE(&error, &emitter->events, yaml_event_t, *event);
+	if (error) {
+		yaml_event_destroy(event);
+		emitter->error = error;
+		return error;
+	}
+
+	while (!yaml_emitter_need_more_events_(emitter)) {
+		error = yaml_emitter_analyze_event_(emitter, emitter->events.head);
+		if (!error)
+			error = yaml_emitter_state_machine_(emitter, emitter->events.head);
+		if (error)
+			return error;
+		yaml_event_destroy(&YAML_QUEUE_DEQUEUE(&emitter->events));
+	}
+
+	return YAML_EOK;
+}
@@ -0,0 +1,177 @@
+#include "yaml_private.h"
+
+/* The initial number of hash slots, a power of two.
+ */
+#define YAML_INTERN_INITIAL_SLOTS	64
+
+/* The standard tags every string table starts with, in YAML_TAG_ID_* order.
+ */
+static const char *yaml_intern_standard_tags_[] = {
+	YAML_TAG_NULL,
+	YAML_TAG_BOOL,
+	YAML_TAG_STR,
+	YAML_TAG_INT,
+	YAML_TAG_FLOAT,
+	YAML_TAG_TIMESTAMP,
+	YAML_TAG_SEQ,
+	YAML_TAG_MAP
+};
+
+/* FNV-1a, good enough for the short tags and keys we intern.
+ */
+uint64_t yaml_intern_hash(const yaml_char_t *string, size_t length) {
+	uint64_t hash = 14695981039346656037ULL;
+	size_t i;
+
+	for (i = 0; i < length; i++) {
+		hash ^= string[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/* Find the slot holding the string, or the empty slot where it belongs.
+ */
+static int *yaml_intern_lookup_(const yaml_intern_t *intern,
+		const yaml_char_t *string, size_t length, uint64_t hash) {
+	size_t mask = intern->capacity - 1;
+	size_t i = (size_t)hash & mask;
+
+	for (;; i = (i + 1) & mask) {
+		int *slot = intern->slots + i;
+		yaml_intern_entry_t *entry;
+
+		if (!*slot)
+			return slot;
+
+		entry = intern->entries.start + (*slot - 1);
+		if (entry->hash == hash && entry->length == length
+				&& !memcmp(entry->string, string, length))
+			return slot;
+	}
+}
+
+/* Double the hash slots, keeping the load factor under 1/2.
+ */
+static int yaml_intern_grow_(yaml_intern_t *intern) {
+	size_t capacity = intern->capacity * 2;
+	int *slots = (int *)YAML_MALLOC(capacity * sizeof(int));
+	yaml_intern_entry_t *entry;
+	int id;
+
+	if (!slots)
+		return YAML_EMEMORY;
+
+	memset(slots, 0, capacity * sizeof(int));
+	YAML_FREE(intern->slots);
+	intern->slots = slots;
+	intern->capacity = capacity;
+
+	for (entry = intern->entries.start, id = 1; entry != intern->entries.top; entry++, id++)
+		*yaml_intern_lookup_(intern, entry->string, entry->length, entry->hash) = id;
+
+	return YAML_EOK;
+}
+
+int yaml_intern_init(yaml_intern_t *intern) {
+	int error;
+	size_t i;
+
+	assert(intern); /* Non-NULL string table expected. */
+	memset(intern, 0, sizeof(yaml_intern_t));
+
+	YAML_STACK_INIT(&error, &intern->entries, yaml_intern_entry_t, YAML_INITIAL_STACK_SIZE);
+	if (error)
+		return error;
+
+	intern->slots = (int *)YAML_MALLOC(YAML_INTERN_INITIAL_SLOTS * sizeof(int));
+	if (!intern->slots) {
+		YAML_STACK_DESTROY(&intern->entries);
+		return YAML_EMEMORY;
+	}
+	memset(intern->slots, 0, YAML_INTERN_INITIAL_SLOTS * sizeof(int));
+	intern->capacity = YAML_INTERN_INITIAL_SLOTS;
+
+	for (i = 0; i < sizeof(yaml_intern_standard_tags_) / sizeof(*yaml_intern_standard_tags_); i++) {
+		const yaml_char_t *tag = (const yaml_char_t *)yaml_intern_standard_tags_[i];
+
+		if (yaml_intern_add(intern, tag, strlen((const char *)tag)) < 0) {
+			yaml_intern_destroy(intern);
+			return YAML_EMEMORY;
+		}
+	}
+
+	return YAML_EOK;
+}
+
+void yaml_intern_destroy(yaml_intern_t *intern) {
+	yaml_intern_entry_t *entry;
+
+	assert(intern); /* Non-NULL string table expected. */
+
+	if (intern->entries.start) {
+		for (entry = intern->entries.start; entry != intern->entries.top; entry++)
+			YAML_FREE(entry->string);
+	}
+	YAML_STACK_DESTROY(&intern->entries);
+	YAML_FREE(intern->slots);
+	memset(intern, 0, sizeof(yaml_intern_t));
+}
+
+int yaml_intern_add(yaml_intern_t *intern, const yaml_char_t *string, size_t length) {
+	uint64_t hash;
+	int *slot;
+	yaml_intern_entry_t entry;
+	int error;
+
+	assert(intern && intern->slots); /* Initialized string table expected. */
+	assert(string || !length);
+
+	hash = yaml_intern_hash(string, length);
+	slot = yaml_intern_lookup_(intern, string, length, hash);
+	if (*slot)
+		return *slot;
+
+	if ((size_t)(intern->entries.top - intern->entries.start) >= INT32_MAX - 1)
+		return YAML_EMEMORY;
+
+	if ((size_t)(intern->entries.top - intern->entries.start + 1) * 2 > intern->capacity) {
+		error = yaml_intern_grow_(intern);
+		if (error)
+			return error;
+		slot = yaml_intern_lookup_(intern, string, length, hash);
+	}
+
+	entry.string = (yaml_char_t *)YAML_MALLOC(length + 1);
+	if (!entry.string)
+		return YAML_EMEMORY;
+	if (length)
+		memcpy(entry.string, string, length);
+	entry.string[length] = '\0';
+	entry.length = length;
+	entry.hash = hash;
+
+	YAML_STACK_PUSH(&error, &intern->entries, yaml_intern_entry_t, entry);
+	if (error) {
+		YAML_FREE(entry.string);
+		return error;
+	}
+	*slot = (int)(intern->entries.top - intern->entries.start);
+
+	return *slot;
+}
+
+int yaml_intern_find(const yaml_intern_t *intern, const yaml_char_t *string, size_t length) {
+	assert(intern && intern->slots); /* Initialized string table expected. */
+	assert(string || !length);
+
+	return *yaml_intern_lookup_(intern, string, length, yaml_intern_hash(string, length));
+}
+
+const yaml_char_t *yaml_intern_get(const yaml_intern_t *intern, int id) {
+	assert(intern); /* Non-NULL string table expected. */
+
+	if (id <= 0 || id > intern->entries.top - intern->entries.start)
+		return NULL;
+	return intern->entries.start[id - 1].string;
+}
@@ -0,0 +1,326 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "yaml_private.h"
+
+/* The position of the next node in the collection being written.
+ */
+#define YAML_JSON_FIRST_ITEM	0 /* The first item of an array. */
+#define YAML_JSON_ITEM			1 /* An item of an array after the first one. */
+#define YAML_JSON_FIRST_KEY		2 /* The first key of an object. */
+#define YAML_JSON_KEY			3 /* A key of an object after the first one. */
+#define YAML_JSON_VALUE			4 /* The value of an object member. */
+
+/* Check for -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][-+]?[0-9]+)?
+ */
+static int yaml_json_is_number_(const yaml_char_t *value, size_t length) {
+	const yaml_char_t *pointer = value;
+	const yaml_char_t *end = value + length;
+
+#define YAML_JSON_DIGITS() do { \
+	if (pointer == end || *pointer < '0' || *pointer > '9') \
+		return 0; \
+	while (pointer != end && *pointer >= '0' && *pointer <= '9') \
+		pointer++; \
+} while (0)
+
+	if (pointer != end && *pointer == '-')
+		pointer++;
+	if (pointer != end && *pointer == '0')
+		pointer++;
+	else
+		YAML_JSON_DIGITS();
+	if (pointer != end && *pointer == '.') {
+		pointer++;
+		YAML_JSON_DIGITS();
+	}
+	if (pointer != end && (*pointer == 'e' || *pointer == 'E')) {
+		pointer++;
+		if (pointer != end && (*pointer == '-' || *pointer == '+'))
+			pointer++;
+		YAML_JSON_DIGITS();
+	}
+
+#undef YAML_JSON_DIGITS
+
+	return pointer == end;
+}
+
+/* Format a double with the fewest digits reading back to the same value.
+ */
+static void yaml_json_format_double_(char *buffer, double value) {
+	int precision;
+
+	for (precision = 15; precision < 17; precision++) {
+		sprintf(buffer, "%.*g", precision, value);
+		if (strtod(buffer, NULL) == value)
+			break;
+	}
+	if (precision == 17)
+		sprintf(buffer, "%.17g", value);
+
+	/* Keep the value a float for the readers telling them apart. */
+	if (!strpbrk(buffer, ".eEn"))
+		strcat(buffer, ".0");
+}
+
+const char *yaml_json_scalar_literal(const yaml_event_t *event, char *buffer) {
+	const char *tag = (const char *)event->data.scalar.tag;
+	int style = event->data.scalar.style;
+	yaml_node_t node;
+
+	assert(event && event->type == YAML_EVENT_SCALAR); /* A SCALAR event is expected. */
+
+	/* Only plain untagged scalars, resolved by value, or the ones tagged
+	 * with a core type other than !!str are literals. */
+	memset(&node, 0, sizeof(yaml_node_t));
+	if (tag) {
+		node.tag_id = !strcmp(tag, YAML_TAG_NULL) ? YAML_TAG_ID_NULL
+			: !strcmp(tag, YAML_TAG_BOOL) ? YAML_TAG_ID_BOOL
+			: !strcmp(tag, YAML_TAG_INT) ? YAML_TAG_ID_INT
+			: !strcmp(tag, YAML_TAG_FLOAT) ? YAML_TAG_ID_FLOAT
+			: 0;
+		if (!node.tag_id)
+			return NULL;
+	}
+	else if (!event->data.scalar.plain_implicit || (style != YAML_SCALAR_ANY && style != YAML_SCALAR_PLAIN))
+		return NULL;
+
+	node.type = YAML_NSTYLE_SCALAR;
+	node.data.scalar.value = event->data.scalar.value;
+	node.data.scalar.length = event->data.scalar.length;
+	node.data.scalar.style = YAML_SCALAR_PLAIN;
+
+	switch (yaml_node_resolve(&node)) {
+	case YAML_RESOLVE_NULL:
+		return "null";
+	case YAML_RESOLVE_BOOL:
+		return node.data.scalar.typed.boolean ? "true" : "false";
+	case YAML_RESOLVE_INT:
+		if (yaml_json_is_number_(event->data.scalar.value, event->data.scalar.length))
+			return (const char *)event->data.scalar.value;
+		sprintf(buffer, "%lld", (long long)node.data.scalar.typed.integer);
+		return buffer;
+	case YAML_RESOLVE_FLOAT:
+		/* JSON has no infinity nor not-a-number, they stay strings. */
+		if (!isfinite(node.data.scalar.typed.real))
+			return NULL;
+		if (yaml_json_is_number_(event->data.scalar.value, event->data.scalar.length))
+			return (const char *)event->data.scalar.value;
+		yaml_json_format_double_(buffer, node.data.scalar.typed.real);
+		return buffer;
+	default:
+		return NULL;
+	}
+}
+
+/* Write one octet of punctuation.
+ */
+static int yaml_json_put_(yaml_emitter_t *emitter, yaml_char_t octet) {
+	int error;
+
+	if (emitter->buffer.end - emitter->buffer.pointer < 8) {
+		error = yaml_emitter_flush(emitter);
+		if (error)
+			return error;
+	}
+
+	*(emitter->buffer.pointer++) = octet;
+	emitter->column++;
+	return YAML_EOK;
+}
+
+/* Write a quoted string. Runs needing no escape are found 8 octets at a
+ * time and written as they are.
+ */
+static int yaml_json_write_string_(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length) {
+	static const char hex[] = "0123456789abcdef";
+	const yaml_char_t *end = value + length;
+	const yaml_char_t *run = value;
+	const yaml_char_t *pointer = value;
+	int error;
+
+	error = yaml_json_put_(emitter, '"');
+	if (error)
+		return error;
+
+	while (pointer != end) {
+		yaml_char_t escape[6];
+		size_t escape_length = 2;
+		uint64_t x;
+
+		while (end - pointer >= 8) {
+			memcpy(&x, pointer, sizeof(x));
+			if (YAML_SWAR_HAS_LESS(x, 0x20) | YAML_SWAR_HAS(x, '"') | YAML_SWAR_HAS(x, '\\'))
+				break;
+			pointer += 8;
+		}
+		while (pointer != end && *pointer >= 0x20 && *pointer != '"' && *pointer != '\\')
+			pointer++;
+		if (pointer == end)
+			break;
+
+		/* Flush the run before the escaped octet. */
+		if (pointer != run) {
+			error = yaml_emitter_write_verbatim(emitter, run, pointer - run);
+			if (error)
+				return error;
+		}
+
+		escape[0] = '\\';
+		switch (*pointer) {
+		case '"': escape[1] = '"'; break;
+		case '\\': escape[1] = '\\'; break;
+		case '\b': escape[1] = 'b'; break;
+		case '\f': escape[1] = 'f'; break;
+		case '\n': escape[1] = 'n'; break;
+		case '\r': escape[1] = 'r'; break;
+		case '\t': escape[1] = 't'; break;
+		default:
+			escape[1] = 'u';
+			escape[2] = '0';
+			escape[3] = '0';
+			escape[4] = hex[*pointer >> 4];
+			escape[5] = hex[*pointer & 0x0F];
+			escape_length = 6;
+			break;
+		}
+		error = yaml_emitter_write_verbatim(emitter, escape, escape_length);
+		if (error)
+			return error;
+
+		run = ++pointer;
+	}
+
+	if (pointer != run) {
+		error = yaml_emitter_write_verbatim(emitter, run, pointer - run);
+		if (error)
+			return error;
+	}
+
+	return yaml_json_put_(emitter, '"');
+}
+
+/* Write the separator due before a node and move to the next position.
+ */
+static int yaml_json_begin_node_(yaml_emitter_t *emitter, int *key) {
+	int *position;
+	int error = YAML_EOK;
+
+	*key = 0;
+	if (emitter->states.top == emitter->states.start)
+		return YAML_EOK;
+
+	position = emitter->states.top - 1;
+	switch (*position) {
+	case YAML_JSON_FIRST_ITEM:
+		*position = YAML_JSON_ITEM;
+		break;
+	case YAML_JSON_ITEM:
+		error = yaml_json_put_(emitter, ',');
+		break;
+	case YAML_JSON_FIRST_KEY:
+		*key = 1;
+		*position = YAML_JSON_VALUE;
+		break;
+	case YAML_JSON_KEY:
+		*key = 1;
+		*position = YAML_JSON_VALUE;
+		error = yaml_json_put_(emitter, ',');
+		break;
+	case YAML_JSON_VALUE:
+		*position = YAML_JSON_KEY;
+		error = yaml_json_put_(emitter, ':');
+		break;
+	}
+
+	return error;
+}
+
+static int yaml_json_emit_(yaml_emitter_t *emitter, yaml_event_t *event) {
+	char buffer[32];
+	const char *literal;
+	int error = YAML_EOK;
+	int key;
+
+	switch (event->type) {
+	case YAML_EVENT_STREAM_START:
+		if (!emitter->encoding)
+			emitter->encoding = event->data.stream_start.encoding;
+		if (!emitter->encoding)
+			emitter->encoding = YAML_ENCODING_UTF8;
+		emitter->line = 0;
+		emitter->column = 0;
+		emitter->state = YAML_ES_FIRST_DOCUMENT_START;
+		return YAML_EOK;
+
+	case YAML_EVENT_STREAM_END:
+		emitter->state = YAML_ES_END_STATE;
+		return yaml_emitter_flush(emitter);
+
+	case YAML_EVENT_DOCUMENT_START:
+		emitter->state = YAML_ES_DOCUMENT_CONTENT;
+		return YAML_EOK;
+
+	/* One document per line. */
+	case YAML_EVENT_DOCUMENT_END:
+		error = yaml_json_put_(emitter, '\n');
+		if (error)
+			return error;
+		emitter->line++;
+		emitter->column = 0;
+		emitter->state = YAML_ES_DOCUMENT_START;
+		return yaml_emitter_flush(emitter);
+
+	case YAML_EVENT_ALIAS:
+		emitter->error = YAML_EEMITTER;
+		emitter->problem = "aliases cannot be written as JSON";
+		return YAML_EEMITTER;
+
+	case YAML_EVENT_SCALAR:
+		error = yaml_json_begin_node_(emitter, &key);
+		if (error)
+			return error;
+		literal = key ? NULL : yaml_json_scalar_literal(event, buffer);
+		if (literal)
+			return yaml_emitter_write_verbatim(emitter, (const yaml_char_t *)literal, strlen(literal));
+		return yaml_json_write_string_(emitter, event->data.scalar.value, event->data.scalar.length);
+
+	case YAML_EVENT_SEQUENCE_START:
+	case YAML_EVENT_MAPPING_START:
+		error = yaml_json_begin_node_(emitter, &key);
+		if (error)
+			return error;
+		if (key) {
+			emitter->error = YAML_EEMITTER;
+			emitter->problem = "complex keys cannot be written as JSON";
+			return YAML_EEMITTER;
+		}
+		YAML_STACK_PUSH(&error, &emitter->states, int,
+			event->type == YAML_EVENT_SEQUENCE_START ? YAML_JSON_FIRST_ITEM : YAML_JSON_FIRST_KEY);
+		if (error) {
+			emitter->error = YAML_EMEMORY;
+			return error;
+		}
+		return yaml_json_put_(emitter, event->type == YAML_EVENT_SEQUENCE_START ? '[' : '{');
+
+	case YAML_EVENT_SEQUENCE_END:
+	case YAML_EVENT_MAPPING_END:
+		(void)YAML_STACK_POP(&emitter->states);
+		return yaml_json_put_(emitter, event->type == YAML_EVENT_SEQUENCE_END ? ']' : '}');
+
+	default:
+		return YAML_EOK;
+	}
+}
+
+int yaml_emitter_emit_json(yaml_emitter_t *emitter, yaml_event_t *event) {
+	int error;
+
+	assert(emitter); /* Non-NULL emitter object is expected. */
+	assert(event); /* Non-NULL event object is expected. */
+
+	error = yaml_json_emit_(emitter, event);
+	yaml_event_destroy(event);
+	return error;
+}
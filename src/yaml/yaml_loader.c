@@ -0,0 +1,368 @@
+#include "yaml_private.h"
+
+/* A collection being composed, with the key waiting for its value.
+ */
+typedef struct {
+	int index;
+	int key;
+} yaml_loader_parent_t;
+
+typedef YAML_STACK_STRUCT(yaml_loader_parent_t) yaml_loader_parents_t;
+
+static int yaml_parser_set_composer_error_(yaml_parser_t *parser,
+		const char *problem, yaml_mark_t problem_mark) {
+	parser->error = YAML_ECOMPOSER;
+	parser->problem = problem;
+	parser->problem_mark = problem_mark;
+	return YAML_ECOMPOSER;
+}
+
+static int yaml_parser_set_composer_error_context_(yaml_parser_t *parser,
+		const char *context, yaml_mark_t context_mark,
+		const char *problem, yaml_mark_t problem_mark) {
+	parser->error = YAML_ECOMPOSER;
+	parser->context = context;
+	parser->context_mark = context_mark;
+	parser->problem = problem;
+	parser->problem_mark = problem_mark;
+	return YAML_ECOMPOSER;
+}
+
+/* Release the anchors of the document, they do not cross documents.
+ */
+static void yaml_parser_delete_aliases_(yaml_parser_t *parser) {
+	while (parser->aliases.top != parser->aliases.start)
+		YAML_FREE(YAML_STACK_POP(&parser->aliases).anchor);
+}
+
+/* Intern the node tag, the non-specific `!` and a missing tag giving the default one.
+ */
+static int yaml_parser_load_tag_(yaml_parser_t *parser, const yaml_char_t *tag,
+		const char *default_tag, yaml_char_t **shared) {
+	int id;
+
+	if (!tag || !strcmp((const char *)tag, "!"))
+		tag = (const yaml_char_t *)default_tag;
+
+	id = yaml_intern_add(&parser->document->strings, tag, strlen((const char *)tag));
+	if (id < 0) {
+		parser->error = id;
+		return id;
+	}
+	*shared = (yaml_char_t *)yaml_intern_get(&parser->document->strings, id);
+	return id;
+}
+
+/* Remember the anchor of a new node, taking it from the event.
+ */
+static int yaml_parser_register_anchor_(yaml_parser_t *parser, int index, yaml_char_t **anchor) {
+	yaml_alias_data_t data;
+	yaml_alias_data_t *alias_data;
+	int error;
+
+	if (!*anchor)
+		return YAML_EOK;
+
+	data.anchor = *anchor;
+	data.index = index;
+	data.mark = parser->document->nodes.start[index - 1].start_mark;
+
+	for (alias_data = parser->aliases.start; alias_data != parser->aliases.top; alias_data++) {
+		if (!strcmp((char *)alias_data->anchor, (char *)data.anchor))
+			return yaml_parser_set_composer_error_context_(parser,
+				"found duplicate anchor; first occurrence", alias_data->mark,
+				"second occurrence", data.mark);
+	}
+
+	YAML_STACK_PUSH(&error, &parser->aliases, yaml_alias_data_t, data);
+	if (error) {
+		parser->error = error;
+		return error;
+	}
+	*anchor = NULL;
+
+	return YAML_EOK;
+}
+
+/* Attach a composed node to the collection on top of the parents, or make it the root.
+ */
+static int yaml_parser_load_node_add_(yaml_parser_t *parser, yaml_loader_parents_t *parents, int index) {
+	yaml_loader_parent_t *parent;
+	int error;
+
+	if (parents->top == parents->start)
+		return YAML_EOK;
+
+	parent = parents->top - 1;
+	if (parser->document->nodes.start[parent->index - 1].type == YAML_NSTYLE_SEQUENCE)
+		error = yaml_document_append_sequence_item(parser->document, parent->index, index);
+	else if (!parent->key) {
+		parent->key = index;
+		return YAML_EOK;
+	}
+	else {
+		error = yaml_document_append_mapping_pair(parser->document, parent->index, parent->key, index);
+		parent->key = 0;
+	}
+
+	if (error)
+		parser->error = error;
+	return error;
+}
+
+static int yaml_parser_load_alias_(yaml_parser_t *parser, yaml_event_t *event, yaml_loader_parents_t *parents) {
+	yaml_alias_data_t *alias_data;
+
+	for (alias_data = parser->aliases.start; alias_data != parser->aliases.top; alias_data++) {
+		if (!strcmp((char *)alias_data->anchor, (char *)event->data.alias.anchor))
+			return yaml_parser_load_node_add_(parser, parents, alias_data->index);
+	}
+
+	return yaml_parser_set_composer_error_(parser, "found undefined alias", event->start_mark);
+}
+
+static int yaml_parser_load_scalar_(yaml_parser_t *parser, yaml_event_t *event, yaml_loader_parents_t *parents) {
+	yaml_char_t *tag = NULL;
+	yaml_node_t node;
+	int tag_id;
+	int index;
+	int error;
+
+	tag_id = yaml_parser_load_tag_(parser, event->data.scalar.tag, YAML_TAG_DEFAULT_SCALAR, &tag);
+	if (tag_id < 0)
+		return tag_id;
+
+	YAML_SCALAR_NODE_INIT(&node, tag, tag_id, event->data.scalar.value, event->data.scalar.length,
+		event->data.scalar.style, event->start_mark, event->end_mark);
+	node.data.scalar.implicit = !event->data.scalar.tag;
+	YAML_STACK_PUSH(&error, &parser->document->nodes, yaml_node_t, node);
+	if (error) {
+		parser->error = error;
+		return error;
+	}
+
+	/* The node owns the value now. */
+	event->data.scalar.value = NULL;
+
+	index = (int)(parser->document->nodes.top - parser->document->nodes.start);
+	error = yaml_parser_register_anchor_(parser, index, &event->data.scalar.anchor);
+	if (error)
+		return error;
+
+	return yaml_parser_load_node_add_(parser, parents, index);
+}
+
+static int yaml_parser_load_sequence_(yaml_parser_t *parser, yaml_event_t *event, yaml_loader_parents_t *parents) {
+	YAML_STACK_STRUCT(yaml_node_item_t) items;
+	yaml_loader_parent_t parent;
+	yaml_char_t *tag = NULL;
+	yaml_node_t node;
+	int tag_id;
+	int error;
+
+	tag_id = yaml_parser_load_tag_(parser, event->data.sequence_start.tag, YAML_TAG_DEFAULT_SEQUENCE, &tag);
+	if (tag_id < 0)
+		return tag_id;
+
+	YAML_STACK_INIT(&error, &items, yaml_node_item_t, YAML_INITIAL_STACK_SIZE);
+	if (error) {
+		parser->error = error;
+		return error;
+	}
+
+	YAML_SEQUENCE_NODE_INIT(&node, tag, tag_id, items.start, items.end,
+		event->data.sequence_start.style, event->start_mark, event->end_mark);
+	YAML_STACK_PUSH(&error, &parser->document->nodes, yaml_node_t, node);
+	if (error) {
+		YAML_STACK_DESTROY(&items);
+		parser->error = error;
+		return error;
+	}
+
+	parent.index = (int)(parser->document->nodes.top - parser->document->nodes.start);
+	parent.key = 0;
+	error = yaml_parser_register_anchor_(parser, parent.index, &event->data.sequence_start.anchor);
+	if (error)
+		return error;
+	error = yaml_parser_load_node_add_(parser, parents, parent.index);
+	if (error)
+		return error;
+
+	YAML_STACK_PUSH(&error, parents, yaml_loader_parent_t, parent);
+	if (error)
+		parser->error = error;
+	return error;
+}
+
+static int yaml_parser_load_mapping_(yaml_parser_t *parser, yaml_event_t *event, yaml_loader_parents_t *parents) {
+	YAML_STACK_STRUCT(yaml_node_pair_t) pairs;
+	yaml_loader_parent_t parent;
+	yaml_char_t *tag = NULL;
+	yaml_node_t node;
+	int tag_id;
+	int error;
+
+	tag_id = yaml_parser_load_tag_(parser, event->data.mapping_start.tag, YAML_TAG_DEFAULT_MAPPING, &tag);
+	if (tag_id < 0)
+		return tag_id;
+
+	YAML_STACK_INIT(&error, &pairs, yaml_node_pair_t, YAML_INITIAL_STACK_SIZE);
+	if (error) {
+		parser->error = error;
+		return error;
+	}
+
+	YAML_MAPPING_NODE_INIT(&node, tag, tag_id, pairs.start, pairs.end,
+		event->data.mapping_start.style, event->start_mark, event->end_mark);
+	YAML_STACK_PUSH(&error, &parser->document->nodes, yaml_node_t, node);
+	if (error) {
+		YAML_STACK_DESTROY(&pairs);
+		parser->error = error;
+		return error;
+	}
+
+	parent.index = (int)(parser->document->nodes.top - parser->document->nodes.start);
+	parent.key = 0;
+	error = yaml_parser_register_anchor_(parser, parent.index, &event->data.mapping_start.anchor);
+	if (error)
+		return error;
+	error = yaml_parser_load_node_add_(parser, parents, parent.index);
+	if (error)
+		return error;
+
+	YAML_STACK_PUSH(&error, parents, yaml_loader_parent_t, parent);
+	if (error)
+		parser->error = error;
+	return error;
+}
+
+/* Compose the nodes of a document up to its DOCUMENT-END, without recursion.
+ */
+static int yaml_parser_load_nodes_(yaml_parser_t *parser, yaml_loader_parents_t *parents) {
+	yaml_event_t event;
+	int error;
+
+	for (;;) {
+		error = yaml_parser_parse(parser, &event);
+		if (error)
+			return error;
+
+		switch (event.type) {
+		case YAML_EVENT_ALIAS:
+			error = yaml_parser_load_alias_(parser, &event, parents);
+			break;
+		case YAML_EVENT_SCALAR:
+			error = yaml_parser_load_scalar_(parser, &event, parents);
+			break;
+		case YAML_EVENT_SEQUENCE_START:
+			error = yaml_parser_load_sequence_(parser, &event, parents);
+			break;
+		case YAML_EVENT_MAPPING_START:
+			error = yaml_parser_load_mapping_(parser, &event, parents);
+			break;
+		case YAML_EVENT_SEQUENCE_END:
+		case YAML_EVENT_MAPPING_END:
+			assert(parents->top != parents->start); /* Balanced events are expected. */
+			parents->top--;
+			parser->document->nodes.start[parents->top->index - 1].end_mark = event.end_mark;
+			break;
+		case YAML_EVENT_DOCUMENT_END:
+			parser->document->end_implicit = event.data.document_end.implicit;
+			parser->document->end_mark = event.end_mark;
+			yaml_event_destroy(&event);
+			return YAML_EOK;
+		default:
+			assert(0); /* Could not happen. */
+			error = YAML_EFAILD;
+			break;
+		}
+
+		yaml_event_destroy(&event);
+		if (error)
+			return error;
+	}
+}
+
+/* Compose the next document of the stream, an empty one at its end.
+ */
+static int yaml_parser_load_document_(yaml_parser_t *parser, yaml_document_t *document) {
+	yaml_loader_parents_t parents = { NULL, NULL, NULL };
+	yaml_event_t event;
+	int error;
+
+	error = yaml_document_init(document, 0, 0, NULL, NULL, 0, 0);
+	if (error) {
+		parser->error = error;
+		return error;
+	}
+
+	if (!parser->stream_start_produced) {
+		error = yaml_parser_parse(parser, &event);
+		if (error)
+			goto ERROR;
+		assert(event.type == YAML_EVENT_STREAM_START); /* STREAM-START is expected. */
+		yaml_event_destroy(&event);
+	}
+
+	/* An empty document tells the stream has ended. */
+	if (parser->stream_end_produced)
+		return YAML_EOK;
+
+	error = yaml_parser_parse(parser, &event);
+	if (error)
+		goto ERROR;
+	if (event.type == YAML_EVENT_STREAM_END) {
+		yaml_event_destroy(&event);
+		return YAML_EOK;
+	}
+	assert(event.type == YAML_EVENT_DOCUMENT_START); /* DOCUMENT-START is expected. */
+
+	/* The document keeps the directives it declares, as the event carries them. */
+	yaml_document_destroy(document);
+	error = yaml_document_init(document,
+		event.data.document_start.version_directive.major,
+		event.data.document_start.version_directive.minor,
+		event.data.document_start.tag_directives.start,
+		event.data.document_start.tag_directives.end,
+		event.data.document_start.implicit, 1);
+	document->start_mark = event.start_mark;
+	yaml_event_destroy(&event);
+	if (error) {
+		parser->error = error;
+		return error;
+	}
+
+	YAML_STACK_INIT(&error, &parents, yaml_loader_parent_t, YAML_INITIAL_STACK_SIZE);
+	if (error)
+		goto ERROR;
+
+	parser->document = document;
+	error = yaml_parser_load_nodes_(parser, &parents);
+	parser->document = NULL;
+	yaml_parser_delete_aliases_(parser);
+	YAML_STACK_DESTROY(&parents);
+	if (error)
+		goto ERROR;
+
+	return YAML_EOK;
+
+ERROR:
+	yaml_document_destroy(document);
+	if (!parser->error)
+		parser->error = error;
+	return error;
+}
+
+int yaml_parser_load(yaml_parser_t *parser, yaml_document_t *document) {
+	int error;
+
+	assert(parser); /* Non-NULL parser object is expected. */
+	assert(document); /* Non-NULL document object is expected. */
+
+	{
+		YAML_STATS_BEGIN(parser, mark);
+		error = yaml_parser_load_document_(parser, document);
+		YAML_STATS_END(parser, YAML_STATS_COMPOSER, mark);
+	}
+	return error;
+}
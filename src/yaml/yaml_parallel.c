@@ -0,0 +1,277 @@
+#include "yaml_private.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+# define YAML_THREADS_WIN32
+#elif defined(YAML_HAVE_THREADS)
+# include <pthread.h>
+# include <unistd.h>
+# define YAML_THREADS_POSIX
+#endif
+
+/* A document to emit and the tail of the emitter state it leaves, the only
+ * state the next document depends on.
+ */
+typedef struct {
+	yaml_document_t *document;
+	yaml_output_buffer_t output;
+
+	/* The document is not the first of the stream. */
+	int subsequent;
+	/* The document follows an open ended one, only known in order. */
+	int open_ended;
+	/* The output depends on the previous document, it is emitted in order. */
+	int deferred;
+
+	int error;
+	const char *problem;
+
+	int line;
+	int column;
+	int whitespace;
+	int indention;
+} yaml_dump_job_t;
+
+typedef struct {
+	const yaml_emitter_t *emitter;
+	yaml_dump_job_t *jobs;
+	size_t count;
+	size_t next;
+#if defined(YAML_THREADS_WIN32)
+	CRITICAL_SECTION lock;
+#elif defined(YAML_THREADS_POSIX)
+	pthread_mutex_t lock;
+#endif
+} yaml_dump_pool_t;
+
+/* Emit one document into memory with a private emitter set up like the shared one.
+ */
+static void yaml_dump_job_run_(const yaml_emitter_t *emitter, yaml_dump_job_t *job) {
+	yaml_emitter_t worker;
+
+	job->error = yaml_emitter_init(&worker);
+	if (job->error) {
+		job->problem = "cannot allocate an emitter";
+		yaml_document_destroy(job->document);
+		return;
+	}
+
+	worker.canonical = emitter->canonical;
+	worker.json = emitter->json;
+	worker.best_indent = emitter->best_indent;
+	worker.best_width = emitter->best_width;
+	worker.unicode = emitter->unicode;
+	worker.line_break = emitter->line_break;
+	worker.zero_copy_threshold = 0;
+	yaml_emitter_set_output_buffer(&worker, &job->output);
+	yaml_emitter_set_encoding(&worker, YAML_ENCODING_UTF8);
+
+	job->error = yaml_emitter_open(&worker);
+	if (job->error) {
+		yaml_document_destroy(job->document);
+	}
+	else {
+		if (job->subsequent)
+			worker.state = YAML_ES_DOCUMENT_START;
+		worker.open_ended = job->open_ended;
+
+		job->error = yaml_emitter_dump(&worker, job->document);
+		if (!job->error)
+			job->error = yaml_emitter_flush(&worker);
+	}
+
+	job->problem = worker.problem;
+	job->open_ended = worker.open_ended;
+	job->line = worker.line;
+	job->column = worker.column;
+	job->whitespace = worker.whitespace;
+	job->indention = worker.indention;
+
+	yaml_emitter_release_output(&worker);
+	yaml_emitter_destroy(&worker);
+}
+
+/* Take the jobs in order until none is left.
+ */
+static void yaml_dump_pool_work_(yaml_dump_pool_t *pool) {
+	for (;;) {
+		size_t index;
+
+#if defined(YAML_THREADS_WIN32)
+		EnterCriticalSection(&pool->lock);
+		index = pool->next++;
+		LeaveCriticalSection(&pool->lock);
+#elif defined(YAML_THREADS_POSIX)
+		pthread_mutex_lock(&pool->lock);
+		index = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+#else
+		index = pool->next++;
+#endif
+
+		if (index >= pool->count)
+			return;
+		if (!pool->jobs[index].deferred)
+			yaml_dump_job_run_(pool->emitter, pool->jobs + index);
+	}
+}
+
+#if defined(YAML_THREADS_WIN32)
+static DWORD WINAPI yaml_dump_thread_(LPVOID data) {
+	yaml_dump_pool_work_((yaml_dump_pool_t *)data);
+	return 0;
+}
+#elif defined(YAML_THREADS_POSIX)
+static void *yaml_dump_thread_(void *data) {
+	yaml_dump_pool_work_((yaml_dump_pool_t *)data);
+	return NULL;
+}
+#endif
+
+/* Run the pool on the given number of threads, the caller being one of them.
+ */
+static void yaml_dump_pool_run_(yaml_dump_pool_t *pool, int threads) {
+#if defined(YAML_THREADS_WIN32)
+	HANDLE *handles;
+	int started = 0;
+	int i;
+
+	if (threads <= 0) {
+		SYSTEM_INFO info;
+
+		GetSystemInfo(&info);
+		threads = (int)info.dwNumberOfProcessors;
+	}
+	if ((size_t)threads > pool->count)
+		threads = (int)pool->count;
+
+	handles = threads > 1 ? (HANDLE *)YAML_MALLOC((threads - 1) * sizeof(HANDLE)) : NULL;
+	InitializeCriticalSection(&pool->lock);
+	for (i = 0; handles && i < threads - 1; i++) {
+		handles[started] = CreateThread(NULL, 0, yaml_dump_thread_, pool, 0, NULL);
+		if (handles[started])
+			started++;
+	}
+	yaml_dump_pool_work_(pool);
+	for (i = 0; i < started; i++) {
+		WaitForSingleObject(handles[i], INFINITE);
+		CloseHandle(handles[i]);
+	}
+	DeleteCriticalSection(&pool->lock);
+	YAML_FREE(handles);
+#elif defined(YAML_THREADS_POSIX)
+	pthread_t *handles;
+	int started = 0;
+	int i;
+
+	if (threads <= 0) {
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+		threads = processors > 0 ? (int)processors : 1;
+	}
+	if ((size_t)threads > pool->count)
+		threads = (int)pool->count;
+
+	handles = threads > 1 ? (pthread_t *)YAML_MALLOC((threads - 1) * sizeof(pthread_t)) : NULL;
+	pthread_mutex_init(&pool->lock, NULL);
+	for (i = 0; handles && i < threads - 1; i++) {
+		if (!pthread_create(handles + started, NULL, yaml_dump_thread_, pool))
+			started++;
+	}
+	yaml_dump_pool_work_(pool);
+	for (i = 0; i < started; i++)
+		pthread_join(handles[i], NULL);
+	pthread_mutex_destroy(&pool->lock);
+	YAML_FREE(handles);
+#else
+	(void)threads;
+	yaml_dump_pool_work_(pool);
+#endif
+}
+
+int yaml_emitter_dump_documents(yaml_emitter_t *emitter,
+		yaml_document_t *documents, size_t count, int threads) {
+	yaml_dump_pool_t pool;
+	yaml_dump_job_t *jobs;
+	size_t i;
+	int error = YAML_EOK;
+
+	assert(emitter); /* Non-NULL emitter object is required. */
+	assert(documents || !count); /* Non-NULL documents array is expected. */
+
+	if (!emitter->opened) {
+		error = yaml_emitter_open(emitter);
+		if (error)
+			return error;
+	}
+	assert(emitter->state == YAML_ES_FIRST_DOCUMENT_START
+		|| emitter->state == YAML_ES_DOCUMENT_START); /* Expect to be between documents. */
+
+	/* Nothing to share the work of. */
+	if (threads == 1 || count < 2) {
+		for (i = 0; i < count; i++) {
+			if (!error)
+				error = yaml_emitter_dump(emitter, documents + i);
+			else
+				yaml_document_destroy(documents + i);
+		}
+		return error;
+	}
+
+	jobs = (yaml_dump_job_t *)YAML_MALLOC(count * sizeof(yaml_dump_job_t));
+	if (!jobs) {
+		emitter->error = YAML_EMEMORY;
+		emitter->problem = "cannot allocate the dump jobs";
+		for (i = 0; i < count; i++)
+			yaml_document_destroy(documents + i);
+		return YAML_EMEMORY;
+	}
+	memset(jobs, 0, count * sizeof(yaml_dump_job_t));
+
+	/* Directives after an open ended document are preceded by "...", which
+	 * only the serial pass knows about. */
+	for (i = 0; i < count; i++) {
+		jobs[i].document = documents + i;
+		jobs[i].subsequent = i || emitter->state == YAML_ES_DOCUMENT_START;
+		jobs[i].open_ended = i ? 0 : emitter->open_ended;
+		jobs[i].deferred = i && (documents[i].version_directive.major
+			|| documents[i].tag_directives.start != documents[i].tag_directives.end);
+	}
+
+	pool.emitter = emitter;
+	pool.jobs = jobs;
+	pool.count = count;
+	pool.next = 0;
+	yaml_dump_pool_run_(&pool, threads);
+
+	/* Write the outputs in order and carry the state over. */
+	for (i = 0; i < count; i++) {
+		yaml_dump_job_t *job = jobs + i;
+
+		if (error) {
+			if (job->deferred)
+				yaml_document_destroy(job->document);
+		}
+		else if (job->deferred) {
+			error = yaml_emitter_dump(emitter, job->document);
+		}
+		else if (job->error) {
+			error = job->error;
+			emitter->error = job->error;
+			emitter->problem = job->problem;
+		}
+		else {
+			error = yaml_emitter_write_verbatim(emitter, job->output.start, job->output.size);
+			emitter->state = YAML_ES_DOCUMENT_START;
+			emitter->open_ended = job->open_ended;
+			emitter->line += job->line;
+			emitter->column = job->column;
+			emitter->whitespace = job->whitespace;
+			emitter->indention = job->indention;
+		}
+		YAML_FREE(job->output.start);
+	}
+
+	YAML_FREE(jobs);
+	return error;
+}
@@ -1,39 +1,1052 @@
-#include <assert.h>
 #include "yaml_private.h"
 
-int yaml_parser_init(yaml_parser_t *parser) {
-	assert(parser);     /* Non-NULL parser object expected. */
-
-	memset(parser, 0, sizeof(yaml_parser_t));
-	if (!BUFFER_INIT(parser, parser->raw_buffer, INPUT_RAW_BUFFER_SIZE))
-		goto error;
-	if (!BUFFER_INIT(parser, parser->buffer, INPUT_BUFFER_SIZE))
-		goto error;
-	if (!QUEUE_INIT(parser, parser->tokens, INITIAL_QUEUE_SIZE))
-		goto error;
-	if (!STACK_INIT(parser, parser->indents, INITIAL_STACK_SIZE))
-		goto error;
-	if (!STACK_INIT(parser, parser->simple_keys, INITIAL_STACK_SIZE))
-		goto error;
-	if (!STACK_INIT(parser, parser->states, INITIAL_STACK_SIZE))
-		goto error;
-	if (!STACK_INIT(parser, parser->marks, INITIAL_STACK_SIZE))
-		goto error;
-	if (!STACK_INIT(parser, parser->tag_directives, INITIAL_STACK_SIZE))
-		goto error;
-
-	return 1;
-
-error:
-
-	BUFFER_DEL(parser, parser->raw_buffer);
-	BUFFER_DEL(parser, parser->buffer);
-	QUEUE_DEL(parser, parser->tokens);
-	STACK_DEL(parser, parser->indents);
-	STACK_DEL(parser, parser->simple_keys);
-	STACK_DEL(parser, parser->states);
-	STACK_DEL(parser, parser->marks);
-	STACK_DEL(parser, parser->tag_directives);
-
-	return 0;
+/* The grammar of the events, parsed from the tokens with one token of
+ * lookahead:
+ *
+ * stream               ::= STREAM-START implicit_document? explicit_document* STREAM-END
+ * implicit_document    ::= block_node DOCUMENT-END*
+ * explicit_document    ::= DIRECTIVE* DOCUMENT-START block_node? DOCUMENT-END*
+ * block_node_or_indentless_sequence ::=
+ *                          ALIAS
+ *                          | properties (block_content | indentless_block_sequence)?
+ *                          | block_content
+ *                          | indentless_block_sequence
+ * block_node           ::= ALIAS
+ *                          | properties block_content?
+ *                          | block_content
+ * flow_node            ::= ALIAS
+ *                          | properties flow_content?
+ *                          | flow_content
+ * properties           ::= TAG ANCHOR? | ANCHOR TAG?
+ * block_content        ::= block_collection | flow_collection | SCALAR
+ * flow_content         ::= flow_collection | SCALAR
+ * block_collection     ::= block_sequence | block_mapping
+ * flow_collection      ::= flow_sequence | flow_mapping
+ * block_sequence       ::= BLOCK-SEQUENCE-START (BLOCK-ENTRY block_node?)* BLOCK-END
+ * indentless_sequence  ::= (BLOCK-ENTRY block_node?)+
+ * block_mapping        ::= BLOCK-MAPPING_START
+ *                          ((KEY block_node_or_indentless_sequence?)?
+ *                          (VALUE block_node_or_indentless_sequence?)?)*
+ *                          BLOCK-END
+ * flow_sequence        ::= FLOW-SEQUENCE-START
+ *                          (flow_sequence_entry FLOW-ENTRY)*
+ *                          flow_sequence_entry?
+ *                          FLOW-SEQUENCE-END
+ * flow_sequence_entry  ::= flow_node | KEY flow_node? (VALUE flow_node?)?
+ * flow_mapping         ::= FLOW-MAPPING-START
+ *                          (flow_mapping_entry FLOW-ENTRY)*
+ *                          flow_mapping_entry?
+ *                          FLOW-MAPPING-END
+ * flow_mapping_entry   ::= flow_node | KEY flow_node? (VALUE flow_node?)?
+ *
+ * %TAG directives stay in effect for the later documents that declare none,
+ * as the documents of a Unity stream rely on the `!u!` handle of the first one.
+ */
+
+/* Set the parser error and return YAML_EPARSER.
+ */
+static int yaml_parser_set_parser_error_(yaml_parser_t *parser, const char *problem,
+		yaml_mark_t problem_mark) {
+	parser->error = YAML_EPARSER;
+	parser->problem = problem;
+	parser->problem_mark = problem_mark;
+	return YAML_EPARSER;
+}
+
+static int yaml_parser_set_parser_error_context_(yaml_parser_t *parser, const char *context,
+		yaml_mark_t context_mark, const char *problem, yaml_mark_t problem_mark) {
+	parser->error = YAML_EPARSER;
+	parser->context = context;
+	parser->context_mark = context_mark;
+	parser->problem = problem;
+	parser->problem_mark = problem_mark;
+	return YAML_EPARSER;
+}
+
+static int yaml_parser_push_state_(yaml_parser_t *parser, int state) {
+	int error;
+
+	YAML_STACK_PUSH(&error, &parser->states, int, state);
+	if (error)
+		parser->error = error;
+	return error;
+}
+
+static int yaml_parser_push_mark_(yaml_parser_t *parser, yaml_mark_t mark) {
+	int error;
+
+	YAML_STACK_PUSH(&error, &parser->marks, yaml_mark_t, mark);
+	if (error)
+		parser->error = error;
+	return error;
+}
+
+/* Produce an empty plain scalar, for a node the input leaves out.
+ */
+static int yaml_parser_process_empty_scalar_(yaml_parser_t *parser, yaml_event_t *event, yaml_mark_t mark) {
+	yaml_char_t *value;
+
+	value = (yaml_char_t *)YAML_MALLOC(1);
+	if (!value) {
+		parser->error = YAML_EMEMORY;
+		return YAML_EMEMORY;
+	}
+	value[0] = '\0';
+
+	YAML_EVENT_SCALAR_INIT(event, NULL, NULL, value, 0, 1, 0, YAML_SCALAR_PLAIN, mark, mark);
+	return YAML_EOK;
+}
+
+static void yaml_parser_clear_tag_directives_(yaml_parser_t *parser) {
+	while (parser->tag_directives.top != parser->tag_directives.start) {
+		yaml_tag_directive_t tag_directive = YAML_STACK_POP(&parser->tag_directives);
+
+		YAML_FREE(tag_directive.handle);
+		YAML_FREE(tag_directive.prefix);
+	}
+}
+
+/* Put a copy of a directive in effect, unless its handle already is.
+ */
+static int yaml_parser_append_tag_directive_(yaml_parser_t *parser, const yaml_tag_directive_t *value) {
+	yaml_tag_directive_t *tag_directive;
+	yaml_tag_directive_t copy;
+	int error;
+
+	for (tag_directive = parser->tag_directives.start; tag_directive != parser->tag_directives.top; tag_directive++) {
+		if (!strcmp((char *)value->handle, (char *)tag_directive->handle))
+			return YAML_EOK;
+	}
+
+	copy.handle = yaml_strdup(value->handle);
+	copy.prefix = yaml_strdup(value->prefix);
+	if (!copy.handle || !copy.prefix) {
+		error = YAML_EMEMORY;
+		goto ERROR;
+	}
+
+	YAML_STACK_PUSH(&error, &parser->tag_directives, yaml_tag_directive_t, copy);
+	if (error)
+		goto ERROR;
+
+	return YAML_EOK;
+
+ERROR:
+	YAML_FREE(copy.handle);
+	YAML_FREE(copy.prefix);
+	parser->error = error;
+	return error;
+}
+
+/* Parse the directives of a document and put its tag handles in effect.
+ * The document gets the %TAG directives it declares, the handles of the
+ * previous document stay in effect if it declares none.
+ */
+static int yaml_parser_process_directives_(yaml_parser_t *parser, int *major, int *minor,
+		yaml_tag_directive_t **tag_directives_start, yaml_tag_directive_t **tag_directives_end) {
+	static const yaml_tag_directive_t default_tag_directives[] = {
+		{ (yaml_char_t *)"!", (yaml_char_t *)"!" },
+		{ (yaml_char_t *)"!!", (yaml_char_t *)"tag:yaml.org,2002:" },
+	};
+	YAML_STACK_STRUCT(yaml_tag_directive_t) tag_directives = { NULL, NULL, NULL };
+	yaml_tag_directive_t *tag_directive;
+	yaml_token_t *token;
+	int has_version = 0;
+	size_t i;
+	int error;
+
+	YAML_STACK_INIT(&error, &tag_directives, yaml_tag_directive_t, YAML_INITIAL_STACK_SIZE);
+	if (error) {
+		parser->error = error;
+		return error;
+	}
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token) {
+		error = parser->error;
+		goto ERROR;
+	}
+
+	while (token->type == YAML_TOKEN_VERSION_DIRECTIVE || token->type == YAML_TOKEN_TAG_DIRECTIVE) {
+		if (token->type == YAML_TOKEN_VERSION_DIRECTIVE) {
+			if (has_version) {
+				error = yaml_parser_set_parser_error_(parser, "found duplicate %YAML directive",
+					token->start_mark);
+				goto ERROR;
+			}
+			if (token->data.version_directive.major != 1
+					|| (token->data.version_directive.minor != 1 && token->data.version_directive.minor != 2)) {
+				error = yaml_parser_set_parser_error_(parser, "found incompatible YAML document",
+					token->start_mark);
+				goto ERROR;
+			}
+			has_version = 1;
+			if (major) {
+				*major = token->data.version_directive.major;
+				*minor = token->data.version_directive.minor;
+			}
+		}
+		else {
+			yaml_tag_directive_t value;
+
+			for (tag_directive = tag_directives.start; tag_directive != tag_directives.top; tag_directive++) {
+				if (!strcmp((char *)token->data.tag_directive.handle, (char *)tag_directive->handle)) {
+					error = yaml_parser_set_parser_error_(parser, "found duplicate %TAG directive",
+						token->start_mark);
+					goto ERROR;
+				}
+			}
+
+			value.handle = token->data.tag_directive.handle;
+			value.prefix = token->data.tag_directive.prefix;
+			YAML_STACK_PUSH(&error, &tag_directives, yaml_tag_directive_t, value);
+			if (error) {
+				parser->error = error;
+				goto ERROR;
+			}
+			token->data.tag_directive.handle = NULL;
+			token->data.tag_directive.prefix = NULL;
+		}
+
+		YAML_PARSER_SKIP_TOKEN(parser);
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token) {
+			error = parser->error;
+			goto ERROR;
+		}
+	}
+
+	/* The declared handles replace the ones in effect. */
+	if (tag_directives.start != tag_directives.top) {
+		yaml_parser_clear_tag_directives_(parser);
+		for (tag_directive = tag_directives.start; tag_directive != tag_directives.top; tag_directive++) {
+			error = yaml_parser_append_tag_directive_(parser, tag_directive);
+			if (error)
+				goto ERROR;
+		}
+	}
+	for (i = 0; i < sizeof(default_tag_directives) / sizeof(default_tag_directives[0]); i++) {
+		error = yaml_parser_append_tag_directive_(parser, default_tag_directives + i);
+		if (error)
+			goto ERROR;
+	}
+
+	if (tag_directives_start && tag_directives.start != tag_directives.top) {
+		*tag_directives_start = tag_directives.start;
+		*tag_directives_end = tag_directives.top;
+	}
+	else {
+		for (tag_directive = tag_directives.start; tag_directive != tag_directives.top; tag_directive++) {
+			YAML_FREE(tag_directive->handle);
+			YAML_FREE(tag_directive->prefix);
+		}
+		YAML_STACK_DESTROY(&tag_directives);
+	}
+
+	return YAML_EOK;
+
+ERROR:
+	for (tag_directive = tag_directives.start; tag_directive != tag_directives.top; tag_directive++) {
+		YAML_FREE(tag_directive->handle);
+		YAML_FREE(tag_directive->prefix);
+	}
+	YAML_STACK_DESTROY(&tag_directives);
+	return error;
+}
+
+static int yaml_parser_parse_stream_start_(yaml_parser_t *parser, yaml_event_t *event) {
+	yaml_token_t *token;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type != YAML_TOKEN_STREAM_START)
+		return yaml_parser_set_parser_error_(parser, "did not find expected <stream-start>",
+			token->start_mark);
+
+	parser->state = YAML_PST_IMPLICIT_DOCUMENT_START;
+	YAML_EVENT_STREAM_START_INIT(event, token->data.stream_start.encoding,
+		token->start_mark, token->start_mark);
+	YAML_PARSER_SKIP_TOKEN(parser);
+
+	return YAML_EOK;
+}
+
+static int yaml_parser_parse_document_start_(yaml_parser_t *parser, yaml_event_t *event, int implicit) {
+	struct {
+		int major;
+		int minor;
+	} version_directive = { 0, 0 };
+	yaml_tag_directive_t *tag_directives_start = NULL;
+	yaml_tag_directive_t *tag_directives_end = NULL;
+	yaml_tag_directive_t *tag_directive;
+	yaml_mark_t start_mark, end_mark;
+	yaml_token_t *token;
+	int error;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	/* Parse extra document end indicators. */
+	if (!implicit) {
+		while (token->type == YAML_TOKEN_DOCUMENT_END) {
+			YAML_PARSER_SKIP_TOKEN(parser);
+			token = YAML_PARSER_PEEK_TOKEN(parser);
+			if (!token)
+				return parser->error;
+		}
+	}
+
+	/* An implicit document. */
+	if (implicit && token->type != YAML_TOKEN_VERSION_DIRECTIVE
+			&& token->type != YAML_TOKEN_TAG_DIRECTIVE && token->type != YAML_TOKEN_DOCUMENT_START
+			&& token->type != YAML_TOKEN_STREAM_END) {
+		error = yaml_parser_process_directives_(parser, NULL, NULL, NULL, NULL);
+		if (error)
+			return error;
+		error = yaml_parser_push_state_(parser, YAML_PARSE_DOCUMENT_END);
+		if (error)
+			return error;
+
+		parser->state = YAML_PARSE_BLOCK_NODE;
+		YAML_EVENT_DOCUMENT_START_INIT(event, version_directive, NULL, NULL, 1,
+			token->start_mark, token->start_mark);
+		return YAML_EOK;
+	}
+
+	/* The end of the stream. */
+	if (token->type == YAML_TOKEN_STREAM_END) {
+		parser->state = YAML_PARSE_END;
+		YAML_EVENT_STREAM_END_INIT(event, token->start_mark, token->end_mark);
+		YAML_PARSER_SKIP_TOKEN(parser);
+		return YAML_EOK;
+	}
+
+	/* An explicit document. */
+	start_mark = token->start_mark;
+	error = yaml_parser_process_directives_(parser, &version_directive.major, &version_directive.minor,
+		&tag_directives_start, &tag_directives_end);
+	if (error)
+		return error;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token) {
+		error = parser->error;
+		goto ERROR;
+	}
+	if (token->type != YAML_TOKEN_DOCUMENT_START) {
+		error = yaml_parser_set_parser_error_(parser, "did not find expected <document start>",
+			token->start_mark);
+		goto ERROR;
+	}
+
+	error = yaml_parser_push_state_(parser, YAML_PARSE_DOCUMENT_END);
+	if (error)
+		goto ERROR;
+
+	parser->state = YAML_PARSE_DOCUMENT_CONTENT;
+	end_mark = token->end_mark;
+	YAML_EVENT_DOCUMENT_START_INIT(event, version_directive, tag_directives_start, tag_directives_end, 0,
+		start_mark, end_mark);
+	YAML_PARSER_SKIP_TOKEN(parser);
+
+	return YAML_EOK;
+
+ERROR:
+	for (tag_directive = tag_directives_start; tag_directive != tag_directives_end; tag_directive++) {
+		YAML_FREE(tag_directive->handle);
+		YAML_FREE(tag_directive->prefix);
+	}
+	YAML_FREE(tag_directives_start);
+	return error;
+}
+
+static int yaml_parser_parse_node_(yaml_parser_t *parser, yaml_event_t *event, int block, int indentless_sequence);
+
+static int yaml_parser_parse_document_content_(yaml_parser_t *parser, yaml_event_t *event) {
+	yaml_token_t *token;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type == YAML_TOKEN_VERSION_DIRECTIVE || token->type == YAML_TOKEN_TAG_DIRECTIVE
+			|| token->type == YAML_TOKEN_DOCUMENT_START || token->type == YAML_TOKEN_DOCUMENT_END
+			|| token->type == YAML_TOKEN_STREAM_END) {
+		parser->state = YAML_STACK_POP(&parser->states);
+		return yaml_parser_process_empty_scalar_(parser, event, token->start_mark);
+	}
+
+	return yaml_parser_parse_node_(parser, event, 1, 0);
+}
+
+static int yaml_parser_parse_document_end_(yaml_parser_t *parser, yaml_event_t *event) {
+	yaml_mark_t start_mark, end_mark;
+	yaml_token_t *token;
+	int implicit = 1;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	start_mark = end_mark = token->start_mark;
+	if (token->type == YAML_TOKEN_DOCUMENT_END) {
+		end_mark = token->end_mark;
+		YAML_PARSER_SKIP_TOKEN(parser);
+		implicit = 0;
+	}
+
+	/* The tag handles stay in effect for the next document. */
+	parser->state = YAML_PST_DOCUMENT_START;
+	YAML_EVENT_DOCUMENT_END_INIT(event, implicit, start_mark, end_mark);
+
+	return YAML_EOK;
+}
+
+/* Resolve the handle of a tag against the directives in effect.
+ */
+static int yaml_parser_resolve_tag_(yaml_parser_t *parser, yaml_char_t *handle, yaml_char_t *suffix,
+		yaml_mark_t start_mark, yaml_mark_t tag_mark, yaml_char_t **tag) {
+	yaml_tag_directive_t *tag_directive;
+	size_t prefix_length, suffix_length;
+
+	/* A verbatim tag. */
+	if (!*handle) {
+		*tag = suffix;
+		YAML_FREE(handle);
+		return YAML_EOK;
+	}
+
+	for (tag_directive = parser->tag_directives.start; tag_directive != parser->tag_directives.top; tag_directive++) {
+		if (!strcmp((char *)tag_directive->handle, (char *)handle)) {
+			prefix_length = strlen((char *)tag_directive->prefix);
+			suffix_length = strlen((char *)suffix);
+
+			*tag = (yaml_char_t *)YAML_MALLOC(prefix_length + suffix_length + 1);
+			if (!*tag) {
+				parser->error = YAML_EMEMORY;
+				break;
+			}
+			memcpy(*tag, tag_directive->prefix, prefix_length);
+			memcpy(*tag + prefix_length, suffix, suffix_length + 1);
+
+			YAML_FREE(handle);
+			YAML_FREE(suffix);
+			return YAML_EOK;
+		}
+	}
+
+	YAML_FREE(handle);
+	YAML_FREE(suffix);
+	if (parser->error)
+		return parser->error;
+	return yaml_parser_set_parser_error_context_(parser, "while parsing a node", start_mark,
+		"found undefined tag handle", tag_mark);
+}
+
+static int yaml_parser_parse_node_(yaml_parser_t *parser, yaml_event_t *event, int block, int indentless_sequence) {
+	yaml_char_t *anchor = NULL;
+	yaml_char_t *tag_handle = NULL;
+	yaml_char_t *tag_suffix = NULL;
+	yaml_char_t *tag = NULL;
+	yaml_mark_t start_mark, end_mark, tag_mark;
+	yaml_token_t *token;
+	int implicit;
+	int error;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type == YAML_TOKEN_ALIAS) {
+		parser->state = YAML_STACK_POP(&parser->states);
+		YAML_EVENT_ALIAS_INIT(event, token->data.alias.value, token->start_mark, token->end_mark);
+		YAML_PARSER_SKIP_TOKEN(parser);
+		return YAML_EOK;
+	}
+
+	start_mark = end_mark = tag_mark = token->start_mark;
+
+	/* The properties, in either order. */
+	if (token->type == YAML_TOKEN_ANCHOR) {
+		anchor = token->data.anchor.value;
+		start_mark = token->start_mark;
+		end_mark = token->end_mark;
+		YAML_PARSER_SKIP_TOKEN(parser);
+
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			goto PEEK_ERROR;
+		if (token->type == YAML_TOKEN_TAG) {
+			tag_handle = token->data.tag.handle;
+			tag_suffix = token->data.tag.suffix;
+			tag_mark = token->start_mark;
+			end_mark = token->end_mark;
+			YAML_PARSER_SKIP_TOKEN(parser);
+
+			token = YAML_PARSER_PEEK_TOKEN(parser);
+			if (!token)
+				goto PEEK_ERROR;
+		}
+	}
+	else if (token->type == YAML_TOKEN_TAG) {
+		tag_handle = token->data.tag.handle;
+		tag_suffix = token->data.tag.suffix;
+		start_mark = tag_mark = token->start_mark;
+		end_mark = token->end_mark;
+		YAML_PARSER_SKIP_TOKEN(parser);
+
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			goto PEEK_ERROR;
+		if (token->type == YAML_TOKEN_ANCHOR) {
+			anchor = token->data.anchor.value;
+			end_mark = token->end_mark;
+			YAML_PARSER_SKIP_TOKEN(parser);
+
+			token = YAML_PARSER_PEEK_TOKEN(parser);
+			if (!token)
+				goto PEEK_ERROR;
+		}
+	}
+
+	if (tag_handle) {
+		error = yaml_parser_resolve_tag_(parser, tag_handle, tag_suffix, start_mark, tag_mark, &tag);
+		tag_handle = tag_suffix = NULL;
+		if (error)
+			goto ERROR;
+	}
+
+	implicit = !tag || !*tag;
+
+	if (indentless_sequence && token->type == YAML_TOKEN_BLOCK_ENTRY) {
+		end_mark = token->end_mark;
+		parser->state = YAML_PARSE_INDENTLESS_SEQUENCE_ENTRY;
+		YAML_EVENT_SEQUENCE_START_INIT(event, anchor, tag, implicit, YAML_SEQUENCE_BLOCK, start_mark, end_mark);
+		return YAML_EOK;
+	}
+
+	if (token->type == YAML_TOKEN_SCALAR) {
+		int plain_implicit = 0;
+		int quoted_implicit = 0;
+
+		end_mark = token->end_mark;
+		if ((token->data.scalar.style == YAML_SCALAR_PLAIN && !tag) || (tag && !strcmp((char *)tag, "!"))) {
+			plain_implicit = 1;
+		}
+		else if (!tag)
+			quoted_implicit = 1;
+
+		parser->state = YAML_STACK_POP(&parser->states);
+		YAML_EVENT_SCALAR_INIT(event, anchor, tag, token->data.scalar.value, token->data.scalar.length,
+			plain_implicit, quoted_implicit, token->data.scalar.style, start_mark, end_mark);
+		YAML_PARSER_SKIP_TOKEN(parser);
+		return YAML_EOK;
+	}
+
+	if (token->type == YAML_TOKEN_FLOW_SEQUENCE_START) {
+		end_mark = token->end_mark;
+		parser->state = YAML_PARSE_FLOW_SEQUENCE_FIRST_ENTRY;
+		YAML_EVENT_SEQUENCE_START_INIT(event, anchor, tag, implicit, YAML_SEQUENCE_FLOW, start_mark, end_mark);
+		return YAML_EOK;
+	}
+
+	if (token->type == YAML_TOKEN_FLOW_MAPPING_START) {
+		end_mark = token->end_mark;
+		parser->state = YAML_PARSE_FLOW_MAPPING_FIRST_KEY;
+		YAML_EVENT_MAPPING_START_INIT(event, anchor, tag, implicit, YAML_MAPPING_FLOW, start_mark, end_mark);
+		return YAML_EOK;
+	}
+
+	if (block && token->type == YAML_TOKEN_BLOCK_SEQUENCE_START) {
+		end_mark = token->end_mark;
+		parser->state = YAML_PARSE_BLOCK_SEQUENCE_FIRST_ENTRY;
+		YAML_EVENT_SEQUENCE_START_INIT(event, anchor, tag, implicit, YAML_SEQUENCE_BLOCK, start_mark, end_mark);
+		return YAML_EOK;
+	}
+
+	if (block && token->type == YAML_TOKEN_BLOCK_MAPPING_START) {
+		end_mark = token->end_mark;
+		parser->state = YAML_PARSE_BLOCK_MAPPING_FIRST_KEY;
+		YAML_EVENT_MAPPING_START_INIT(event, anchor, tag, implicit, YAML_MAPPING_BLOCK, start_mark, end_mark);
+		return YAML_EOK;
+	}
+
+	/* Properties alone make an empty scalar. */
+	if (anchor || tag) {
+		yaml_char_t *value = (yaml_char_t *)YAML_MALLOC(1);
+
+		if (!value) {
+			error = parser->error = YAML_EMEMORY;
+			goto ERROR;
+		}
+		value[0] = '\0';
+
+		parser->state = YAML_STACK_POP(&parser->states);
+		YAML_EVENT_SCALAR_INIT(event, anchor, tag, value, 0, implicit, 0, YAML_SCALAR_PLAIN, start_mark, end_mark);
+		return YAML_EOK;
+	}
+
+	error = yaml_parser_set_parser_error_context_(parser,
+		block ? "while parsing a block node" : "while parsing a flow node", start_mark,
+		"did not find expected node content", token->start_mark);
+	goto ERROR;
+
+PEEK_ERROR:
+	error = parser->error;
+ERROR:
+	YAML_FREE(anchor);
+	YAML_FREE(tag_handle);
+	YAML_FREE(tag_suffix);
+	YAML_FREE(tag);
+	return error;
+}
+
+static int yaml_parser_parse_block_sequence_entry_(yaml_parser_t *parser, yaml_event_t *event, int first) {
+	yaml_token_t *token;
+	yaml_mark_t mark;
+	int error;
+
+	if (first) {
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+		error = yaml_parser_push_mark_(parser, token->start_mark);
+		if (error)
+			return error;
+		YAML_PARSER_SKIP_TOKEN(parser);
+	}
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type == YAML_TOKEN_BLOCK_ENTRY) {
+		mark = token->end_mark;
+		YAML_PARSER_SKIP_TOKEN(parser);
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+
+		if (token->type != YAML_TOKEN_BLOCK_ENTRY && token->type != YAML_TOKEN_BLOCK_END) {
+			error = yaml_parser_push_state_(parser, YAML_PARSE_BLOCK_SEQUENCE_ENTRY);
+			if (error)
+				return error;
+			return yaml_parser_parse_node_(parser, event, 1, 0);
+		}
+
+		parser->state = YAML_PARSE_BLOCK_SEQUENCE_ENTRY;
+		return yaml_parser_process_empty_scalar_(parser, event, mark);
+	}
+
+	if (token->type == YAML_TOKEN_BLOCK_END) {
+		parser->state = YAML_STACK_POP(&parser->states);
+		(void)YAML_STACK_POP(&parser->marks);
+		YAML_EVENT_SEQUENCE_END_INIT(event, token->start_mark, token->end_mark);
+		YAML_PARSER_SKIP_TOKEN(parser);
+		return YAML_EOK;
+	}
+
+	return yaml_parser_set_parser_error_context_(parser, "while parsing a block collection",
+		YAML_STACK_POP(&parser->marks), "did not find expected '-' indicator", token->start_mark);
+}
+
+static int yaml_parser_parse_indentless_sequence_entry_(yaml_parser_t *parser, yaml_event_t *event) {
+	yaml_token_t *token;
+	yaml_mark_t mark;
+	int error;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type == YAML_TOKEN_BLOCK_ENTRY) {
+		mark = token->end_mark;
+		YAML_PARSER_SKIP_TOKEN(parser);
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+
+		if (token->type != YAML_TOKEN_BLOCK_ENTRY && token->type != YAML_TOKEN_KEY
+				&& token->type != YAML_TOKEN_VALUE && token->type != YAML_TOKEN_BLOCK_END) {
+			error = yaml_parser_push_state_(parser, YAML_PARSE_INDENTLESS_SEQUENCE_ENTRY);
+			if (error)
+				return error;
+			return yaml_parser_parse_node_(parser, event, 1, 0);
+		}
+
+		parser->state = YAML_PARSE_INDENTLESS_SEQUENCE_ENTRY;
+		return yaml_parser_process_empty_scalar_(parser, event, mark);
+	}
+
+	parser->state = YAML_STACK_POP(&parser->states);
+	YAML_EVENT_SEQUENCE_END_INIT(event, token->start_mark, token->start_mark);
+	return YAML_EOK;
+}
+
+static int yaml_parser_parse_block_mapping_key_(yaml_parser_t *parser, yaml_event_t *event, int first) {
+	yaml_token_t *token;
+	yaml_mark_t mark;
+	int error;
+
+	if (first) {
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+		error = yaml_parser_push_mark_(parser, token->start_mark);
+		if (error)
+			return error;
+		YAML_PARSER_SKIP_TOKEN(parser);
+	}
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type == YAML_TOKEN_KEY) {
+		mark = token->end_mark;
+		YAML_PARSER_SKIP_TOKEN(parser);
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+
+		if (token->type != YAML_TOKEN_KEY && token->type != YAML_TOKEN_VALUE
+				&& token->type != YAML_TOKEN_BLOCK_END) {
+			error = yaml_parser_push_state_(parser, YAML_PARSE_BLOCK_MAPPING_VALUE);
+			if (error)
+				return error;
+			return yaml_parser_parse_node_(parser, event, 1, 1);
+		}
+
+		parser->state = YAML_PARSE_BLOCK_MAPPING_VALUE;
+		return yaml_parser_process_empty_scalar_(parser, event, mark);
+	}
+
+	if (token->type == YAML_TOKEN_BLOCK_END) {
+		parser->state = YAML_STACK_POP(&parser->states);
+		(void)YAML_STACK_POP(&parser->marks);
+		YAML_EVENT_MAPPING_END_INIT(event, token->start_mark, token->end_mark);
+		YAML_PARSER_SKIP_TOKEN(parser);
+		return YAML_EOK;
+	}
+
+	return yaml_parser_set_parser_error_context_(parser, "while parsing a block mapping",
+		YAML_STACK_POP(&parser->marks), "did not find expected key", token->start_mark);
+}
+
+static int yaml_parser_parse_block_mapping_value_(yaml_parser_t *parser, yaml_event_t *event) {
+	yaml_token_t *token;
+	yaml_mark_t mark;
+	int error;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type == YAML_TOKEN_VALUE) {
+		mark = token->end_mark;
+		YAML_PARSER_SKIP_TOKEN(parser);
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+
+		if (token->type != YAML_TOKEN_KEY && token->type != YAML_TOKEN_VALUE
+				&& token->type != YAML_TOKEN_BLOCK_END) {
+			error = yaml_parser_push_state_(parser, YAML_PARSE_BLOCK_MAPPING_KEY);
+			if (error)
+				return error;
+			return yaml_parser_parse_node_(parser, event, 1, 1);
+		}
+
+		parser->state = YAML_PARSE_BLOCK_MAPPING_KEY;
+		return yaml_parser_process_empty_scalar_(parser, event, mark);
+	}
+
+	parser->state = YAML_PARSE_BLOCK_MAPPING_KEY;
+	return yaml_parser_process_empty_scalar_(parser, event, token->start_mark);
+}
+
+static int yaml_parser_parse_flow_sequence_entry_(yaml_parser_t *parser, yaml_event_t *event, int first) {
+	yaml_token_t *token;
+	int error;
+
+	if (first) {
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+		error = yaml_parser_push_mark_(parser, token->start_mark);
+		if (error)
+			return error;
+		YAML_PARSER_SKIP_TOKEN(parser);
+	}
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type != YAML_TOKEN_FLOW_SEQUENCE_END) {
+		if (!first) {
+			if (token->type != YAML_TOKEN_FLOW_ENTRY)
+				return yaml_parser_set_parser_error_context_(parser, "while parsing a flow sequence",
+					YAML_STACK_POP(&parser->marks), "did not find expected ',' or ']'", token->start_mark);
+
+			YAML_PARSER_SKIP_TOKEN(parser);
+			token = YAML_PARSER_PEEK_TOKEN(parser);
+			if (!token)
+				return parser->error;
+		}
+
+		/* A single pair mapping, [ key: value ]. */
+		if (token->type == YAML_TOKEN_KEY) {
+			parser->state = YAML_PARSE_FLOW_SEQUENCE_ENTRY_MAPPING_KEY;
+			YAML_EVENT_MAPPING_START_INIT(event, NULL, NULL, 1, YAML_MAPPING_FLOW,
+				token->start_mark, token->end_mark);
+			YAML_PARSER_SKIP_TOKEN(parser);
+			return YAML_EOK;
+		}
+
+		if (token->type != YAML_TOKEN_FLOW_SEQUENCE_END) {
+			error = yaml_parser_push_state_(parser, YAML_PARSE_FLOW_SEQUENCE_ENTRY);
+			if (error)
+				return error;
+			return yaml_parser_parse_node_(parser, event, 0, 0);
+		}
+	}
+
+	parser->state = YAML_STACK_POP(&parser->states);
+	(void)YAML_STACK_POP(&parser->marks);
+	YAML_EVENT_SEQUENCE_END_INIT(event, token->start_mark, token->end_mark);
+	YAML_PARSER_SKIP_TOKEN(parser);
+	return YAML_EOK;
+}
+
+static int yaml_parser_parse_flow_sequence_entry_mapping_key_(yaml_parser_t *parser, yaml_event_t *event) {
+	yaml_token_t *token;
+	int error;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type != YAML_TOKEN_VALUE && token->type != YAML_TOKEN_FLOW_ENTRY
+			&& token->type != YAML_TOKEN_FLOW_SEQUENCE_END) {
+		error = yaml_parser_push_state_(parser, YAML_PARSE_FLOW_SEQUENCE_ENTRY_MAPPING_VALUE);
+		if (error)
+			return error;
+		return yaml_parser_parse_node_(parser, event, 0, 0);
+	}
+
+	parser->state = YAML_PARSE_FLOW_SEQUENCE_ENTRY_MAPPING_VALUE;
+	return yaml_parser_process_empty_scalar_(parser, event, token->start_mark);
+}
+
+static int yaml_parser_parse_flow_sequence_entry_mapping_value_(yaml_parser_t *parser, yaml_event_t *event) {
+	yaml_token_t *token;
+	int error;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type == YAML_TOKEN_VALUE) {
+		YAML_PARSER_SKIP_TOKEN(parser);
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+
+		if (token->type != YAML_TOKEN_FLOW_ENTRY && token->type != YAML_TOKEN_FLOW_SEQUENCE_END) {
+			error = yaml_parser_push_state_(parser, YAML_PARSE_FLOW_SEQUENCE_ENTRY_MAPPING_END);
+			if (error)
+				return error;
+			return yaml_parser_parse_node_(parser, event, 0, 0);
+		}
+	}
+
+	parser->state = YAML_PARSE_FLOW_SEQUENCE_ENTRY_MAPPING_END;
+	return yaml_parser_process_empty_scalar_(parser, event, token->start_mark);
+}
+
+static int yaml_parser_parse_flow_sequence_entry_mapping_end_(yaml_parser_t *parser, yaml_event_t *event) {
+	yaml_token_t *token;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	parser->state = YAML_PARSE_FLOW_SEQUENCE_ENTRY;
+	YAML_EVENT_MAPPING_END_INIT(event, token->start_mark, token->start_mark);
+	return YAML_EOK;
+}
+
+static int yaml_parser_parse_flow_mapping_key_(yaml_parser_t *parser, yaml_event_t *event, int first) {
+	yaml_token_t *token;
+	int error;
+
+	if (first) {
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+		error = yaml_parser_push_mark_(parser, token->start_mark);
+		if (error)
+			return error;
+		YAML_PARSER_SKIP_TOKEN(parser);
+	}
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (token->type != YAML_TOKEN_FLOW_MAPPING_END) {
+		if (!first) {
+			if (token->type != YAML_TOKEN_FLOW_ENTRY)
+				return yaml_parser_set_parser_error_context_(parser, "while parsing a flow mapping",
+					YAML_STACK_POP(&parser->marks), "did not find expected ',' or '}'", token->start_mark);
+
+			YAML_PARSER_SKIP_TOKEN(parser);
+			token = YAML_PARSER_PEEK_TOKEN(parser);
+			if (!token)
+				return parser->error;
+		}
+
+		if (token->type == YAML_TOKEN_KEY) {
+			YAML_PARSER_SKIP_TOKEN(parser);
+			token = YAML_PARSER_PEEK_TOKEN(parser);
+			if (!token)
+				return parser->error;
+
+			if (token->type != YAML_TOKEN_VALUE && token->type != YAML_TOKEN_FLOW_ENTRY
+					&& token->type != YAML_TOKEN_FLOW_MAPPING_END) {
+				error = yaml_parser_push_state_(parser, YAML_PARSE_FLOW_MAPPING_VALUE);
+				if (error)
+					return error;
+				return yaml_parser_parse_node_(parser, event, 0, 0);
+			}
+
+			parser->state = YAML_PARSE_FLOW_MAPPING_VALUE;
+			return yaml_parser_process_empty_scalar_(parser, event, token->start_mark);
+		}
+
+		if (token->type != YAML_TOKEN_FLOW_MAPPING_END) {
+			error = yaml_parser_push_state_(parser, YAML_PARSE_FLOW_MAPPING_EMPTY_VALUE);
+			if (error)
+				return error;
+			return yaml_parser_parse_node_(parser, event, 0, 0);
+		}
+	}
+
+	parser->state = YAML_STACK_POP(&parser->states);
+	(void)YAML_STACK_POP(&parser->marks);
+	YAML_EVENT_MAPPING_END_INIT(event, token->start_mark, token->end_mark);
+	YAML_PARSER_SKIP_TOKEN(parser);
+	return YAML_EOK;
+}
+
+static int yaml_parser_parse_flow_mapping_value_(yaml_parser_t *parser, yaml_event_t *event, int empty) {
+	yaml_token_t *token;
+	int error;
+
+	token = YAML_PARSER_PEEK_TOKEN(parser);
+	if (!token)
+		return parser->error;
+
+	if (empty) {
+		parser->state = YAML_PARSE_FLOW_MAPPING_KEY;
+		return yaml_parser_process_empty_scalar_(parser, event, token->start_mark);
+	}
+
+	if (token->type == YAML_TOKEN_VALUE) {
+		YAML_PARSER_SKIP_TOKEN(parser);
+		token = YAML_PARSER_PEEK_TOKEN(parser);
+		if (!token)
+			return parser->error;
+
+		if (token->type != YAML_TOKEN_FLOW_ENTRY && token->type != YAML_TOKEN_FLOW_MAPPING_END) {
+			error = yaml_parser_push_state_(parser, YAML_PARSE_FLOW_MAPPING_KEY);
+			if (error)
+				return error;
+			return yaml_parser_parse_node_(parser, event, 0, 0);
+		}
+	}
+
+	parser->state = YAML_PARSE_FLOW_MAPPING_KEY;
+	return yaml_parser_process_empty_scalar_(parser, event, token->start_mark);
+}
+
+static int yaml_parser_state_machine_(yaml_parser_t *parser, yaml_event_t *event) {
+	switch (parser->state) {
+	case YAML_PST_STREAM_START:
+		return yaml_parser_parse_stream_start_(parser, event);
+	case YAML_PST_IMPLICIT_DOCUMENT_START:
+		return yaml_parser_parse_document_start_(parser, event, 1);
+	case YAML_PST_DOCUMENT_START:
+		return yaml_parser_parse_document_start_(parser, event, 0);
+	case YAML_PARSE_DOCUMENT_CONTENT:
+		return yaml_parser_parse_document_content_(parser, event);
+	case YAML_PARSE_DOCUMENT_END:
+		return yaml_parser_parse_document_end_(parser, event);
+	case YAML_PARSE_BLOCK_NODE:
+		return yaml_parser_parse_node_(parser, event, 1, 0);
+	case YAML_PARSE_BLOCK_NODE_OR_INDENTLESS_SEQUENCE:
+		return yaml_parser_parse_node_(parser, event, 1, 1);
+	case YAML_PARSE_FLOW_NODE:
+		return yaml_parser_parse_node_(parser, event, 0, 0);
+	case YAML_PARSE_BLOCK_SEQUENCE_FIRST_ENTRY:
+		return yaml_parser_parse_block_sequence_entry_(parser, event, 1);
+	case YAML_PARSE_BLOCK_SEQUENCE_ENTRY:
+		return yaml_parser_parse_block_sequence_entry_(parser, event, 0);
+	case YAML_PARSE_INDENTLESS_SEQUENCE_ENTRY:
+		return yaml_parser_parse_indentless_sequence_entry_(parser, event);
+	case YAML_PARSE_BLOCK_MAPPING_FIRST_KEY:
+		return yaml_parser_parse_block_mapping_key_(parser, event, 1);
+	case YAML_PARSE_BLOCK_MAPPING_KEY:
+		return yaml_parser_parse_block_mapping_key_(parser, event, 0);
+	case YAML_PARSE_BLOCK_MAPPING_VALUE:
+		return yaml_parser_parse_block_mapping_value_(parser, event);
+	case YAML_PARSE_FLOW_SEQUENCE_FIRST_ENTRY:
+		return yaml_parser_parse_flow_sequence_entry_(parser, event, 1);
+	case YAML_PARSE_FLOW_SEQUENCE_ENTRY:
+		return yaml_parser_parse_flow_sequence_entry_(parser, event, 0);
+	case YAML_PARSE_FLOW_SEQUENCE_ENTRY_MAPPING_KEY:
+		return yaml_parser_parse_flow_sequence_entry_mapping_key_(parser, event);
+	case YAML_PARSE_FLOW_SEQUENCE_ENTRY_MAPPING_VALUE:
+		return yaml_parser_parse_flow_sequence_entry_mapping_value_(parser, event);
+	case YAML_PARSE_FLOW_SEQUENCE_ENTRY_MAPPING_END:
+		return yaml_parser_parse_flow_sequence_entry_mapping_end_(parser, event);
+	case YAML_PARSE_FLOW_MAPPING_FIRST_KEY:
+		return yaml_parser_parse_flow_mapping_key_(parser, event, 1);
+	case YAML_PARSE_FLOW_MAPPING_KEY:
+		return yaml_parser_parse_flow_mapping_key_(parser, event, 0);
+	case YAML_PARSE_FLOW_MAPPING_VALUE:
+		return yaml_parser_parse_flow_mapping_value_(parser, event, 0);
+	case YAML_PARSE_FLOW_MAPPING_EMPTY_VALUE:
+		return yaml_parser_parse_flow_mapping_value_(parser, event, 1);
+	default:
+		assert(0); /* Invalid state. */
+		return YAML_EFAILD;
+	}
+}
+
+int yaml_parser_parse(yaml_parser_t *parser, yaml_event_t *event) {
+	int error;
+
+	assert(parser); /* Non-NULL parser object is expected. */
+	assert(event); /* Non-NULL event object is expected. */
+
+	/* Erase the event object. */
+	memset(event, 0, sizeof(yaml_event_t));
+
+	/* No events after the end of the stream or an error. */
+	if (parser->error)
+		return parser->error;
+	if (parser->stream_end_produced || parser->state == YAML_PARSE_END)
+		return YAML_EOK;
+
+	{
+		YAML_STATS_BEGIN(parser, mark);
+		error = yaml_parser_state_machine_(parser, event);
+		YAML_STATS_END(parser, YAML_STATS_PARSER, mark);
+	}
+	return error;
 }
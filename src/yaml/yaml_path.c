@@ -0,0 +1,335 @@
+#include "yaml_private.h"
+
+/* Parse the expression into steps.
+ * With NULL steps only count the steps and the key bytes.
+ */
+static int yaml_path_parse_(const char *expression, yaml_path_step_t *steps,
+		yaml_char_t *keys, size_t *step_count, size_t *key_size) {
+	const char *pointer = expression;
+	size_t count = 0;
+	size_t size = 0;
+
+	while (*pointer) {
+		yaml_path_step_t step;
+
+		memset(&step, 0, sizeof(yaml_path_step_t));
+
+		if (*pointer == '[') {
+			pointer++;
+			if (*pointer == '*') {
+				step.type = YAML_PATH_ANY;
+				pointer++;
+			}
+			else if (*pointer >= '0' && *pointer <= '9') {
+				step.type = YAML_PATH_INDEX;
+				for (; *pointer >= '0' && *pointer <= '9'; pointer++) {
+					if (step.index > (0x7FFFFFFF - (*pointer - '0')) / 10)
+						return YAML_EFAILD;
+					step.index = step.index * 10 + (*pointer - '0');
+				}
+			}
+			else
+				return YAML_EFAILD;
+
+			if (*pointer++ != ']')
+				return YAML_EFAILD;
+		}
+		else {
+			const char *name;
+
+			if (count && *pointer++ != '.')
+				return YAML_EFAILD;
+
+			for (name = pointer; *pointer && *pointer != '.' && *pointer != '['; pointer++)
+				;
+			if (pointer == name)
+				return YAML_EFAILD;
+
+			if (pointer - name == 1 && *name == '*')
+				step.type = YAML_PATH_ANY;
+			else {
+				step.type = YAML_PATH_KEY;
+				step.length = pointer - name;
+				if (keys) {
+					step.key = keys + size;
+					memcpy(step.key, name, step.length);
+					step.key[step.length] = '\0';
+				}
+				size += step.length + 1;
+			}
+		}
+
+		if (steps)
+			steps[count] = step;
+		count++;
+	}
+
+	*step_count = count;
+	*key_size = size;
+	return YAML_EOK;
+}
+
+int yaml_path_compile(yaml_path_t *path, const char *expression) {
+	size_t count;
+	size_t size;
+	int error;
+
+	assert(path); /* Non-NULL path object is expected. */
+	assert(expression); /* Non-NULL expression is expected. */
+	memset(path, 0, sizeof(yaml_path_t));
+
+	error = yaml_path_parse_(expression, NULL, NULL, &count, &size);
+	if (error)
+		return error;
+
+	path->steps.start = (yaml_path_step_t *)YAML_MALLOC((count ? count : 1) * sizeof(yaml_path_step_t));
+	path->keys = (yaml_char_t *)YAML_MALLOC(size ? size : 1);
+	if (!path->steps.start || !path->keys) {
+		yaml_path_destroy(path);
+		return YAML_EMEMORY;
+	}
+
+	yaml_path_parse_(expression, path->steps.start, path->keys, &count, &size);
+	path->steps.end = path->steps.start + count;
+
+	return YAML_EOK;
+}
+
+void yaml_path_destroy(yaml_path_t *path) {
+	assert(path); /* Non-NULL path object is expected. */
+
+	YAML_FREE(path->steps.start);
+	YAML_FREE(path->keys);
+	memset(path, 0, sizeof(yaml_path_t));
+}
+
+/* Check a key node against a KEY step, key_id being the ID of the step key
+ * in the document, 0 if no interned string equals it.
+ */
+static int yaml_path_key_match_(const yaml_path_step_t *step, int key_id, const yaml_node_t *key) {
+	if (key->type != YAML_NSTYLE_SCALAR)
+		return 0;
+
+	/* Interned keys are compared by ID only. */
+	if (key->data.scalar.value_id)
+		return key->data.scalar.value_id == key_id;
+
+	return key->data.scalar.length == step->length
+		&& !memcmp(key->data.scalar.value, step->key, step->length);
+}
+
+static int yaml_path_eval_(yaml_document_t *document, const yaml_path_t *path,
+		const yaml_path_step_t *step, int index,
+		yaml_path_handler_t *handler, void *data) {
+	yaml_node_t *node;
+	yaml_node_item_t *item;
+	yaml_node_pair_t *pair;
+	int key_id = 0;
+	int error;
+
+	if (step == path->steps.end)
+		return handler(data, document, index);
+
+	node = document->nodes.start + index - 1;
+
+	switch (node->type) {
+	case YAML_NSTYLE_SEQUENCE:
+		if (step->type == YAML_PATH_INDEX) {
+			if (step->index < node->data.sequence.items.top - node->data.sequence.items.start)
+				return yaml_path_eval_(document, path, step + 1,
+					node->data.sequence.items.start[step->index], handler, data);
+		}
+		else if (step->type == YAML_PATH_ANY) {
+			for (item = node->data.sequence.items.start; item != node->data.sequence.items.top; item++) {
+				error = yaml_path_eval_(document, path, step + 1, *item, handler, data);
+				if (error)
+					return error;
+			}
+		}
+		break;
+	case YAML_NSTYLE_MAPPING:
+		if (step->type == YAML_PATH_INDEX)
+			break;
+
+		/* Look the key up once per mapping, so matching compares IDs. */
+		if (step->type == YAML_PATH_KEY)
+			key_id = yaml_document_find_string(document, step->key, step->length);
+		for (pair = node->data.mapping.pairs.start; pair != node->data.mapping.pairs.top; pair++) {
+			if (step->type == YAML_PATH_KEY
+					&& !yaml_path_key_match_(step, key_id, document->nodes.start + pair->key - 1))
+				continue;
+			error = yaml_path_eval_(document, path, step + 1, pair->value, handler, data);
+			if (error)
+				return error;
+		}
+		break;
+	default:
+		break;
+	}
+
+	return YAML_EOK;
+}
+
+int yaml_path_eval(yaml_document_t *document, const yaml_path_t *path,
+		yaml_path_handler_t *handler, void *data) {
+	assert(document); /* Non-NULL document object is expected. */
+	assert(path && path->steps.start); /* Compiled path is expected. */
+	assert(handler); /* Non-NULL handler is expected. */
+
+	if (document->nodes.top == document->nodes.start)
+		return YAML_EOK;
+
+	return yaml_path_eval_(document, path, path->steps.start, 1, handler, data);
+}
+
+int yaml_path_stream_init(yaml_path_stream_t *stream, const yaml_path_t *path) {
+	size_t count;
+
+	assert(stream); /* Non-NULL stream object is expected. */
+	assert(path && path->steps.start); /* Compiled path is expected. */
+	memset(stream, 0, sizeof(yaml_path_stream_t));
+
+	/* Every matched collection but the last step needs a frame. */
+	count = path->steps.end - path->steps.start;
+	stream->frames.start = (yaml_path_frame_t *)YAML_MALLOC((count ? count : 1) * sizeof(yaml_path_frame_t));
+	if (!stream->frames.start)
+		return YAML_EMEMORY;
+	stream->frames.top = stream->frames.start;
+	stream->frames.end = stream->frames.start + (count ? count : 1);
+	stream->path = path;
+
+	return YAML_EOK;
+}
+
+void yaml_path_stream_destroy(yaml_path_stream_t *stream) {
+	assert(stream); /* Non-NULL stream object is expected. */
+
+	YAML_FREE(stream->frames.start);
+	memset(stream, 0, sizeof(yaml_path_stream_t));
+}
+
+int yaml_path_feed(yaml_path_stream_t *stream, yaml_event_t *event,
+		yaml_path_event_handler_t *handler, void *data) {
+	const yaml_path_t *path;
+	const yaml_path_step_t *step;
+	yaml_path_frame_t *parent;
+	int collection;
+	int matched;
+	size_t depth;
+
+	assert(stream && stream->frames.start); /* Initialized stream is expected. */
+	assert(event); /* Non-NULL event object is expected. */
+	assert(handler); /* Non-NULL handler is expected. */
+
+	path = stream->path;
+	switch (event->type) {
+	case YAML_EVENT_STREAM_START:
+	case YAML_EVENT_STREAM_END:
+	case YAML_EVENT_DOCUMENT_START:
+	case YAML_EVENT_DOCUMENT_END:
+		stream->frames.top = stream->frames.start;
+		stream->skip = 0;
+		return YAML_EOK;
+	case YAML_EVENT_SEQUENCE_END:
+	case YAML_EVENT_MAPPING_END:
+		if (stream->skip)
+			stream->skip--;
+		else if (stream->frames.top != stream->frames.start)
+			stream->frames.top--;
+		return YAML_EOK;
+	case YAML_EVENT_SEQUENCE_START:
+	case YAML_EVENT_MAPPING_START:
+		collection = 1;
+		break;
+	case YAML_EVENT_SCALAR:
+	case YAML_EVENT_ALIAS:
+		collection = 0;
+		break;
+	default:
+		return YAML_EOK;
+	}
+
+	/* Inside a subtree the path does not reach. */
+	if (stream->skip) {
+		stream->skip += collection;
+		return YAML_EOK;
+	}
+
+	depth = stream->frames.top - stream->frames.start;
+	if (!depth)
+		matched = 1;
+	else {
+		parent = stream->frames.top - 1;
+		step = path->steps.start + depth - 1;
+
+		if (parent->type == YAML_EVENT_MAPPING_START && parent->expect_key) {
+			/* Remember if the key selects the value, complex keys never do. */
+			parent->expect_key = 0;
+			parent->key_matched = step->type == YAML_PATH_ANY
+				|| (event->type == YAML_EVENT_SCALAR && step->type == YAML_PATH_KEY
+					&& event->data.scalar.length == step->length
+					&& !memcmp(event->data.scalar.value, step->key, step->length));
+			stream->skip = collection;
+			return YAML_EOK;
+		}
+
+		if (parent->type == YAML_EVENT_MAPPING_START) {
+			matched = parent->key_matched;
+			parent->expect_key = 1;
+		}
+		else {
+			matched = step->type == YAML_PATH_ANY
+				|| (step->type == YAML_PATH_INDEX && step->index == parent->index);
+			parent->index++;
+		}
+	}
+
+	if (!matched) {
+		stream->skip = collection;
+		return YAML_EOK;
+	}
+
+	if (path->steps.start + depth == path->steps.end) {
+		stream->skip = collection;
+		return handler(data, event);
+	}
+
+	if (collection) {
+		assert(stream->frames.top != stream->frames.end);
+		stream->frames.top->type = event->type;
+		stream->frames.top->index = 0;
+		stream->frames.top->expect_key = event->type == YAML_EVENT_MAPPING_START;
+		stream->frames.top->key_matched = 0;
+		stream->frames.top++;
+	}
+
+	return YAML_EOK;
+}
+
+int yaml_path_eval_parser(yaml_parser_t *parser, const yaml_path_t *path,
+		yaml_path_event_handler_t *handler, void *data) {
+	yaml_path_stream_t stream;
+	yaml_event_t event;
+	int error;
+	int done;
+
+	assert(parser); /* Non-NULL parser object is expected. */
+	assert(path && path->steps.start); /* Compiled path is expected. */
+
+	error = yaml_path_stream_init(&stream, path);
+	if (error)
+		return error;
+
+	do {
+		error = yaml_parser_parse(parser, &event);
+		if (error)
+			break;
+
+		done = event.type == YAML_EVENT_STREAM_END;
+		error = yaml_path_feed(&stream, &event, handler, data);
+		yaml_event_destroy(&event);
+	} while (!error && !done);
+
+	yaml_path_stream_destroy(&stream);
+	return error;
+}
@@ -0,0 +1,45 @@
+#include <stdlib.h>
+#include "yaml_private.h"
+
+/* The parsers released by the thread, ready for the next input.
+ */
+static YAML_THREAD_LOCAL yaml_parser_t *yaml_parser_pool_[YAML_PARSER_POOL_SIZE];
+static YAML_THREAD_LOCAL size_t yaml_parser_pool_count_;
+
+yaml_parser_t *yaml_parser_acquire(void) {
+	yaml_parser_t *parser;
+
+	if (yaml_parser_pool_count_)
+		return yaml_parser_pool_[--yaml_parser_pool_count_];
+
+	parser = (yaml_parser_t *)YAML_MALLOC(sizeof(yaml_parser_t));
+	if (!parser)
+		return NULL;
+	if (yaml_parser_init(parser)) {
+		YAML_FREE(parser);
+		return NULL;
+	}
+	return parser;
+}
+
+void yaml_parser_release(yaml_parser_t *parser) {
+	if (!parser)
+		return;
+
+	if (yaml_parser_pool_count_ < YAML_PARSER_POOL_SIZE && !yaml_parser_reset(parser)) {
+		yaml_parser_pool_[yaml_parser_pool_count_++] = parser;
+		return;
+	}
+
+	yaml_parser_destroy(parser);
+	YAML_FREE(parser);
+}
+
+void yaml_parser_pool_clear(void) {
+	while (yaml_parser_pool_count_) {
+		yaml_parser_t *parser = yaml_parser_pool_[--yaml_parser_pool_count_];
+
+		yaml_parser_destroy(parser);
+		YAML_FREE(parser);
+	}
+}
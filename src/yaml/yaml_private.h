@@ -1,6 +1,7 @@
 #ifndef YAML_PRIVATE_H_
 #define YAML_PRIVATE_H_
 
+#include <string.h>
 #include "yaml.h"
 
 /* The size of the input raw buffer.
@@ -27,132 +28,359 @@
 #define YAML_INITIAL_QUEUE_SIZE		16
 #define YAML_INITIAL_STRING_SIZE	16
 
+/* The number of parsers each thread keeps for reuse.
+ */
+#define YAML_PARSER_POOL_SIZE		8
+
+/* Storage private to each thread.
+ */
+#if defined(_MSC_VER)
+# define YAML_THREAD_LOCAL	__declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+# define YAML_THREAD_LOCAL	_Thread_local
+#else
+# define YAML_THREAD_LOCAL	__thread
+#endif
+
+/* Statistics hooks, compiled out unless the library is built with YAML_STATS.
+ */
+#if defined(YAML_STATS)
+
+typedef struct yaml_stats_mark_s {
+	uint64_t cycles;
+	uint64_t nested;					/* Time of the stages run inside this one. */
+	yaml_parser_t *previous;
+	struct yaml_stats_mark_s *outer;
+} yaml_stats_mark_t;
+
+void yaml_stats_begin(yaml_parser_t *parser, yaml_stats_mark_t *mark);
+void yaml_stats_end(yaml_parser_t *parser, int stage, yaml_stats_mark_t *mark);
+
+#define YAML_STATS_ADD(parser, counter, count)	((parser)->stats.counter += (count))
+#define YAML_STATS_BEGIN(parser, mark)			yaml_stats_mark_t mark; yaml_stats_begin((parser), &mark)
+#define YAML_STATS_END(parser, stage, mark)		yaml_stats_end((parser), (stage), &mark)
+
+/* Allocations are counted for the parser at work on the thread.
+ */
+#if !defined(YAML_STATS_ALLOCATOR)
+void *yaml_stats_malloc(size_t size);
+void *yaml_stats_realloc(void *ptr, size_t size);
+
+# undef YAML_MALLOC
+# undef YAML_REALLOC
+# define YAML_MALLOC(size) yaml_stats_malloc(size)
+# define YAML_REALLOC(ptr, size) yaml_stats_realloc((ptr), (size))
+#endif
+
+#else
+
+#define YAML_STATS_ADD(parser, counter, count)	((void)0)
+#define YAML_STATS_BEGIN(parser, mark)			((void)0)
+#define YAML_STATS_END(parser, stage, mark)		((void)0)
+
+#endif
+
 	 /* Token initializers.
 	  */
 
-#define YAML_TOKEN_INIT(token, type, start_mark, end_mark) do { \
-	(memset(token, 0, sizeof(yaml_token_t)); \
-	(token)->type = (type); \
-	(token)->start_mark = (start_mark); \
-	(token)->end_mark = (end_mark); \
+#define YAML_TOKEN_INIT(token, token_type, token_start_mark, token_end_mark) do { \
+	memset((token), 0, sizeof(yaml_token_t)); \
+	(token)->type = (token_type); \
+	(token)->start_mark = (token_start_mark); \
+	(token)->end_mark = (token_end_mark); \
 } while (0)
 
-#define YAML_TOKEN_STREAM_START_INIT(token, encoding, start_mark, end_mark) do { \
-    YAML_TOKEN_INIT((token), YAML_TOKEN_STREAM_START, (start_mark), (end_mark)); \
-	(token)->data.stream_start.encoding = (encoding); \
+#define YAML_TOKEN_STREAM_START_INIT(token, token_encoding, token_start_mark, token_end_mark) do { \
+	YAML_TOKEN_INIT((token), YAML_TOKEN_STREAM_START, (token_start_mark), (token_end_mark)); \
+	(token)->data.stream_start.encoding = (token_encoding); \
 } while (0)
 
-#define YAML_TOKEN_STREAM_END_INIT(token, start_mark, end_mark) do { \
-    YAML_TOKEN_INIT((token), YAML_TOKEN_STREAM_END, (start_mark), (end_mark)); \
+#define YAML_TOKEN_STREAM_END_INIT(token, token_start_mark, token_end_mark) do { \
+	YAML_TOKEN_INIT((token), YAML_TOKEN_STREAM_END, (token_start_mark), (token_end_mark)); \
 } while (0)
 
-#define YAML_TOKEN_ALIAS_INIT(token, value, start_mark, end_mark) do { \
-    YAML_TOKEN_INIT((token), YAML_TOKEN_ALIAS, (start_mark), (end_mark)); \
-	(token)->data.alias.value = (value); \
+#define YAML_TOKEN_ALIAS_INIT(token, token_value, token_start_mark, token_end_mark) do { \
+	YAML_TOKEN_INIT((token), YAML_TOKEN_ALIAS, (token_start_mark), (token_end_mark)); \
+	(token)->data.alias.value = (token_value); \
 } while (0)
 
-#define YAML_TOKEN_ANCHOR_INIT(token, value, start_mark, end_mark) do { \
-	YAML_TOKEN_INIT((token), YAML_TOKEN_ANCHOR, (start_mark), (end_mark)); \
-	(token)->data.anchor.value = (value); \
+#define YAML_TOKEN_ANCHOR_INIT(token, token_value, token_start_mark, token_end_mark) do { \
+	YAML_TOKEN_INIT((token), YAML_TOKEN_ANCHOR, (token_start_mark), (token_end_mark)); \
+	(token)->data.anchor.value = (token_value); \
 } while (0)
 
-#define YAML_TOKEN_TAG_INIT(token, handle, suffix, start_mark, end_mark) do { \
-	YAML_TOKEN_INIT((token), YAML_TOKEN_TAG, (start_mark), (end_mark)); \
-	(token)->data.tag.handle = (handle); \
-	(token)->data.tag.suffix = (suffix); \
+#define YAML_TOKEN_TAG_INIT(token, token_handle, token_suffix, token_start_mark, token_end_mark) do { \
+	YAML_TOKEN_INIT((token), YAML_TOKEN_TAG, (token_start_mark), (token_end_mark)); \
+	(token)->data.tag.handle = (token_handle); \
+	(token)->data.tag.suffix = (token_suffix); \
 } while (0)
 
-#define YAML_TOKEN_SCALAR_INIT(token, value, length, style, start_mark, end_mark) do { \
-	YAML_TOKEN_INIT((token), YAML_TOKEN_SCALAR, (start_mark), (end_mark)); \
-	(token)->data.scalar.value = (value); \
-    (token)->data.scalar.length = (length); \
-	(token)->data.scalar.style = (style); \
+#define YAML_TOKEN_SCALAR_INIT(token, token_value, token_length, token_style, token_start_mark, token_end_mark) do { \
+	YAML_TOKEN_INIT((token), YAML_TOKEN_SCALAR, (token_start_mark), (token_end_mark)); \
+	(token)->data.scalar.value = (token_value); \
+	(token)->data.scalar.length = (token_length); \
+	(token)->data.scalar.style = (token_style); \
 } while (0)
 
-#define YAML_TOKEN_VERSION_DIRECTIVE_INIT(token, major, minor, start_mark, end_mark) do { \
-    YAML_TOKEN_INIT((token), YAML_TOKEN_VERSION_DIRECTIVE, (start_mark), (end_mark)); \
-	(token)->data.version_directive.major = (major); \
-	(token)->data.version_directive.minor = (minor); \
+#define YAML_TOKEN_VERSION_DIRECTIVE_INIT(token, token_major, token_minor, token_start_mark, token_end_mark) do { \
+	YAML_TOKEN_INIT((token), YAML_TOKEN_VERSION_DIRECTIVE, (token_start_mark), (token_end_mark)); \
+	(token)->data.version_directive.major = (token_major); \
+	(token)->data.version_directive.minor = (token_minor); \
 } while (0)
 
-#define YAML_TOKEN_TAG_DIRECTIVE_INIT(token, handle, prefix, start_mark, end_mark) do { \
-	YAML_TOKEN_INIT((token), YAML_TOKEN_TAG_DIRECTIVE, (start_mark), (end_mark)); \
-	(token)->data.tag_directive.handle = (handle); \
-	(token)->data.tag_directive.prefix = (prefix); \
+#define YAML_TOKEN_TAG_DIRECTIVE_INIT(token, token_handle, token_prefix, token_start_mark, token_end_mark) do { \
+	YAML_TOKEN_INIT((token), YAML_TOKEN_TAG_DIRECTIVE, (token_start_mark), (token_end_mark)); \
+	(token)->data.tag_directive.handle = (token_handle); \
+	(token)->data.tag_directive.prefix = (token_prefix); \
 } while (0)
 
 	  /* Event initializers.
 	   */
 
-#define YAML_EVENT_INIT(event, type, start_mark, end_mark) do { \
-	memset(&(event), 0, sizeof(yaml_event_t)); \
-	(event)->type = (type); \
-    (event)->start_mark = (start_mark); \
-    (event)->end_mark = (end_mark); \
+#define YAML_EVENT_INIT(event, event_type, event_start_mark, event_end_mark) do { \
+	memset((event), 0, sizeof(yaml_event_t)); \
+	(event)->type = (event_type); \
+	(event)->start_mark = (event_start_mark); \
+	(event)->end_mark = (event_end_mark); \
+} while (0)
+
+#define YAML_EVENT_STREAM_START_INIT(event, event_encoding, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_STREAM_START, (event_start_mark), (event_end_mark)); \
+	(event)->data.stream_start.encoding = (event_encoding); \
 } while (0)
 
-#define YAML_EVENT_STREAM_START_INIT(event, encoding, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_STREAM_START, (start_mark), (end_mark)); \
-	(event)->data.stream_start.encoding = (encoding); \
+#define YAML_EVENT_STREAM_END_INIT(event, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_STREAM_END, (event_start_mark), (event_end_mark)); \
 } while (0)
 
-#define YAML_EVENT_STREAM_END_INIT(event, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_STREAM_END, (start_mark), (end_mark)); \
+#define YAML_EVENT_DOCUMENT_START_INIT(event, event_version_directive, event_tag_directives_start, \
+		event_tag_directives_end, event_implicit, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_DOCUMENT_START, (event_start_mark), (event_end_mark)); \
+	(event)->data.document_start.version_directive.major = (event_version_directive).major; \
+	(event)->data.document_start.version_directive.minor = (event_version_directive).minor; \
+	(event)->data.document_start.tag_directives.start = (event_tag_directives_start); \
+	(event)->data.document_start.tag_directives.end = (event_tag_directives_end); \
+	(event)->data.document_start.implicit = (event_implicit); \
 } while (0)
 
-#define YAML_EVENT_DOCUMENT_START_INIT(event, version_directive, tag_directives_start, \
-										tag_directives_end, implicit, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_DOCUMENT_START, (start_mark), (end_mark)); \
-	(event)->data.document_start.version_directive = (version_directive); \
-	(event)->data.document_start.tag_directives.start = (tag_directives_start); \
-	(event)->data.document_start.tag_directives.end = (tag_directives_end); \
-	(event)->data.document_start.implicit = (implicit); \
+#define YAML_EVENT_DOCUMENT_END_INIT(event, event_implicit, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_DOCUMENT_END, (event_start_mark), (event_end_mark)); \
+	(event)->data.document_end.implicit = (event_implicit); \
 } while (0)
 
-#define YAML_EVENT_DOCUMENT_END_INIT(event, implicit, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_DOCUMENT_END, (start_mark), (end_mark)); \
-	(event)->data.document_end.implicit = (implicit); \
+#define YAML_EVENT_ALIAS_INIT(event, event_anchor, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_ALIAS, (event_start_mark), (event_end_mark)); \
+	(event)->data.alias.anchor = (event_anchor); \
 } while (0)
 
-#define YAML_EVENT_ALIAS_INIT(event, anchor, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_ALIAS, (start_mark), (end_mark)); \
-	(event)->data.alias.anchor = (anchor); \
+#define YAML_EVENT_SCALAR_INIT(event, event_anchor, event_tag, event_value, event_length, event_plain_implicit, \
+		event_quoted_implicit, event_style, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_SCALAR, (event_start_mark), (event_end_mark)); \
+	(event)->data.scalar.anchor = (event_anchor); \
+	(event)->data.scalar.tag = (event_tag); \
+	(event)->data.scalar.value = (event_value); \
+	(event)->data.scalar.length = (event_length); \
+	(event)->data.scalar.plain_implicit = (event_plain_implicit); \
+	(event)->data.scalar.quoted_implicit = (event_quoted_implicit); \
+	(event)->data.scalar.style = (event_style); \
 } while (0)
 
-#define YAML_EVENT_SCALAR_INIT(event, anchor, tag, value, length, plain_implicit, \
-								quoted_implicit, style, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_SCALAR, (start_mark), (end_mark)); \
-	(event)->data.scalar.anchor = (anchor); \
-	(event)->data.scalar.tag = (tag); \
-	(event)->data.scalar.value = (value); \
-	(event)->data.scalar.length = (length); \
-	(event)->data.scalar.plain_implicit = (plain_implicit); \
-	(event)->data.scalar.quoted_implicit = (quoted_implicit); \
-	(event)->data.scalar.style = (style); \
+#define YAML_EVENT_SEQUENCE_START_INIT(event, event_anchor, event_tag, event_implicit, event_style, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_SEQUENCE_START, (event_start_mark), (event_end_mark)); \
+	(event)->data.sequence_start.anchor = (event_anchor); \
+	(event)->data.sequence_start.tag = (event_tag); \
+	(event)->data.sequence_start.implicit = (event_implicit); \
+	(event)->data.sequence_start.style = (event_style); \
 } while (0)
 
-#define YAML_EVENT_SEQUENCE_START_INIT(event, anchor, tag, implicit, style, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_SEQUENCE_START, (start_mark), (end_mark)); \
-	(event)->data.sequence_start.anchor = (anchor); \
-	(event)->data.sequence_start.tag = (tag); \
-	(event)->data.sequence_start.implicit = (implicit); \
-	(event)->data.sequence_start.style = (style); \
+#define YAML_EVENT_SEQUENCE_END_INIT(event, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_SEQUENCE_END, (event_start_mark), (event_end_mark)); \
 } while (0)
 
-#define YAML_EVENT_SEQUENCE_END_INIT(event, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_SEQUENCE_END, (start_mark), (end_mark)); \
+#define YAML_EVENT_MAPPING_START_INIT(event, event_anchor, event_tag, event_implicit, event_style, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_MAPPING_START, (event_start_mark), (event_end_mark)); \
+	(event)->data.mapping_start.anchor = (event_anchor); \
+	(event)->data.mapping_start.tag = (event_tag); \
+	(event)->data.mapping_start.implicit = (event_implicit); \
+	(event)->data.mapping_start.style = (event_style); \
 } while (0)
 
-#define YAML_EVENT_MAPPING_START_INIT(event, anchor, tag, implicit, style, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_MAPPING_START, (start_mark), (end_mark)); \
-	(event)->data.mapping_start.anchor = (anchor); \
-	(event)->data.mapping_start.tag = (tag); \
-	(event)->data.mapping_start.implicit = (implicit); \
-	(event)->data.mapping_start.style = (style); \
+#define YAML_EVENT_MAPPING_END_INIT(event, event_start_mark, event_end_mark) do { \
+	YAML_EVENT_INIT((event), YAML_EVENT_MAPPING_END, (event_start_mark), (event_end_mark)); \
 } while (0)
 
-#define YAML_EVENT_MAPPING_END_INIT(event, start_mark, end_mark) do { \
-	YAML_EVENT_INIT((event), YAML_EVENT_MAPPING_END, (start_mark), (end_mark)); \
+	   /* Node initializers.
+	    */
+
+#define YAML_NODE_INIT(node, node_type, node_tag, node_tag_id, node_start_mark, node_end_mark) do { \
+	memset((node), 0, sizeof(yaml_node_t)); \
+	(node)->type = (node_type); \
+	(node)->tag = (node_tag); \
+	(node)->tag_id = (node_tag_id); \
+	(node)->start_mark = (node_start_mark); \
+	(node)->end_mark = (node_end_mark); \
+} while (0)
+
+#define YAML_SCALAR_NODE_INIT(node, node_tag, node_tag_id, node_value, node_length, \
+								node_style, node_start_mark, node_end_mark) do { \
+	YAML_NODE_INIT((node), YAML_NSTYLE_SCALAR, (node_tag), (node_tag_id), \
+		(node_start_mark), (node_end_mark)); \
+	(node)->data.scalar.value = (node_value); \
+	(node)->data.scalar.length = (node_length); \
+	(node)->data.scalar.style = (node_style); \
+} while (0)
+
+#define YAML_SEQUENCE_NODE_INIT(node, node_tag, node_tag_id, items_start, items_end, \
+								node_style, node_start_mark, node_end_mark) do { \
+	YAML_NODE_INIT((node), YAML_NSTYLE_SEQUENCE, (node_tag), (node_tag_id), \
+		(node_start_mark), (node_end_mark)); \
+	(node)->data.sequence.items.start = (items_start); \
+	(node)->data.sequence.items.end = (items_end); \
+	(node)->data.sequence.items.top = (items_start); \
+	(node)->data.sequence.style = (node_style); \
 } while (0)
 
+#define YAML_MAPPING_NODE_INIT(node, node_tag, node_tag_id, pairs_start, pairs_end, \
+								node_style, node_start_mark, node_end_mark) do { \
+	YAML_NODE_INIT((node), YAML_NSTYLE_MAPPING, (node_tag), (node_tag_id), \
+		(node_start_mark), (node_end_mark)); \
+	(node)->data.mapping.pairs.start = (pairs_start); \
+	(node)->data.mapping.pairs.end = (pairs_end); \
+	(node)->data.mapping.pairs.top = (pairs_start); \
+	(node)->data.mapping.style = (node_style); \
+} while (0)
+
+/* SWAR tests over 8 octets at a time, loaded with memcpy().
+ * They tell if any octet matches, not which one.
+ */
+#define YAML_SWAR_ONES		UINT64_C(0x0101010101010101)
+#define YAML_SWAR_HIGHS		UINT64_C(0x8080808080808080)
+#define YAML_SWAR_HAS_ZERO(x)	(((x) - YAML_SWAR_ONES) & ~(x) & YAML_SWAR_HIGHS)
+#define YAML_SWAR_HAS_LESS(x, n)	(((x) - YAML_SWAR_ONES * (n)) & ~(x) & YAML_SWAR_HIGHS)
+#define YAML_SWAR_HAS(x, c)	YAML_SWAR_HAS_ZERO((x) ^ (YAML_SWAR_ONES * (c)))
+
+/* The width of the UTF-8 character starting with the octet.
+ */
+#define YAML_UTF8_WIDTH(octet) \
+	(((octet) & 0x80) == 0x00 ? 1 : ((octet) & 0xE0) == 0xC0 ? 2 : \
+	 ((octet) & 0xF0) == 0xE0 ? 3 : ((octet) & 0xF8) == 0xF0 ? 4 : 1)
+
+/* Check for NEL, LS and PS.
+ */
+#define YAML_IS_UNICODE_BREAK(pointer, end) \
+	((pointer)[0] == 0xC2 ? (pointer) + 1 < (end) && (pointer)[1] == 0x85 : \
+	 (pointer)[0] == 0xE2 ? (pointer) + 2 < (end) && (pointer)[1] == 0x80 \
+		&& ((pointer)[2] == 0xA8 || (pointer)[2] == 0xA9) : 0)
+
+/* Check for a printable non-ASCII character, as the reader accepts them.
+ */
+#define YAML_IS_UNICODE_PRINTABLE(pointer, end) \
+	((pointer)[0] == 0xC2 ? (pointer) + 1 < (end) && (pointer)[1] >= 0xA0 : \
+	 (pointer)[0] == 0xED ? (pointer) + 1 < (end) && (pointer)[1] < 0xA0 : \
+	 (pointer)[0] == 0xEF ? (pointer) + 2 < (end) \
+		&& !((pointer)[1] == 0xBB && (pointer)[2] == 0xBF) \
+		&& !((pointer)[1] == 0xBF && ((pointer)[2] == 0xBE || (pointer)[2] == 0xBF)) : \
+	 ((pointer)[0] > 0xC2 && (pointer)[0] < 0xED) || (pointer)[0] == 0xEE)
+
+/* Count a new reference to a node, the root being held by the document
+ * itself. The composer counts the target of an alias the same way.
+ */
+#define YAML_DOCUMENT_REFERENCE(document, index) do { \
+	if (++(document)->nodes.start[(index) - 1].references + ((index) == 1) == 2) \
+		(document)->shared++; \
+} while (0)
+
+/* Write a run of characters that needs no escaping or folding.
+ * Long UTF-8 runs are handed to the output by reference, so the value must
+ * stay valid until the function returns only.
+ */
+int yaml_emitter_write_verbatim(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length);
+
+/* Write the parts of the output, keeping the column, the line and the
+ * whitespace state of the emitter. The scalar writers hand the runs that
+ * need no escaping or folding to yaml_emitter_write_verbatim().
+ */
+int yaml_emitter_write_bom(yaml_emitter_t *emitter);
+int yaml_emitter_write_indent(yaml_emitter_t *emitter);
+int yaml_emitter_write_indicator(yaml_emitter_t *emitter, const char *indicator,
+	int need_whitespace, int is_whitespace, int is_indention);
+int yaml_emitter_write_anchor(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length);
+int yaml_emitter_write_tag_handle(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length);
+int yaml_emitter_write_tag_content(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length,
+	int need_whitespace);
+int yaml_emitter_write_plain_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length,
+	int allow_breaks);
+int yaml_emitter_write_single_quoted_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length,
+	int allow_breaks);
+int yaml_emitter_write_double_quoted_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length,
+	int allow_breaks);
+int yaml_emitter_write_literal_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length);
+int yaml_emitter_write_folded_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length);
+
+/* Analyze a scalar value and fill the scalar data of the emitter.
+ */
+int yaml_emitter_analyze_scalar(yaml_emitter_t *emitter, yaml_char_t *value, size_t length);
+
+/* Analyze the value of a SCALAR event, trusting it if the event says so.
+ */
+int yaml_emitter_analyze_scalar_event(yaml_emitter_t *emitter, yaml_event_t *event);
+
+/* Growable memory write handler, used when the output is recoded.
+ */
+int yaml_buffer_write_handler(void *data, unsigned char *buffer, size_t size);
+
+/* Hand the memory output over to the caller once the stream is closed.
+ */
+void yaml_emitter_release_output(yaml_emitter_t *emitter);
+
+/* Write an event as compact JSON, yaml_emitter_emit() routes the events
+ * here when the json mode is set. The event is destroyed.
+ */
+int yaml_emitter_emit_json(yaml_emitter_t *emitter, yaml_event_t *event);
+
+/* Get the JSON literal of a scalar: null, a boolean or a number, formatted
+ * into buffer (32 octets) if needed. NULL means the scalar is a string.
+ */
+const char *yaml_json_scalar_literal(const yaml_event_t *event, char *buffer);
+
+/* File descriptor writev handler, the data is the emitter.
+ */
+int yaml_fd_writev_handler(void *data, const yaml_iovec_t *segments, size_t count);
+
+/* Ensure the buffer holds at least length characters, reading and decoding
+ * more of the input. The buffer ends with a NUL once the input is exhausted.
+ */
+int yaml_parser_update_buffer(yaml_parser_t *parser, size_t length);
+
+#define YAML_PARSER_CACHE(parser, length) \
+	((parser)->unread >= (length) ? YAML_EOK : yaml_parser_update_buffer((parser), (length)))
+
+/* Scan until the token at the head of the queue is final, that is no
+ * potential simple key may still put a KEY token before it.
+ */
+int yaml_parser_fetch_more_tokens(yaml_parser_t *parser);
+
+/* Get the token at the head of the queue, or NULL on error.
+ */
+#define YAML_PARSER_PEEK_TOKEN(parser) \
+	((parser)->token_available || yaml_parser_fetch_more_tokens(parser) == YAML_EOK \
+		? (parser)->tokens.head : NULL)
+
+/* Drop the token at the head of the queue, its data now belongs to the caller.
+ */
+#define YAML_PARSER_SKIP_TOKEN(parser) do { \
+	(parser)->token_available = 0; \
+	(parser)->tokens_parsed++; \
+	(parser)->stream_end_produced = (parser)->tokens.head->type == YAML_TOKEN_STREAM_END; \
+	(parser)->tokens.head++; \
+} while (0)
+
+/* Hash a string for the string tables, FNV-1a.
+ */
+uint64_t yaml_intern_hash(const yaml_char_t *string, size_t length);
+
+/* Duplicate a NUL terminated string with YAML_MALLOC.
+ */
+yaml_char_t *yaml_strdup(const yaml_char_t *str);
+
 #endif /* !YAML_PRIVATE_H_ */
@@ -0,0 +1,318 @@
+#include "yaml_private.h"
+
+/* The byte order marks.
+ */
+#define YAML_BOM_UTF8		"\xef\xbb\xbf"
+#define YAML_BOM_UTF16LE	"\xff\xfe"
+#define YAML_BOM_UTF16BE	"\xfe\xff"
+
+/* The longest input the marks can count.
+ */
+#define YAML_MAX_INPUT_SIZE	(~(size_t)0 / 2)
+
+/* Set the reader error and return YAML_EREADER.
+ */
+static int yaml_parser_set_reader_error_(yaml_parser_t *parser, const char *problem,
+		size_t offset, int value) {
+	parser->error = YAML_EREADER;
+	parser->problem = problem;
+	parser->problem_offset = offset;
+	parser->problem_value = value;
+	return YAML_EREADER;
+}
+
+/* Fill the raw buffer from the read handler.
+ */
+static int yaml_parser_update_raw_buffer_(yaml_parser_t *parser) {
+	size_t size_read = 0;
+
+	/* Nothing to do if the raw buffer is full or the input exhausted. */
+	if (parser->raw_buffer.start == parser->raw_buffer.pointer
+			&& parser->raw_buffer.last == parser->raw_buffer.end)
+		return YAML_EOK;
+	if (parser->eof)
+		return YAML_EOK;
+
+	/* Move the remaining bytes to the beginning of the raw buffer. */
+	if (parser->raw_buffer.start < parser->raw_buffer.pointer
+			&& parser->raw_buffer.pointer < parser->raw_buffer.last)
+		memmove(parser->raw_buffer.start, parser->raw_buffer.pointer,
+			parser->raw_buffer.last - parser->raw_buffer.pointer);
+	parser->raw_buffer.last -= parser->raw_buffer.pointer - parser->raw_buffer.start;
+	parser->raw_buffer.pointer = parser->raw_buffer.start;
+
+	if (parser->read_handler(parser->read_handler_data, parser->raw_buffer.last,
+			parser->raw_buffer.end - parser->raw_buffer.last, &size_read) != YAML_EOK)
+		return yaml_parser_set_reader_error_(parser, "input error", parser->offset, -1);
+
+	YAML_STATS_ADD(parser, refills, 1);
+	YAML_STATS_ADD(parser, bytes_read, size_read);
+	parser->raw_buffer.last += size_read;
+	if (!size_read)
+		parser->eof = 1;
+
+	return YAML_EOK;
+}
+
+/* Determine the input encoding from the byte order mark, UTF-8 without one.
+ */
+static int yaml_parser_determine_encoding_(yaml_parser_t *parser) {
+	size_t size;
+	int error;
+
+	while (!parser->eof && parser->raw_buffer.last - parser->raw_buffer.pointer < 3) {
+		error = yaml_parser_update_raw_buffer_(parser);
+		if (error)
+			return error;
+	}
+
+	size = parser->raw_buffer.last - parser->raw_buffer.pointer;
+	if (size >= 2 && !memcmp(parser->raw_buffer.pointer, YAML_BOM_UTF16LE, 2)) {
+		parser->encoding = YAML_ENCODING_UTF16LE;
+		parser->raw_buffer.pointer += 2;
+		parser->offset += 2;
+	}
+	else if (size >= 2 && !memcmp(parser->raw_buffer.pointer, YAML_BOM_UTF16BE, 2)) {
+		parser->encoding = YAML_ENCODING_UTF16BE;
+		parser->raw_buffer.pointer += 2;
+		parser->offset += 2;
+	}
+	else if (size >= 3 && !memcmp(parser->raw_buffer.pointer, YAML_BOM_UTF8, 3)) {
+		parser->encoding = YAML_ENCODING_UTF8;
+		parser->raw_buffer.pointer += 3;
+		parser->offset += 3;
+
+		/* The marks index the input octets, the BOM included. */
+		parser->mark.index = 3;
+	}
+	else
+		parser->encoding = YAML_ENCODING_UTF8;
+
+	return YAML_EOK;
+}
+
+/* Check if a character may appear in a YAML stream:
+ * #x9 | #xA | #xD | [#x20-#x7E] | #x85 | [#xA0-#xD7FF] | [#xE000-#xFFFD] | [#x10000-#x10FFFF]
+ */
+#define YAML_READER_IS_ALLOWED(value) \
+	((value) == 0x09 || (value) == 0x0A || (value) == 0x0D \
+	 || ((value) >= 0x20 && (value) <= 0x7E) || (value) == 0x85 \
+	 || ((value) >= 0xA0 && (value) <= 0xD7FF) || ((value) >= 0xE000 && (value) <= 0xFFFD) \
+	 || ((value) >= 0x10000 && (value) <= 0x10FFFF))
+
+/* Decode one character of the raw buffer.
+ * Returns 0 with *width 0 if the raw buffer ends inside the character.
+ */
+static int yaml_parser_decode_(yaml_parser_t *parser, unsigned int *value, size_t *width) {
+	const yaml_byte_t *pointer = parser->raw_buffer.pointer;
+	size_t raw_unread = parser->raw_buffer.last - pointer;
+	unsigned int value2;
+	int low, high;
+	size_t k;
+
+	*width = 0;
+
+	switch (parser->encoding) {
+	case YAML_ENCODING_UTF8:
+		*width = YAML_UTF8_WIDTH(pointer[0]);
+		if (*width == 1 && (pointer[0] & 0x80))
+			return yaml_parser_set_reader_error_(parser, "invalid leading UTF-8 octet",
+				parser->offset, pointer[0]);
+		if (*width > raw_unread) {
+			*width = 0;
+			if (parser->eof)
+				return yaml_parser_set_reader_error_(parser, "incomplete UTF-8 octet sequence",
+					parser->offset, -1);
+			return YAML_EOK;
+		}
+
+		*value = *width == 1 ? pointer[0] : *width == 2 ? pointer[0] & 0x1F
+			: *width == 3 ? pointer[0] & 0x0F : pointer[0] & 0x07;
+		for (k = 1; k < *width; k++) {
+			if ((pointer[k] & 0xC0) != 0x80)
+				return yaml_parser_set_reader_error_(parser, "invalid trailing UTF-8 octet",
+					parser->offset + k, pointer[k]);
+			*value = (*value << 6) + (pointer[k] & 0x3F);
+		}
+
+		if (!(*width == 1 || (*width == 2 && *value >= 0x80)
+				|| (*width == 3 && *value >= 0x800) || (*width == 4 && *value >= 0x10000)))
+			return yaml_parser_set_reader_error_(parser, "invalid length of a UTF-8 sequence",
+				parser->offset, -1);
+		if ((*value >= 0xD800 && *value <= 0xDFFF) || *value > 0x10FFFF)
+			return yaml_parser_set_reader_error_(parser, "invalid Unicode character",
+				parser->offset, (int)*value);
+		return YAML_EOK;
+
+	case YAML_ENCODING_UTF16LE:
+	case YAML_ENCODING_UTF16BE:
+		low = parser->encoding == YAML_ENCODING_UTF16LE ? 0 : 1;
+		high = 1 - low;
+
+		if (raw_unread < 2) {
+			if (parser->eof)
+				return yaml_parser_set_reader_error_(parser, "incomplete UTF-16 character",
+					parser->offset, -1);
+			return YAML_EOK;
+		}
+
+		*value = pointer[low] + (pointer[high] << 8);
+		if ((*value & 0xFC00) == 0xDC00)
+			return yaml_parser_set_reader_error_(parser, "unexpected low surrogate area",
+				parser->offset, (int)*value);
+
+		if ((*value & 0xFC00) != 0xD800) {
+			*width = 2;
+			return YAML_EOK;
+		}
+
+		/* A surrogate pair. */
+		if (raw_unread < 4) {
+			if (parser->eof)
+				return yaml_parser_set_reader_error_(parser, "incomplete UTF-16 surrogate pair",
+					parser->offset, -1);
+			return YAML_EOK;
+		}
+		value2 = pointer[low + 2] + (pointer[high + 2] << 8);
+		if ((value2 & 0xFC00) != 0xDC00)
+			return yaml_parser_set_reader_error_(parser, "expected low surrogate area",
+				parser->offset + 2, (int)value2);
+		*value = 0x10000 + ((*value & 0x3FF) << 10) + (value2 & 0x3FF);
+		*width = 4;
+		return YAML_EOK;
+
+	default:
+		assert(0); /* Impossible encoding. */
+		return YAML_EFAILD;
+	}
+}
+
+/* Decode the raw buffer into the buffer as UTF-8.
+ */
+static int yaml_parser_decode_raw_buffer_(yaml_parser_t *parser) {
+	while (parser->raw_buffer.pointer != parser->raw_buffer.last) {
+		unsigned int value = 0;
+		size_t width;
+		int error;
+
+		/* Printable ASCII is copied as it is. */
+		if (parser->encoding == YAML_ENCODING_UTF8) {
+			yaml_byte_t *pointer = parser->raw_buffer.pointer;
+			yaml_char_t *last = parser->buffer.last;
+
+			while (pointer != parser->raw_buffer.last
+					&& ((*pointer >= 0x20 && *pointer <= 0x7E) || *pointer == '\n'
+						|| *pointer == '\r' || *pointer == '\t'))
+				*last++ = *pointer++;
+
+			parser->unread += last - parser->buffer.last;
+			parser->offset += last - parser->buffer.last;
+			parser->raw_buffer.pointer = pointer;
+			parser->buffer.last = last;
+			if (pointer == parser->raw_buffer.last)
+				break;
+		}
+
+		error = yaml_parser_decode_(parser, &value, &width);
+		if (error)
+			return error;
+		if (!width)
+			break;
+
+		if (!YAML_READER_IS_ALLOWED(value))
+			return yaml_parser_set_reader_error_(parser, "control characters are not allowed",
+				parser->offset, (int)value);
+
+		parser->raw_buffer.pointer += width;
+		parser->offset += width;
+
+		if (value <= 0x7F)
+			*(parser->buffer.last++) = (yaml_char_t)value;
+		else if (value <= 0x7FF) {
+			*(parser->buffer.last++) = (yaml_char_t)(0xC0 + (value >> 6));
+			*(parser->buffer.last++) = (yaml_char_t)(0x80 + (value & 0x3F));
+		}
+		else if (value <= 0xFFFF) {
+			*(parser->buffer.last++) = (yaml_char_t)(0xE0 + (value >> 12));
+			*(parser->buffer.last++) = (yaml_char_t)(0x80 + ((value >> 6) & 0x3F));
+			*(parser->buffer.last++) = (yaml_char_t)(0x80 + (value & 0x3F));
+		}
+		else {
+			*(parser->buffer.last++) = (yaml_char_t)(0xF0 + (value >> 18));
+			*(parser->buffer.last++) = (yaml_char_t)(0x80 + ((value >> 12) & 0x3F));
+			*(parser->buffer.last++) = (yaml_char_t)(0x80 + ((value >> 6) & 0x3F));
+			*(parser->buffer.last++) = (yaml_char_t)(0x80 + (value & 0x3F));
+		}
+		parser->unread++;
+	}
+
+	return YAML_EOK;
+}
+
+/* Decode the input until the buffer holds the given count of characters.
+ */
+static int yaml_parser_fill_buffer_(yaml_parser_t *parser, size_t length) {
+	int first = 1;
+	int error;
+
+	assert(parser->read_handler); /* Read handler must be set. */
+
+	/* Nothing left to read. */
+	if (parser->eof && parser->raw_buffer.pointer == parser->raw_buffer.last)
+		return YAML_EOK;
+	if (parser->unread >= length)
+		return YAML_EOK;
+
+	if (!parser->encoding) {
+		error = yaml_parser_determine_encoding_(parser);
+		if (error)
+			return error;
+	}
+
+	/* Move the unread characters to the beginning of the buffer. */
+	if (parser->buffer.start < parser->buffer.pointer && parser->buffer.pointer < parser->buffer.last) {
+		size_t size = parser->buffer.last - parser->buffer.pointer;
+
+		memmove(parser->buffer.start, parser->buffer.pointer, size);
+		parser->buffer.pointer = parser->buffer.start;
+		parser->buffer.last = parser->buffer.start + size;
+	}
+	else if (parser->buffer.pointer == parser->buffer.last) {
+		parser->buffer.pointer = parser->buffer.start;
+		parser->buffer.last = parser->buffer.start;
+	}
+
+	while (parser->unread < length) {
+		if (!first || parser->raw_buffer.pointer == parser->raw_buffer.last) {
+			error = yaml_parser_update_raw_buffer_(parser);
+			if (error)
+				return error;
+		}
+		first = 0;
+
+		error = yaml_parser_decode_raw_buffer_(parser);
+		if (error)
+			return error;
+
+		/* The scanner stops at the NUL ending the input. */
+		if (parser->eof && parser->raw_buffer.pointer == parser->raw_buffer.last) {
+			*(parser->buffer.last++) = '\0';
+			parser->unread++;
+			return YAML_EOK;
+		}
+	}
+
+	if (parser->offset >= YAML_MAX_INPUT_SIZE)
+		return yaml_parser_set_reader_error_(parser, "input is too long", parser->offset, -1);
+
+	return YAML_EOK;
+}
+
+int yaml_parser_update_buffer(yaml_parser_t *parser, size_t length) {
+	int error;
+	YAML_STATS_BEGIN(parser, mark);
+
+	error = yaml_parser_fill_buffer_(parser, length);
+	YAML_STATS_END(parser, YAML_STATS_READER, mark);
+	return error;
+}
@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include "yaml_private.h"
+
+/* Count the line breaks the way the reader does: CR LF, CR and LF.
+ */
+static size_t yaml_reload_count_breaks_(const unsigned char *pointer, size_t size) {
+	const unsigned char *end = pointer + size;
+	size_t breaks = 0;
+
+	for (; pointer != end; pointer++) {
+		if (*pointer == '\n')
+			breaks++;
+		else if (*pointer == '\r') {
+			breaks++;
+			if (pointer + 1 != end && pointer[1] == '\n')
+				pointer++;
+		}
+	}
+	return breaks;
+}
+
+/* Build the directives the later documents of a Unity stream rely on for
+ * the `!u!` handle, from the nearest earlier document declaring some. They
+ * end in an empty document of their own, so the documents of the slice keep
+ * only the directives they declare.
+ */
+static int yaml_reload_prefix_(const yaml_document_t *documents, size_t count,
+		unsigned char **prefix, size_t *size, size_t *lines) {
+	static const char empty_document[] = "---\n...\n";
+	const yaml_document_t *document = NULL;
+	yaml_tag_directive_t *tag_directive;
+	size_t capacity = sizeof(empty_document) + 32;
+	size_t length = 0;
+
+	*prefix = NULL;
+	*size = 0;
+	*lines = 0;
+	while (count && !document) {
+		count--;
+		if (documents[count].version_directive.major
+				|| documents[count].tag_directives.start != documents[count].tag_directives.end)
+			document = documents + count;
+	}
+	if (!document)
+		return YAML_EOK;
+
+	for (tag_directive = document->tag_directives.start; tag_directive != document->tag_directives.end; tag_directive++)
+		capacity += strlen((char *)tag_directive->handle) + strlen((char *)tag_directive->prefix) + 8;
+
+	*prefix = (unsigned char *)YAML_MALLOC(capacity);
+	if (!*prefix)
+		return YAML_EMEMORY;
+
+	if (document->version_directive.major) {
+		length += sprintf((char *)*prefix, "%%YAML %d.%d\n",
+			document->version_directive.major, document->version_directive.minor);
+		(*lines)++;
+	}
+	for (tag_directive = document->tag_directives.start; tag_directive != document->tag_directives.end; tag_directive++) {
+		length += sprintf((char *)*prefix + length, "%%TAG %s %s\n",
+			(char *)tag_directive->handle, (char *)tag_directive->prefix);
+		(*lines)++;
+	}
+	memcpy(*prefix + length, empty_document, sizeof(empty_document) - 1);
+	length += sizeof(empty_document) - 1;
+	*lines += 2;
+
+	*size = length;
+	return YAML_EOK;
+}
+
+/* Move a mark of the parsed slice to the new source.
+ */
+static void yaml_reload_rebase_mark_(yaml_mark_t *mark, const yaml_mark_t *base,
+		size_t prefix_size, size_t prefix_lines) {
+	if (mark->index < prefix_size) {
+		*mark = *base;
+		return;
+	}
+
+	mark->index = mark->index - prefix_size + base->index;
+	if (mark->line == prefix_lines)
+		mark->column += base->column;
+	mark->line = mark->line - prefix_lines + base->line;
+}
+
+static void yaml_reload_rebase_(yaml_document_t *document, const yaml_mark_t *base,
+		size_t prefix_size, size_t prefix_lines) {
+	yaml_node_t *node;
+
+	yaml_reload_rebase_mark_(&document->start_mark, base, prefix_size, prefix_lines);
+	yaml_reload_rebase_mark_(&document->end_mark, base, prefix_size, prefix_lines);
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		yaml_reload_rebase_mark_(&node->start_mark, base, prefix_size, prefix_lines);
+		yaml_reload_rebase_mark_(&node->end_mark, base, prefix_size, prefix_lines);
+	}
+}
+
+/* Shift the marks of a document following the edit.
+ */
+static void yaml_reload_shift_(yaml_document_t *document, ptrdiff_t delta, ptrdiff_t line_delta) {
+	yaml_node_t *node;
+
+#define YAML_RELOAD_SHIFT_MARK(mark) do { \
+	(mark).index = (size_t)((ptrdiff_t)(mark).index + delta); \
+	(mark).line = (size_t)((ptrdiff_t)(mark).line + line_delta); \
+} while (0)
+
+	YAML_RELOAD_SHIFT_MARK(document->start_mark);
+	YAML_RELOAD_SHIFT_MARK(document->end_mark);
+	for (node = document->nodes.start; node != document->nodes.top; node++) {
+		YAML_RELOAD_SHIFT_MARK(node->start_mark);
+		YAML_RELOAD_SHIFT_MARK(node->end_mark);
+	}
+
+#undef YAML_RELOAD_SHIFT_MARK
+}
+
+/* Parse all the documents of a string.
+ */
+static int yaml_reload_parse_(const unsigned char *input, size_t size,
+		yaml_document_t **documents, size_t *count) {
+	yaml_parser_t parser;
+	yaml_document_t *parsed = NULL;
+	size_t capacity = 0;
+	size_t length = 0;
+	int error;
+
+	error = yaml_parser_init(&parser);
+	if (error)
+		return error;
+	yaml_parser_set_input_string(&parser, input, size);
+
+	for (;;) {
+		if (length == capacity) {
+			size_t new_capacity = capacity ? capacity * 2 : YAML_INITIAL_STACK_SIZE;
+			yaml_document_t *new_parsed = (yaml_document_t *)YAML_REALLOC(parsed,
+				new_capacity * sizeof(yaml_document_t));
+
+			if (!new_parsed) {
+				error = YAML_EMEMORY;
+				break;
+			}
+			parsed = new_parsed;
+			capacity = new_capacity;
+		}
+
+		error = yaml_parser_load(&parser, parsed + length);
+		if (error)
+			break;
+
+		/* An empty document marks the end of the stream. */
+		if (!yaml_document_get_root_node(parsed + length)) {
+			yaml_document_destroy(parsed + length);
+			break;
+		}
+		length++;
+	}
+	yaml_parser_destroy(&parser);
+
+	if (error) {
+		while (length)
+			yaml_document_destroy(parsed + --length);
+		YAML_FREE(parsed);
+		return error;
+	}
+
+	*documents = parsed;
+	*count = length;
+	return YAML_EOK;
+}
+
+int yaml_parser_reload(yaml_document_t **documents, size_t *count,
+		const unsigned char *input, size_t size,
+		const yaml_edit_t *edit) {
+	yaml_document_t *old_documents;
+	yaml_document_t *new_documents;
+	yaml_document_t *parsed = NULL;
+	yaml_mark_t base = { 0, 0, 0 };
+	unsigned char *buffer = NULL;
+	unsigned char *prefix = NULL;
+	size_t prefix_size = 0;
+	size_t prefix_lines = 0;
+	size_t parsed_count = 0;
+	size_t old_count;
+	size_t new_count;
+	size_t slice_start;
+	size_t slice_end;
+	size_t first;
+	size_t last;
+	size_t i;
+	ptrdiff_t delta;
+	ptrdiff_t line_delta;
+	int error;
+
+	assert(documents && count); /* Non-NULL documents array is expected. */
+	assert(input || !size);
+	assert(edit && edit->start <= edit->end); /* Valid edit is expected. */
+
+	old_documents = *documents;
+	old_count = *count;
+	delta = (ptrdiff_t)edit->length - (ptrdiff_t)(edit->end - edit->start);
+
+	/* Find the documents whose spans, up to the start of the next one, touch the edit. */
+	first = old_count;
+	last = 0;
+	for (i = 0; i < old_count; i++) {
+		size_t start = i ? old_documents[i].start_mark.index : 0;
+		size_t next = i + 1 < old_count ? old_documents[i + 1].start_mark.index : (size_t)-1;
+
+		if (start <= edit->end && next >= edit->start) {
+			if (first == old_count)
+				first = i;
+			last = i;
+		}
+	}
+	if (first == old_count) {
+		first = 0;
+		last = old_count ? old_count - 1 : 0;
+	}
+
+	if (first) {
+		base = old_documents[first].start_mark;
+		error = yaml_reload_prefix_(old_documents, first, &prefix, &prefix_size, &prefix_lines);
+		if (error)
+			return error;
+	}
+	slice_start = base.index;
+	slice_end = last + 1 < old_count
+		? (size_t)((ptrdiff_t)old_documents[last + 1].start_mark.index + delta) : size;
+	if (slice_start > slice_end || slice_end > size) {
+		YAML_FREE(prefix);
+		return YAML_EFAILD;
+	}
+
+	/* Parse the slice behind the directives it depends on. */
+	buffer = (unsigned char *)YAML_MALLOC(prefix_size + (slice_end - slice_start) + 1);
+	if (!buffer) {
+		YAML_FREE(prefix);
+		return YAML_EMEMORY;
+	}
+	if (prefix_size)
+		memcpy(buffer, prefix, prefix_size);
+	memcpy(buffer + prefix_size, input + slice_start, slice_end - slice_start);
+	YAML_FREE(prefix);
+
+	error = yaml_reload_parse_(buffer, prefix_size + (slice_end - slice_start), &parsed, &parsed_count);
+	YAML_FREE(buffer);
+	if (error)
+		return error;
+
+	/* Drop the empty document ending the prefix. */
+	if (prefix_size) {
+		assert(parsed_count); /* The prefix document is expected. */
+		yaml_document_destroy(parsed);
+		memmove(parsed, parsed + 1, --parsed_count * sizeof(yaml_document_t));
+	}
+	for (i = 0; i < parsed_count; i++)
+		yaml_reload_rebase_(parsed + i, &base, prefix_size, prefix_lines);
+
+	/* Splice the parsed documents in place of the affected ones. */
+	if (!old_count)
+		last = 0, first = 0;
+	new_count = old_count ? old_count - (last - first + 1) + parsed_count : parsed_count;
+	new_documents = (yaml_document_t *)YAML_MALLOC((new_count ? new_count : 1) * sizeof(yaml_document_t));
+	if (!new_documents) {
+		for (i = 0; i < parsed_count; i++)
+			yaml_document_destroy(parsed + i);
+		YAML_FREE(parsed);
+		return YAML_EMEMORY;
+	}
+
+	if (old_count) {
+		line_delta = last + 1 < old_count
+			? (ptrdiff_t)(base.line + yaml_reload_count_breaks_(input + slice_start, slice_end - slice_start))
+				- (ptrdiff_t)old_documents[last + 1].start_mark.line
+			: 0;
+
+		memcpy(new_documents, old_documents, first * sizeof(yaml_document_t));
+		for (i = first; i <= last; i++)
+			yaml_document_destroy(old_documents + i);
+		for (i = last + 1; i < old_count; i++) {
+			yaml_reload_shift_(old_documents + i, delta, line_delta);
+			new_documents[first + parsed_count + i - last - 1] = old_documents[i];
+		}
+	}
+	if (parsed_count)
+		memcpy(new_documents + first, parsed, parsed_count * sizeof(yaml_document_t));
+
+	YAML_FREE(parsed);
+	YAML_FREE(old_documents);
+	*documents = new_documents;
+	*count = new_count;
+
+	return YAML_EOK;
+}
@@ -0,0 +1,287 @@
+#include <stdlib.h>
+#include <math.h>
+#include "yaml_private.h"
+
+/* Powers of ten exactly representable as a double.
+ */
+static const double yaml_resolve_pow10_[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define YAML_IS_DIGIT(c)	((c) >= '0' && (c) <= '9')
+
+/* Compare a value with a NUL terminated literal.
+ */
+#define YAML_RESOLVE_IS(value, length, literal) \
+	((length) == sizeof(literal) - 1 && !memcmp((value), (literal), sizeof(literal) - 1))
+
+static int yaml_resolve_null_(const yaml_char_t *value, size_t length) {
+	return !length
+		|| YAML_RESOLVE_IS(value, length, "~")
+		|| YAML_RESOLVE_IS(value, length, "null")
+		|| YAML_RESOLVE_IS(value, length, "Null")
+		|| YAML_RESOLVE_IS(value, length, "NULL");
+}
+
+static int yaml_resolve_bool_(const yaml_char_t *value, size_t length, int *boolean) {
+	if (YAML_RESOLVE_IS(value, length, "true")
+			|| YAML_RESOLVE_IS(value, length, "True")
+			|| YAML_RESOLVE_IS(value, length, "TRUE")) {
+		*boolean = 1;
+		return 1;
+	}
+	if (YAML_RESOLVE_IS(value, length, "false")
+			|| YAML_RESOLVE_IS(value, length, "False")
+			|| YAML_RESOLVE_IS(value, length, "FALSE")) {
+		*boolean = 0;
+		return 1;
+	}
+	return 0;
+}
+
+static int yaml_resolve_hex_digit_(yaml_char_t c) {
+	if (YAML_IS_DIGIT(c))
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+/* Parse [-+]?[0-9]+, 0o[0-7]+ or 0x[0-9a-fA-F]+.
+ * Returns 0 if the value is not an integer. Values outside of int64_t set
+ * overflow and are returned as a double in real.
+ */
+static int yaml_resolve_int_(const yaml_char_t *value, size_t length,
+		int64_t *integer, double *real, int *overflow) {
+	const yaml_char_t *pointer = value;
+	const yaml_char_t *end = value + length;
+	uint64_t limit = INT64_MAX;
+	uint64_t result = 0;
+	int negative = 0;
+	int base = 10;
+	int digit;
+
+	*overflow = 0;
+	if (pointer == end)
+		return 0;
+
+	if (length > 2 && pointer[0] == '0' && (pointer[1] == 'x' || pointer[1] == 'o')) {
+		base = pointer[1] == 'x' ? 16 : 8;
+		pointer += 2;
+	}
+	else if (*pointer == '-' || *pointer == '+') {
+		negative = *pointer++ == '-';
+		if (pointer == end)
+			return 0;
+		if (negative)
+			limit = (uint64_t)INT64_MAX + 1;
+	}
+
+	for (; pointer != end; pointer++) {
+		digit = yaml_resolve_hex_digit_(*pointer);
+		if (digit < 0 || digit >= base)
+			return 0;
+
+		if (!*overflow && result > (limit - digit) / base) {
+			*overflow = 1;
+			*real = (double)result;
+		}
+		if (*overflow)
+			*real = *real * base + digit;
+		else
+			result = result * base + digit;
+	}
+
+	if (*overflow) {
+		/* Decimals are rounded correctly by strtod(), the value is NUL terminated. */
+		if (base == 10)
+			*real = strtod((const char *)value, NULL);
+		else if (negative)
+			*real = -*real;
+	}
+	else if (negative)
+		*integer = result == (uint64_t)INT64_MAX + 1 ? INT64_MIN : -(int64_t)result;
+	else
+		*integer = (int64_t)result;
+
+	return 1;
+}
+
+/* Parse [-+]?(\.[0-9]+|[0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)? and the
+ * infinity and not-a-number forms.
+ * Short decimals are converted exactly with one multiplication or division
+ * by a power of ten (Clinger's fast path), the rest falls back to strtod().
+ */
+static int yaml_resolve_float_(const yaml_char_t *value, size_t length, double *real) {
+	const yaml_char_t *pointer = value;
+	const yaml_char_t *end = value + length;
+	uint64_t mantissa = 0;
+	int significant = 0;
+	int exponent = 0;
+	int fraction = 0;
+	int digits = 0;
+	int negative = 0;
+
+	if (pointer != end && (*pointer == '-' || *pointer == '+'))
+		negative = *pointer++ == '-';
+
+	if (YAML_RESOLVE_IS(pointer, (size_t)(end - pointer), ".inf")
+			|| YAML_RESOLVE_IS(pointer, (size_t)(end - pointer), ".Inf")
+			|| YAML_RESOLVE_IS(pointer, (size_t)(end - pointer), ".INF")) {
+		*real = negative ? -HUGE_VAL : HUGE_VAL;
+		return 1;
+	}
+	if (pointer == value && (YAML_RESOLVE_IS(value, length, ".nan")
+			|| YAML_RESOLVE_IS(value, length, ".NaN")
+			|| YAML_RESOLVE_IS(value, length, ".NAN"))) {
+		*real = NAN;
+		return 1;
+	}
+
+	for (; pointer != end && YAML_IS_DIGIT(*pointer); pointer++, digits++) {
+		if (significant || *pointer != '0') {
+			if (significant < 19)
+				mantissa = mantissa * 10 + (*pointer - '0');
+			else
+				exponent++;
+			significant++;
+		}
+	}
+	if (pointer != end && *pointer == '.') {
+		for (pointer++; pointer != end && YAML_IS_DIGIT(*pointer); pointer++, fraction++) {
+			if (significant || *pointer != '0') {
+				if (significant < 19) {
+					mantissa = mantissa * 10 + (*pointer - '0');
+					exponent--;
+				}
+				significant++;
+			}
+			else
+				exponent--;
+		}
+		/* At least one digit, before or after the point. */
+		if (!digits && !fraction)
+			return 0;
+	}
+	else if (!digits)
+		return 0;
+
+	if (pointer != end && (*pointer == 'e' || *pointer == 'E')) {
+		int exponent_negative = 0;
+		int value_exponent = 0;
+
+		pointer++;
+		if (pointer != end && (*pointer == '-' || *pointer == '+'))
+			exponent_negative = *pointer++ == '-';
+		if (pointer == end)
+			return 0;
+		for (; pointer != end && YAML_IS_DIGIT(*pointer); pointer++) {
+			if (value_exponent < 100000)
+				value_exponent = value_exponent * 10 + (*pointer - '0');
+		}
+		exponent += exponent_negative ? -value_exponent : value_exponent;
+	}
+	if (pointer != end)
+		return 0;
+
+	if (significant <= 19 && mantissa <= ((uint64_t)1 << 53)
+			&& exponent >= -22 && exponent <= 22) {
+		*real = (double)mantissa;
+		if (exponent < 0)
+			*real /= yaml_resolve_pow10_[-exponent];
+		else
+			*real *= yaml_resolve_pow10_[exponent];
+		if (negative)
+			*real = -*real;
+		return 1;
+	}
+
+	/* The syntax is checked, the value is NUL terminated. */
+	*real = strtod((const char *)value, NULL);
+	return 1;
+}
+
+int yaml_node_resolve(yaml_node_t *node) {
+	const yaml_char_t *value;
+	size_t length;
+	int implicit;
+	int overflow;
+	int resolved = YAML_RESOLVE_STR;
+
+	assert(node); /* Non-NULL node object is expected. */
+
+	if (node->type != YAML_NSTYLE_SCALAR)
+		return YAML_RESOLVE_NONE;
+	if (node->data.scalar.resolved)
+		return node->data.scalar.resolved;
+
+	value = node->data.scalar.value;
+	length = node->data.scalar.length;
+
+	/* Only plain scalars without an explicit tag are resolved by value,
+	 * a node filled in without any tag counts as one. */
+	implicit = (!node->tag_id || (node->tag_id == YAML_TAG_ID_STR && node->data.scalar.implicit))
+		&& (node->data.scalar.style == YAML_SCALAR_ANY || node->data.scalar.style == YAML_SCALAR_PLAIN);
+
+	if ((implicit || node->tag_id == YAML_TAG_ID_NULL) && yaml_resolve_null_(value, length))
+		resolved = YAML_RESOLVE_NULL;
+	else if ((implicit || node->tag_id == YAML_TAG_ID_BOOL)
+			&& yaml_resolve_bool_(value, length, &node->data.scalar.typed.boolean))
+		resolved = YAML_RESOLVE_BOOL;
+	else if ((implicit || node->tag_id == YAML_TAG_ID_INT || node->tag_id == YAML_TAG_ID_FLOAT)
+			&& yaml_resolve_int_(value, length, &node->data.scalar.typed.integer,
+				&node->data.scalar.typed.real, &overflow)) {
+		if (overflow)
+			resolved = YAML_RESOLVE_FLOAT;
+		else if (node->tag_id == YAML_TAG_ID_FLOAT) {
+			node->data.scalar.typed.real = (double)node->data.scalar.typed.integer;
+			resolved = YAML_RESOLVE_FLOAT;
+		}
+		else
+			resolved = YAML_RESOLVE_INT;
+	}
+	else if ((implicit || node->tag_id == YAML_TAG_ID_FLOAT)
+			&& yaml_resolve_float_(value, length, &node->data.scalar.typed.real))
+		resolved = YAML_RESOLVE_FLOAT;
+
+	node->data.scalar.resolved = resolved;
+	return resolved;
+}
+
+int yaml_node_as_int64(yaml_node_t *node, int64_t *value) {
+	assert(value); /* Non-NULL value is expected. */
+
+	if (yaml_node_resolve(node) != YAML_RESOLVE_INT)
+		return YAML_EFAILD;
+
+	*value = node->data.scalar.typed.integer;
+	return YAML_EOK;
+}
+
+int yaml_node_as_double(yaml_node_t *node, double *value) {
+	assert(value); /* Non-NULL value is expected. */
+
+	switch (yaml_node_resolve(node)) {
+	case YAML_RESOLVE_INT:
+		*value = (double)node->data.scalar.typed.integer;
+		return YAML_EOK;
+	case YAML_RESOLVE_FLOAT:
+		*value = node->data.scalar.typed.real;
+		return YAML_EOK;
+	default:
+		return YAML_EFAILD;
+	}
+}
+
+int yaml_node_as_bool(yaml_node_t *node, int *value) {
+	assert(value); /* Non-NULL value is expected. */
+
+	if (yaml_node_resolve(node) != YAML_RESOLVE_BOOL)
+		return YAML_EFAILD;
+
+	*value = node->data.scalar.typed.boolean;
+	return YAML_EOK;
+}
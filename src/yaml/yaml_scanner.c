@@ -472,39 +472,2059 @@
 
 #include "yaml_private.h"
 
-/* Ensure that the buffer contains the required number of characters.
- * Return YAML_E_OK on success.
+/* Character classes of the buffer at an octet offset from the pointer.
+ * Only the first octet of a character is checked before the next ones, the
+ * reader never splits a character, so the checks stay in the buffer.
  */
-//#define YAML_CACHE(parser, length) \
-//			(parser->unread >= (length) ? \
-//			YAML_E_OK : \ 
-//			yaml_parser_update_buffer(parser, (length)))
+#define YAML_SCANNER_CHECK(parser, octet, offset) \
+	((parser)->buffer.pointer[offset] == (yaml_char_t)(octet))
+
+#define YAML_SCANNER_IS_ALPHA(parser, offset) \
+	(((parser)->buffer.pointer[offset] >= '0' && (parser)->buffer.pointer[offset] <= '9') \
+	 || ((parser)->buffer.pointer[offset] >= 'A' && (parser)->buffer.pointer[offset] <= 'Z') \
+	 || ((parser)->buffer.pointer[offset] >= 'a' && (parser)->buffer.pointer[offset] <= 'z') \
+	 || (parser)->buffer.pointer[offset] == '_' || (parser)->buffer.pointer[offset] == '-')
+
+#define YAML_SCANNER_IS_DIGIT(parser, offset) \
+	((parser)->buffer.pointer[offset] >= '0' && (parser)->buffer.pointer[offset] <= '9')
+
+#define YAML_SCANNER_AS_DIGIT(parser, offset) ((parser)->buffer.pointer[offset] - '0')
+
+#define YAML_SCANNER_IS_HEX(parser, offset) \
+	(YAML_SCANNER_IS_DIGIT(parser, offset) \
+	 || ((parser)->buffer.pointer[offset] >= 'A' && (parser)->buffer.pointer[offset] <= 'F') \
+	 || ((parser)->buffer.pointer[offset] >= 'a' && (parser)->buffer.pointer[offset] <= 'f'))
+
+#define YAML_SCANNER_AS_HEX(parser, offset) \
+	((parser)->buffer.pointer[offset] >= 'a' ? (parser)->buffer.pointer[offset] - 'a' + 10 : \
+	 (parser)->buffer.pointer[offset] >= 'A' ? (parser)->buffer.pointer[offset] - 'A' + 10 : \
+	 (parser)->buffer.pointer[offset] - '0')
+
+#define YAML_SCANNER_IS_BOM(parser) \
+	(YAML_SCANNER_CHECK(parser, 0xEF, 0) && YAML_SCANNER_CHECK(parser, 0xBB, 1) \
+	 && YAML_SCANNER_CHECK(parser, 0xBF, 2))
+
+#define YAML_SCANNER_IS_BLANK(parser, offset) \
+	(YAML_SCANNER_CHECK(parser, ' ', offset) || YAML_SCANNER_CHECK(parser, '\t', offset))
+
+#define YAML_SCANNER_IS_BREAK(parser, offset) \
+	(YAML_SCANNER_CHECK(parser, '\r', offset) || YAML_SCANNER_CHECK(parser, '\n', offset) \
+	 || (YAML_SCANNER_CHECK(parser, 0xC2, offset) && YAML_SCANNER_CHECK(parser, 0x85, (offset) + 1)) \
+	 || (YAML_SCANNER_CHECK(parser, 0xE2, offset) && YAML_SCANNER_CHECK(parser, 0x80, (offset) + 1) \
+		&& (YAML_SCANNER_CHECK(parser, 0xA8, (offset) + 2) || YAML_SCANNER_CHECK(parser, 0xA9, (offset) + 2))))
+
+#define YAML_SCANNER_IS_Z(parser, offset) YAML_SCANNER_CHECK(parser, '\0', offset)
+
+#define YAML_SCANNER_IS_BREAKZ(parser, offset) \
+	(YAML_SCANNER_IS_BREAK(parser, offset) || YAML_SCANNER_IS_Z(parser, offset))
+
+#define YAML_SCANNER_IS_BLANKZ(parser, offset) \
+	(YAML_SCANNER_IS_BLANK(parser, offset) || YAML_SCANNER_IS_BREAKZ(parser, offset))
+
+/* Check for a document start or end marker at the start of a line.
+ */
+#define YAML_SCANNER_IS_DOCUMENT_INDICATOR(parser) \
+	((parser)->mark.column == 0 \
+	 && ((YAML_SCANNER_CHECK(parser, '-', 0) && YAML_SCANNER_CHECK(parser, '-', 1) \
+			&& YAML_SCANNER_CHECK(parser, '-', 2)) \
+		|| (YAML_SCANNER_CHECK(parser, '.', 0) && YAML_SCANNER_CHECK(parser, '.', 1) \
+			&& YAML_SCANNER_CHECK(parser, '.', 2))) \
+	 && YAML_SCANNER_IS_BLANKZ(parser, 3))
+
+/* A growable string the scanned values are built in.
+ * The octets past the pointer are always zero, so the value is NUL terminated.
+ */
+typedef struct {
+	yaml_char_t *start;
+	yaml_char_t *end;
+	yaml_char_t *pointer;
+} yaml_string_t;
+
+static int yaml_string_init_(yaml_string_t *string) {
+	string->start = (yaml_char_t *)YAML_MALLOC(YAML_INITIAL_STRING_SIZE);
+	if (!string->start)
+		return YAML_EMEMORY;
+	memset(string->start, 0, YAML_INITIAL_STRING_SIZE);
+	string->pointer = string->start;
+	string->end = string->start + YAML_INITIAL_STRING_SIZE;
+	return YAML_EOK;
+}
+
+static void yaml_string_destroy_(yaml_string_t *string) {
+	YAML_FREE(string->start);
+	string->start = string->end = string->pointer = NULL;
+}
+
+/* Make room for length more octets and the terminating NUL.
+ */
+static int yaml_string_reserve_(yaml_string_t *string, size_t length) {
+	size_t size = string->end - string->start;
+	size_t used = string->pointer - string->start;
+	size_t new_size = size;
+	yaml_char_t *start;
+
+	if (used + length < size)
+		return YAML_EOK;
+
+	while (used + length >= new_size)
+		new_size *= 2;
+	start = (yaml_char_t *)YAML_REALLOC(string->start, new_size);
+	if (!start)
+		return YAML_EMEMORY;
+	memset(start + size, 0, new_size - size);
+
+	string->start = start;
+	string->pointer = start + used;
+	string->end = start + new_size;
+	return YAML_EOK;
+}
+
+static void yaml_string_clear_(yaml_string_t *string) {
+	memset(string->start, 0, string->pointer - string->start);
+	string->pointer = string->start;
+}
+
+/* Append a string to another one, clearing the appended one.
+ */
+static int yaml_string_join_(yaml_string_t *string, yaml_string_t *other) {
+	size_t length = other->pointer - other->start;
+
+	if (!length)
+		return YAML_EOK;
+	if (yaml_string_reserve_(string, length))
+		return YAML_EMEMORY;
+	memcpy(string->pointer, other->start, length);
+	string->pointer += length;
+	yaml_string_clear_(other);
+	return YAML_EOK;
+}
+
+/* Set the scanner error and return YAML_ESCANNER.
+ */
+static int yaml_parser_set_scanner_error_(yaml_parser_t *parser, const char *context,
+		yaml_mark_t context_mark, const char *problem) {
+	parser->error = YAML_ESCANNER;
+	parser->context = context;
+	parser->context_mark = context_mark;
+	parser->problem = problem;
+	parser->problem_mark = parser->mark;
+	return YAML_ESCANNER;
+}
+
+static int yaml_parser_set_memory_error_(yaml_parser_t *parser) {
+	parser->error = YAML_EMEMORY;
+	return YAML_EMEMORY;
+}
+
+/* Advance the buffer pointer over a character, the marks count octets so
+ * they slice the UTF-8 input as it is.
+ */
+static void yaml_parser_skip_(yaml_parser_t *parser) {
+	size_t width = YAML_UTF8_WIDTH(parser->buffer.pointer[0]);
+
+	parser->mark.index += width;
+	parser->mark.column++;
+	parser->unread--;
+	parser->buffer.pointer += width;
+}
+
+static void yaml_parser_skip_line_(yaml_parser_t *parser) {
+	if (YAML_SCANNER_CHECK(parser, '\r', 0) && YAML_SCANNER_CHECK(parser, '\n', 1)) {
+		parser->mark.index += 2;
+		parser->mark.column = 0;
+		parser->mark.line++;
+		parser->unread -= 2;
+		parser->buffer.pointer += 2;
+	}
+	else if (YAML_SCANNER_IS_BREAK(parser, 0)) {
+		size_t width = YAML_UTF8_WIDTH(parser->buffer.pointer[0]);
+
+		parser->mark.index += width;
+		parser->mark.column = 0;
+		parser->mark.line++;
+		parser->unread--;
+		parser->buffer.pointer += width;
+	}
+}
+
+/* Copy a character to a string and advance the buffer pointer.
+ */
+static int yaml_parser_read_(yaml_parser_t *parser, yaml_string_t *string) {
+	size_t width = YAML_UTF8_WIDTH(parser->buffer.pointer[0]);
+
+	if (yaml_string_reserve_(string, width))
+		return yaml_parser_set_memory_error_(parser);
+	memcpy(string->pointer, parser->buffer.pointer, width);
+	string->pointer += width;
+	parser->mark.index += width;
+	parser->mark.column++;
+	parser->unread--;
+	parser->buffer.pointer += width;
+	return YAML_EOK;
+}
+
+/* Copy a line break to a string, CR LF, CR, LF and NEL becoming LF.
+ */
+static int yaml_parser_read_line_(yaml_parser_t *parser, yaml_string_t *string) {
+	const yaml_char_t *pointer = parser->buffer.pointer;
+	size_t width;
+
+	if (yaml_string_reserve_(string, 3))
+		return yaml_parser_set_memory_error_(parser);
+
+	if (pointer[0] == '\r' && pointer[1] == '\n') {
+		*(string->pointer++) = '\n';
+		parser->unread--;
+		width = 2;
+	}
+	else if (pointer[0] == '\r' || pointer[0] == '\n') {
+		*(string->pointer++) = '\n';
+		width = 1;
+	}
+	else if (pointer[0] == 0xC2 && pointer[1] == 0x85) {
+		*(string->pointer++) = '\n';
+		width = 2;
+	}
+	else if (pointer[0] == 0xE2 && pointer[1] == 0x80 && (pointer[2] == 0xA8 || pointer[2] == 0xA9)) {
+		memcpy(string->pointer, pointer, 3);
+		string->pointer += 3;
+		width = 3;
+	}
+	else
+		return YAML_EOK;
+
+	parser->mark.index += width;
+	parser->mark.column = 0;
+	parser->mark.line++;
+	parser->unread--;
+	parser->buffer.pointer += width;
+	return YAML_EOK;
+}
+
+/* Queue a token, destroying it if the queue cannot grow.
+ */
+static int yaml_parser_enqueue_(yaml_parser_t *parser, yaml_token_t *token) {
+	int error;
+
+	YAML_QUEUE_ENQUEUE(&error, &parser->tokens, yaml_token_t, *token);
+	if (error) {
+		yaml_token_destroy(token);
+		return yaml_parser_set_memory_error_(parser);
+	}
+	return YAML_EOK;
+}
+
+static int yaml_parser_fetch_next_token_(yaml_parser_t *parser);
 
 int yaml_parser_scan(yaml_parser_t *parser, yaml_token_t *token) {
-	assert(parser && token);
-	
+	int error;
+
+	assert(parser); /* Non-NULL parser object is expected. */
+	assert(token); /* Non-NULL token object is expected. */
+
 	/* Erase the token object. */
 	memset(token, 0, sizeof(yaml_token_t));
 
 	/* No tokens after STREAM-END or error. */
-	if (parser->stream_end_produced || parser->error)
-		return YAML_E_FAILD;
+	if (parser->error)
+		return parser->error;
+	if (parser->stream_end_produced)
+		return YAML_EOK;
 
 	/* Ensure that the tokens queue contains enough tokens. */
 	if (!parser->token_available) {
-		if (yaml_parser_fetch_more_tokens(parser))
-			return 0;
+		error = yaml_parser_fetch_more_tokens(parser);
+		if (error)
+			return error;
 	}
 
 	/* Fetch the next token from the queue. */
-
-	*token = DEQUEUE(parser, parser->tokens);
+	*token = YAML_QUEUE_DEQUEUE(&parser->tokens);
 	parser->token_available = 0;
 	parser->tokens_parsed++;
-
-	if (token->type == YAML_STREAM_END_TOKEN) {
+	if (token->type == YAML_TOKEN_STREAM_END)
 		parser->stream_end_produced = 1;
+
+	return YAML_EOK;
+}
+
+/* Check the simple keys that cannot be keys any more: a simple key is
+ * limited to a single line and 1024 octets.
+ */
+static int yaml_parser_stale_simple_keys_(yaml_parser_t *parser) {
+	yaml_simple_key_t *simple_key;
+
+	for (simple_key = parser->simple_keys.start; simple_key != parser->simple_keys.top; simple_key++) {
+		if (simple_key->possible && (simple_key->mark.line < parser->mark.line
+				|| simple_key->mark.index + 1024 < parser->mark.index)) {
+			if (simple_key->required)
+				return yaml_parser_set_scanner_error_(parser, "while scanning a simple key",
+					simple_key->mark, "could not find expected ':'");
+			simple_key->possible = 0;
+		}
+	}
+
+	return YAML_EOK;
+}
+
+int yaml_parser_fetch_more_tokens(yaml_parser_t *parser) {
+#if defined(YAML_STATS)
+	size_t capacity = parser->tokens.end - parser->tokens.start;
+	size_t head = parser->tokens.head - parser->tokens.start;
+#endif
+	yaml_simple_key_t *simple_key;
+	int need_more_tokens;
+	int error;
+
+	YAML_STATS_BEGIN(parser, mark);
+	for (;;) {
+		/* The queue is empty, or its head may still get a KEY before it. */
+		need_more_tokens = parser->tokens.head == parser->tokens.tail;
+		if (!need_more_tokens) {
+			error = yaml_parser_stale_simple_keys_(parser);
+			if (error)
+				break;
+
+			for (simple_key = parser->simple_keys.start; simple_key != parser->simple_keys.top; simple_key++) {
+				if (simple_key->possible && simple_key->token_number == parser->tokens_parsed) {
+					need_more_tokens = 1;
+					break;
+				}
+			}
+		}
+
+		error = YAML_EOK;
+		if (!need_more_tokens)
+			break;
+
+		error = yaml_parser_fetch_next_token_(parser);
+		if (error)
+			break;
+	}
+	YAML_STATS_END(parser, YAML_STATS_SCANNER, mark);
+
+#if defined(YAML_STATS)
+	/* The queue only ever doubles, and moves to its start when it does not. */
+	for (; capacity < (size_t)(parser->tokens.end - parser->tokens.start); capacity *= 2)
+		parser->stats.token_queue_extends++;
+	if ((size_t)(parser->tokens.head - parser->tokens.start) < head)
+		parser->stats.token_queue_moves++;
+#endif
+
+	if (!error)
+		parser->token_available = 1;
+	return error;
+}
+
+/* Drop the possible simple key of the current flow level.
+ */
+static int yaml_parser_remove_simple_key_(yaml_parser_t *parser) {
+	yaml_simple_key_t *simple_key = parser->simple_keys.top - 1;
+
+	if (simple_key->possible && simple_key->required)
+		return yaml_parser_set_scanner_error_(parser, "while scanning a simple key",
+			simple_key->mark, "could not find expected ':'");
+
+	simple_key->possible = 0;
+	return YAML_EOK;
+}
+
+/* Remember a possible simple key at the current position.
+ */
+static int yaml_parser_save_simple_key_(yaml_parser_t *parser) {
+	yaml_simple_key_t simple_key;
+	int error;
+
+	if (!parser->simple_key_allowed)
+		return YAML_EOK;
+
+	/* A simple key is required in the block context at the indentation column. */
+	simple_key.possible = 1;
+	simple_key.required = !parser->flow_level && parser->indent == (int)parser->mark.column;
+	simple_key.token_number = parser->tokens_parsed + (parser->tokens.tail - parser->tokens.head);
+	simple_key.mark = parser->mark;
+
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+	*(parser->simple_keys.top - 1) = simple_key;
+	YAML_STATS_ADD(parser, simple_key_saves, 1);
+
+	return YAML_EOK;
+}
+
+static int yaml_parser_increase_flow_level_(yaml_parser_t *parser) {
+	yaml_simple_key_t empty_simple_key = { 0, 0, 0, { 0, 0, 0 } };
+	int error;
+
+	YAML_STACK_PUSH(&error, &parser->simple_keys, yaml_simple_key_t, empty_simple_key);
+	if (error)
+		return yaml_parser_set_memory_error_(parser);
+
+	parser->flow_level++;
+	return YAML_EOK;
+}
+
+static void yaml_parser_decrease_flow_level_(yaml_parser_t *parser) {
+	if (parser->flow_level) {
+		parser->flow_level--;
+		(void)YAML_STACK_POP(&parser->simple_keys);
+	}
+}
+
+/* Push the indentation level and queue a block collection start when the
+ * column is deeper than the current one. number is the position of the
+ * token to insert before, -1 to append it.
+ */
+static int yaml_parser_roll_indent_(yaml_parser_t *parser, ptrdiff_t column, ptrdiff_t number,
+		int type, yaml_mark_t mark) {
+	yaml_token_t token;
+	int error;
+
+	/* In the flow context, do nothing. */
+	if (parser->flow_level)
+		return YAML_EOK;
+
+	if (parser->indent < column) {
+		YAML_STACK_PUSH(&error, &parser->indents, int, parser->indent);
+		if (error)
+			return yaml_parser_set_memory_error_(parser);
+
+		parser->indent = (int)column;
+
+		YAML_TOKEN_INIT(&token, type, mark, mark);
+		if (number == -1)
+			return yaml_parser_enqueue_(parser, &token);
+
+		YAML_QUEUE_INSERT(&error, &parser->tokens, (size_t)(number - parser->tokens_parsed), yaml_token_t, token);
+		if (error)
+			return yaml_parser_set_memory_error_(parser);
+	}
+
+	return YAML_EOK;
+}
+
+/* Pop the indentation levels deeper than the column, queueing a BLOCK-END
+ * for each of them.
+ */
+static int yaml_parser_unroll_indent_(yaml_parser_t *parser, ptrdiff_t column) {
+	yaml_token_t token;
+	int error;
+
+	/* In the flow context, do nothing. */
+	if (parser->flow_level)
+		return YAML_EOK;
+
+	while (parser->indent > column) {
+		YAML_TOKEN_INIT(&token, YAML_TOKEN_BLOCK_END, parser->mark, parser->mark);
+		error = yaml_parser_enqueue_(parser, &token);
+		if (error)
+			return error;
+
+		parser->indent = YAML_STACK_POP(&parser->indents);
+	}
+
+	return YAML_EOK;
+}
+
+static int yaml_parser_fetch_stream_start_(yaml_parser_t *parser) {
+	yaml_simple_key_t simple_key = { 0, 0, 0, { 0, 0, 0 } };
+	yaml_token_t token;
+	int error;
+
+	/* Set the initial indentation and the simple key of the block context. */
+	parser->indent = -1;
+	YAML_STACK_PUSH(&error, &parser->simple_keys, yaml_simple_key_t, simple_key);
+	if (error)
+		return yaml_parser_set_memory_error_(parser);
+
+	/* A simple key is allowed at the beginning of the stream. */
+	parser->simple_key_allowed = 1;
+	parser->stream_start_produced = 1;
+
+	YAML_TOKEN_STREAM_START_INIT(&token, parser->encoding, parser->mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_stream_end_(yaml_parser_t *parser) {
+	yaml_token_t token;
+	int error;
+
+	/* Force a new line. */
+	if (parser->mark.column != 0) {
+		parser->mark.column = 0;
+		parser->mark.line++;
+	}
+
+	error = yaml_parser_unroll_indent_(parser, -1);
+	if (error)
+		return error;
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 0;
+
+	YAML_TOKEN_STREAM_END_INIT(&token, parser->mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_scan_directive_(yaml_parser_t *parser, yaml_token_t *token);
+
+static int yaml_parser_fetch_directive_(yaml_parser_t *parser) {
+	yaml_token_t token;
+	int error;
+
+	/* Directives end the block collections and the simple keys. */
+	error = yaml_parser_unroll_indent_(parser, -1);
+	if (error)
+		return error;
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 0;
+
+	error = yaml_parser_scan_directive_(parser, &token);
+	if (error)
+		return error;
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_document_indicator_(yaml_parser_t *parser, int type) {
+	yaml_mark_t start_mark;
+	yaml_token_t token;
+	int error;
+
+	error = yaml_parser_unroll_indent_(parser, -1);
+	if (error)
+		return error;
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 0;
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+	yaml_parser_skip_(parser);
+	yaml_parser_skip_(parser);
+
+	YAML_TOKEN_INIT(&token, type, start_mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_flow_collection_start_(yaml_parser_t *parser, int type) {
+	yaml_mark_t start_mark;
+	yaml_token_t token;
+	int error;
+
+	/* '[' and '{' may start a simple key. */
+	error = yaml_parser_save_simple_key_(parser);
+	if (error)
+		return error;
+	error = yaml_parser_increase_flow_level_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 1;
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	YAML_TOKEN_INIT(&token, type, start_mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_flow_collection_end_(yaml_parser_t *parser, int type) {
+	yaml_mark_t start_mark;
+	yaml_token_t token;
+	int error;
+
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+	yaml_parser_decrease_flow_level_(parser);
+	parser->simple_key_allowed = 0;
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	YAML_TOKEN_INIT(&token, type, start_mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_flow_entry_(yaml_parser_t *parser) {
+	yaml_mark_t start_mark;
+	yaml_token_t token;
+	int error;
+
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 1;
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	YAML_TOKEN_INIT(&token, YAML_TOKEN_FLOW_ENTRY, start_mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_block_entry_(yaml_parser_t *parser) {
+	yaml_mark_t start_mark;
+	yaml_token_t token;
+	int error;
+
+	if (!parser->flow_level) {
+		if (!parser->simple_key_allowed)
+			return yaml_parser_set_scanner_error_(parser, NULL, parser->mark,
+				"block sequence entries are not allowed in this context");
+
+		error = yaml_parser_roll_indent_(parser, parser->mark.column, -1,
+			YAML_TOKEN_BLOCK_SEQUENCE_START, parser->mark);
+		if (error)
+			return error;
+	}
+	/* In the flow context the parser reports the '-' as an error. */
+
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 1;
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	YAML_TOKEN_INIT(&token, YAML_TOKEN_BLOCK_ENTRY, start_mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_key_(yaml_parser_t *parser) {
+	yaml_mark_t start_mark;
+	yaml_token_t token;
+	int error;
+
+	if (!parser->flow_level) {
+		if (!parser->simple_key_allowed)
+			return yaml_parser_set_scanner_error_(parser, NULL, parser->mark,
+				"mapping keys are not allowed in this context");
+
+		error = yaml_parser_roll_indent_(parser, parser->mark.column, -1,
+			YAML_TOKEN_BLOCK_MAPPING_START, parser->mark);
+		if (error)
+			return error;
+	}
+
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+
+	/* A simple key is allowed after '?' in the block context. */
+	parser->simple_key_allowed = !parser->flow_level;
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	YAML_TOKEN_INIT(&token, YAML_TOKEN_KEY, start_mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_value_(yaml_parser_t *parser) {
+	yaml_simple_key_t *simple_key = parser->simple_keys.top - 1;
+	yaml_mark_t start_mark;
+	yaml_token_t token;
+	int error;
+
+	if (simple_key->possible) {
+		/* Insert the KEY token before the tokens of the simple key. */
+		YAML_TOKEN_INIT(&token, YAML_TOKEN_KEY, simple_key->mark, simple_key->mark);
+		YAML_QUEUE_INSERT(&error, &parser->tokens, simple_key->token_number - parser->tokens_parsed,
+			yaml_token_t, token);
+		if (error)
+			return yaml_parser_set_memory_error_(parser);
+
+		/* And the BLOCK-MAPPING-START before it, if needed. */
+		error = yaml_parser_roll_indent_(parser, simple_key->mark.column, simple_key->token_number,
+			YAML_TOKEN_BLOCK_MAPPING_START, simple_key->mark);
+		if (error)
+			return error;
+
+		simple_key->possible = 0;
+		parser->simple_key_allowed = 0;
+	}
+	else {
+		/* The ':' indicator follows a complex key. */
+		if (!parser->flow_level) {
+			if (!parser->simple_key_allowed)
+				return yaml_parser_set_scanner_error_(parser, NULL, parser->mark,
+					"mapping values are not allowed in this context");
+
+			error = yaml_parser_roll_indent_(parser, parser->mark.column, -1,
+				YAML_TOKEN_BLOCK_MAPPING_START, parser->mark);
+			if (error)
+				return error;
+		}
+
+		/* A simple key is allowed after ':' in the block context. */
+		parser->simple_key_allowed = !parser->flow_level;
+	}
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	YAML_TOKEN_INIT(&token, YAML_TOKEN_VALUE, start_mark, parser->mark);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_scan_anchor_(yaml_parser_t *parser, yaml_token_t *token, int type);
+static int yaml_parser_scan_tag_(yaml_parser_t *parser, yaml_token_t *token);
+static int yaml_parser_scan_block_scalar_(yaml_parser_t *parser, yaml_token_t *token, int literal);
+static int yaml_parser_scan_flow_scalar_(yaml_parser_t *parser, yaml_token_t *token, int single);
+static int yaml_parser_scan_plain_scalar_(yaml_parser_t *parser, yaml_token_t *token);
+
+static int yaml_parser_fetch_anchor_(yaml_parser_t *parser, int type) {
+	yaml_token_t token;
+	int error;
+
+	/* An anchor or an alias may start a simple key. */
+	error = yaml_parser_save_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 0;
+
+	error = yaml_parser_scan_anchor_(parser, &token, type);
+	if (error)
+		return error;
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_tag_(yaml_parser_t *parser) {
+	yaml_token_t token;
+	int error;
+
+	/* A tag may start a simple key. */
+	error = yaml_parser_save_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 0;
+
+	error = yaml_parser_scan_tag_(parser, &token);
+	if (error)
+		return error;
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_block_scalar_(yaml_parser_t *parser, int literal) {
+	yaml_token_t token;
+	int error;
+
+	/* A simple key may follow a block scalar. */
+	error = yaml_parser_remove_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 1;
+
+	error = yaml_parser_scan_block_scalar_(parser, &token, literal);
+	if (error)
+		return error;
+	YAML_STATS_ADD(parser, scalars[token.data.scalar.style], 1);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_flow_scalar_(yaml_parser_t *parser, int single) {
+	yaml_token_t token;
+	int error;
+
+	/* A quoted scalar may be a simple key. */
+	error = yaml_parser_save_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 0;
+
+	error = yaml_parser_scan_flow_scalar_(parser, &token, single);
+	if (error)
+		return error;
+	YAML_STATS_ADD(parser, scalars[token.data.scalar.style], 1);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+static int yaml_parser_fetch_plain_scalar_(yaml_parser_t *parser) {
+	yaml_token_t token;
+	int error;
+
+	/* A plain scalar may be a simple key. */
+	error = yaml_parser_save_simple_key_(parser);
+	if (error)
+		return error;
+	parser->simple_key_allowed = 0;
+
+	error = yaml_parser_scan_plain_scalar_(parser, &token);
+	if (error)
+		return error;
+	YAML_STATS_ADD(parser, scalars[token.data.scalar.style], 1);
+	return yaml_parser_enqueue_(parser, &token);
+}
+
+/* Skip the whitespaces, comments and line breaks before the next token.
+ */
+static int yaml_parser_scan_to_next_token_(yaml_parser_t *parser) {
+	int error;
+
+	for (;;) {
+		error = YAML_PARSER_CACHE(parser, 1);
+		if (error)
+			return error;
+
+		/* A BOM may start any line. */
+		if (parser->mark.column == 0 && YAML_SCANNER_IS_BOM(parser))
+			yaml_parser_skip_(parser);
+
+		/* Tabs are whitespace only where no simple key may start, that is
+		 * in the flow context and after the block indicators. */
+		error = YAML_PARSER_CACHE(parser, 1);
+		if (error)
+			return error;
+		while (YAML_SCANNER_CHECK(parser, ' ', 0)
+				|| ((parser->flow_level || !parser->simple_key_allowed) && YAML_SCANNER_CHECK(parser, '\t', 0))) {
+			yaml_parser_skip_(parser);
+			error = YAML_PARSER_CACHE(parser, 1);
+			if (error)
+				return error;
+		}
+
+		if (YAML_SCANNER_CHECK(parser, '#', 0)) {
+			while (!YAML_SCANNER_IS_BREAKZ(parser, 0)) {
+				yaml_parser_skip_(parser);
+				error = YAML_PARSER_CACHE(parser, 1);
+				if (error)
+					return error;
+			}
+		}
+
+		if (!YAML_SCANNER_IS_BREAK(parser, 0))
+			break;
+
+		error = YAML_PARSER_CACHE(parser, 2);
+		if (error)
+			return error;
+		yaml_parser_skip_line_(parser);
+
+		/* A simple key may start at a new line in the block context. */
+		if (!parser->flow_level)
+			parser->simple_key_allowed = 1;
+	}
+
+	return YAML_EOK;
+}
+
+static int yaml_parser_fetch_next_token_(yaml_parser_t *parser) {
+	int error;
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		return error;
+
+	if (!parser->stream_start_produced)
+		return yaml_parser_fetch_stream_start_(parser);
+
+	error = yaml_parser_scan_to_next_token_(parser);
+	if (error)
+		return error;
+	error = yaml_parser_stale_simple_keys_(parser);
+	if (error)
+		return error;
+	error = yaml_parser_unroll_indent_(parser, parser->mark.column);
+	if (error)
+		return error;
+
+	/* The longest indicator, '--- ', needs 4 characters. */
+	error = YAML_PARSER_CACHE(parser, 4);
+	if (error)
+		return error;
+
+	if (YAML_SCANNER_IS_Z(parser, 0))
+		return yaml_parser_fetch_stream_end_(parser);
+
+	if (parser->mark.column == 0 && YAML_SCANNER_CHECK(parser, '%', 0))
+		return yaml_parser_fetch_directive_(parser);
+
+	if (YAML_SCANNER_IS_DOCUMENT_INDICATOR(parser))
+		return yaml_parser_fetch_document_indicator_(parser,
+			YAML_SCANNER_CHECK(parser, '-', 0) ? YAML_TOKEN_DOCUMENT_START : YAML_TOKEN_DOCUMENT_END);
+
+	switch (parser->buffer.pointer[0]) {
+	case '[':
+		return yaml_parser_fetch_flow_collection_start_(parser, YAML_TOKEN_FLOW_SEQUENCE_START);
+	case '{':
+		return yaml_parser_fetch_flow_collection_start_(parser, YAML_TOKEN_FLOW_MAPPING_START);
+	case ']':
+		return yaml_parser_fetch_flow_collection_end_(parser, YAML_TOKEN_FLOW_SEQUENCE_END);
+	case '}':
+		return yaml_parser_fetch_flow_collection_end_(parser, YAML_TOKEN_FLOW_MAPPING_END);
+	case ',':
+		return yaml_parser_fetch_flow_entry_(parser);
+	case '-':
+		if (YAML_SCANNER_IS_BLANKZ(parser, 1))
+			return yaml_parser_fetch_block_entry_(parser);
+		break;
+	case '?':
+		if (parser->flow_level || YAML_SCANNER_IS_BLANKZ(parser, 1))
+			return yaml_parser_fetch_key_(parser);
+		break;
+	case ':':
+		if (parser->flow_level || YAML_SCANNER_IS_BLANKZ(parser, 1))
+			return yaml_parser_fetch_value_(parser);
+		break;
+	case '*':
+		return yaml_parser_fetch_anchor_(parser, YAML_TOKEN_ALIAS);
+	case '&':
+		return yaml_parser_fetch_anchor_(parser, YAML_TOKEN_ANCHOR);
+	case '!':
+		return yaml_parser_fetch_tag_(parser);
+	case '|':
+		if (!parser->flow_level)
+			return yaml_parser_fetch_block_scalar_(parser, 1);
+		break;
+	case '>':
+		if (!parser->flow_level)
+			return yaml_parser_fetch_block_scalar_(parser, 0);
+		break;
+	case '\'':
+		return yaml_parser_fetch_flow_scalar_(parser, 1);
+	case '"':
+		return yaml_parser_fetch_flow_scalar_(parser, 0);
+	default:
+		break;
+	}
+
+	/* A plain scalar starts with any non-space character but the indicators.
+	 * '-', '?' and ':' start it too when a non-space follows, the last two
+	 * only in the block context. */
+	if (!(YAML_SCANNER_IS_BLANKZ(parser, 0) || YAML_SCANNER_CHECK(parser, '-', 0)
+			|| YAML_SCANNER_CHECK(parser, '?', 0) || YAML_SCANNER_CHECK(parser, ':', 0)
+			|| YAML_SCANNER_CHECK(parser, ',', 0) || YAML_SCANNER_CHECK(parser, '[', 0)
+			|| YAML_SCANNER_CHECK(parser, ']', 0) || YAML_SCANNER_CHECK(parser, '{', 0)
+			|| YAML_SCANNER_CHECK(parser, '}', 0) || YAML_SCANNER_CHECK(parser, '#', 0)
+			|| YAML_SCANNER_CHECK(parser, '&', 0) || YAML_SCANNER_CHECK(parser, '*', 0)
+			|| YAML_SCANNER_CHECK(parser, '!', 0) || YAML_SCANNER_CHECK(parser, '|', 0)
+			|| YAML_SCANNER_CHECK(parser, '>', 0) || YAML_SCANNER_CHECK(parser, '\'', 0)
+			|| YAML_SCANNER_CHECK(parser, '"', 0) || YAML_SCANNER_CHECK(parser, '%', 0)
+			|| YAML_SCANNER_CHECK(parser, '@', 0) || YAML_SCANNER_CHECK(parser, '`', 0))
+			|| (YAML_SCANNER_CHECK(parser, '-', 0) && !YAML_SCANNER_IS_BLANK(parser, 1))
+			|| (!parser->flow_level && (YAML_SCANNER_CHECK(parser, '?', 0) || YAML_SCANNER_CHECK(parser, ':', 0))
+				&& !YAML_SCANNER_IS_BLANKZ(parser, 1)))
+		return yaml_parser_fetch_plain_scalar_(parser);
+
+	return yaml_parser_set_scanner_error_(parser, "while scanning for the next token",
+		parser->mark, "found character that cannot start any token");
+}
+
+static int yaml_parser_scan_directive_name_(yaml_parser_t *parser, yaml_mark_t start_mark,
+		yaml_char_t **name) {
+	yaml_string_t string;
+	int error;
+
+	if (yaml_string_init_(&string))
+		return yaml_parser_set_memory_error_(parser);
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	while (!error && YAML_SCANNER_IS_ALPHA(parser, 0)) {
+		error = yaml_parser_read_(parser, &string);
+		if (!error)
+			error = YAML_PARSER_CACHE(parser, 1);
+	}
+	if (error)
+		goto ERROR;
+
+	if (string.start == string.pointer) {
+		error = yaml_parser_set_scanner_error_(parser, "while scanning a directive",
+			start_mark, "could not find expected directive name");
+		goto ERROR;
+	}
+	if (!YAML_SCANNER_IS_BLANKZ(parser, 0)) {
+		error = yaml_parser_set_scanner_error_(parser, "while scanning a directive",
+			start_mark, "found unexpected non-alphabetical character");
+		goto ERROR;
+	}
+
+	*name = string.start;
+	return YAML_EOK;
+
+ERROR:
+	yaml_string_destroy_(&string);
+	return error;
+}
+
+static int yaml_parser_scan_version_directive_number_(yaml_parser_t *parser, yaml_mark_t start_mark,
+		int *number) {
+	size_t length = 0;
+	int value = 0;
+	int error;
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		return error;
+
+	while (YAML_SCANNER_IS_DIGIT(parser, 0)) {
+		/* Check if the number is too long. */
+		if (++length > 9)
+			return yaml_parser_set_scanner_error_(parser, "while scanning a %YAML directive",
+				start_mark, "found extremely long version number");
+
+		value = value * 10 + YAML_SCANNER_AS_DIGIT(parser, 0);
+		yaml_parser_skip_(parser);
+		error = YAML_PARSER_CACHE(parser, 1);
+		if (error)
+			return error;
 	}
 
-	return 1;
-}
\ No newline at end of file
+	if (!length)
+		return yaml_parser_set_scanner_error_(parser, "while scanning a %YAML directive",
+			start_mark, "did not find expected version number");
+
+	*number = value;
+	return YAML_EOK;
+}
+
+static int yaml_parser_scan_version_directive_value_(yaml_parser_t *parser, yaml_mark_t start_mark,
+		int *major, int *minor) {
+	int error;
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	while (!error && YAML_SCANNER_IS_BLANK(parser, 0)) {
+		yaml_parser_skip_(parser);
+		error = YAML_PARSER_CACHE(parser, 1);
+	}
+	if (error)
+		return error;
+
+	error = yaml_parser_scan_version_directive_number_(parser, start_mark, major);
+	if (error)
+		return error;
+
+	if (!YAML_SCANNER_CHECK(parser, '.', 0))
+		return yaml_parser_set_scanner_error_(parser, "while scanning a %YAML directive",
+			start_mark, "did not find expected digit or '.' character");
+	yaml_parser_skip_(parser);
+
+	return yaml_parser_scan_version_directive_number_(parser, start_mark, minor);
+}
+
+static int yaml_parser_scan_tag_handle_(yaml_parser_t *parser, int directive,
+		yaml_mark_t start_mark, yaml_char_t **handle);
+static int yaml_parser_scan_tag_uri_(yaml_parser_t *parser, int uri_char, int directive,
+		const yaml_char_t *head, yaml_mark_t start_mark, yaml_char_t **uri);
+
+static int yaml_parser_scan_tag_directive_value_(yaml_parser_t *parser, yaml_mark_t start_mark,
+		yaml_char_t **handle, yaml_char_t **prefix) {
+	yaml_char_t *handle_value = NULL;
+	yaml_char_t *prefix_value = NULL;
+	int error;
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	while (!error && YAML_SCANNER_IS_BLANK(parser, 0)) {
+		yaml_parser_skip_(parser);
+		error = YAML_PARSER_CACHE(parser, 1);
+	}
+	if (error)
+		return error;
+
+	error = yaml_parser_scan_tag_handle_(parser, 1, start_mark, &handle_value);
+	if (error)
+		return error;
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		goto ERROR;
+	if (!YAML_SCANNER_IS_BLANK(parser, 0)) {
+		error = yaml_parser_set_scanner_error_(parser, "while scanning a %TAG directive",
+			start_mark, "did not find expected whitespace");
+		goto ERROR;
+	}
+	while (!error && YAML_SCANNER_IS_BLANK(parser, 0)) {
+		yaml_parser_skip_(parser);
+		error = YAML_PARSER_CACHE(parser, 1);
+	}
+	if (error)
+		goto ERROR;
+
+	error = yaml_parser_scan_tag_uri_(parser, 1, 1, NULL, start_mark, &prefix_value);
+	if (error)
+		goto ERROR;
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		goto ERROR;
+	if (!YAML_SCANNER_IS_BLANKZ(parser, 0)) {
+		error = yaml_parser_set_scanner_error_(parser, "while scanning a %TAG directive",
+			start_mark, "did not find expected whitespace or line break");
+		goto ERROR;
+	}
+
+	*handle = handle_value;
+	*prefix = prefix_value;
+	return YAML_EOK;
+
+ERROR:
+	YAML_FREE(handle_value);
+	YAML_FREE(prefix_value);
+	return error;
+}
+
+static int yaml_parser_scan_directive_(yaml_parser_t *parser, yaml_token_t *token) {
+	yaml_mark_t start_mark, end_mark;
+	yaml_char_t *name = NULL;
+	yaml_char_t *handle = NULL;
+	yaml_char_t *prefix = NULL;
+	int major, minor;
+	int error;
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	error = yaml_parser_scan_directive_name_(parser, start_mark, &name);
+	if (error)
+		return error;
+
+	if (!strcmp((char *)name, "YAML")) {
+		error = yaml_parser_scan_version_directive_value_(parser, start_mark, &major, &minor);
+		if (error)
+			goto ERROR;
+		end_mark = parser->mark;
+		YAML_TOKEN_VERSION_DIRECTIVE_INIT(token, major, minor, start_mark, end_mark);
+	}
+	else if (!strcmp((char *)name, "TAG")) {
+		error = yaml_parser_scan_tag_directive_value_(parser, start_mark, &handle, &prefix);
+		if (error)
+			goto ERROR;
+		end_mark = parser->mark;
+		YAML_TOKEN_TAG_DIRECTIVE_INIT(token, handle, prefix, start_mark, end_mark);
+	}
+	else {
+		error = yaml_parser_set_scanner_error_(parser, "while scanning a directive",
+			start_mark, "found unknown directive name");
+		goto ERROR;
+	}
+
+	/* Eat the rest of the line including any comments. */
+	error = YAML_PARSER_CACHE(parser, 1);
+	while (!error && YAML_SCANNER_IS_BLANK(parser, 0)) {
+		yaml_parser_skip_(parser);
+		error = YAML_PARSER_CACHE(parser, 1);
+	}
+	if (!error && YAML_SCANNER_CHECK(parser, '#', 0)) {
+		while (!error && !YAML_SCANNER_IS_BREAKZ(parser, 0)) {
+			yaml_parser_skip_(parser);
+			error = YAML_PARSER_CACHE(parser, 1);
+		}
+	}
+	if (error)
+		goto TOKEN_ERROR;
+
+	if (!YAML_SCANNER_IS_BREAKZ(parser, 0)) {
+		error = yaml_parser_set_scanner_error_(parser, "while scanning a directive",
+			start_mark, "did not find expected comment or line break");
+		goto TOKEN_ERROR;
+	}
+	if (YAML_SCANNER_IS_BREAK(parser, 0)) {
+		error = YAML_PARSER_CACHE(parser, 2);
+		if (error)
+			goto TOKEN_ERROR;
+		yaml_parser_skip_line_(parser);
+	}
+
+	YAML_FREE(name);
+	return YAML_EOK;
+
+TOKEN_ERROR:
+	yaml_token_destroy(token);
+ERROR:
+	YAML_FREE(name);
+	return error;
+}
+
+static int yaml_parser_scan_anchor_(yaml_parser_t *parser, yaml_token_t *token, int type) {
+	yaml_mark_t start_mark;
+	yaml_string_t string;
+	int error;
+
+	if (yaml_string_init_(&string))
+		return yaml_parser_set_memory_error_(parser);
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	while (!error && YAML_SCANNER_IS_ALPHA(parser, 0)) {
+		error = yaml_parser_read_(parser, &string);
+		if (!error)
+			error = YAML_PARSER_CACHE(parser, 1);
+	}
+	if (error)
+		goto ERROR;
+
+	/* An anchor or an alias ends where a token may start. */
+	if (string.start == string.pointer
+			|| !(YAML_SCANNER_IS_BLANKZ(parser, 0) || YAML_SCANNER_CHECK(parser, '?', 0)
+				|| YAML_SCANNER_CHECK(parser, ':', 0) || YAML_SCANNER_CHECK(parser, ',', 0)
+				|| YAML_SCANNER_CHECK(parser, ']', 0) || YAML_SCANNER_CHECK(parser, '}', 0)
+				|| YAML_SCANNER_CHECK(parser, '%', 0) || YAML_SCANNER_CHECK(parser, '@', 0)
+				|| YAML_SCANNER_CHECK(parser, '`', 0))) {
+		error = yaml_parser_set_scanner_error_(parser,
+			type == YAML_TOKEN_ANCHOR ? "while scanning an anchor" : "while scanning an alias",
+			start_mark, "did not find expected alphabetic or numeric character");
+		goto ERROR;
+	}
+
+	if (type == YAML_TOKEN_ANCHOR)
+		YAML_TOKEN_ANCHOR_INIT(token, string.start, start_mark, parser->mark);
+	else
+		YAML_TOKEN_ALIAS_INIT(token, string.start, start_mark, parser->mark);
+	return YAML_EOK;
+
+ERROR:
+	yaml_string_destroy_(&string);
+	return error;
+}
+
+static int yaml_parser_scan_tag_(yaml_parser_t *parser, yaml_token_t *token) {
+	yaml_char_t *handle = NULL;
+	yaml_char_t *suffix = NULL;
+	yaml_mark_t start_mark;
+	int error;
+
+	start_mark = parser->mark;
+
+	error = YAML_PARSER_CACHE(parser, 2);
+	if (error)
+		return error;
+
+	if (YAML_SCANNER_CHECK(parser, '<', 1)) {
+		/* A verbatim tag, !<uri>, has an empty handle. */
+		handle = (yaml_char_t *)YAML_MALLOC(1);
+		if (!handle)
+			return yaml_parser_set_memory_error_(parser);
+		handle[0] = '\0';
+
+		yaml_parser_skip_(parser);
+		yaml_parser_skip_(parser);
+
+		error = yaml_parser_scan_tag_uri_(parser, 1, 0, NULL, start_mark, &suffix);
+		if (error)
+			goto ERROR;
+
+		if (!YAML_SCANNER_CHECK(parser, '>', 0)) {
+			error = yaml_parser_set_scanner_error_(parser, "while scanning a tag",
+				start_mark, "did not find the expected '>'");
+			goto ERROR;
+		}
+		yaml_parser_skip_(parser);
+	}
+	else {
+		/* The tag is either '!suffix' or '!handle!suffix'. */
+		error = yaml_parser_scan_tag_handle_(parser, 0, start_mark, &handle);
+		if (error)
+			goto ERROR;
+
+		if (handle[0] == '!' && handle[1] != '\0' && handle[strlen((char *)handle) - 1] == '!') {
+			error = yaml_parser_scan_tag_uri_(parser, 0, 0, NULL, start_mark, &suffix);
+			if (error)
+				goto ERROR;
+		}
+		else {
+			/* What looked like a handle is the start of the suffix. */
+			error = yaml_parser_scan_tag_uri_(parser, 0, 0, handle, start_mark, &suffix);
+			if (error)
+				goto ERROR;
+
+			handle[0] = '!';
+			handle[1] = '\0';
+
+			/* The tag '!' alone is the non-specific tag, its handle is empty. */
+			if (suffix[0] == '\0') {
+				yaml_char_t *tmp = handle;
+
+				handle = suffix;
+				suffix = tmp;
+			}
+		}
+	}
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		goto ERROR;
+	if (!YAML_SCANNER_IS_BLANKZ(parser, 0)
+			&& (!parser->flow_level || !YAML_SCANNER_CHECK(parser, ',', 0))) {
+		error = yaml_parser_set_scanner_error_(parser, "while scanning a tag",
+			start_mark, "did not find expected whitespace or line break");
+		goto ERROR;
+	}
+
+	YAML_TOKEN_TAG_INIT(token, handle, suffix, start_mark, parser->mark);
+	return YAML_EOK;
+
+ERROR:
+	YAML_FREE(handle);
+	YAML_FREE(suffix);
+	return error;
+}
+
+static int yaml_parser_scan_tag_handle_(yaml_parser_t *parser, int directive,
+		yaml_mark_t start_mark, yaml_char_t **handle) {
+	yaml_string_t string;
+	int error;
+
+	if (yaml_string_init_(&string))
+		return yaml_parser_set_memory_error_(parser);
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		goto ERROR;
+
+	if (!YAML_SCANNER_CHECK(parser, '!', 0)) {
+		error = yaml_parser_set_scanner_error_(parser,
+			directive ? "while scanning a tag directive" : "while scanning a tag",
+			start_mark, "did not find expected '!'");
+		goto ERROR;
+	}
+
+	error = yaml_parser_read_(parser, &string);
+	if (!error)
+		error = YAML_PARSER_CACHE(parser, 1);
+	while (!error && YAML_SCANNER_IS_ALPHA(parser, 0)) {
+		error = yaml_parser_read_(parser, &string);
+		if (!error)
+			error = YAML_PARSER_CACHE(parser, 1);
+	}
+	if (error)
+		goto ERROR;
+
+	if (YAML_SCANNER_CHECK(parser, '!', 0)) {
+		error = yaml_parser_read_(parser, &string);
+		if (error)
+			goto ERROR;
+	}
+	else if (directive && !(string.start[0] == '!' && string.start[1] == '\0')) {
+		/* A tag handle of a directive is '!', '!!' or '!word!'; in a tag the
+		 * '!word' part is the start of the suffix. */
+		error = yaml_parser_set_scanner_error_(parser, "while parsing a tag directive",
+			start_mark, "did not find expected '!'");
+		goto ERROR;
+	}
+
+	*handle = string.start;
+	return YAML_EOK;
+
+ERROR:
+	yaml_string_destroy_(&string);
+	return error;
+}
+
+/* Decode a run of %-escaped octets forming one UTF-8 character.
+ */
+static int yaml_parser_scan_uri_escapes_(yaml_parser_t *parser, int directive,
+		yaml_mark_t start_mark, yaml_string_t *string) {
+	const char *context = directive ? "while parsing a %TAG directive" : "while parsing a tag";
+	int width = 0;
+	int error;
+
+	do {
+		yaml_char_t octet;
+
+		error = YAML_PARSER_CACHE(parser, 3);
+		if (error)
+			return error;
+
+		if (!(YAML_SCANNER_CHECK(parser, '%', 0) && YAML_SCANNER_IS_HEX(parser, 1)
+				&& YAML_SCANNER_IS_HEX(parser, 2)))
+			return yaml_parser_set_scanner_error_(parser, context, start_mark,
+				"did not find URI escaped octet");
+
+		octet = (yaml_char_t)((YAML_SCANNER_AS_HEX(parser, 1) << 4) + YAML_SCANNER_AS_HEX(parser, 2));
+
+		if (!width) {
+			width = (octet & 0x80) == 0x00 ? 1 : (octet & 0xE0) == 0xC0 ? 2 :
+				(octet & 0xF0) == 0xE0 ? 3 : (octet & 0xF8) == 0xF0 ? 4 : 0;
+			if (!width)
+				return yaml_parser_set_scanner_error_(parser, context, start_mark,
+					"found an incorrect leading UTF-8 octet");
+		}
+		else if ((octet & 0xC0) != 0x80)
+			return yaml_parser_set_scanner_error_(parser, context, start_mark,
+				"found an incorrect trailing UTF-8 octet");
+
+		if (yaml_string_reserve_(string, 1))
+			return yaml_parser_set_memory_error_(parser);
+		*(string->pointer++) = octet;
+
+		yaml_parser_skip_(parser);
+		yaml_parser_skip_(parser);
+		yaml_parser_skip_(parser);
+	} while (--width);
+
+	return YAML_EOK;
+}
+
+/* Scan a tag URI. The flow indicators ',', '[' and ']' belong to the URI of
+ * a directive or a verbatim tag only; a shorthand tag ends before them.
+ */
+static int yaml_parser_scan_tag_uri_(yaml_parser_t *parser, int uri_char, int directive,
+		const yaml_char_t *head, yaml_mark_t start_mark, yaml_char_t **uri) {
+	size_t length = head ? strlen((const char *)head) : 0;
+	yaml_string_t string;
+	int error;
+
+	if (yaml_string_init_(&string))
+		return yaml_parser_set_memory_error_(parser);
+
+	/* Copy the head, without its leading '!'. */
+	if (length > 1) {
+		if (yaml_string_reserve_(&string, length - 1)) {
+			error = yaml_parser_set_memory_error_(parser);
+			goto ERROR;
+		}
+		memcpy(string.pointer, head + 1, length - 1);
+		string.pointer += length - 1;
+	}
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		goto ERROR;
+
+	while (YAML_SCANNER_IS_ALPHA(parser, 0) || YAML_SCANNER_CHECK(parser, ';', 0)
+			|| YAML_SCANNER_CHECK(parser, '/', 0) || YAML_SCANNER_CHECK(parser, '?', 0)
+			|| YAML_SCANNER_CHECK(parser, ':', 0) || YAML_SCANNER_CHECK(parser, '@', 0)
+			|| YAML_SCANNER_CHECK(parser, '&', 0) || YAML_SCANNER_CHECK(parser, '=', 0)
+			|| YAML_SCANNER_CHECK(parser, '+', 0) || YAML_SCANNER_CHECK(parser, '$', 0)
+			|| YAML_SCANNER_CHECK(parser, '.', 0) || YAML_SCANNER_CHECK(parser, '%', 0)
+			|| YAML_SCANNER_CHECK(parser, '!', 0) || YAML_SCANNER_CHECK(parser, '~', 0)
+			|| YAML_SCANNER_CHECK(parser, '*', 0) || YAML_SCANNER_CHECK(parser, '\'', 0)
+			|| YAML_SCANNER_CHECK(parser, '(', 0) || YAML_SCANNER_CHECK(parser, ')', 0)
+			|| (uri_char && (YAML_SCANNER_CHECK(parser, ',', 0)
+				|| YAML_SCANNER_CHECK(parser, '[', 0) || YAML_SCANNER_CHECK(parser, ']', 0)))) {
+		if (YAML_SCANNER_CHECK(parser, '%', 0))
+			error = yaml_parser_scan_uri_escapes_(parser, directive, start_mark, &string);
+		else
+			error = yaml_parser_read_(parser, &string);
+		if (!error)
+			error = YAML_PARSER_CACHE(parser, 1);
+		if (error)
+			goto ERROR;
+		length++;
+	}
+
+	if (!length) {
+		error = yaml_parser_set_scanner_error_(parser,
+			directive ? "while parsing a %TAG directive" : "while parsing a tag",
+			start_mark, "did not find expected tag URI");
+		goto ERROR;
+	}
+
+	*uri = string.start;
+	return YAML_EOK;
+
+ERROR:
+	yaml_string_destroy_(&string);
+	return error;
+}
+
+/* Scan the indentation spaces and the line breaks before the content of a
+ * block scalar, finding its indentation if it is not given.
+ */
+static int yaml_parser_scan_block_scalar_breaks_(yaml_parser_t *parser, int *indent,
+		yaml_string_t *breaks, yaml_mark_t start_mark, yaml_mark_t *end_mark) {
+	int max_indent = 0;
+	int error;
+
+	*end_mark = parser->mark;
+
+	for (;;) {
+		error = YAML_PARSER_CACHE(parser, 1);
+		while (!error && (!*indent || (int)parser->mark.column < *indent)
+				&& YAML_SCANNER_CHECK(parser, ' ', 0)) {
+			yaml_parser_skip_(parser);
+			error = YAML_PARSER_CACHE(parser, 1);
+		}
+		if (error)
+			return error;
+
+		if ((int)parser->mark.column > max_indent)
+			max_indent = (int)parser->mark.column;
+
+		if ((!*indent || (int)parser->mark.column < *indent) && YAML_SCANNER_CHECK(parser, '\t', 0))
+			return yaml_parser_set_scanner_error_(parser, "while scanning a block scalar",
+				start_mark, "found a tab character where an indentation space is expected");
+
+		if (!YAML_SCANNER_IS_BREAK(parser, 0))
+			break;
+
+		error = YAML_PARSER_CACHE(parser, 2);
+		if (!error)
+			error = yaml_parser_read_line_(parser, breaks);
+		if (error)
+			return error;
+		*end_mark = parser->mark;
+	}
+
+	/* Without an indentation indicator the first non-empty line sets it. */
+	if (!*indent) {
+		*indent = max_indent;
+		if (*indent < parser->indent + 1)
+			*indent = parser->indent + 1;
+		if (*indent < 1)
+			*indent = 1;
+	}
+
+	return YAML_EOK;
+}
+
+static int yaml_parser_scan_block_scalar_(yaml_parser_t *parser, yaml_token_t *token, int literal) {
+	yaml_mark_t start_mark, end_mark;
+	yaml_string_t string = { NULL, NULL, NULL };
+	yaml_string_t leading_break = { NULL, NULL, NULL };
+	yaml_string_t trailing_breaks = { NULL, NULL, NULL };
+	int chomping = 0;
+	int increment = 0;
+	int indent = 0;
+	int leading_blank = 0;
+	int trailing_blank = 0;
+	int error;
+
+	if (yaml_string_init_(&string) || yaml_string_init_(&leading_break)
+			|| yaml_string_init_(&trailing_breaks)) {
+		error = yaml_parser_set_memory_error_(parser);
+		goto ERROR;
+	}
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	/* The chomping and indentation indicators, in any order. */
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		goto ERROR;
+
+	if (YAML_SCANNER_CHECK(parser, '+', 0) || YAML_SCANNER_CHECK(parser, '-', 0)) {
+		chomping = YAML_SCANNER_CHECK(parser, '+', 0) ? +1 : -1;
+		yaml_parser_skip_(parser);
+
+		error = YAML_PARSER_CACHE(parser, 1);
+		if (error)
+			goto ERROR;
+		if (YAML_SCANNER_IS_DIGIT(parser, 0)) {
+			if (YAML_SCANNER_CHECK(parser, '0', 0)) {
+				error = yaml_parser_set_scanner_error_(parser, "while scanning a block scalar",
+					start_mark, "found an indentation indicator equal to 0");
+				goto ERROR;
+			}
+			increment = YAML_SCANNER_AS_DIGIT(parser, 0);
+			yaml_parser_skip_(parser);
+		}
+	}
+	else if (YAML_SCANNER_IS_DIGIT(parser, 0)) {
+		if (YAML_SCANNER_CHECK(parser, '0', 0)) {
+			error = yaml_parser_set_scanner_error_(parser, "while scanning a block scalar",
+				start_mark, "found an indentation indicator equal to 0");
+			goto ERROR;
+		}
+		increment = YAML_SCANNER_AS_DIGIT(parser, 0);
+		yaml_parser_skip_(parser);
+
+		error = YAML_PARSER_CACHE(parser, 1);
+		if (error)
+			goto ERROR;
+		if (YAML_SCANNER_CHECK(parser, '+', 0) || YAML_SCANNER_CHECK(parser, '-', 0)) {
+			chomping = YAML_SCANNER_CHECK(parser, '+', 0) ? +1 : -1;
+			yaml_parser_skip_(parser);
+		}
+	}
+
+	/* Eat the whitespaces and the comment up to the line break. */
+	error = YAML_PARSER_CACHE(parser, 1);
+	while (!error && YAML_SCANNER_IS_BLANK(parser, 0)) {
+		yaml_parser_skip_(parser);
+		error = YAML_PARSER_CACHE(parser, 1);
+	}
+	if (!error && YAML_SCANNER_CHECK(parser, '#', 0)) {
+		while (!error && !YAML_SCANNER_IS_BREAKZ(parser, 0)) {
+			yaml_parser_skip_(parser);
+			error = YAML_PARSER_CACHE(parser, 1);
+		}
+	}
+	if (error)
+		goto ERROR;
+
+	if (!YAML_SCANNER_IS_BREAKZ(parser, 0)) {
+		error = yaml_parser_set_scanner_error_(parser, "while scanning a block scalar",
+			start_mark, "did not find expected comment or line break");
+		goto ERROR;
+	}
+	if (YAML_SCANNER_IS_BREAK(parser, 0)) {
+		error = YAML_PARSER_CACHE(parser, 2);
+		if (error)
+			goto ERROR;
+		yaml_parser_skip_line_(parser);
+	}
+
+	end_mark = parser->mark;
+
+	if (increment)
+		indent = parser->indent >= 0 ? parser->indent + increment : increment;
+
+	error = yaml_parser_scan_block_scalar_breaks_(parser, &indent, &trailing_breaks, start_mark, &end_mark);
+	if (error)
+		goto ERROR;
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	if (error)
+		goto ERROR;
+
+	while ((int)parser->mark.column == indent && !YAML_SCANNER_IS_Z(parser, 0)) {
+		/* A folded line break becomes a space unless more indented or empty lines follow. */
+		trailing_blank = YAML_SCANNER_IS_BLANK(parser, 0);
+
+		if (!literal && leading_break.start[0] == '\n' && !leading_blank && !trailing_blank) {
+			if (trailing_breaks.start[0] == '\0') {
+				if (yaml_string_reserve_(&string, 1)) {
+					error = yaml_parser_set_memory_error_(parser);
+					goto ERROR;
+				}
+				*(string.pointer++) = ' ';
+			}
+			yaml_string_clear_(&leading_break);
+		}
+		else if (yaml_string_join_(&string, &leading_break)) {
+			error = yaml_parser_set_memory_error_(parser);
+			goto ERROR;
+		}
+
+		if (yaml_string_join_(&string, &trailing_breaks)) {
+			error = yaml_parser_set_memory_error_(parser);
+			goto ERROR;
+		}
+
+		leading_blank = YAML_SCANNER_IS_BLANK(parser, 0);
+
+		/* The current line. */
+		while (!YAML_SCANNER_IS_BREAKZ(parser, 0)) {
+			error = yaml_parser_read_(parser, &string);
+			if (!error)
+				error = YAML_PARSER_CACHE(parser, 1);
+			if (error)
+				goto ERROR;
+		}
+
+		error = YAML_PARSER_CACHE(parser, 2);
+		if (!error)
+			error = yaml_parser_read_line_(parser, &leading_break);
+		if (!error)
+			error = yaml_parser_scan_block_scalar_breaks_(parser, &indent, &trailing_breaks,
+				start_mark, &end_mark);
+		if (error)
+			goto ERROR;
+	}
+
+	/* Chomp the tail. */
+	if (chomping != -1 && yaml_string_join_(&string, &leading_break)) {
+		error = yaml_parser_set_memory_error_(parser);
+		goto ERROR;
+	}
+	if (chomping == 1 && yaml_string_join_(&string, &trailing_breaks)) {
+		error = yaml_parser_set_memory_error_(parser);
+		goto ERROR;
+	}
+
+	YAML_TOKEN_SCALAR_INIT(token, string.start, string.pointer - string.start,
+		literal ? YAML_SCALAR_LITERAL : YAML_SCALAR_FOLDED, start_mark, end_mark);
+
+	yaml_string_destroy_(&leading_break);
+	yaml_string_destroy_(&trailing_breaks);
+	return YAML_EOK;
+
+ERROR:
+	yaml_string_destroy_(&string);
+	yaml_string_destroy_(&leading_break);
+	yaml_string_destroy_(&trailing_breaks);
+	return error;
+}
+
+/* Write a Unicode code point as UTF-8.
+ */
+static void yaml_string_put_utf8_(yaml_string_t *string, unsigned int value) {
+	if (value <= 0x7F)
+		*(string->pointer++) = (yaml_char_t)value;
+	else if (value <= 0x7FF) {
+		*(string->pointer++) = (yaml_char_t)(0xC0 + (value >> 6));
+		*(string->pointer++) = (yaml_char_t)(0x80 + (value & 0x3F));
+	}
+	else if (value <= 0xFFFF) {
+		*(string->pointer++) = (yaml_char_t)(0xE0 + (value >> 12));
+		*(string->pointer++) = (yaml_char_t)(0x80 + ((value >> 6) & 0x3F));
+		*(string->pointer++) = (yaml_char_t)(0x80 + (value & 0x3F));
+	}
+	else {
+		*(string->pointer++) = (yaml_char_t)(0xF0 + (value >> 18));
+		*(string->pointer++) = (yaml_char_t)(0x80 + ((value >> 12) & 0x3F));
+		*(string->pointer++) = (yaml_char_t)(0x80 + ((value >> 6) & 0x3F));
+		*(string->pointer++) = (yaml_char_t)(0x80 + (value & 0x3F));
+	}
+}
+
+/* Scan an escape sequence of a double-quoted scalar, the '\' included.
+ */
+static int yaml_parser_scan_escape_(yaml_parser_t *parser, yaml_mark_t start_mark, yaml_string_t *string) {
+	size_t code_length = 0;
+	unsigned int value = 0;
+	size_t k;
+	int error;
+
+	if (yaml_string_reserve_(string, 4))
+		return yaml_parser_set_memory_error_(parser);
+
+	switch (parser->buffer.pointer[1]) {
+	case '0': *(string->pointer++) = '\0'; break;
+	case 'a': *(string->pointer++) = '\x07'; break;
+	case 'b': *(string->pointer++) = '\x08'; break;
+	case 't':
+	case '\t': *(string->pointer++) = '\x09'; break;
+	case 'n': *(string->pointer++) = '\x0A'; break;
+	case 'v': *(string->pointer++) = '\x0B'; break;
+	case 'f': *(string->pointer++) = '\x0C'; break;
+	case 'r': *(string->pointer++) = '\x0D'; break;
+	case 'e': *(string->pointer++) = '\x1B'; break;
+	case ' ': *(string->pointer++) = ' '; break;
+	case '"': *(string->pointer++) = '"'; break;
+	case '/': *(string->pointer++) = '/'; break;
+	case '\'': *(string->pointer++) = '\''; break;
+	case '\\': *(string->pointer++) = '\\'; break;
+	case 'N': yaml_string_put_utf8_(string, 0x85); break;
+	case '_': yaml_string_put_utf8_(string, 0xA0); break;
+	case 'L': yaml_string_put_utf8_(string, 0x2028); break;
+	case 'P': yaml_string_put_utf8_(string, 0x2029); break;
+	case 'x': code_length = 2; break;
+	case 'u': code_length = 4; break;
+	case 'U': code_length = 8; break;
+	default:
+		return yaml_parser_set_scanner_error_(parser, "while parsing a quoted scalar",
+			start_mark, "found unknown escape character");
+	}
+
+	yaml_parser_skip_(parser);
+	yaml_parser_skip_(parser);
+
+	if (!code_length)
+		return YAML_EOK;
+
+	error = YAML_PARSER_CACHE(parser, code_length);
+	if (error)
+		return error;
+
+	for (k = 0; k < code_length; k++) {
+		if (!YAML_SCANNER_IS_HEX(parser, k))
+			return yaml_parser_set_scanner_error_(parser, "while parsing a quoted scalar",
+				start_mark, "did not find expected hexdecimal number");
+		value = (value << 4) + YAML_SCANNER_AS_HEX(parser, k);
+	}
+
+	if ((value >= 0xD800 && value <= 0xDFFF) || value > 0x10FFFF)
+		return yaml_parser_set_scanner_error_(parser, "while parsing a quoted scalar",
+			start_mark, "found invalid Unicode character escape code");
+
+	yaml_string_put_utf8_(string, value);
+	for (k = 0; k < code_length; k++)
+		yaml_parser_skip_(parser);
+
+	return YAML_EOK;
+}
+
+/* Fold the line breaks and the whitespaces between two parts of a
+ * multi-line flow or plain scalar into the value.
+ */
+static int yaml_parser_join_folded_(yaml_string_t *string, int leading_blanks, yaml_string_t *whitespaces,
+		yaml_string_t *leading_break, yaml_string_t *trailing_breaks) {
+	if (!leading_blanks)
+		return yaml_string_join_(string, whitespaces);
+
+	/* A single line break is a space, the next ones are kept. */
+	if (leading_break->start[0] == '\n') {
+		if (trailing_breaks->start[0] == '\0') {
+			if (yaml_string_reserve_(string, 1))
+				return YAML_EMEMORY;
+			*(string->pointer++) = ' ';
+		}
+		else if (yaml_string_join_(string, trailing_breaks))
+			return YAML_EMEMORY;
+		yaml_string_clear_(leading_break);
+		return YAML_EOK;
+	}
+
+	if (yaml_string_join_(string, leading_break) || yaml_string_join_(string, trailing_breaks))
+		return YAML_EMEMORY;
+	return YAML_EOK;
+}
+
+/* Scan the whitespaces and the line breaks in a multi-line scalar.
+ */
+static int yaml_parser_scan_folding_(yaml_parser_t *parser, int *leading_blanks, yaml_string_t *whitespaces,
+		yaml_string_t *leading_break, yaml_string_t *trailing_breaks, int indent, yaml_mark_t start_mark) {
+	int error;
+
+	error = YAML_PARSER_CACHE(parser, 1);
+	while (!error && (YAML_SCANNER_IS_BLANK(parser, 0) || YAML_SCANNER_IS_BREAK(parser, 0))) {
+		if (YAML_SCANNER_IS_BLANK(parser, 0)) {
+			/* A tab in the indentation of a plain scalar continuation is an error. */
+			if (indent && *leading_blanks && (int)parser->mark.column < indent
+					&& YAML_SCANNER_CHECK(parser, '\t', 0))
+				return yaml_parser_set_scanner_error_(parser, "while scanning a plain scalar",
+					start_mark, "found a tab character that violates indentation");
+
+			if (!*leading_blanks)
+				error = yaml_parser_read_(parser, whitespaces);
+			else
+				yaml_parser_skip_(parser);
+		}
+		else {
+			error = YAML_PARSER_CACHE(parser, 2);
+			if (!error && !*leading_blanks) {
+				yaml_string_clear_(whitespaces);
+				error = yaml_parser_read_line_(parser, leading_break);
+				*leading_blanks = 1;
+			}
+			else if (!error)
+				error = yaml_parser_read_line_(parser, trailing_breaks);
+		}
+		if (!error)
+			error = YAML_PARSER_CACHE(parser, 1);
+	}
+
+	return error;
+}
+
+static int yaml_parser_scan_flow_scalar_(yaml_parser_t *parser, yaml_token_t *token, int single) {
+	yaml_mark_t start_mark;
+	yaml_string_t string = { NULL, NULL, NULL };
+	yaml_string_t leading_break = { NULL, NULL, NULL };
+	yaml_string_t trailing_breaks = { NULL, NULL, NULL };
+	yaml_string_t whitespaces = { NULL, NULL, NULL };
+	int leading_blanks;
+	int error;
+
+	if (yaml_string_init_(&string) || yaml_string_init_(&leading_break)
+			|| yaml_string_init_(&trailing_breaks) || yaml_string_init_(&whitespaces)) {
+		error = yaml_parser_set_memory_error_(parser);
+		goto ERROR;
+	}
+
+	start_mark = parser->mark;
+	yaml_parser_skip_(parser);
+
+	for (;;) {
+		error = YAML_PARSER_CACHE(parser, 4);
+		if (error)
+			goto ERROR;
+
+		if (YAML_SCANNER_IS_DOCUMENT_INDICATOR(parser)) {
+			error = yaml_parser_set_scanner_error_(parser, "while scanning a quoted scalar",
+				start_mark, "found unexpected document indicator");
+			goto ERROR;
+		}
+		if (YAML_SCANNER_IS_Z(parser, 0)) {
+			error = yaml_parser_set_scanner_error_(parser, "while scanning a quoted scalar",
+				start_mark, "found unexpected end of stream");
+			goto ERROR;
+		}
+
+		/* Consume the non-blank characters. */
+		leading_blanks = 0;
+		while (!YAML_SCANNER_IS_BLANKZ(parser, 0)) {
+			if (single && YAML_SCANNER_CHECK(parser, '\'', 0) && YAML_SCANNER_CHECK(parser, '\'', 1)) {
+				/* An escaped single quote. */
+				if (yaml_string_reserve_(&string, 1)) {
+					error = yaml_parser_set_memory_error_(parser);
+					goto ERROR;
+				}
+				*(string.pointer++) = '\'';
+				yaml_parser_skip_(parser);
+				yaml_parser_skip_(parser);
+			}
+			else if (YAML_SCANNER_CHECK(parser, single ? '\'' : '"', 0))
+				break;
+			else if (!single && YAML_SCANNER_CHECK(parser, '\\', 0) && YAML_SCANNER_IS_BREAK(parser, 1)) {
+				/* An escaped line break. */
+				error = YAML_PARSER_CACHE(parser, 3);
+				if (error)
+					goto ERROR;
+				yaml_parser_skip_(parser);
+				yaml_parser_skip_line_(parser);
+				leading_blanks = 1;
+				break;
+			}
+			else if (!single && YAML_SCANNER_CHECK(parser, '\\', 0))
+				error = yaml_parser_scan_escape_(parser, start_mark, &string);
+			else
+				error = yaml_parser_read_(parser, &string);
+
+			if (!error)
+				error = YAML_PARSER_CACHE(parser, 2);
+			if (error)
+				goto ERROR;
+		}
+
+		error = YAML_PARSER_CACHE(parser, 1);
+		if (error)
+			goto ERROR;
+		if (YAML_SCANNER_CHECK(parser, single ? '\'' : '"', 0))
+			break;
+
+		error = yaml_parser_scan_folding_(parser, &leading_blanks, &whitespaces,
+			&leading_break, &trailing_breaks, 0, start_mark);
+		if (error)
+			goto ERROR;
+
+		if (yaml_parser_join_folded_(&string, leading_blanks, &whitespaces,
+				&leading_break, &trailing_breaks)) {
+			error = yaml_parser_set_memory_error_(parser);
+			goto ERROR;
+		}
+	}
+
+	/* Eat the right quote. */
+	yaml_parser_skip_(parser);
+
+	YAML_TOKEN_SCALAR_INIT(token, string.start, string.pointer - string.start,
+		single ? YAML_SCALAR_SINGLE_QUOTED : YAML_SCALAR_DOUBLE_QUOTED, start_mark, parser->mark);
+
+	yaml_string_destroy_(&leading_break);
+	yaml_string_destroy_(&trailing_breaks);
+	yaml_string_destroy_(&whitespaces);
+	return YAML_EOK;
+
+ERROR:
+	yaml_string_destroy_(&string);
+	yaml_string_destroy_(&leading_break);
+	yaml_string_destroy_(&trailing_breaks);
+	yaml_string_destroy_(&whitespaces);
+	return error;
+}
+
+/* Count the printable ASCII characters at the pointer that cannot end a
+ * plain scalar, they are copied at once.
+ */
+static size_t yaml_parser_plain_run_(const yaml_parser_t *parser) {
+	const yaml_char_t *pointer = parser->buffer.pointer;
+	size_t run = 0;
+
+	while (run < parser->unread && pointer[run] > 0x20 && pointer[run] < 0x7F && pointer[run] != ':'
+			&& !(parser->flow_level && (pointer[run] == ',' || pointer[run] == '['
+				|| pointer[run] == ']' || pointer[run] == '{' || pointer[run] == '}')))
+		run++;
+	return run;
+}
+
+static int yaml_parser_scan_plain_scalar_(yaml_parser_t *parser, yaml_token_t *token) {
+	yaml_mark_t start_mark, end_mark;
+	yaml_string_t string = { NULL, NULL, NULL };
+	yaml_string_t leading_break = { NULL, NULL, NULL };
+	yaml_string_t trailing_breaks = { NULL, NULL, NULL };
+	yaml_string_t whitespaces = { NULL, NULL, NULL };
+	int leading_blanks = 0;
+	int indent = parser->indent + 1;
+	size_t run;
+	int error;
+
+	if (yaml_string_init_(&string) || yaml_string_init_(&leading_break)
+			|| yaml_string_init_(&trailing_breaks) || yaml_string_init_(&whitespaces)) {
+		error = yaml_parser_set_memory_error_(parser);
+		goto ERROR;
+	}
+
+	start_mark = end_mark = parser->mark;
+
+	for (;;) {
+		error = YAML_PARSER_CACHE(parser, 4);
+		if (error)
+			goto ERROR;
+
+		/* A document indicator or a comment ends the scalar. */
+		if (YAML_SCANNER_IS_DOCUMENT_INDICATOR(parser) || YAML_SCANNER_CHECK(parser, '#', 0))
+			break;
+
+		while (!YAML_SCANNER_IS_BLANKZ(parser, 0)) {
+			/* "x:" followed by a flow indicator ends the scalar in the flow context. */
+			if (parser->flow_level && YAML_SCANNER_CHECK(parser, ':', 0)
+					&& (YAML_SCANNER_CHECK(parser, ',', 1) || YAML_SCANNER_CHECK(parser, '?', 1)
+						|| YAML_SCANNER_CHECK(parser, '[', 1) || YAML_SCANNER_CHECK(parser, ']', 1)
+						|| YAML_SCANNER_CHECK(parser, '{', 1) || YAML_SCANNER_CHECK(parser, '}', 1)))
+				break;
+
+			/* So do ": " and the flow indicators. */
+			if ((YAML_SCANNER_CHECK(parser, ':', 0) && YAML_SCANNER_IS_BLANKZ(parser, 1))
+					|| (parser->flow_level && (YAML_SCANNER_CHECK(parser, ',', 0)
+						|| YAML_SCANNER_CHECK(parser, '[', 0) || YAML_SCANNER_CHECK(parser, ']', 0)
+						|| YAML_SCANNER_CHECK(parser, '{', 0) || YAML_SCANNER_CHECK(parser, '}', 0))))
+				break;
+
+			if (leading_blanks || whitespaces.start != whitespaces.pointer) {
+				if (yaml_parser_join_folded_(&string, leading_blanks, &whitespaces,
+						&leading_break, &trailing_breaks)) {
+					error = yaml_parser_set_memory_error_(parser);
+					goto ERROR;
+				}
+				leading_blanks = 0;
+			}
+
+			run = yaml_parser_plain_run_(parser);
+			if (run) {
+				if (yaml_string_reserve_(&string, run)) {
+					error = yaml_parser_set_memory_error_(parser);
+					goto ERROR;
+				}
+				memcpy(string.pointer, parser->buffer.pointer, run);
+				string.pointer += run;
+				parser->mark.index += run;
+				parser->mark.column += run;
+				parser->unread -= run;
+				parser->buffer.pointer += run;
+			}
+			else {
+				error = yaml_parser_read_(parser, &string);
+				if (error)
+					goto ERROR;
+			}
+
+			end_mark = parser->mark;
+			error = YAML_PARSER_CACHE(parser, 2);
+			if (error)
+				goto ERROR;
+		}
+
+		/* Is it the end? */
+		if (!(YAML_SCANNER_IS_BLANK(parser, 0) || YAML_SCANNER_IS_BREAK(parser, 0)))
+			break;
+
+		error = yaml_parser_scan_folding_(parser, &leading_blanks, &whitespaces,
+			&leading_break, &trailing_breaks, indent, start_mark);
+		if (error)
+			goto ERROR;
+
+		/* A continuation line of a block plain scalar is more indented. */
+		if (!parser->flow_level && (int)parser->mark.column < indent)
+			break;
+	}
+
+	YAML_TOKEN_SCALAR_INIT(token, string.start, string.pointer - string.start,
+		YAML_SCALAR_PLAIN, start_mark, end_mark);
+
+	/* A simple key may start on the line after the scalar. */
+	if (leading_blanks)
+		parser->simple_key_allowed = 1;
+
+	yaml_string_destroy_(&leading_break);
+	yaml_string_destroy_(&trailing_breaks);
+	yaml_string_destroy_(&whitespaces);
+	return YAML_EOK;
+
+ERROR:
+	yaml_string_destroy_(&string);
+	yaml_string_destroy_(&leading_break);
+	yaml_string_destroy_(&trailing_breaks);
+	yaml_string_destroy_(&whitespaces);
+	return error;
+}
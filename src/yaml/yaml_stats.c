@@ -0,0 +1,89 @@
+#define YAML_STATS_ALLOCATOR
+#include "yaml_private.h"
+
+#if defined(YAML_STATS)
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# define YAML_STATS_CYCLES() __rdtsc()
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# include <x86intrin.h>
+# define YAML_STATS_CYCLES() __rdtsc()
+#elif defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+static uint64_t yaml_stats_cycles_(void) {
+	LARGE_INTEGER counter;
+
+	QueryPerformanceCounter(&counter);
+	return (uint64_t)counter.QuadPart;
+}
+# define YAML_STATS_CYCLES() yaml_stats_cycles_()
+#else
+# include <time.h>
+/* Nanoseconds stand for cycles where no cycle counter is at hand. */
+static uint64_t yaml_stats_cycles_(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+# define YAML_STATS_CYCLES() yaml_stats_cycles_()
+#endif
+
+/* The parser the allocations of the thread are counted for, and the stage it is timing.
+ */
+static YAML_THREAD_LOCAL yaml_parser_t *yaml_stats_parser_;
+static YAML_THREAD_LOCAL yaml_stats_mark_t *yaml_stats_mark_;
+
+void yaml_stats_begin(yaml_parser_t *parser, yaml_stats_mark_t *mark) {
+	mark->previous = yaml_stats_parser_;
+	mark->outer = yaml_stats_mark_;
+	mark->nested = 0;
+	yaml_stats_parser_ = parser;
+	yaml_stats_mark_ = mark;
+	mark->cycles = YAML_STATS_CYCLES();
+}
+
+/* A stage is charged its own time only, the time of the stages it runs is taken off.
+ */
+void yaml_stats_end(yaml_parser_t *parser, int stage, yaml_stats_mark_t *mark) {
+	uint64_t elapsed = YAML_STATS_CYCLES() - mark->cycles;
+
+	parser->stats.cycles[stage] += elapsed - mark->nested;
+	if (mark->outer)
+		mark->outer->nested += elapsed;
+	yaml_stats_parser_ = mark->previous;
+	yaml_stats_mark_ = mark->outer;
+}
+
+void *yaml_stats_malloc(size_t size) {
+	if (yaml_stats_parser_) {
+		yaml_stats_parser_->stats.allocations++;
+		yaml_stats_parser_->stats.bytes_allocated += size;
+	}
+	return YAML_MALLOC(size);
+}
+
+void *yaml_stats_realloc(void *ptr, size_t size) {
+	if (yaml_stats_parser_) {
+		yaml_stats_parser_->stats.allocations++;
+		yaml_stats_parser_->stats.bytes_allocated += size;
+	}
+	return YAML_REALLOC(ptr, size);
+}
+
+#endif
+
+int yaml_parser_get_stats(const yaml_parser_t *parser, yaml_parser_stats_t *stats) {
+	assert(parser); /* Non-NULL parser object expected. */
+	assert(stats); /* Non-NULL stats object expected. */
+
+#if defined(YAML_STATS)
+	*stats = parser->stats;
+	return YAML_EOK;
+#else
+	(void)parser;
+	memset(stats, 0, sizeof(yaml_parser_stats_t));
+	return YAML_EFAILD;
+#endif
+}
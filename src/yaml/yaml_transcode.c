@@ -0,0 +1,34 @@
+#include "yaml_private.h"
+
+int yaml_transcode(yaml_parser_t *parser, yaml_emitter_t *emitter, int flags) {
+	yaml_event_t event;
+	int error = YAML_EOK;
+	int done;
+
+	assert(parser); /* Non-NULL parser object is expected. */
+	assert(emitter); /* Non-NULL emitter object is expected. */
+
+	/* The JSON writer of the emitter drops the tags, anchors and directives
+	 * and escapes the strings the JSON way. */
+	if (flags & YAML_TRANSCODE_JSON)
+		yaml_emitter_set_json(emitter, 1);
+
+	do {
+		error = yaml_parser_parse(parser, &event);
+		if (error)
+			break;
+
+		/* The emitter owns the event from here on. */
+		done = event.type == YAML_EVENT_STREAM_END;
+		error = yaml_emitter_emit(emitter, &event);
+	} while (!error && !done);
+
+	/* The stream is over as if closed, a memory output is handed back. */
+	if (!error) {
+		emitter->opened = 1;
+		emitter->closed = 1;
+		yaml_emitter_release_output(emitter);
+	}
+
+	return error;
+}
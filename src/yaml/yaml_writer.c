@@ -0,0 +1,978 @@
+#include "yaml_private.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+# include <io.h>
+#else
+# include <errno.h>
+# include <limits.h>
+# include <unistd.h>
+# include <sys/uio.h>
+#endif
+
+/* The number of segments passed to one writev() call.
+ */
+#if defined(IOV_MAX) && IOV_MAX < 64
+# define YAML_WRITEV_MAX	IOV_MAX
+#else
+# define YAML_WRITEV_MAX	64
+#endif
+
+int yaml_fd_writev_handler(void *data, const yaml_iovec_t *segments, size_t count) {
+	yaml_emitter_t *emitter = (yaml_emitter_t *)data;
+
+#if defined(_WIN32) || defined(_WIN64)
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		const unsigned char *pointer = segments[i].base;
+		size_t length = segments[i].length;
+
+		while (length) {
+			int written = _write(emitter->output.fd, pointer,
+				(unsigned int)(length < 0x40000000 ? length : 0x40000000));
+
+			if (written <= 0)
+				return YAML_EFAILD;
+			pointer += written;
+			length -= written;
+		}
+	}
+#else
+	struct iovec iov[YAML_WRITEV_MAX];
+
+	while (count) {
+		size_t n = count < YAML_WRITEV_MAX ? count : YAML_WRITEV_MAX;
+		struct iovec *head = iov;
+		size_t i;
+
+		for (i = 0; i < n; i++) {
+			iov[i].iov_base = (void *)segments[i].base;
+			iov[i].iov_len = segments[i].length;
+		}
+		segments += n;
+		count -= n;
+
+		/* Resume after partial writes. */
+		while (n) {
+			ssize_t written = writev(emitter->output.fd, head, (int)n);
+
+			if (written < 0) {
+				if (errno == EINTR)
+					continue;
+				return YAML_EFAILD;
+			}
+			while (n && (size_t)written >= head->iov_len) {
+				written -= head->iov_len;
+				head++;
+				n--;
+			}
+			if (n) {
+				head->iov_base = (char *)head->iov_base + written;
+				head->iov_len -= written;
+			}
+		}
+	}
+#endif
+
+	return YAML_EOK;
+}
+
+/* Write a block of output through the handler set by the user.
+ */
+static int yaml_emitter_write_(yaml_emitter_t *emitter, const unsigned char *buffer, size_t size) {
+	int error;
+
+	if (emitter->writev_handler) {
+		yaml_iovec_t segment;
+
+		segment.base = buffer;
+		segment.length = size;
+		error = emitter->writev_handler(emitter->writev_handler_data, &segment, 1);
+	}
+	else
+		error = emitter->write_handler(emitter->write_handler_data, (unsigned char *)buffer, size);
+
+	if (error) {
+		emitter->error = YAML_EWRITER;
+		emitter->problem = "write error";
+		return YAML_EWRITER;
+	}
+	return YAML_EOK;
+}
+
+int yaml_buffer_write_handler(void *data, unsigned char *buffer, size_t size) {
+	yaml_output_buffer_t *output = ((yaml_emitter_t *)data)->output.buffer;
+
+	if (output->capacity - output->size < size) {
+		size_t capacity = output->capacity ? output->capacity : YAML_OUTPUT_BUFFER_SIZE;
+		unsigned char *start;
+
+		while (capacity - output->size < size)
+			capacity *= 2;
+		start = (unsigned char *)YAML_REALLOC(output->start, capacity);
+		if (!start)
+			return YAML_EMEMORY;
+		output->start = start;
+		output->capacity = capacity;
+	}
+
+	memcpy(output->start + output->size, buffer, size);
+	output->size += size;
+	return YAML_EOK;
+}
+
+/* Check if the output goes to memory without recoding, through the buffer itself.
+ */
+#define YAML_EMITTER_IS_DIRECT(emitter) \
+	((emitter)->write_handler == yaml_buffer_write_handler \
+	 && ((emitter)->encoding == YAML_ENCODING_UTF8 || !(emitter)->encoding))
+
+/* Make room in a direct memory output by growing the buffer in place.
+ */
+static int yaml_emitter_grow_(yaml_emitter_t *emitter) {
+	size_t capacity = emitter->buffer.end - emitter->buffer.start;
+	size_t used = emitter->buffer.pointer - emitter->buffer.start;
+	yaml_char_t *start;
+
+	/* Explicit flushes at the end of documents need no room. */
+	if (capacity - used > 16)
+		return YAML_EOK;
+
+	capacity = capacity * 2 > YAML_OUTPUT_BUFFER_SIZE ? capacity * 2 : YAML_OUTPUT_BUFFER_SIZE;
+	start = (yaml_char_t *)YAML_REALLOC(emitter->buffer.start, capacity);
+	if (!start) {
+		emitter->error = YAML_EMEMORY;
+		emitter->problem = "cannot grow the output buffer";
+		return YAML_EMEMORY;
+	}
+
+	emitter->buffer.start = start;
+	emitter->buffer.pointer = start + used;
+	emitter->buffer.last = start + used;
+	emitter->buffer.end = start + capacity;
+	return YAML_EOK;
+}
+
+void yaml_emitter_release_output(yaml_emitter_t *emitter) {
+	yaml_output_buffer_t *output;
+
+	assert(emitter); /* Non-NULL emitter object is expected. */
+
+	if (emitter->write_handler != yaml_buffer_write_handler || !emitter->output.buffer)
+		return;
+	output = emitter->output.buffer;
+
+	/* A recoded output is already in place. */
+	if (YAML_EMITTER_IS_DIRECT(emitter)) {
+		output->start = emitter->buffer.start;
+		output->size = emitter->buffer.pointer - emitter->buffer.start;
+		output->capacity = emitter->buffer.end - emitter->buffer.start;
+		emitter->buffer.start = NULL;
+		emitter->buffer.end = NULL;
+		emitter->buffer.pointer = NULL;
+		emitter->buffer.last = NULL;
+	}
+	emitter->output.buffer = NULL;
+}
+
+int yaml_emitter_flush(yaml_emitter_t *emitter) {
+	int low;
+	int high;
+	int error;
+
+	assert(emitter); /* Non-NULL emitter object is expected. */
+	assert(emitter->write_handler || emitter->writev_handler); /* Write handler must be set. */
+	assert(emitter->encoding); /* Output encoding must be set. */
+
+	if (YAML_EMITTER_IS_DIRECT(emitter))
+		return yaml_emitter_grow_(emitter);
+
+	emitter->buffer.last = emitter->buffer.pointer;
+	emitter->buffer.pointer = emitter->buffer.start;
+
+	/* Check if the buffer is empty. */
+	if (emitter->buffer.start == emitter->buffer.last)
+		return YAML_EOK;
+
+	/* If the output encoding is UTF-8, we don't need to recode the buffer. */
+	if (emitter->encoding == YAML_ENCODING_UTF8) {
+		error = yaml_emitter_write_(emitter, emitter->buffer.start,
+			emitter->buffer.last - emitter->buffer.start);
+		emitter->buffer.last = emitter->buffer.start;
+		emitter->buffer.pointer = emitter->buffer.start;
+		return error;
+	}
+
+	/* Recode the buffer into the raw buffer. */
+	low = (emitter->encoding == YAML_ENCODING_UTF16LE ? 0 : 1);
+	high = (emitter->encoding == YAML_ENCODING_UTF16LE ? 1 : 0);
+
+	while (emitter->buffer.pointer != emitter->buffer.last) {
+		unsigned char octet;
+		unsigned int width;
+		unsigned int value;
+		size_t k;
+
+		/* See the "reader.c" code for more details on UTF-8 encoding.  Note
+		 * that we assume that the buffer contains a valid UTF-8 sequence. */
+
+		/* Read the next UTF-8 character. */
+		octet = emitter->buffer.pointer[0];
+
+		width = (octet & 0x80) == 0x00 ? 1 :
+			(octet & 0xE0) == 0xC0 ? 2 :
+			(octet & 0xF0) == 0xE0 ? 3 :
+			(octet & 0xF8) == 0xF0 ? 4 : 0;
+
+		value = (octet & 0x80) == 0x00 ? octet & 0x7F :
+			(octet & 0xE0) == 0xC0 ? octet & 0x1F :
+			(octet & 0xF0) == 0xE0 ? octet & 0x0F :
+			(octet & 0xF8) == 0xF0 ? octet & 0x07 : 0;
+
+		for (k = 1; k < width; k++) {
+			octet = emitter->buffer.pointer[k];
+			value = (value << 6) + (octet & 0x3F);
+		}
+		emitter->buffer.pointer += width;
+
+		/* A reused memory buffer may hold more than the raw buffer takes. */
+		if (emitter->raw_buffer.end - emitter->raw_buffer.last < 4) {
+			error = yaml_emitter_write_(emitter, emitter->raw_buffer.start,
+				emitter->raw_buffer.last - emitter->raw_buffer.start);
+			emitter->raw_buffer.last = emitter->raw_buffer.start;
+			if (error)
+				return error;
+		}
+
+		/* Write the character. */
+		if (value < 0x10000) {
+			emitter->raw_buffer.last[high] = value >> 8;
+			emitter->raw_buffer.last[low] = value & 0xFF;
+			emitter->raw_buffer.last += 2;
+		}
+		else {
+			/* Write the character using a surrogate pair (check "reader.c"). */
+			value -= 0x10000;
+			emitter->raw_buffer.last[high] = 0xD8 + (value >> 18);
+			emitter->raw_buffer.last[low] = (value >> 10) & 0xFF;
+			emitter->raw_buffer.last[high + 2] = 0xDC + ((value >> 8) & 0xFF);
+			emitter->raw_buffer.last[low + 2] = value & 0xFF;
+			emitter->raw_buffer.last += 4;
+		}
+	}
+
+	/* Write the raw buffer. */
+	error = yaml_emitter_write_(emitter, emitter->raw_buffer.start,
+		emitter->raw_buffer.last - emitter->raw_buffer.start);
+	emitter->buffer.last = emitter->buffer.start;
+	emitter->buffer.pointer = emitter->buffer.start;
+	emitter->raw_buffer.last = emitter->raw_buffer.start;
+	emitter->raw_buffer.pointer = emitter->raw_buffer.start;
+
+	return error;
+}
+
+int yaml_emitter_write_verbatim(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length) {
+	const yaml_char_t *pointer;
+	int error;
+
+	assert(emitter); /* Non-NULL emitter object is expected. */
+	assert(value || !length);
+
+	/* The column counts characters, not octets. */
+	for (pointer = value; pointer != value + length; pointer++) {
+		if ((*pointer & 0xC0) != 0x80)
+			emitter->column++;
+	}
+
+	/* Long UTF-8 runs go out by reference, after what is buffered. */
+	if (emitter->zero_copy_threshold && length >= emitter->zero_copy_threshold
+			&& emitter->encoding == YAML_ENCODING_UTF8 && !YAML_EMITTER_IS_DIRECT(emitter)) {
+		if (emitter->writev_handler) {
+			yaml_iovec_t segments[2];
+
+			segments[0].base = emitter->buffer.start;
+			segments[0].length = emitter->buffer.pointer - emitter->buffer.start;
+			segments[1].base = value;
+			segments[1].length = length;
+			emitter->buffer.pointer = emitter->buffer.start;
+			emitter->buffer.last = emitter->buffer.start;
+
+			if (emitter->writev_handler(emitter->writev_handler_data,
+					segments + !segments[0].length, 2 - !segments[0].length)) {
+				emitter->error = YAML_EWRITER;
+				emitter->problem = "write error";
+				return YAML_EWRITER;
+			}
+			return YAML_EOK;
+		}
+
+		error = yaml_emitter_flush(emitter);
+		if (error)
+			return error;
+		return yaml_emitter_write_(emitter, value, length);
+	}
+
+	/* Copy whole characters, so the recoder never sees a split one. */
+	while (length) {
+		size_t room = emitter->buffer.end - emitter->buffer.pointer;
+		size_t count = length < room ? length : room;
+
+		while (count < length && count && (value[count] & 0xC0) == 0x80)
+			count--;
+		if (!count) {
+			error = yaml_emitter_flush(emitter);
+			if (error)
+				return error;
+			continue;
+		}
+
+		memcpy(emitter->buffer.pointer, value, count);
+		emitter->buffer.pointer += count;
+		value += count;
+		length -= count;
+	}
+
+	return YAML_EOK;
+}
+
+/* Put an ASCII octet, with room for it made first.
+ */
+static int yaml_emitter_put_(yaml_emitter_t *emitter, yaml_char_t value) {
+	int error;
+
+	if (emitter->buffer.end - emitter->buffer.pointer < 8) {
+		error = yaml_emitter_flush(emitter);
+		if (error)
+			return error;
+	}
+	*(emitter->buffer.pointer++) = value;
+	emitter->column++;
+	return YAML_EOK;
+}
+
+/* Put the line break chosen for the output.
+ */
+static int yaml_emitter_put_break_(yaml_emitter_t *emitter) {
+	int error;
+
+	if (emitter->buffer.end - emitter->buffer.pointer < 8) {
+		error = yaml_emitter_flush(emitter);
+		if (error)
+			return error;
+	}
+	if (emitter->line_break == YAML_BREAK_CR)
+		*(emitter->buffer.pointer++) = '\r';
+	else if (emitter->line_break == YAML_BREAK_LN)
+		*(emitter->buffer.pointer++) = '\n';
+	else if (emitter->line_break == YAML_BREAK_CRLN) {
+		*(emitter->buffer.pointer++) = '\r';
+		*(emitter->buffer.pointer++) = '\n';
+	}
+	emitter->column = 0;
+	emitter->line++;
+	return YAML_EOK;
+}
+
+/* Write a line break of the value, LF as the chosen break and the others as they are.
+ */
+static int yaml_emitter_write_break_(yaml_emitter_t *emitter, const yaml_char_t *pointer) {
+	int error;
+
+	if (*pointer == '\n')
+		return yaml_emitter_put_break_(emitter);
+
+	error = yaml_emitter_write_verbatim(emitter, pointer, YAML_UTF8_WIDTH(*pointer));
+	emitter->column = 0;
+	emitter->line++;
+	return error;
+}
+
+/* Check for a line break of the value: CR, LF, NEL, LS or PS.
+ */
+#define YAML_WRITER_IS_BREAK(pointer, end) \
+	(*(pointer) == '\r' || *(pointer) == '\n' || YAML_IS_UNICODE_BREAK((pointer), (end)))
+
+/* Find the end of the run from pointer that needs no care: printable ASCII
+ * octets other than the space and the two stop octets, 8 octets at a time.
+ */
+static const yaml_char_t *yaml_emitter_run_end_(const yaml_char_t *pointer, const yaml_char_t *end,
+		yaml_char_t stop, yaml_char_t other_stop) {
+	while (end - pointer >= 8) {
+		uint64_t x;
+
+		memcpy(&x, pointer, sizeof(x));
+		if ((x & YAML_SWAR_HIGHS) | YAML_SWAR_HAS_LESS(x, 0x21) | YAML_SWAR_HAS(x, 0x7F)
+				| YAML_SWAR_HAS(x, stop) | YAML_SWAR_HAS(x, other_stop))
+			break;
+		pointer += 8;
+	}
+	while (pointer != end && *pointer > 0x20 && *pointer < 0x7F && *pointer != stop && *pointer != other_stop)
+		pointer++;
+	return pointer;
+}
+
+int yaml_emitter_write_bom(yaml_emitter_t *emitter) {
+	int error;
+
+	/* The BOM is no character of the output, the column stays. */
+	if (emitter->buffer.end - emitter->buffer.pointer < 8) {
+		error = yaml_emitter_flush(emitter);
+		if (error)
+			return error;
+	}
+	*(emitter->buffer.pointer++) = 0xEF;
+	*(emitter->buffer.pointer++) = 0xBB;
+	*(emitter->buffer.pointer++) = 0xBF;
+	return YAML_EOK;
+}
+
+int yaml_emitter_write_indent(yaml_emitter_t *emitter) {
+	int indent = (emitter->indent >= 0) ? emitter->indent : 0;
+	int error;
+
+	if (!emitter->indention || emitter->column > indent
+			|| (emitter->column == indent && !emitter->whitespace)) {
+		error = yaml_emitter_put_break_(emitter);
+		if (error)
+			return error;
+	}
+	while (emitter->column < indent) {
+		error = yaml_emitter_put_(emitter, ' ');
+		if (error)
+			return error;
+	}
+
+	emitter->whitespace = 1;
+	emitter->indention = 1;
+	return YAML_EOK;
+}
+
+int yaml_emitter_write_indicator(yaml_emitter_t *emitter, const char *indicator,
+		int need_whitespace, int is_whitespace, int is_indention) {
+	int error;
+
+	if (need_whitespace && !emitter->whitespace) {
+		error = yaml_emitter_put_(emitter, ' ');
+		if (error)
+			return error;
+	}
+	error = yaml_emitter_write_verbatim(emitter, (const yaml_char_t *)indicator, strlen(indicator));
+	if (error)
+		return error;
+
+	emitter->whitespace = is_whitespace;
+	emitter->indention = (emitter->indention && is_indention);
+	emitter->open_ended = 0;
+	return YAML_EOK;
+}
+
+int yaml_emitter_write_anchor(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length) {
+	int error;
+
+	error = yaml_emitter_write_verbatim(emitter, value, length);
+	if (error)
+		return error;
+
+	emitter->whitespace = 0;
+	emitter->indention = 0;
+	return YAML_EOK;
+}
+
+int yaml_emitter_write_tag_handle(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length) {
+	int error;
+
+	if (!emitter->whitespace) {
+		error = yaml_emitter_put_(emitter, ' ');
+		if (error)
+			return error;
+	}
+	error = yaml_emitter_write_verbatim(emitter, value, length);
+	if (error)
+		return error;
+
+	emitter->whitespace = 0;
+	emitter->indention = 0;
+	return YAML_EOK;
+}
+
+/* Check for an URI character written as it is in a tag.
+ */
+#define YAML_WRITER_IS_URI(octet) \
+	(((octet) >= '0' && (octet) <= '9') || ((octet) >= 'A' && (octet) <= 'Z') \
+	 || ((octet) >= 'a' && (octet) <= 'z') || ((octet) && strchr("-;/?:@&=+$,_.~*'()[]", (octet))))
+
+int yaml_emitter_write_tag_content(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length,
+		int need_whitespace) {
+	static const char digits[] = "0123456789ABCDEF";
+	const yaml_char_t *end = value + length;
+	int error;
+
+	if (need_whitespace && !emitter->whitespace) {
+		error = yaml_emitter_put_(emitter, ' ');
+		if (error)
+			return error;
+	}
+
+	while (value != end) {
+		const yaml_char_t *run = value;
+		int width;
+
+		while (value != end && YAML_WRITER_IS_URI(*value))
+			value++;
+		error = yaml_emitter_write_verbatim(emitter, run, value - run);
+		if (error)
+			return error;
+
+		/* Every octet of the other characters is escaped. */
+		for (width = value != end ? YAML_UTF8_WIDTH(*value) : 0; width && value != end; width--, value++) {
+			error = yaml_emitter_put_(emitter, '%');
+			if (!error)
+				error = yaml_emitter_put_(emitter, digits[*value >> 4]);
+			if (!error)
+				error = yaml_emitter_put_(emitter, digits[*value & 0x0F]);
+			if (error)
+				return error;
+		}
+	}
+
+	emitter->whitespace = 0;
+	emitter->indention = 0;
+	return YAML_EOK;
+}
+
+int yaml_emitter_write_plain_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length,
+		int allow_breaks) {
+	const yaml_char_t *end = value + length;
+	int spaces = 0;
+	int breaks = 0;
+	int error;
+
+	/* No trailing space for empty values in block mode. */
+	if (!emitter->whitespace && (length || emitter->flow_level)) {
+		error = yaml_emitter_put_(emitter, ' ');
+		if (error)
+			return error;
+	}
+
+	while (value != end) {
+		const yaml_char_t *run = yaml_emitter_run_end_(value, end, ' ', ' ');
+
+		if (run != value) {
+			if (breaks) {
+				error = yaml_emitter_write_indent(emitter);
+				if (error)
+					return error;
+			}
+			error = yaml_emitter_write_verbatim(emitter, value, run - value);
+			if (error)
+				return error;
+			emitter->indention = 0;
+			spaces = 0;
+			breaks = 0;
+			value = run;
+		}
+		else if (*value == ' ') {
+			if (allow_breaks && !spaces && emitter->column > emitter->best_width
+					&& value + 1 != end && value[1] != ' ')
+				error = yaml_emitter_write_indent(emitter);
+			else
+				error = yaml_emitter_put_(emitter, ' ');
+			if (error)
+				return error;
+			spaces = 1;
+			value++;
+		}
+		else if (YAML_WRITER_IS_BREAK(value, end)) {
+			if (!breaks && *value == '\n') {
+				error = yaml_emitter_put_break_(emitter);
+				if (error)
+					return error;
+			}
+			error = yaml_emitter_write_break_(emitter, value);
+			if (error)
+				return error;
+			emitter->indention = 1;
+			breaks = 1;
+			value += YAML_UTF8_WIDTH(*value);
+		}
+		else {
+			if (breaks) {
+				error = yaml_emitter_write_indent(emitter);
+				if (error)
+					return error;
+			}
+			error = yaml_emitter_write_verbatim(emitter, value, YAML_UTF8_WIDTH(*value));
+			if (error)
+				return error;
+			emitter->indention = 0;
+			spaces = 0;
+			breaks = 0;
+			value += YAML_UTF8_WIDTH(*value);
+		}
+	}
+
+	emitter->whitespace = 0;
+	emitter->indention = 0;
+	return YAML_EOK;
+}
+
+int yaml_emitter_write_single_quoted_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length,
+		int allow_breaks) {
+	const yaml_char_t *start = value;
+	const yaml_char_t *end = value + length;
+	int spaces = 0;
+	int breaks = 0;
+	int error;
+
+	error = yaml_emitter_write_indicator(emitter, "'", 1, 0, 0);
+	if (error)
+		return error;
+
+	while (value != end) {
+		const yaml_char_t *run = yaml_emitter_run_end_(value, end, '\'', ' ');
+
+		if (*value == ' ') {
+			if (allow_breaks && !spaces && emitter->column > emitter->best_width
+					&& value != start && value + 1 != end && value[1] != ' ')
+				error = yaml_emitter_write_indent(emitter);
+			else
+				error = yaml_emitter_put_(emitter, ' ');
+			if (error)
+				return error;
+			spaces = 1;
+			value++;
+		}
+		else if (YAML_WRITER_IS_BREAK(value, end)) {
+			if (!breaks && *value == '\n') {
+				error = yaml_emitter_put_break_(emitter);
+				if (error)
+					return error;
+			}
+			error = yaml_emitter_write_break_(emitter, value);
+			if (error)
+				return error;
+			emitter->indention = 1;
+			breaks = 1;
+			value += YAML_UTF8_WIDTH(*value);
+		}
+		else {
+			if (breaks) {
+				error = yaml_emitter_write_indent(emitter);
+				if (error)
+					return error;
+			}
+			/* A quote is doubled, then written with the characters after it. */
+			if (run == value) {
+				if (*value == '\'') {
+					error = yaml_emitter_put_(emitter, '\'');
+					if (error)
+						return error;
+				}
+				run = value + YAML_UTF8_WIDTH(*value);
+			}
+			error = yaml_emitter_write_verbatim(emitter, value, run - value);
+			if (error)
+				return error;
+			emitter->indention = 0;
+			spaces = 0;
+			breaks = 0;
+			value = run;
+		}
+	}
+
+	if (breaks) {
+		error = yaml_emitter_write_indent(emitter);
+		if (error)
+			return error;
+	}
+	error = yaml_emitter_write_indicator(emitter, "'", 0, 0, 0);
+	if (error)
+		return error;
+
+	emitter->whitespace = 0;
+	emitter->indention = 0;
+	return YAML_EOK;
+}
+
+/* Write a character of a double-quoted scalar as an escape sequence.
+ */
+static int yaml_emitter_write_escape_(yaml_emitter_t *emitter, const yaml_char_t *pointer, int width) {
+	static const char digits[] = "0123456789ABCDEF";
+	unsigned int value;
+	yaml_char_t octet = pointer[0];
+	int digit_count = 0;
+	int error;
+	int k;
+
+	value = (octet & 0x80) == 0x00 ? octet & 0x7F :
+		(octet & 0xE0) == 0xC0 ? octet & 0x1F :
+		(octet & 0xF0) == 0xE0 ? octet & 0x0F :
+		(octet & 0xF8) == 0xF0 ? octet & 0x07 : 0;
+	for (k = 1; k < width; k++)
+		value = (value << 6) + (pointer[k] & 0x3F);
+
+	error = yaml_emitter_put_(emitter, '\\');
+	if (error)
+		return error;
+
+	switch (value) {
+	case 0x00: octet = '0'; break;
+	case 0x07: octet = 'a'; break;
+	case 0x08: octet = 'b'; break;
+	case 0x09: octet = 't'; break;
+	case 0x0A: octet = 'n'; break;
+	case 0x0B: octet = 'v'; break;
+	case 0x0C: octet = 'f'; break;
+	case 0x0D: octet = 'r'; break;
+	case 0x1B: octet = 'e'; break;
+	case 0x22: octet = '"'; break;
+	case 0x5C: octet = '\\'; break;
+	case 0x85: octet = 'N'; break;
+	case 0xA0: octet = '_'; break;
+	case 0x2028: octet = 'L'; break;
+	case 0x2029: octet = 'P'; break;
+	default:
+		if (value <= 0xFF) {
+			octet = 'x';
+			digit_count = 2;
+		}
+		else if (value <= 0xFFFF) {
+			octet = 'u';
+			digit_count = 4;
+		}
+		else {
+			octet = 'U';
+			digit_count = 8;
+		}
+		break;
+	}
+
+	error = yaml_emitter_put_(emitter, octet);
+	for (k = (digit_count - 1) * 4; !error && k >= 0; k -= 4)
+		error = yaml_emitter_put_(emitter, digits[(value >> k) & 0x0F]);
+	return error;
+}
+
+int yaml_emitter_write_double_quoted_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length,
+		int allow_breaks) {
+	const yaml_char_t *start = value;
+	const yaml_char_t *end = value + length;
+	int spaces = 0;
+	int error;
+
+	error = yaml_emitter_write_indicator(emitter, "\"", 1, 0, 0);
+	if (error)
+		return error;
+
+	while (value != end) {
+		const yaml_char_t *run = yaml_emitter_run_end_(value, end, '"', '\\');
+		int width = YAML_UTF8_WIDTH(*value);
+
+		if (run != value) {
+			error = yaml_emitter_write_verbatim(emitter, value, run - value);
+			spaces = 0;
+			value = run;
+		}
+		else if (*value == ' ') {
+			if (allow_breaks && !spaces && emitter->column > emitter->best_width
+					&& value != start && value + 1 != end) {
+				error = yaml_emitter_write_indent(emitter);
+				if (!error && value[1] == ' ')
+					error = yaml_emitter_put_(emitter, '\\');
+			}
+			else
+				error = yaml_emitter_put_(emitter, ' ');
+			spaces = 1;
+			value++;
+		}
+		else if (*value < 0x80 || !emitter->unicode || !YAML_IS_UNICODE_PRINTABLE(value, end)
+				|| YAML_IS_UNICODE_BREAK(value, end)) {
+			error = yaml_emitter_write_escape_(emitter, value, width);
+			spaces = 0;
+			value += width;
+		}
+		else {
+			error = yaml_emitter_write_verbatim(emitter, value, width);
+			spaces = 0;
+			value += width;
+		}
+		if (error)
+			return error;
+	}
+
+	error = yaml_emitter_write_indicator(emitter, "\"", 0, 0, 0);
+	if (error)
+		return error;
+
+	emitter->whitespace = 0;
+	emitter->indention = 0;
+	return YAML_EOK;
+}
+
+/* Write the indentation and chomping indicators of a block scalar.
+ */
+static int yaml_emitter_write_block_scalar_hints_(yaml_emitter_t *emitter,
+		const yaml_char_t *value, size_t length) {
+	const yaml_char_t *end = value + length;
+	const yaml_char_t *pointer = end;
+	const char *chomp_hint = NULL;
+	char indent_hint[2];
+	int error;
+
+	if (length && (*value == ' ' || YAML_WRITER_IS_BREAK(value, end))) {
+		indent_hint[0] = (char)('0' + emitter->best_indent);
+		indent_hint[1] = '\0';
+		error = yaml_emitter_write_indicator(emitter, indent_hint, 0, 0, 0);
+		if (error)
+			return error;
+	}
+
+	emitter->open_ended = 0;
+
+	if (!length)
+		chomp_hint = "-";
+	else {
+		do {
+			pointer--;
+		} while ((*pointer & 0xC0) == 0x80);
+		if (!YAML_WRITER_IS_BREAK(pointer, end))
+			chomp_hint = "-";
+		else if (pointer == value) {
+			chomp_hint = "+";
+			emitter->open_ended = 2;
+		}
+		else {
+			do {
+				pointer--;
+			} while ((*pointer & 0xC0) == 0x80);
+			if (YAML_WRITER_IS_BREAK(pointer, end)) {
+				chomp_hint = "+";
+				emitter->open_ended = 2;
+			}
+		}
+	}
+
+	if (chomp_hint) {
+		error = yaml_emitter_write_indicator(emitter, chomp_hint, 0, 0, 0);
+		if (error)
+			return error;
+	}
+	return YAML_EOK;
+}
+
+int yaml_emitter_write_literal_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length) {
+	const yaml_char_t *end = value + length;
+	int breaks = 1;
+	int error;
+
+	error = yaml_emitter_write_indicator(emitter, "|", 1, 0, 0);
+	if (!error)
+		error = yaml_emitter_write_block_scalar_hints_(emitter, value, length);
+	if (!error)
+		error = yaml_emitter_put_break_(emitter);
+	if (error)
+		return error;
+
+	emitter->indention = 1;
+	emitter->whitespace = 1;
+
+	while (value != end) {
+		if (YAML_WRITER_IS_BREAK(value, end)) {
+			error = yaml_emitter_write_break_(emitter, value);
+			if (error)
+				return error;
+			emitter->indention = 1;
+			breaks = 1;
+			value += YAML_UTF8_WIDTH(*value);
+		}
+		else {
+			const yaml_char_t *run = yaml_emitter_run_end_(value, end, ' ', ' ');
+
+			if (breaks) {
+				error = yaml_emitter_write_indent(emitter);
+				if (error)
+					return error;
+			}
+			if (run == value)
+				run = value + YAML_UTF8_WIDTH(*value);
+			error = yaml_emitter_write_verbatim(emitter, value, run - value);
+			if (error)
+				return error;
+			emitter->indention = 0;
+			breaks = 0;
+			value = run;
+		}
+	}
+
+	return YAML_EOK;
+}
+
+int yaml_emitter_write_folded_scalar(yaml_emitter_t *emitter, const yaml_char_t *value, size_t length) {
+	const yaml_char_t *end = value + length;
+	int breaks = 1;
+	int leading_spaces = 1;
+	int error;
+
+	error = yaml_emitter_write_indicator(emitter, ">", 1, 0, 0);
+	if (!error)
+		error = yaml_emitter_write_block_scalar_hints_(emitter, value, length);
+	if (!error)
+		error = yaml_emitter_put_break_(emitter);
+	if (error)
+		return error;
+
+	emitter->indention = 1;
+	emitter->whitespace = 1;
+
+	while (value != end) {
+		if (YAML_WRITER_IS_BREAK(value, end)) {
+			/* A single break between two lines of text would fold into a space. */
+			if (!breaks && !leading_spaces && *value == '\n') {
+				const yaml_char_t *next = value;
+
+				while (next != end && YAML_WRITER_IS_BREAK(next, end))
+					next += YAML_UTF8_WIDTH(*next);
+				if (next != end && *next != ' ' && *next != '\t') {
+					error = yaml_emitter_put_break_(emitter);
+					if (error)
+						return error;
+				}
+			}
+			error = yaml_emitter_write_break_(emitter, value);
+			if (error)
+				return error;
+			emitter->indention = 1;
+			breaks = 1;
+			value += YAML_UTF8_WIDTH(*value);
+		}
+		else {
+			const yaml_char_t *run = yaml_emitter_run_end_(value, end, ' ', ' ');
+
+			if (breaks) {
+				error = yaml_emitter_write_indent(emitter);
+				if (error)
+					return error;
+				leading_spaces = (*value == ' ' || *value == '\t');
+			}
+			if (run != value)
+				error = yaml_emitter_write_verbatim(emitter, value, run - value);
+			else if (!breaks && *value == ' ' && value + 1 != end && value[1] != ' '
+					&& emitter->column > emitter->best_width) {
+				error = yaml_emitter_write_indent(emitter);
+				run = value + 1;
+			}
+			else {
+				run = value + YAML_UTF8_WIDTH(*value);
+				error = yaml_emitter_write_verbatim(emitter, value, run - value);
+			}
+			if (error)
+				return error;
+			emitter->indention = 0;
+			breaks = 0;
+			value = run;
+		}
+	}
+
+	return YAML_EOK;
+}